@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace ratl
+{
+static constexpr std::size_t num_channels = 32;
+static constexpr std::size_t num_frames = 48000 * 20;
+static constexpr std::size_t block_frames = 4800;
+
+// FORM header, an 18 byte COMM chunk and the SSND chunk header, with the SSND offset aligning the samples to 4 bytes
+static constexpr std::size_t header_size = 12 + 26 + 16 + 2;
+
+using file_sample_value_type = int24_t;
+using file_sample_type = network_sample<file_sample_value_type>;
+
+template<typename Tp>
+static void write_big_endian(std::FILE* file, Tp value)
+{
+    for (std::size_t byte_num = sizeof(Tp); byte_num > 0; --byte_num)
+    {
+        std::fputc(static_cast<int>((static_cast<std::uint64_t>(value) >> ((byte_num - 1) * 8)) & 0xff), file);
+    }
+}
+
+// Writes an AIFF file of random big endian samples once, and returns its path
+static const std::string& aiff_path()
+{
+    static const std::string path = []()
+    {
+        auto* tmp_dir = std::getenv("TMPDIR");
+        auto path = std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") + "/ratl_bench_aiff_file.aiff";
+        auto data_size = static_cast<std::uint32_t>(num_channels * num_frames * sizeof(file_sample_type));
+
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+        std::fwrite("FORM", 1, 4, file.get());
+        write_big_endian(file.get(), static_cast<std::uint32_t>(data_size + header_size - 8));
+        std::fwrite("AIFFCOMM", 1, 8, file.get());
+        write_big_endian(file.get(), std::uint32_t(18));
+        write_big_endian(file.get(), static_cast<std::uint16_t>(num_channels));
+        write_big_endian(file.get(), static_cast<std::uint32_t>(num_frames));
+        write_big_endian(file.get(), static_cast<std::uint16_t>(sizeof(file_sample_type) * 8));
+        // 48000 as an 80 bit extended precision float
+        write_big_endian(file.get(), std::uint16_t(0x400e));
+        write_big_endian(file.get(), std::uint64_t(0xbb80000000000000));
+        std::fwrite("SSND", 1, 4, file.get());
+        write_big_endian(file.get(), static_cast<std::uint32_t>(data_size + 10));
+        write_big_endian(file.get(), std::uint32_t(2));
+        write_big_endian(file.get(), std::uint32_t(0));
+        write_big_endian(file.get(), std::uint16_t(0));
+
+        auto block =
+            utils::generateRandomInput<network_interleaved<file_sample_value_type>>(num_channels, block_frames);
+        for (std::size_t frame_num = 0; frame_num < num_frames; frame_num += block_frames)
+        {
+            std::fwrite(block.data(), sizeof(file_sample_type), block.samples(), file.get());
+        }
+        return path;
+    }();
+    return path;
+}
+
+// Byte swaps each block into a host order buffer, then converts it, as a loader that swaps on load would
+static void benchSwapThenConvert(benchmark::State& state)
+{
+    interleaved<file_sample_value_type> host_order(num_channels, block_frames);
+    noninterleaved<float32_t> output(num_channels, block_frames);
+    for (auto _ : state)
+    {
+        aiff_file file(aiff_path());
+        for (std::size_t frame_num = 0; frame_num < file.frames(); frame_num += block_frames)
+        {
+            file.will_need(frame_num + block_frames, block_frames);
+            auto input = file.network_samples<file_sample_value_type>(frame_num, block_frames);
+            transform(input.begin(), input.end(), host_order.begin());
+            transform(host_order.begin(), host_order.end(), output.begin());
+            benchmark::DoNotOptimize(output.data());
+        }
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * num_channels * num_frames * sizeof(file_sample_type)));
+}
+
+// Converts each block straight out of the mapped file, with the byte swap fused into the conversion
+static void benchFusedConvert(benchmark::State& state)
+{
+    noninterleaved<float32_t> output(num_channels, block_frames);
+    for (auto _ : state)
+    {
+        aiff_file file(aiff_path());
+        for (std::size_t frame_num = 0; frame_num < file.frames(); frame_num += block_frames)
+        {
+            file.will_need(frame_num + block_frames, block_frames);
+            auto input = file.network_samples<file_sample_value_type>(frame_num, block_frames);
+            transform(input.begin(), input.end(), output.begin());
+            benchmark::DoNotOptimize(output.data());
+        }
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * num_channels * num_frames * sizeof(file_sample_type)));
+}
+
+BENCHMARK(benchSwapThenConvert)->Unit(benchmark::kMillisecond);
+BENCHMARK(benchFusedConvert)->Unit(benchmark::kMillisecond);
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace ratl
+{
+using sample_type = sample<float32_t>;
+
+static constexpr std::size_t num_callbacks = 100000;
+static constexpr std::size_t num_channels = 8;
+static constexpr std::array<std::size_t, 6> callback_frames = {{32, 64, 128, 256, 480, 1024}};
+static constexpr std::size_t arena_capacity = 4 * 1024 * 1024;
+
+struct DefaultAllocator
+{
+    static ratl::allocator<sample_type> make(arena&)
+    {
+        return {};
+    }
+
+    static void reset(arena&) {}
+};
+
+struct StdAllocator
+{
+    static std::allocator<sample_type> make(arena&)
+    {
+        return {};
+    }
+
+    static void reset(arena&) {}
+};
+
+struct ArenaAllocator
+{
+    static arena_allocator<sample_type> make(arena& scratch)
+    {
+        return arena_allocator<sample_type>(scratch);
+    }
+
+    static void reset(arena&) {}
+};
+
+struct ArenaAllocatorWithReset
+{
+    static arena_allocator<sample_type> make(arena& scratch)
+    {
+        return arena_allocator<sample_type>(scratch);
+    }
+
+    static void reset(arena& scratch)
+    {
+        scratch.reset();
+    }
+};
+
+// Simulates an audio callback that allocates one scratch buffer of each size in callback_frames, and reports the
+// latency percentiles of the individual allocations
+template<typename AllocatorFactory>
+void benchAllocationLatency(benchmark::State& state)
+{
+    arena scratch(arena_capacity);
+    auto alloc = AllocatorFactory::make(scratch);
+    using alloc_traits = std::allocator_traits<decltype(alloc)>;
+
+    std::vector<double> latencies;
+    latencies.reserve(num_callbacks * callback_frames.size());
+    std::array<sample_type*, callback_frames.size()> buffers;
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < callback_frames.size(); ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            buffers[i] = alloc_traits::allocate(alloc, num_channels * callback_frames[i]);
+            auto end = std::chrono::steady_clock::now();
+            benchmark::DoNotOptimize(buffers[i]);
+            latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        for (std::size_t i = 0; i < callback_frames.size(); ++i)
+        {
+            alloc_traits::deallocate(alloc, buffers[i], num_channels * callback_frames[i]);
+        }
+        AllocatorFactory::reset(scratch);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p)
+    {
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p99.9_ns"] = percentile(0.999);
+    state.counters["max_ns"] = latencies.back();
+}
+
+BENCHMARK_TEMPLATE(benchAllocationLatency, DefaultAllocator)->Iterations(num_callbacks);
+BENCHMARK_TEMPLATE(benchAllocationLatency, StdAllocator)->Iterations(num_callbacks);
+BENCHMARK_TEMPLATE(benchAllocationLatency, ArenaAllocator)->Iterations(num_callbacks);
+BENCHMARK_TEMPLATE(benchAllocationLatency, ArenaAllocatorWithReset)->Iterations(num_callbacks);
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace ratl
+{
+static constexpr std::size_t num_channels = 64;
+static constexpr std::size_t num_frames = 48000 * 10;
+static constexpr std::size_t block_frames = 480;
+
+template<typename SampleType>
+struct DefaultAllocator
+{
+    static ratl::allocator<SampleType> make()
+    {
+        return {};
+    }
+};
+
+template<typename SampleType>
+struct HugePageAllocator
+{
+    static huge_page_allocator<SampleType> make()
+    {
+        return huge_page_allocator<SampleType>();
+    }
+};
+
+template<typename SampleType>
+struct RealtimeHugePageAllocator
+{
+    static huge_page_allocator<SampleType> make()
+    {
+        return huge_page_allocator<SampleType>(page_options::realtime());
+    }
+};
+
+// Time taken to construct a large capture buffer, including any page faults taken while zeroing it
+template<template<typename> class AllocatorFactory>
+void benchConstructLarge(benchmark::State& state)
+{
+    using output_sample_type = network_sample<int24_t>;
+    for (auto _ : state)
+    {
+        basic_noninterleaved<output_sample_type, decltype(AllocatorFactory<output_sample_type>::make())> output(
+            num_channels, num_frames, AllocatorFactory<output_sample_type>::make());
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * num_channels * num_frames * sizeof(output_sample_type)));
+}
+
+// Streams blocks of input into successive positions of a large capture buffer, reporting the throughput and the
+// latency percentiles of the individual blocks
+template<template<typename> class AllocatorFactory>
+void benchTransformLarge(benchmark::State& state)
+{
+    using input_type = interleaved<float32_t>;
+    using output_sample_type = network_sample<int24_t>;
+    using output_allocator = decltype(AllocatorFactory<output_sample_type>::make());
+
+    auto input = utils::generateRandomInput<input_type>(num_channels, block_frames);
+    basic_noninterleaved<output_sample_type, output_allocator> output(
+        num_channels, num_frames, AllocatorFactory<output_sample_type>::make());
+
+    std::vector<double> latencies;
+    latencies.reserve(num_frames / block_frames);
+    std::size_t frame_num = 0;
+    for (auto _ : state)
+    {
+        auto output_span = network_noninterleaved_span<int24_t>(
+            output.data() + frame_num, num_channels, block_frames, num_frames);
+        auto start = std::chrono::steady_clock::now();
+        transform(input.begin(), input.end(), output_span.begin());
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        frame_num = (frame_num + block_frames) % num_frames;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * num_channels * block_frames));
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p)
+    {
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p99.9_ns"] = percentile(0.999);
+    state.counters["max_ns"] = latencies.back();
+}
+
+BENCHMARK_TEMPLATE(benchConstructLarge, DefaultAllocator)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(benchConstructLarge, HugePageAllocator)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(benchTransformLarge, DefaultAllocator)->Iterations(num_frames / block_frames);
+BENCHMARK_TEMPLATE(benchTransformLarge, HugePageAllocator)->Iterations(num_frames / block_frames);
+BENCHMARK_TEMPLATE(benchTransformLarge, RealtimeHugePageAllocator)->Iterations(num_frames / block_frames);
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_bench_perf_counters_
+#define _ratl_bench_perf_counters_
+
+// ratl includes
+#include <ratl/ratl.hpp>
+
+// other includes
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if defined(RATL_CPP_PLATFORM_LINUX)
+#    include <cstring>
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace ratl
+{
+namespace utils
+{
+// Counts hardware events in the calling thread with perf_event_open, so that benchmarks can report why a conversion
+// takes the time it does, not only how long. Counters that can't be opened, e.g. in containers or with
+// perf_event_paranoid set too high, are left out, and when none can be opened the benchmark is labelled as such
+// instead of failing.
+// Model specific events, such as the uops dispatched to each execution port, can be counted by setting
+// RATL_PERF_RAW_EVENTS to comma separated name=config pairs, where config is the raw event code, e.g. on Skylake
+// RATL_PERF_RAW_EVENTS=port0=0x1a1,port1=0x2a1,port5=0x20a1,port6=0x40a1
+class perf_counters
+{
+public:
+    enum class event
+    {
+        cycles,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        branch_misses,
+        raw
+    };
+
+private:
+    struct counter
+    {
+        event event_;
+        std::string name_;
+        int fd_;
+        std::uint64_t value_;
+    };
+
+    std::vector<counter> counters_;
+
+#if defined(RATL_CPP_PLATFORM_LINUX)
+    void open(event counter_event, const std::string& name, std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        auto fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd >= 0)
+        {
+            counters_.push_back(counter{counter_event, name, fd, 0});
+        }
+    }
+
+    static std::uint64_t cache_miss_config(std::uint64_t cache)
+    {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    void open_raw_events()
+    {
+        auto raw_events = std::getenv("RATL_PERF_RAW_EVENTS");
+        if (raw_events == nullptr)
+        {
+            return;
+        }
+        std::string events = raw_events;
+        std::size_t start = 0;
+        while (start < events.size())
+        {
+            auto end = events.find(',', start);
+            if (end == std::string::npos)
+            {
+                end = events.size();
+            }
+            auto raw_event = events.substr(start, end - start);
+            auto equals = raw_event.find('=');
+            if (equals != std::string::npos)
+            {
+                auto config = std::strtoull(raw_event.c_str() + equals + 1, nullptr, 0);
+                open(event::raw, raw_event.substr(0, equals), PERF_TYPE_RAW, config);
+            }
+            start = end + 1;
+        }
+    }
+#endif
+
+public:
+    perf_counters()
+    {
+#if defined(RATL_CPP_PLATFORM_LINUX)
+        open(event::cycles, "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open(event::instructions, "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open(event::l1d_misses, "l1d_misses", PERF_TYPE_HW_CACHE, cache_miss_config(PERF_COUNT_HW_CACHE_L1D));
+        open(event::llc_misses, "llc_misses", PERF_TYPE_HW_CACHE, cache_miss_config(PERF_COUNT_HW_CACHE_LL));
+        open(event::branch_misses, "branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        open_raw_events();
+#endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    ~perf_counters()
+    {
+#if defined(RATL_CPP_PLATFORM_LINUX)
+        for (auto& counter : counters_)
+        {
+            ::close(counter.fd_);
+        }
+#endif
+    }
+
+    bool available() const noexcept
+    {
+        return !counters_.empty();
+    }
+
+    void start() noexcept
+    {
+#if defined(RATL_CPP_PLATFORM_LINUX)
+        for (auto& counter : counters_)
+        {
+            ::ioctl(counter.fd_, PERF_EVENT_IOC_RESET, 0);
+        }
+        for (auto& counter : counters_)
+        {
+            ::ioctl(counter.fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Reads the counters, scaling them up for the time they weren't counting if the PMU had to multiplex them
+    void stop() noexcept
+    {
+#if defined(RATL_CPP_PLATFORM_LINUX)
+        for (auto& counter : counters_)
+        {
+            ::ioctl(counter.fd_, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (auto& counter : counters_)
+        {
+            std::uint64_t values[3] = {};
+            counter.value_ = 0;
+            if (::read(counter.fd_, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)) && values[2] != 0)
+            {
+                counter.value_ = static_cast<std::uint64_t>(
+                    static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]));
+            }
+        }
+#endif
+    }
+
+    // Returns the count of an event, or a negative value if it isn't being counted
+    double value(event counter_event) const noexcept
+    {
+        for (auto& counter : counters_)
+        {
+            if (counter.event_ == counter_event)
+            {
+                return static_cast<double>(counter.value_);
+            }
+        }
+        return -1.0;
+    }
+
+    // Reports cycles per sample and instructions per cycle, misses per thousand samples and raw events per sample
+    void report(benchmark::State& state, std::size_t samples_per_iteration) const
+    {
+        if (!available())
+        {
+            state.SetLabel("perf counters unavailable");
+            return;
+        }
+        auto samples = static_cast<double>(state.iterations()) * static_cast<double>(samples_per_iteration);
+        auto cycles = value(event::cycles);
+        auto instructions = value(event::instructions);
+        if (cycles > 0.0)
+        {
+            state.counters["cycles_per_sample"] = cycles / samples;
+            if (instructions >= 0.0)
+            {
+                state.counters["ipc"] = instructions / cycles;
+            }
+        }
+        if (instructions >= 0.0)
+        {
+            state.counters["instructions_per_sample"] = instructions / samples;
+        }
+        for (auto& counter : counters_)
+        {
+            switch (counter.event_)
+            {
+            case event::l1d_misses:
+            case event::llc_misses:
+            case event::branch_misses:
+                state.counters[counter.name_ + "_per_k"] = 1000.0 * static_cast<double>(counter.value_) / samples;
+                break;
+            case event::raw:
+                state.counters[counter.name_ + "_per_sample"] = static_cast<double>(counter.value_) / samples;
+                break;
+            case event::cycles:
+            case event::instructions:
+                break;
+            }
+        }
+    }
+};
+} // namespace utils
+} // namespace ratl
+
+#endif // _ratl_bench_perf_counters_
@@ -5,6 +5,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+// ratl bench includes
+#include "bench_utils.hpp"
+
 // ratl includes
 #include <ratl/ratl.hpp>
 
@@ -94,6 +97,20 @@ static void benchReverseEndiannessTest(benchmark::State& state)
 }
 BENCHMARK(benchReverseEndiannessTest);
 
+static void benchReverseEndiannessInplace(benchmark::State& state)
+{
+    auto buffer = utils::generateRandomInput<interleaved<sample_type>>(2, 500);
+    for (auto _ : state)
+    {
+        // swaps the whole buffer to network byte order and back again
+        auto network = reverse_endianness_inplace(interleaved_span<sample_type>(buffer));
+        auto host = reverse_endianness_inplace(network);
+        benchmark::DoNotOptimize(host.data());
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(benchReverseEndiannessInplace);
+
 } // namespace ratl
 
 BENCHMARK_MAIN();
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <atomic>
+#include <thread>
+
+namespace ratl
+{
+static constexpr std::size_t num_channels = 8;
+static constexpr std::size_t num_frames = 64;
+static constexpr std::size_t ring_capacity = 1024;
+
+// Uncontended single thread write then read of one block through the ring buffer
+template<typename RingType, typename InputType, typename OutputType>
+void benchRingBufferSingleThread(benchmark::State& state)
+{
+    RingType ring(num_channels, ring_capacity);
+    auto input = utils::generateRandomInput<InputType>(num_channels, num_frames);
+    auto output = OutputType(num_channels, num_frames);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(transform(input.begin(), input.end(), ring));
+        benchmark::DoNotOptimize(transform(ring, output.begin(), output.end()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * num_frames * num_channels));
+}
+
+// Producer thread continuously writes blocks while the benchmark thread consumes them
+// The retries counter reports how often the consumer found the ring buffer empty, which gives an indication of how
+// much time is spent waiting on the other side rather than moving samples.
+template<typename RingType, typename InputType, typename OutputType>
+void benchRingBufferContended(benchmark::State& state)
+{
+    RingType ring(num_channels, ring_capacity);
+    auto input = utils::generateRandomInput<InputType>(num_channels, num_frames);
+    auto output = OutputType(num_channels, num_frames);
+
+    std::atomic<bool> running{true};
+    std::thread producer(
+        [&]()
+        {
+            while (running.load(std::memory_order_relaxed))
+            {
+                if (transform(input.begin(), input.end(), ring) == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    std::size_t frames_read = 0;
+    std::size_t retries = 0;
+    for (auto _ : state)
+    {
+        auto frames = transform(ring, output.begin(), output.end());
+        if (frames == 0)
+        {
+            ++retries;
+            std::this_thread::yield();
+        }
+        frames_read += frames;
+    }
+
+    running.store(false, std::memory_order_relaxed);
+    producer.join();
+
+    state.SetItemsProcessed(static_cast<int64_t>(frames_read * num_channels));
+    state.counters["retries"] = benchmark::Counter(static_cast<double>(retries), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_TEMPLATE(
+    benchRingBufferSingleThread,
+    interleaved_ring_buffer<float32_t>,
+    interleaved<float32_t>,
+    interleaved<float32_t>);
+BENCHMARK_TEMPLATE(
+    benchRingBufferSingleThread,
+    interleaved_ring_buffer<float32_t>,
+    noninterleaved<float32_t>,
+    noninterleaved<float32_t>);
+BENCHMARK_TEMPLATE(
+    benchRingBufferSingleThread,
+    noninterleaved_ring_buffer<float32_t>,
+    noninterleaved<float32_t>,
+    noninterleaved<float32_t>);
+BENCHMARK_TEMPLATE(
+    benchRingBufferSingleThread,
+    network_interleaved_ring_buffer<int24_t>,
+    interleaved<float32_t>,
+    interleaved<float32_t>);
+
+BENCHMARK_TEMPLATE(
+    benchRingBufferContended,
+    interleaved_ring_buffer<float32_t>,
+    interleaved<float32_t>,
+    interleaved<float32_t>);
+BENCHMARK_TEMPLATE(
+    benchRingBufferContended,
+    noninterleaved_ring_buffer<float32_t>,
+    noninterleaved<float32_t>,
+    noninterleaved<float32_t>);
+BENCHMARK_TEMPLATE(
+    benchRingBufferContended,
+    network_interleaved_ring_buffer<int24_t>,
+    interleaved<float32_t>,
+    interleaved<float32_t>);
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
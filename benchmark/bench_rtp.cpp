@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace ratl
+{
+static constexpr std::size_t num_channels = 8;
+static constexpr std::size_t sample_rate = 48000;
+
+// Packet storage, aligned for any payload sample type
+static std::vector<std::uint32_t> make_packet(std::size_t bytes)
+{
+    return std::vector<std::uint32_t>((bytes + 3) / 4);
+}
+
+// Converts a non-interleaved float period straight into RTP packets, reporting packets per second, for packet times
+// given in microseconds
+template<typename SampleValueType>
+static void benchPacketise(benchmark::State& state)
+{
+    auto frames = rtp_packet_frames(sample_rate, std::chrono::microseconds(state.range(0)));
+    auto input = utils::generateRandomInput<noninterleaved<float32_t>>(num_channels, frames);
+    rtp_packetiser<SampleValueType> packetiser(num_channels, frames, 97, 1);
+    auto packet = make_packet(packetiser.packet_bytes());
+    for (auto _ : state)
+    {
+        packetiser.write_packet(input, reinterpret_cast<unsigned char*>(packet.data()));
+        benchmark::DoNotOptimize(packet.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packetiser.packet_bytes()));
+}
+
+// Parses received RTP packets and converts their payloads into a non-interleaved float period
+template<typename SampleValueType>
+static void benchDepacketise(benchmark::State& state)
+{
+    auto frames = rtp_packet_frames(sample_rate, std::chrono::microseconds(state.range(0)));
+    auto input = utils::generateRandomInput<noninterleaved<float32_t>>(num_channels, frames);
+    rtp_packetiser<SampleValueType> packetiser(num_channels, frames, 97, 1);
+    rtp_depacketiser<SampleValueType> depacketiser(num_channels, 97);
+    auto packet = make_packet(packetiser.packet_bytes());
+    auto packet_bytes = packetiser.write_packet(input, reinterpret_cast<unsigned char*>(packet.data()));
+
+    noninterleaved<float32_t> output(num_channels, frames);
+    rtp_packet<SampleValueType> received;
+    for (auto _ : state)
+    {
+        if (depacketiser.read_packet(packet.data(), packet_bytes, received))
+        {
+            transform(received.payload.begin(), received.payload.end(), output.begin());
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packet_bytes));
+}
+
+BENCHMARK_TEMPLATE(benchPacketise, int16_t)->Arg(1000)->Arg(125);
+BENCHMARK_TEMPLATE(benchPacketise, int24_t)->Arg(1000)->Arg(125);
+BENCHMARK_TEMPLATE(benchDepacketise, int16_t)->Arg(1000)->Arg(125);
+BENCHMARK_TEMPLATE(benchDepacketise, int24_t)->Arg(1000)->Arg(125);
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
@@ -0,0 +1,270 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ratl
+{
+static constexpr std::size_t num_channels = 8;
+static constexpr std::size_t ring_periods = 8;
+
+using ring_sample_value_type = int32_t;
+
+static std::string bench_ring_name(const char* name)
+{
+    return std::string("/ratl_bench_") + name + "_" + std::to_string(::getpid());
+}
+
+static void report_latencies(benchmark::State& state, std::vector<double>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p)
+    {
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p99.9_ns"] = percentile(0.999);
+    state.counters["max_ns"] = latencies.back();
+}
+
+static void set_bytes_processed(benchmark::State& state, std::size_t period)
+{
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * num_channels * period * sizeof(sample<ring_sample_value_type>)));
+}
+
+// Sends whole buffers over a stream socket, as the processes did before shm_ring
+static bool send_all(int fd, const void* data, std::size_t size)
+{
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        auto sent = ::send(fd, bytes, size, 0);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+static bool recv_all(int fd, void* data, std::size_t size)
+{
+    auto bytes = static_cast<char*>(data);
+    while (size > 0)
+    {
+        auto received = ::recv(fd, bytes, size, 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+// Streams periods of 8 channels to a reader process, which converts each period to float straight out of the ring
+static void benchShmRingThroughput(benchmark::State& state)
+{
+    auto period = static_cast<std::size_t>(state.range(0));
+    auto name = bench_ring_name("shm_ring_throughput");
+    std::unique_ptr<shm_ring_writer<ring_sample_value_type>> writer(
+        new shm_ring_writer<ring_sample_value_type>(name, num_channels, ring_periods * period));
+
+    auto child = ::fork();
+    if (child == 0)
+    {
+        {
+            shm_ring_reader<ring_sample_value_type> reader(name);
+            interleaved<float32_t> output(num_channels, period);
+            while (reader.wait_read(period, std::chrono::seconds(10)))
+            {
+                transform(reader, output.begin(), output.end());
+            }
+        }
+        ::_exit(0);
+    }
+    while (writer->readers() == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    auto input = utils::generateRandomInput<interleaved<float32_t>>(num_channels, period);
+    for (auto _ : state)
+    {
+        writer->wait_write(period, std::chrono::seconds(10));
+        transform(input.begin(), input.end(), *writer);
+    }
+    writer.reset();
+    ::waitpid(child, nullptr, 0);
+    set_bytes_processed(state, period);
+}
+
+// Streams the same periods through a Unix domain socket, converting on both sides of the copy
+static void benchUnixSocketThroughput(benchmark::State& state)
+{
+    auto period = static_cast<std::size_t>(state.range(0));
+    int sockets[2];
+    ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+
+    auto child = ::fork();
+    if (child == 0)
+    {
+        ::close(sockets[0]);
+        interleaved<ring_sample_value_type> received(num_channels, period);
+        interleaved<float32_t> output(num_channels, period);
+        while (recv_all(sockets[1], received.data(), received.samples() * sizeof(sample<ring_sample_value_type>)))
+        {
+            transform(received.begin(), received.end(), output.begin());
+        }
+        ::_exit(0);
+    }
+    ::close(sockets[1]);
+
+    auto input = utils::generateRandomInput<interleaved<float32_t>>(num_channels, period);
+    interleaved<ring_sample_value_type> converted(num_channels, period);
+    for (auto _ : state)
+    {
+        transform(input.begin(), input.end(), converted.begin());
+        send_all(sockets[0], converted.data(), converted.samples() * sizeof(sample<ring_sample_value_type>));
+    }
+    ::close(sockets[0]);
+    ::waitpid(child, nullptr, 0);
+    set_bytes_processed(state, period);
+}
+
+// Round trips a period to another process and back through a pair of rings, reporting latency percentiles
+static void benchShmRingLatency(benchmark::State& state)
+{
+    auto period = static_cast<std::size_t>(state.range(0));
+    auto ping_name = bench_ring_name("shm_ring_ping");
+    auto pong_name = bench_ring_name("shm_ring_pong");
+    std::unique_ptr<shm_ring_writer<ring_sample_value_type>> ping(
+        new shm_ring_writer<ring_sample_value_type>(ping_name, num_channels, ring_periods * period));
+
+    auto child = ::fork();
+    if (child == 0)
+    {
+        {
+            shm_ring_writer<ring_sample_value_type> pong(pong_name, num_channels, ring_periods * period);
+            shm_ring_reader<ring_sample_value_type> reader(ping_name);
+            while (reader.wait_read(period, std::chrono::seconds(10)))
+            {
+                auto region = reader.read_region(period);
+                auto first = region.first();
+                auto second = region.second();
+                transform(first.begin(), first.end(), pong);
+                transform(second.begin(), second.end(), pong);
+                reader.commit_read(region.frames());
+            }
+        }
+        ::_exit(0);
+    }
+
+    std::unique_ptr<shm_ring_reader<ring_sample_value_type>> pong;
+    while (!pong)
+    {
+        try
+        {
+            pong.reset(new shm_ring_reader<ring_sample_value_type>(pong_name));
+        }
+        catch (const std::exception&)
+        {
+            std::this_thread::yield();
+        }
+    }
+    while (ping->readers() == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    auto input = utils::generateRandomInput<interleaved<float32_t>>(num_channels, period);
+    interleaved<float32_t> output(num_channels, period);
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+    for (auto _ : state)
+    {
+        auto start = std::chrono::steady_clock::now();
+        transform(input.begin(), input.end(), *ping);
+        pong->wait_read(period, std::chrono::seconds(10));
+        transform(*pong, output.begin(), output.end());
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    ping.reset();
+    ::waitpid(child, nullptr, 0);
+    set_bytes_processed(state, period);
+    report_latencies(state, latencies);
+}
+
+// Round trips the same periods through a Unix domain socket pair
+static void benchUnixSocketLatency(benchmark::State& state)
+{
+    auto period = static_cast<std::size_t>(state.range(0));
+    auto bytes = num_channels * period * sizeof(sample<ring_sample_value_type>);
+    int sockets[2];
+    ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+
+    auto child = ::fork();
+    if (child == 0)
+    {
+        ::close(sockets[0]);
+        std::vector<char> buffer(bytes);
+        while (recv_all(sockets[1], buffer.data(), bytes) && send_all(sockets[1], buffer.data(), bytes))
+        {
+        }
+        ::_exit(0);
+    }
+    ::close(sockets[1]);
+
+    auto input = utils::generateRandomInput<interleaved<float32_t>>(num_channels, period);
+    interleaved<ring_sample_value_type> converted(num_channels, period);
+    interleaved<float32_t> output(num_channels, period);
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+    for (auto _ : state)
+    {
+        auto start = std::chrono::steady_clock::now();
+        transform(input.begin(), input.end(), converted.begin());
+        send_all(sockets[0], converted.data(), bytes);
+        recv_all(sockets[0], converted.data(), bytes);
+        transform(converted.begin(), converted.end(), output.begin());
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    ::close(sockets[0]);
+    ::waitpid(child, nullptr, 0);
+    set_bytes_processed(state, period);
+    report_latencies(state, latencies);
+}
+
+BENCHMARK(benchShmRingThroughput)->Arg(64)->Arg(256)->Arg(1024);
+BENCHMARK(benchUnixSocketThroughput)->Arg(64)->Arg(256)->Arg(1024);
+BENCHMARK(benchShmRingLatency)->Arg(64)->Arg(256)->Iterations(20000);
+BENCHMARK(benchUnixSocketLatency)->Arg(64)->Arg(256)->Iterations(20000);
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+namespace ratl
+{
+// Compares interleaved <-> noninterleaved transforms through static and dynamic extent interleaved spans, for each
+// transform tier, so that the frame by frame static extent kernel can be checked against the channel by channel
+// dynamic extent path
+static constexpr std::size_t num_frames = 480;
+
+template<typename InputSampleType, typename OutputSampleType>
+static void set_processed(benchmark::State& state, std::size_t samples)
+{
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * samples));
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * samples * (sizeof(InputSampleType) + sizeof(OutputSampleType))));
+}
+
+template<
+    utils::transform_tier Tier,
+    typename InputSampleType,
+    typename OutputSampleType,
+    std::size_t Channels,
+    std::size_t Extent>
+void benchDeinterleave(benchmark::State& state)
+{
+    using input_span = basic_interleaved_span<
+        const InputSampleType,
+        detail::const_sample_traits_t<detail::sample_traits<InputSampleType>>,
+        Extent>;
+
+    auto input = utils::random_samples<InputSampleType>(Channels * num_frames);
+    auto output = basic_noninterleaved<OutputSampleType>(Channels, num_frames);
+    auto span = input_span(input.data(), Channels, num_frames);
+    for (auto _ : state)
+    {
+        utils::tier_transformer<Tier>::apply(span.begin(), span.end(), output.begin());
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed<InputSampleType, OutputSampleType>(state, Channels * num_frames);
+}
+
+template<
+    utils::transform_tier Tier,
+    typename InputSampleType,
+    typename OutputSampleType,
+    std::size_t Channels,
+    std::size_t Extent>
+void benchInterleave(benchmark::State& state)
+{
+    using output_span = basic_interleaved_span<OutputSampleType, detail::sample_traits<OutputSampleType>, Extent>;
+
+    auto input = utils::generateRandomInput<basic_noninterleaved<InputSampleType>>(Channels, num_frames);
+    auto output = utils::aligned_samples<OutputSampleType>(Channels * num_frames);
+    auto span = output_span(output.data(), Channels, num_frames);
+    for (auto _ : state)
+    {
+        utils::tier_transformer<Tier>::apply(input.begin(), input.end(), span.begin());
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed<InputSampleType, OutputSampleType>(state, Channels * num_frames);
+}
+
+#define RATL_BENCH_STATIC_EXTENT(bench, input, output, channels)                                                       \
+    BENCHMARK_TEMPLATE(bench, utils::transform_tier::reference, input, output, channels, dynamic_extent);              \
+    BENCHMARK_TEMPLATE(bench, utils::transform_tier::reference, input, output, channels, channels);                    \
+    BENCHMARK_TEMPLATE(bench, utils::transform_tier::fast, input, output, channels, dynamic_extent);                   \
+    BENCHMARK_TEMPLATE(bench, utils::transform_tier::fast, input, output, channels, channels);                         \
+    BENCHMARK_TEMPLATE(bench, utils::transform_tier::standard, input, output, channels, dynamic_extent);               \
+    BENCHMARK_TEMPLATE(bench, utils::transform_tier::standard, input, output, channels, channels)
+
+RATL_BENCH_STATIC_EXTENT(benchDeinterleave, sample<int16_t>, sample<float32_t>, 2);
+RATL_BENCH_STATIC_EXTENT(benchDeinterleave, sample<int16_t>, sample<float32_t>, 8);
+RATL_BENCH_STATIC_EXTENT(benchDeinterleave, sample<float32_t>, sample<float32_t>, 2);
+RATL_BENCH_STATIC_EXTENT(benchDeinterleave, network_sample<int24_t>, sample<float32_t>, 2);
+RATL_BENCH_STATIC_EXTENT(benchInterleave, sample<float32_t>, sample<int16_t>, 2);
+RATL_BENCH_STATIC_EXTENT(benchInterleave, sample<float32_t>, sample<int16_t>, 8);
+RATL_BENCH_STATIC_EXTENT(benchInterleave, sample<float32_t>, sample<float32_t>, 2);
+RATL_BENCH_STATIC_EXTENT(benchInterleave, sample<float32_t>, network_sample<int24_t>, 2);
+
+#undef RATL_BENCH_STATIC_EXTENT
+
+} // namespace ratl
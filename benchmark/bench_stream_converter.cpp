@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ratl
+{
+static constexpr std::size_t num_channels = 16;
+static constexpr std::size_t max_block_frames = 65536;
+static constexpr std::size_t num_frames = max_block_frames * 44;
+
+using input_sample_value_type = int24_t;
+using output_sample_value_type = float32_t;
+
+static std::string bench_path(const char* name)
+{
+    auto* tmp_dir = std::getenv("TMPDIR");
+    return std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") + "/ratl_bench_stream_converter_" + name;
+}
+
+// About a minute of 16 channel 24 bit audio at 48kHz (138MB), which is converted to a float file of 184MB
+class BenchFiles
+{
+private:
+    std::string input_path_ = bench_path("input.raw");
+    std::string output_path_ = bench_path("output.raw");
+    int input_fd_ = -1;
+    int output_fd_ = -1;
+
+public:
+    BenchFiles()
+    {
+        input_fd_ = ::open(input_path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        output_fd_ = ::open(output_path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        static constexpr std::size_t chunk_frames = max_block_frames;
+        auto chunk = utils::generateRandomInput<interleaved<input_sample_value_type>>(num_channels, chunk_frames);
+        auto chunk_bytes = chunk.samples() * sizeof(sample<input_sample_value_type>);
+        for (std::size_t chunk_num = 0; chunk_num < num_frames / chunk_frames; ++chunk_num)
+        {
+            if (::pwrite(input_fd_, chunk.data(), chunk_bytes, static_cast<off_t>(chunk_num * chunk_bytes)) < 0)
+            {
+                break;
+            }
+        }
+    }
+
+    BenchFiles(const BenchFiles&) = delete;
+    BenchFiles& operator=(const BenchFiles&) = delete;
+
+    ~BenchFiles()
+    {
+        ::close(input_fd_);
+        ::close(output_fd_);
+        ::unlink(input_path_.c_str());
+        ::unlink(output_path_.c_str());
+    }
+
+    int input_fd() const noexcept
+    {
+        return input_fd_;
+    }
+
+    int output_fd() const noexcept
+    {
+        return output_fd_;
+    }
+};
+
+static void set_bytes_processed(benchmark::State& state)
+{
+    state.SetBytesProcessed(static_cast<int64_t>(
+        state.iterations() * num_frames * num_channels *
+        (sizeof(sample<input_sample_value_type>) + sizeof(sample<output_sample_value_type>))));
+}
+
+// Reads, converts and writes each block in turn on one thread, as the conversion jobs did before stream_converter
+static void benchSynchronous(benchmark::State& state)
+{
+    BenchFiles files;
+    auto block_frames = static_cast<std::size_t>(state.range(0));
+    interleaved<input_sample_value_type> input(num_channels, block_frames);
+    interleaved<output_sample_value_type> output(num_channels, block_frames);
+    auto input_block_bytes = input.samples() * sizeof(sample<input_sample_value_type>);
+    auto output_block_bytes = output.samples() * sizeof(sample<output_sample_value_type>);
+
+    auto start_cpu = detail::process_cpu_seconds();
+    auto start = std::chrono::steady_clock::now();
+    for (auto _ : state)
+    {
+        for (std::size_t block_num = 0; block_num < num_frames / block_frames; ++block_num)
+        {
+            if (::pread(files.input_fd(), input.data(), input_block_bytes,
+                        static_cast<off_t>(block_num * input_block_bytes)) < 0)
+            {
+                state.SkipWithError("pread failed");
+                return;
+            }
+            transform(input.begin(), input.end(), output.begin());
+            if (::pwrite(files.output_fd(), output.data(), output_block_bytes,
+                         static_cast<off_t>(block_num * output_block_bytes)) < 0)
+            {
+                state.SkipWithError("pwrite failed");
+                return;
+            }
+        }
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    state.counters["cpu_utilisation"] = (detail::process_cpu_seconds() - start_cpu) / seconds;
+    set_bytes_processed(state);
+}
+
+template<stream_io_backend Backend>
+static void benchStreamConverter(benchmark::State& state)
+{
+    BenchFiles files;
+    stream_converter_options options;
+    options.block_frames = static_cast<std::size_t>(state.range(0));
+    options.backend = Backend;
+    std::unique_ptr<stream_converter<input_sample_value_type, output_sample_value_type>> converter;
+    try
+    {
+        converter.reset(new stream_converter<input_sample_value_type, output_sample_value_type>(num_channels, options));
+    }
+    catch (const std::exception& exception)
+    {
+        state.SkipWithError(exception.what());
+        return;
+    }
+
+    double seconds = 0.0;
+    double cpu_seconds = 0.0;
+    for (auto _ : state)
+    {
+        auto stats = converter->convert(files.input_fd(), 0, files.output_fd(), 0, num_frames);
+        seconds += stats.seconds;
+        cpu_seconds += stats.cpu_seconds;
+    }
+    state.counters["cpu_utilisation"] = cpu_seconds / seconds;
+    set_bytes_processed(state);
+}
+
+BENCHMARK(benchSynchronous)->Arg(4096)->Arg(16384)->Arg(65536)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(benchStreamConverter, stream_io_backend::io_uring)
+    ->Arg(4096)
+    ->Arg(16384)
+    ->Arg(65536)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(benchStreamConverter, stream_io_backend::threads)
+    ->Arg(4096)
+    ->Arg(16384)
+    ->Arg(65536)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
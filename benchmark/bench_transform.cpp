@@ -8,8 +8,23 @@
 // ratl bench includes
 #include "bench_utils.hpp"
 
+// other includes
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace ratl
 {
+// Reports the samples converted, and the bytes read and written, so results compare directly in samples/s and GB/s
+template<typename InputSampleType, typename OutputSampleType>
+static void set_processed(benchmark::State& state, std::size_t samples)
+{
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * samples));
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * samples * (sizeof(InputSampleType) + sizeof(OutputSampleType))));
+}
+
 template<typename InputSampleType, typename OutputSampleType>
 void benchTransform(benchmark::State& state)
 {
@@ -26,6 +41,7 @@ void benchTransform(benchmark::State& state)
     {
         reference_transform(input.begin(), input.end(), output.begin(), dither_gen);
     }
+    set_processed<InputSampleType, OutputSampleType>(state, num_channels * num_frames);
 }
 
 BENCHMARK_TEMPLATE(benchTransform, sample<int16_t>, sample<int16_t>);
@@ -76,6 +92,201 @@ BENCHMARK_TEMPLATE(benchTransform, network_sample<float32_t>, sample<int16_t>);
 BENCHMARK_TEMPLATE(benchTransform, network_sample<float32_t>, sample<int24_t>);
 BENCHMARK_TEMPLATE(benchTransform, network_sample<float32_t>, sample<int32_t>);
 BENCHMARK_TEMPLATE(benchTransform, network_sample<float32_t>, sample<float32_t>);
+BENCHMARK_TEMPLATE(benchTransform, network_sample<int16_t>, network_sample<int24_t>);
+BENCHMARK_TEMPLATE(benchTransform, network_sample<int24_t>, network_sample<int16_t>);
+BENCHMARK_TEMPLATE(benchTransform, network_sample<int24_t>, network_sample<int32_t>);
+BENCHMARK_TEMPLATE(benchTransform, network_sample<int32_t>, network_sample<int24_t>);
+
+// Undithered fast transforms, which use the fused network conversions where they are available
+template<typename InputSampleType, typename OutputSampleType>
+void benchFastTransform(benchmark::State& state)
+{
+    using input_type = basic_interleaved<InputSampleType>;
+    using output_type = basic_noninterleaved<OutputSampleType>;
+
+    static constexpr std::size_t num_channels = 32;
+    static constexpr std::size_t num_frames = 480;
+
+    auto input = utils::generateRandomInput<input_type>(num_channels, num_frames);
+    auto output = output_type(num_channels, num_frames);
+    for (auto _ : state)
+    {
+        fast_transform(input.begin(), input.end(), output.begin());
+    }
+    set_processed<InputSampleType, OutputSampleType>(state, num_channels * num_frames);
+}
+
+BENCHMARK_TEMPLATE(benchFastTransform, sample<int24_t>, sample<float32_t>);
+BENCHMARK_TEMPLATE(benchFastTransform, sample<float32_t>, sample<int24_t>);
+BENCHMARK_TEMPLATE(benchFastTransform, sample<float32_t>, network_sample<int24_t>);
+BENCHMARK_TEMPLATE(benchFastTransform, network_sample<int24_t>, sample<int32_t>);
+BENCHMARK_TEMPLATE(benchFastTransform, network_sample<int24_t>, sample<float32_t>);
+BENCHMARK_TEMPLATE(benchFastTransform, network_sample<int16_t>, network_sample<int24_t>);
+BENCHMARK_TEMPLATE(benchFastTransform, network_sample<int24_t>, network_sample<int16_t>);
+BENCHMARK_TEMPLATE(benchFastTransform, network_sample<int24_t>, network_sample<int32_t>);
+BENCHMARK_TEMPLATE(benchFastTransform, network_sample<int32_t>, network_sample<int24_t>);
+
+using utils::aligned_samples;
+using utils::interleaved_layout;
+using utils::noninterleaved_layout;
+using utils::random_samples;
+using utils::tier_transformer;
+using utils::transform_tier;
+
+// Transforms channels x frames samples between two layouts. The output can have extra channels or frames, which the
+// transform has to step over (mismatched layouts can't be blitted), and both buffers can be offset from their
+// allocation by a number of samples so that neither is aligned for SIMD loads and stores.
+// Arguments are channels, frames, extra output channels, extra output frames and the offset in samples.
+template<
+    transform_tier Tier,
+    typename InputLayout,
+    typename OutputLayout,
+    typename InputSampleType,
+    typename OutputSampleType,
+    bool Dither>
+void benchTransformMatrix(benchmark::State& state)
+{
+    auto channels = static_cast<std::size_t>(state.range(0));
+    auto frames = static_cast<std::size_t>(state.range(1));
+    auto output_channels = channels + static_cast<std::size_t>(state.range(2));
+    auto output_frames = frames + static_cast<std::size_t>(state.range(3));
+    auto offset = static_cast<std::size_t>(state.range(4));
+
+    auto input_samples = random_samples<InputSampleType>(offset + (channels * frames));
+    aligned_samples<OutputSampleType> output_samples(offset + (output_channels * output_frames));
+    auto input = typename InputLayout::template const_span<InputSampleType>(
+        input_samples.data() + offset, channels, frames);
+    auto output = typename OutputLayout::template span<OutputSampleType>(
+        output_samples.data() + offset, output_channels, output_frames);
+    dither_generator dither_gen;
+    for (auto _ : state)
+    {
+        if (Dither)
+        {
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin(), dither_gen);
+        }
+        else
+        {
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin());
+        }
+        benchmark::ClobberMemory();
+    }
+    set_processed<InputSampleType, OutputSampleType>(state, channels * frames);
+}
+
+static void matrix_args(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"channels", "frames", "extra_channels", "extra_frames", "offset"});
+    benchmark->Args({32, 480, 0, 0, 0});
+    benchmark->Args({32, 480, 0, 0, 1});
+}
+
+static void mismatched_channels_args(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"channels", "frames", "extra_channels", "extra_frames", "offset"});
+    benchmark->Args({32, 480, 2, 0, 0});
+    benchmark->Args({32, 480, 2, 0, 1});
+}
+
+static void mismatched_frames_args(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"channels", "frames", "extra_channels", "extra_frames", "offset"});
+    benchmark->Args({32, 480, 0, 16, 0});
+    benchmark->Args({32, 480, 0, 16, 1});
+}
+
+// Every layout pair, aligned and misaligned, for one tier and pair of sample types
+#define RATL_BENCH_TRANSFORM_MATRIX(tier, input_sample, output_sample, dither)                                         \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformMatrix, tier, interleaved_layout, interleaved_layout, input_sample, output_sample, dither)       \
+        ->Apply(matrix_args);                                                                                          \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformMatrix, tier, noninterleaved_layout, noninterleaved_layout, input_sample, output_sample, dither) \
+        ->Apply(matrix_args);                                                                                          \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformMatrix, tier, interleaved_layout, noninterleaved_layout, input_sample, output_sample, dither)    \
+        ->Apply(matrix_args);                                                                                          \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformMatrix, tier, noninterleaved_layout, interleaved_layout, input_sample, output_sample, dither)    \
+        ->Apply(matrix_args);                                                                                          \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformMatrix, tier, interleaved_layout, interleaved_layout, input_sample, output_sample, dither)       \
+        ->Apply(mismatched_channels_args);                                                                             \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformMatrix, tier, noninterleaved_layout, noninterleaved_layout, input_sample, output_sample, dither) \
+        ->Apply(mismatched_frames_args)
+
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::reference, sample<int16_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::fast, sample<int16_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::standard, sample<int16_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::reference, sample<float32_t>, sample<int16_t>, false);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::fast, sample<float32_t>, sample<int16_t>, false);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::standard, sample<float32_t>, sample<int16_t>, false);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::reference, sample<float32_t>, sample<int16_t>, true);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::fast, sample<float32_t>, sample<int16_t>, true);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::standard, sample<float32_t>, sample<int16_t>, true);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::reference, network_sample<int24_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::fast, network_sample<int24_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_MATRIX(transform_tier::standard, network_sample<int24_t>, sample<float32_t>, false);
+
+#undef RATL_BENCH_TRANSFORM_MATRIX
+
+// Sweeps the shape of an interleaved to non-interleaved transform, from a single channel to many and from a few
+// frames to many
+BENCHMARK_TEMPLATE(
+    benchTransformMatrix,
+    transform_tier::standard,
+    interleaved_layout,
+    noninterleaved_layout,
+    sample<int24_t>,
+    sample<float32_t>,
+    false)
+    ->ArgNames({"channels", "frames", "extra_channels", "extra_frames", "offset"})
+    ->ArgsProduct({{1, 2, 8, 32, 64}, {32, 480, 4096}, {0}, {0}, {0}});
+
+// Transforms each channel in turn through its sample iterators, which step over the other channels of an interleaved
+// input and are contiguous for a non-interleaved one
+template<transform_tier Tier, bool Strided, typename InputSampleType, typename OutputSampleType>
+void benchTransformChannels(benchmark::State& state)
+{
+    using input_type =
+        std::conditional_t<Strided, basic_interleaved<InputSampleType>, basic_noninterleaved<InputSampleType>>;
+    using output_type = basic_noninterleaved<OutputSampleType>;
+
+    auto channels = static_cast<std::size_t>(state.range(0));
+    auto frames = static_cast<std::size_t>(state.range(1));
+    auto input = utils::generateRandomInput<input_type>(channels, frames);
+    auto output = output_type(channels, frames);
+    for (auto _ : state)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            auto input_channel = input.channel(channel_num);
+            auto output_channel = output.channel(channel_num);
+            tier_transformer<Tier>::apply(input_channel.begin(), input_channel.end(), output_channel.begin());
+        }
+        benchmark::ClobberMemory();
+    }
+    set_processed<InputSampleType, OutputSampleType>(state, channels * frames);
+}
+
+static void channels_args(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"channels", "frames"})->Args({2, 480})->Args({32, 480});
+}
+
+BENCHMARK_TEMPLATE(benchTransformChannels, transform_tier::reference, false, sample<int16_t>, sample<float32_t>)
+    ->Apply(channels_args);
+BENCHMARK_TEMPLATE(benchTransformChannels, transform_tier::reference, true, sample<int16_t>, sample<float32_t>)
+    ->Apply(channels_args);
+BENCHMARK_TEMPLATE(benchTransformChannels, transform_tier::fast, false, sample<int16_t>, sample<float32_t>)
+    ->Apply(channels_args);
+BENCHMARK_TEMPLATE(benchTransformChannels, transform_tier::fast, true, sample<int16_t>, sample<float32_t>)
+    ->Apply(channels_args);
+BENCHMARK_TEMPLATE(benchTransformChannels, transform_tier::standard, false, sample<int16_t>, sample<float32_t>)
+    ->Apply(channels_args);
+BENCHMARK_TEMPLATE(benchTransformChannels, transform_tier::standard, true, sample<int16_t>, sample<float32_t>)
+    ->Apply(channels_args);
 
 } // namespace ratl
 
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_perf_counters.hpp"
+#include "bench_utils.hpp"
+
+// Transforms with hardware performance counters, reporting cycles per sample, instructions per cycle, cache and
+// branch misses, so that a slow conversion can be put down to memory, dispatch or arithmetic
+
+namespace ratl
+{
+using utils::aligned_samples;
+using utils::interleaved_layout;
+using utils::noninterleaved_layout;
+using utils::random_samples;
+using utils::tier_transformer;
+using utils::transform_tier;
+
+template<
+    transform_tier Tier,
+    typename InputLayout,
+    typename OutputLayout,
+    typename InputSampleType,
+    typename OutputSampleType,
+    bool Dither>
+void benchTransformCounters(benchmark::State& state)
+{
+    auto channels = static_cast<std::size_t>(state.range(0));
+    auto frames = static_cast<std::size_t>(state.range(1));
+
+    auto input_samples = random_samples<InputSampleType>(channels * frames);
+    aligned_samples<OutputSampleType> output_samples(channels * frames);
+    auto input = typename InputLayout::template const_span<InputSampleType>(input_samples.data(), channels, frames);
+    auto output = typename OutputLayout::template span<OutputSampleType>(output_samples.data(), channels, frames);
+    dither_generator dither_gen;
+    utils::perf_counters counters;
+    counters.start();
+    for (auto _ : state)
+    {
+        if (Dither)
+        {
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin(), dither_gen);
+        }
+        else
+        {
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin());
+        }
+        benchmark::ClobberMemory();
+    }
+    counters.stop();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * channels * frames));
+    counters.report(state, channels * frames);
+}
+
+// A period that stays in L1 and L2, and one that spills out of L2
+static void counters_args(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"channels", "frames"});
+    benchmark->Args({32, 480});
+    benchmark->Args({64, 8192});
+}
+
+// Every layout pair for one tier and pair of sample types
+#define RATL_BENCH_TRANSFORM_COUNTERS(tier, input_sample, output_sample, dither)                                       \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformCounters, tier, interleaved_layout, interleaved_layout, input_sample, output_sample, dither)     \
+        ->Apply(counters_args);                                                                                        \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformCounters, tier, interleaved_layout, noninterleaved_layout, input_sample, output_sample, dither)  \
+        ->Apply(counters_args);                                                                                        \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformCounters, tier, noninterleaved_layout, interleaved_layout, input_sample, output_sample, dither)  \
+        ->Apply(counters_args);                                                                                        \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformCounters,                                                                                        \
+        tier,                                                                                                          \
+        noninterleaved_layout,                                                                                         \
+        noninterleaved_layout,                                                                                         \
+        input_sample,                                                                                                  \
+        output_sample,                                                                                                 \
+        dither)                                                                                                        \
+        ->Apply(counters_args)
+
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, sample<int16_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, sample<int24_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, sample<int32_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, sample<float32_t>, sample<int16_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, sample<float32_t>, sample<int16_t>, true);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, sample<float32_t>, sample<int24_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, sample<float32_t>, sample<int32_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, network_sample<int24_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, sample<float32_t>, network_sample<int24_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::standard, network_sample<int24_t>, network_sample<int16_t>, false);
+
+// The reference tier shows how much of the standard tier's time its dispatch and SIMD conversions save
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::reference, sample<int16_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::reference, sample<float32_t>, sample<int16_t>, false);
+RATL_BENCH_TRANSFORM_COUNTERS(transform_tier::reference, sample<float32_t>, sample<int16_t>, true);
+
+#undef RATL_BENCH_TRANSFORM_COUNTERS
+
+} // namespace ratl
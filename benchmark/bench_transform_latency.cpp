@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Times single transforms of audio callback sized buffers, reporting the distribution of the time each call takes
+// rather than only the mean, so that regressions in per-call overhead (dispatch, alignment checks, tail handling and
+// dither generator construction) show up even when they hardly move throughput.
+
+namespace ratl
+{
+using utils::aligned_samples;
+using utils::interleaved_layout;
+using utils::noninterleaved_layout;
+using utils::random_samples;
+using utils::tier_transformer;
+using utils::transform_tier;
+
+// Enough calls for a meaningful 99.9th percentile without storing millions of timings
+static constexpr int64_t latency_iterations = 100000;
+
+// Cold calls rotate through enough buffers to overflow the last level cache
+static constexpr std::size_t cold_cache_bytes = 64 * 1024 * 1024;
+
+enum class cache_state
+{
+    // Every call converts the same buffers, which stay in L1
+    warm,
+    // Every call converts buffers that were last touched long enough ago to have been evicted
+    cold
+};
+
+enum class dither_mode
+{
+    // No dither, so each call constructs a null dither generator
+    none,
+    // One dither generator kept across calls, as a callback would keep it
+    kept,
+    // A dither generator constructed for each call
+    per_call
+};
+
+// The least time between two reads of the clock, which every timing below includes
+static double clock_overhead_ns()
+{
+    auto overhead = std::chrono::steady_clock::duration::max();
+    for (auto read_num = 0; read_num < 1000; ++read_num)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto end = std::chrono::steady_clock::now();
+        overhead = std::min(overhead, end - start);
+    }
+    return std::chrono::duration<double, std::nano>(overhead).count();
+}
+
+static void report_latencies(benchmark::State& state, std::vector<double>& latencies)
+{
+    static const auto clock_ns = clock_overhead_ns();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p)
+    {
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+    state.counters["min_ns"] = latencies.front();
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p90_ns"] = percentile(0.9);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p99.9_ns"] = percentile(0.999);
+    state.counters["max_ns"] = latencies.back();
+    state.counters["clock_ns"] = clock_ns;
+}
+
+// Buffers start a whole number of cache lines apart, whatever the sample size
+static std::size_t buffer_stride(std::size_t samples)
+{
+    return (samples + 63) / 64 * 64;
+}
+
+template<
+    transform_tier Tier,
+    cache_state Cache,
+    typename InputLayout,
+    typename OutputLayout,
+    typename InputSampleType,
+    typename OutputSampleType,
+    dither_mode Dither>
+void benchTransformLatency(benchmark::State& state)
+{
+    auto channels = static_cast<std::size_t>(state.range(0));
+    auto frames = static_cast<std::size_t>(state.range(1));
+    auto stride = buffer_stride(channels * frames);
+    auto buffer_bytes = stride * (sizeof(InputSampleType) + sizeof(OutputSampleType));
+    auto buffers =
+        Cache == cache_state::warm ? std::size_t(1) : std::max(cold_cache_bytes / buffer_bytes, std::size_t(1));
+
+    auto input_samples = random_samples<InputSampleType>(buffers * stride);
+    aligned_samples<OutputSampleType> output_samples(buffers * stride);
+
+    // Cold buffers are visited in a random order, so that the prefetchers can't bring the next one in ahead of its call
+    std::vector<std::size_t> order(buffers);
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::shuffle(order.begin(), order.end(), std::default_random_engine(42));
+
+    dither_generator dither_gen;
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+    std::size_t call_num = 0;
+    for (auto _ : state)
+    {
+        auto offset = order[call_num++ % buffers] * stride;
+        auto input = typename InputLayout::template const_span<InputSampleType>(
+            input_samples.data() + offset, channels, frames);
+        auto output = typename OutputLayout::template span<OutputSampleType>(
+            output_samples.data() + offset, channels, frames);
+
+        auto start = std::chrono::steady_clock::now();
+        if (Dither == dither_mode::none)
+        {
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin());
+        }
+        else if (Dither == dither_mode::kept)
+        {
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin(), dither_gen);
+        }
+        else
+        {
+            dither_generator call_dither_gen;
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin(), call_dither_gen);
+        }
+        benchmark::ClobberMemory();
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * channels * frames));
+    report_latencies(state, latencies);
+}
+
+// Callback periods of 16 to 64 frames, for stereo and multichannel devices
+static void latency_args(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"channels", "frames"});
+    benchmark->ArgsProduct({{2, 8}, {16, 32, 64}});
+    benchmark->Iterations(latency_iterations);
+}
+
+// Warm and cold calls between each layout pair that callbacks convert between
+#define RATL_BENCH_TRANSFORM_LATENCY(input_sample, output_sample)                                                      \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformLatency,                                                                                         \
+        transform_tier::standard,                                                                                      \
+        cache_state::warm,                                                                                             \
+        interleaved_layout,                                                                                            \
+        interleaved_layout,                                                                                            \
+        input_sample,                                                                                                  \
+        output_sample,                                                                                                 \
+        dither_mode::none)                                                                                             \
+        ->Apply(latency_args);                                                                                         \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformLatency,                                                                                         \
+        transform_tier::standard,                                                                                      \
+        cache_state::cold,                                                                                             \
+        interleaved_layout,                                                                                            \
+        interleaved_layout,                                                                                            \
+        input_sample,                                                                                                  \
+        output_sample,                                                                                                 \
+        dither_mode::none)                                                                                             \
+        ->Apply(latency_args);                                                                                         \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformLatency,                                                                                         \
+        transform_tier::standard,                                                                                      \
+        cache_state::warm,                                                                                             \
+        interleaved_layout,                                                                                            \
+        noninterleaved_layout,                                                                                         \
+        input_sample,                                                                                                  \
+        output_sample,                                                                                                 \
+        dither_mode::none)                                                                                             \
+        ->Apply(latency_args);                                                                                         \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformLatency,                                                                                         \
+        transform_tier::standard,                                                                                      \
+        cache_state::cold,                                                                                             \
+        interleaved_layout,                                                                                            \
+        noninterleaved_layout,                                                                                         \
+        input_sample,                                                                                                  \
+        output_sample,                                                                                                 \
+        dither_mode::none)                                                                                             \
+        ->Apply(latency_args);                                                                                         \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformLatency,                                                                                         \
+        transform_tier::standard,                                                                                      \
+        cache_state::warm,                                                                                             \
+        noninterleaved_layout,                                                                                         \
+        interleaved_layout,                                                                                            \
+        input_sample,                                                                                                  \
+        output_sample,                                                                                                 \
+        dither_mode::none)                                                                                             \
+        ->Apply(latency_args);                                                                                         \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformLatency,                                                                                         \
+        transform_tier::standard,                                                                                      \
+        cache_state::cold,                                                                                             \
+        noninterleaved_layout,                                                                                         \
+        interleaved_layout,                                                                                            \
+        input_sample,                                                                                                  \
+        output_sample,                                                                                                 \
+        dither_mode::none)                                                                                             \
+        ->Apply(latency_args)
+
+RATL_BENCH_TRANSFORM_LATENCY(sample<int16_t>, sample<float32_t>);
+RATL_BENCH_TRANSFORM_LATENCY(sample<float32_t>, sample<int16_t>);
+RATL_BENCH_TRANSFORM_LATENCY(sample<int24_t>, sample<float32_t>);
+RATL_BENCH_TRANSFORM_LATENCY(sample<float32_t>, network_sample<int24_t>);
+
+#undef RATL_BENCH_TRANSFORM_LATENCY
+
+// The cost of dithering, and of constructing a dither generator in every call rather than keeping one
+#define RATL_BENCH_TRANSFORM_LATENCY_DITHER(cache, dither)                                                             \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformLatency,                                                                                         \
+        transform_tier::standard,                                                                                      \
+        cache,                                                                                                         \
+        interleaved_layout,                                                                                            \
+        interleaved_layout,                                                                                            \
+        sample<float32_t>,                                                                                             \
+        sample<int16_t>,                                                                                               \
+        dither)                                                                                                        \
+        ->Apply(latency_args)
+
+RATL_BENCH_TRANSFORM_LATENCY_DITHER(cache_state::warm, dither_mode::kept);
+RATL_BENCH_TRANSFORM_LATENCY_DITHER(cache_state::warm, dither_mode::per_call);
+RATL_BENCH_TRANSFORM_LATENCY_DITHER(cache_state::cold, dither_mode::kept);
+RATL_BENCH_TRANSFORM_LATENCY_DITHER(cache_state::cold, dither_mode::per_call);
+
+#undef RATL_BENCH_TRANSFORM_LATENCY_DITHER
+
+// The dispatch overhead of each tier when there is little conversion to amortise it over
+#define RATL_BENCH_TRANSFORM_LATENCY_TIER(tier, input_sample, output_sample)                                           \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformLatency,                                                                                         \
+        tier,                                                                                                          \
+        cache_state::warm,                                                                                             \
+        interleaved_layout,                                                                                            \
+        noninterleaved_layout,                                                                                         \
+        input_sample,                                                                                                  \
+        output_sample,                                                                                                 \
+        dither_mode::none)                                                                                             \
+        ->Apply(latency_args)
+
+RATL_BENCH_TRANSFORM_LATENCY_TIER(transform_tier::reference, sample<int16_t>, sample<float32_t>);
+RATL_BENCH_TRANSFORM_LATENCY_TIER(transform_tier::fast, sample<int16_t>, sample<float32_t>);
+RATL_BENCH_TRANSFORM_LATENCY_TIER(transform_tier::reference, sample<float32_t>, sample<int16_t>);
+RATL_BENCH_TRANSFORM_LATENCY_TIER(transform_tier::fast, sample<float32_t>, sample<int16_t>);
+
+#undef RATL_BENCH_TRANSFORM_LATENCY_TIER
+
+} // namespace ratl
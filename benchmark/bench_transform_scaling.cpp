@@ -0,0 +1,299 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(RATL_CPP_PLATFORM_LINUX)
+#    include <pthread.h>
+#    include <sched.h>
+#endif
+
+// Runs the same transform on 1 up to one thread per core, each thread pinned to its own core and converting its own
+// buffers, with the buffers sized to stay in L1, L2 or the last level cache or to stream from DRAM. Reports the
+// aggregate samples/s of every run and then, for each transform and buffer size, how throughput scaled with threads and
+// the thread count where it stopped scaling, i.e. where the shared cache or memory bandwidth saturated.
+// bench_transform_scaling --benchmark_filter=fast.*level:4 picks out the runs that stream from DRAM with the fast tier.
+
+namespace ratl
+{
+using utils::aligned_samples;
+using utils::interleaved_layout;
+using utils::noninterleaved_layout;
+using utils::random_samples;
+using utils::tier_transformer;
+using utils::transform_tier;
+
+// Each thread converts 8 channel buffers, as one multichannel stream
+static constexpr std::size_t num_channels = 8;
+
+// Aggregate throughput within this fraction of the peak counts as saturated
+static constexpr double saturation_fraction = 0.9;
+
+enum class buffer_level
+{
+    l1 = 1,
+    l2 = 2,
+    llc = 3,
+    dram = 4
+};
+
+// The CPUs this process may run on, in order, which threads are pinned to in turn
+static const std::vector<int>& allowed_cpus()
+{
+    static const std::vector<int> cpus = []
+    {
+        std::vector<int> allowed;
+#if defined(RATL_CPP_PLATFORM_LINUX)
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        if (::sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+        {
+            for (auto cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &cpu_set))
+                {
+                    allowed.push_back(cpu);
+                }
+            }
+        }
+#endif
+        if (allowed.empty())
+        {
+            for (auto cpu = 0; cpu < static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)); ++cpu)
+            {
+                allowed.push_back(cpu);
+            }
+        }
+        return allowed;
+    }();
+    return cpus;
+}
+
+static void pin_thread(int thread_index)
+{
+#if defined(RATL_CPP_PLATFORM_LINUX)
+    auto& cpus = allowed_cpus();
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpus[static_cast<std::size_t>(thread_index) % cpus.size()], &cpu_set);
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set);
+#else
+    static_cast<void>(thread_index);
+#endif
+}
+
+// The size of the caches of a level, or of the largest cache for level 0, as the benchmark library found them
+static std::size_t cache_bytes(int level, std::size_t default_bytes)
+{
+    std::size_t bytes = 0;
+    for (auto& cache : benchmark::CPUInfo::Get().caches)
+    {
+        if (cache.type != "Instruction" && (level == 0 || cache.level == level))
+        {
+            bytes = std::max(bytes, static_cast<std::size_t>(cache.size));
+        }
+    }
+    return bytes != 0 ? bytes : default_bytes;
+}
+
+// The bytes of input and output each thread converts: half of L1 or L2, an equal share of half the last level cache,
+// or, for DRAM, an equal share of four times the last level cache
+static std::size_t buffer_bytes(buffer_level level, std::size_t threads)
+{
+    auto l1_bytes = cache_bytes(1, 32 * 1024);
+    auto l2_bytes = cache_bytes(2, 1024 * 1024);
+    auto llc_bytes = cache_bytes(0, 8 * 1024 * 1024);
+    switch (level)
+    {
+    case buffer_level::l1:
+        return l1_bytes / 2;
+    case buffer_level::l2:
+        return l2_bytes / 2;
+    case buffer_level::llc:
+        return std::max(llc_bytes / (2 * threads), l2_bytes);
+    case buffer_level::dram:
+        break;
+    }
+    return std::max(4 * llc_bytes / threads, 4 * l2_bytes);
+}
+
+template<
+    transform_tier Tier,
+    typename InputLayout,
+    typename OutputLayout,
+    typename InputSampleType,
+    typename OutputSampleType,
+    bool Dither>
+void benchTransformScaling(benchmark::State& state)
+{
+    pin_thread(state.thread_index());
+
+    // Each thread allocates and first touches its own buffers once pinned, so that they're local to its NUMA node
+    auto bytes = buffer_bytes(static_cast<buffer_level>(state.range(0)), static_cast<std::size_t>(state.threads()));
+    auto sample_bytes = sizeof(InputSampleType) + sizeof(OutputSampleType);
+    auto frames = std::max(bytes / (num_channels * sample_bytes), std::size_t(1));
+    auto input_samples = random_samples<InputSampleType>(num_channels * frames);
+    aligned_samples<OutputSampleType> output_samples(num_channels * frames);
+    auto input = typename InputLayout::template const_span<InputSampleType>(input_samples.data(), num_channels, frames);
+    auto output = typename OutputLayout::template span<OutputSampleType>(output_samples.data(), num_channels, frames);
+    dither_generator dither_gen;
+    for (auto _ : state)
+    {
+        if (Dither)
+        {
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin(), dither_gen);
+        }
+        else
+        {
+            tier_transformer<Tier>::apply(input.begin(), input.end(), output.begin());
+        }
+        benchmark::ClobberMemory();
+    }
+    auto samples = num_channels * frames;
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * samples));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * samples * sample_bytes));
+    state.counters["buffer_bytes"] =
+        benchmark::Counter(static_cast<double>(samples * sample_bytes), benchmark::Counter::kAvgThreads);
+}
+
+// Every buffer level, on 1, 2, 4... threads up to one per core
+static void scaling_args(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"level"});
+    for (auto level : {buffer_level::l1, buffer_level::l2, buffer_level::llc, buffer_level::dram})
+    {
+        benchmark->Arg(static_cast<int64_t>(level));
+    }
+    auto max_threads = static_cast<int>(allowed_cpus().size());
+    for (auto threads = 1; threads < max_threads; threads *= 2)
+    {
+        benchmark->Threads(threads);
+    }
+    benchmark->Threads(max_threads);
+    benchmark->UseRealTime();
+}
+
+#define RATL_BENCH_TRANSFORM_SCALING(tier, input_layout, output_layout, input_sample, output_sample, dither)          \
+    BENCHMARK_TEMPLATE(                                                                                                \
+        benchTransformScaling, tier, input_layout, output_layout, input_sample, output_sample, dither)                 \
+        ->Apply(scaling_args)
+
+RATL_BENCH_TRANSFORM_SCALING(
+    transform_tier::reference, interleaved_layout, interleaved_layout, sample<float32_t>, sample<int16_t>, false);
+RATL_BENCH_TRANSFORM_SCALING(
+    transform_tier::fast, interleaved_layout, interleaved_layout, sample<float32_t>, sample<int16_t>, false);
+RATL_BENCH_TRANSFORM_SCALING(
+    transform_tier::reference, interleaved_layout, interleaved_layout, sample<float32_t>, sample<int16_t>, true);
+RATL_BENCH_TRANSFORM_SCALING(
+    transform_tier::fast, interleaved_layout, interleaved_layout, sample<float32_t>, sample<int16_t>, true);
+RATL_BENCH_TRANSFORM_SCALING(
+    transform_tier::reference, interleaved_layout, noninterleaved_layout, sample<int16_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_SCALING(
+    transform_tier::fast, interleaved_layout, noninterleaved_layout, sample<int16_t>, sample<float32_t>, false);
+RATL_BENCH_TRANSFORM_SCALING(
+    transform_tier::fast, interleaved_layout, interleaved_layout, network_sample<int24_t>, sample<float32_t>, false);
+
+#undef RATL_BENCH_TRANSFORM_SCALING
+
+// Prints the runs as usual, then summarises how each transform and buffer level scaled with threads
+class scaling_reporter : public benchmark::ConsoleReporter
+{
+private:
+    // Aggregate samples/s by thread count, for each benchmark and its arguments
+    std::map<std::string, std::map<int64_t, double>> throughputs_;
+
+public:
+    // Uncoloured, since the results are usually kept for capacity planning
+    scaling_reporter() : ConsoleReporter(OO_None)
+    {
+    }
+
+    void ReportRuns(const std::vector<Run>& reports) override
+    {
+        for (auto& run : reports)
+        {
+            auto counter = run.counters.find("items_per_second");
+            if (run.run_type == Run::RT_Iteration && !run.error_occurred && counter != run.counters.end())
+            {
+                throughputs_[run.run_name.function_name + "/" + run.run_name.args][run.threads] = counter->second;
+            }
+        }
+        ConsoleReporter::ReportRuns(reports);
+    }
+
+    void Finalize() override
+    {
+        auto& out = GetOutputStream();
+        for (auto& benchmark_throughputs : throughputs_)
+        {
+            auto& throughputs = benchmark_throughputs.second;
+            auto single = throughputs.begin()->second;
+            auto peak = std::max_element(
+                throughputs.begin(),
+                throughputs.end(),
+                [](const std::pair<const int64_t, double>& a, const std::pair<const int64_t, double>& b)
+                { return a.second < b.second; });
+            auto saturated = std::find_if(
+                throughputs.begin(),
+                throughputs.end(),
+                [&peak](const std::pair<const int64_t, double>& throughput)
+                { return throughput.second >= saturation_fraction * peak->second; });
+
+            out << "\n" << benchmark_throughputs.first << "\n";
+            char line[128];
+            std::snprintf(line, sizeof(line), "%10s %16s %10s %12s\n", "threads", "samples/s", "speedup", "efficiency");
+            out << line;
+            for (auto& throughput : throughputs)
+            {
+                auto speedup = single > 0.0 ? throughput.second / single : 0.0;
+                std::snprintf(
+                    line,
+                    sizeof(line),
+                    "%10lld %16.4g %9.2fx %11.0f%%\n",
+                    static_cast<long long>(throughput.first),
+                    throughput.second,
+                    speedup,
+                    100.0 * speedup / static_cast<double>(throughput.first));
+                out << line;
+            }
+            std::snprintf(
+                line,
+                sizeof(line),
+                "saturates at %lld threads, %.4g samples/s, of a peak of %.4g samples/s on %lld threads\n",
+                static_cast<long long>(saturated->first),
+                saturated->second,
+                peak->second,
+                static_cast<long long>(peak->first));
+            out << line;
+        }
+        ConsoleReporter::Finalize();
+    }
+};
+} // namespace ratl
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    ratl::scaling_reporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+    return 0;
+}
@@ -14,6 +14,8 @@
 // other includes
 #include <benchmark/benchmark.h>
 #include <random>
+#include <utility>
+#include <vector>
 
 namespace ratl
 {
@@ -39,6 +41,79 @@ InputType generateRandomInput(std::size_t num_channels, std::size_t num_frames)
     transform(float_container.begin(), float_container.end(), input.begin());
     return input;
 }
+
+// The transform entry points, so that benchmarks can compare them
+enum class transform_tier
+{
+    reference,
+    fast,
+    standard
+};
+
+template<transform_tier Tier>
+struct tier_transformer;
+
+template<>
+struct tier_transformer<transform_tier::reference>
+{
+    template<typename... Args>
+    static void apply(Args&&... args)
+    {
+        reference_transform(std::forward<Args>(args)...);
+    }
+};
+
+template<>
+struct tier_transformer<transform_tier::fast>
+{
+    template<typename... Args>
+    static void apply(Args&&... args)
+    {
+        fast_transform(std::forward<Args>(args)...);
+    }
+};
+
+template<>
+struct tier_transformer<transform_tier::standard>
+{
+    template<typename... Args>
+    static void apply(Args&&... args)
+    {
+        transform(std::forward<Args>(args)...);
+    }
+};
+
+// Views a flat run of samples as a layout, so that the views can start at any sample rather than only where a
+// container's allocator puts them
+struct interleaved_layout
+{
+    template<typename SampleType>
+    using span = basic_interleaved_span<SampleType, detail::sample_traits<SampleType>>;
+
+    template<typename SampleType>
+    using const_span =
+        basic_interleaved_span<const SampleType, detail::const_sample_traits_t<detail::sample_traits<SampleType>>>;
+};
+
+struct noninterleaved_layout
+{
+    template<typename SampleType>
+    using span = basic_noninterleaved_span<SampleType, detail::sample_traits<SampleType>>;
+
+    template<typename SampleType>
+    using const_span =
+        basic_noninterleaved_span<const SampleType, detail::const_sample_traits_t<detail::sample_traits<SampleType>>>;
+};
+
+template<typename SampleType>
+using aligned_samples = std::vector<SampleType, allocator<SampleType>>;
+
+template<typename SampleType>
+inline aligned_samples<SampleType> random_samples(std::size_t samples)
+{
+    auto random = utils::generateRandomInput<basic_interleaved<SampleType>>(1, samples);
+    return aligned_samples<SampleType>(random.data(), random.data() + samples);
+}
 } // namespace utils
 } // namespace ratl
 
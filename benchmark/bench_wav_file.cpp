@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace ratl
+{
+static constexpr std::size_t num_channels = 32;
+static constexpr std::size_t num_frames = 48000 * 20;
+static constexpr std::size_t block_frames = 4800;
+static constexpr std::size_t header_size = 44;
+
+using file_sample_value_type = int24_t;
+using file_sample_type = sample<file_sample_value_type>;
+
+template<typename Tp>
+static void write_little_endian(std::FILE* file, Tp value)
+{
+    for (std::size_t byte_num = 0; byte_num < sizeof(Tp); ++byte_num)
+    {
+        std::fputc(static_cast<int>((static_cast<std::uint64_t>(value) >> (byte_num * 8)) & 0xff), file);
+    }
+}
+
+// Writes a canonical 44 byte header WAV file of random samples once, and returns its path
+static const std::string& wav_path()
+{
+    static const std::string path = []()
+    {
+        auto* tmp_dir = std::getenv("TMPDIR");
+        auto path = std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") + "/ratl_bench_wav_file.wav";
+        auto data_size = static_cast<std::uint32_t>(num_channels * num_frames * sizeof(file_sample_type));
+        auto block_align = static_cast<std::uint16_t>(num_channels * sizeof(file_sample_type));
+
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+        std::fwrite("RIFF", 1, 4, file.get());
+        write_little_endian(file.get(), static_cast<std::uint32_t>(data_size + header_size - 8));
+        std::fwrite("WAVEfmt ", 1, 8, file.get());
+        write_little_endian(file.get(), std::uint32_t(16));
+        write_little_endian(file.get(), std::uint16_t(1));
+        write_little_endian(file.get(), static_cast<std::uint16_t>(num_channels));
+        write_little_endian(file.get(), std::uint32_t(48000));
+        write_little_endian(file.get(), static_cast<std::uint32_t>(48000 * block_align));
+        write_little_endian(file.get(), block_align);
+        write_little_endian(file.get(), static_cast<std::uint16_t>(sizeof(file_sample_type) * 8));
+        std::fwrite("data", 1, 4, file.get());
+        write_little_endian(file.get(), data_size);
+
+        auto block = utils::generateRandomInput<interleaved<file_sample_value_type>>(num_channels, block_frames);
+        for (std::size_t frame_num = 0; frame_num < num_frames; frame_num += block_frames)
+        {
+            std::fwrite(block.data(), sizeof(file_sample_type), block.samples(), file.get());
+        }
+        return path;
+    }();
+    return path;
+}
+
+// Loads the file a block at a time with fread into an interleaved buffer, then converts each block
+static void benchReadLoader(benchmark::State& state)
+{
+    interleaved<file_sample_value_type> input(num_channels, block_frames);
+    noninterleaved<float32_t> output(num_channels, block_frames);
+    for (auto _ : state)
+    {
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(wav_path().c_str(), "rb"), &std::fclose);
+        std::fseek(file.get(), static_cast<long>(header_size), SEEK_SET);
+        for (std::size_t frame_num = 0; frame_num < num_frames; frame_num += block_frames)
+        {
+            std::fread(input.data(), sizeof(file_sample_type), input.samples(), file.get());
+            transform(input.begin(), input.end(), output.begin());
+            benchmark::DoNotOptimize(output.data());
+        }
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * num_channels * num_frames * sizeof(file_sample_type)));
+}
+
+// Converts each block straight out of the mapped file, reading ahead of the conversion
+static void benchMappedFile(benchmark::State& state)
+{
+    noninterleaved<float32_t> output(num_channels, block_frames);
+    for (auto _ : state)
+    {
+        wav_file file(wav_path());
+        for (std::size_t frame_num = 0; frame_num < file.frames(); frame_num += block_frames)
+        {
+            file.will_need(frame_num + block_frames, block_frames);
+            auto input = file.samples<file_sample_value_type>(frame_num, block_frames);
+            transform(input.begin(), input.end(), output.begin());
+            benchmark::DoNotOptimize(output.data());
+        }
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * num_channels * num_frames * sizeof(file_sample_type)));
+}
+
+BENCHMARK(benchReadLoader)->Unit(benchmark::kMillisecond);
+BENCHMARK(benchMappedFile)->Unit(benchmark::kMillisecond);
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl bench includes
+#include "bench_utils.hpp"
+
+// other includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ratl
+{
+static constexpr std::size_t num_channels = 128;
+static constexpr std::size_t sample_rate = 96000;
+static constexpr std::size_t period_frames = 256;
+static constexpr std::size_t num_periods = (sample_rate * 10) / period_frames;
+
+using file_sample_value_type = int24_t;
+
+static std::string wav_path()
+{
+    auto* tmp_dir = std::getenv("TMPDIR");
+    return std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") + "/ratl_bench_wav_writer.wav";
+}
+
+static void report_latencies(benchmark::State& state, std::vector<double>& latencies)
+{
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * num_channels * period_frames * sizeof(sample<int24_t>)));
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p)
+    {
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p99.9_ns"] = percentile(0.999);
+    state.counters["max_ns"] = latencies.back();
+}
+
+// Records 10 seconds of 128 channels at 96kHz a period at a time, converting each period and writing it with fwrite
+// on the producing thread, reporting the throughput and the latency percentiles of the individual periods
+static void benchConvertFwrite(benchmark::State& state)
+{
+    auto input = utils::generateRandomInput<noninterleaved<float32_t>>(num_channels, period_frames);
+    interleaved<file_sample_value_type> output(num_channels, period_frames);
+    dither_generator dither_gen;
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(wav_path().c_str(), "wb"), &std::fclose);
+    std::vector<double> latencies;
+    latencies.reserve(num_periods);
+    for (auto _ : state)
+    {
+        auto start = std::chrono::steady_clock::now();
+        transform(input.begin(), input.end(), output.begin(), dither_gen);
+        std::fwrite(output.data(), sizeof(sample<file_sample_value_type>), output.samples(), file.get());
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    file.reset();
+    report_latencies(state, latencies);
+}
+
+// Records the same periods with wav_writer, which converts them into staging blocks and leaves the disk to its
+// background thread
+static void benchWavWriter(benchmark::State& state)
+{
+    auto input = utils::generateRandomInput<noninterleaved<float32_t>>(num_channels, period_frames);
+
+    wav_writer_options options;
+    options.direct_io = state.range(0) != 0;
+    wav_writer<file_sample_value_type> writer(wav_path(), num_channels, sample_rate, options);
+    std::vector<double> latencies;
+    latencies.reserve(num_periods);
+    for (auto _ : state)
+    {
+        auto start = std::chrono::steady_clock::now();
+        writer.write(input);
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    writer.close();
+    report_latencies(state, latencies);
+    state.counters["direct_io"] = writer.direct_io() ? 1 : 0;
+    state.counters["dropped_frames"] = static_cast<double>(writer.dropped_frames());
+}
+
+BENCHMARK(benchConvertFwrite)->Iterations(num_periods);
+BENCHMARK(benchWavWriter)->Arg(0)->Arg(1)->Iterations(num_periods);
+
+} // namespace ratl
+
+BENCHMARK_MAIN();
@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl includes
+#include "alsa_engine.hpp"
+
+// other includes
+#include <cerrno>
+#include <chrono>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <utility>
+
+namespace ratl
+{
+namespace example
+{
+namespace alsa
+{
+#if !defined(RATL_CPP_VERSION_HAS_CPP17)
+constexpr std::size_t engine_histogram::buckets;
+#endif
+
+// Stack the audio thread touches before it starts streaming, so it doesn't page fault on its first deep call
+static constexpr std::size_t prefault_stack_size = 256 * 1024;
+static constexpr std::size_t prefault_page_size = 4096;
+
+// How long the audio thread waits on the PCM before checking whether it has been stopped
+static constexpr int wait_timeout_ms = 100;
+
+static std::uint64_t elapsed_us(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+alsa_engine::alsa_engine(engine_config config, render_function render) :
+    config_(std::move(config)), render_(std::move(render)), playback_(config_.device)
+{
+}
+
+alsa_engine::~alsa_engine()
+{
+    stop();
+}
+
+result alsa_engine::start()
+{
+    if (running())
+    {
+        return result();
+    }
+
+    auto params = playback_.construct_hardware_params();
+    auto res = params.set_access(SND_PCM_ACCESS_RW_INTERLEAVED);
+    if (!res)
+    {
+        return res;
+    }
+    res = params.set_format(SND_PCM_FORMAT_S16_LE);
+    if (!res)
+    {
+        return res;
+    }
+    res = params.set_channels(config_.channels);
+    if (!res)
+    {
+        return res;
+    }
+    res = params.set_rate(config_.rate);
+    if (!res)
+    {
+        return res;
+    }
+    res = params.set_period_size(config_.period_size);
+    if (!res)
+    {
+        return res;
+    }
+    res = playback_.write_hardware_params(params);
+    if (!res)
+    {
+        return res;
+    }
+
+    // the buffers are zero filled as they are constructed, which faults in every page before the thread starts
+    render_buffer_ = interleaved<float32_t>(playback_.channels(), playback_.period_size());
+    converted_buffer_ = interleaved<int16_t>(playback_.channels(), playback_.period_size());
+
+    realtime_error_.store(0, std::memory_order_relaxed);
+    stream_error_.store(0, std::memory_order_relaxed);
+    if (config_.lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        record_error(errno);
+    }
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(
+        [this]()
+        {
+            run();
+        });
+    return result();
+}
+
+void alsa_engine::stop()
+{
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+engine_telemetry alsa_engine::telemetry() const
+{
+    engine_telemetry telemetry{};
+    telemetry.periods = periods_.load(std::memory_order_relaxed);
+    telemetry.xruns = xruns_.load(std::memory_order_relaxed);
+    telemetry.max_conversion_time_us = max_conversion_time_us_.load(std::memory_order_relaxed);
+    telemetry.max_wakeup_jitter_us = max_wakeup_jitter_us_.load(std::memory_order_relaxed);
+    telemetry.conversion_time_us = conversion_time_us_.counts();
+    telemetry.wakeup_jitter_us = wakeup_jitter_us_.counts();
+    telemetry.realtime_error = realtime_error_.load(std::memory_order_relaxed);
+    telemetry.stream_error = stream_error_.load(std::memory_order_relaxed);
+    return telemetry;
+}
+
+void alsa_engine::run()
+{
+    setup_thread();
+
+    auto pcm = playback_.get();
+    auto period_size = static_cast<snd_pcm_sframes_t>(playback_.period_size());
+    auto period_us = static_cast<double>(1000000) / static_cast<double>(config_.rate);
+
+    // the first period is converted before the stream starts, after that each period is converted while the
+    // previous ones play
+    render_next_period();
+    while (running_.load(std::memory_order_acquire))
+    {
+        auto wait_result = snd_pcm_wait(pcm, wait_timeout_ms);
+        if (wait_result == 0)
+        {
+            continue;
+        }
+
+        // errors are left for write_interleaved to recover from, so that xruns are counted in one place
+        auto avail = snd_pcm_avail_update(pcm);
+        if (wait_result > 0 && avail >= 0 && avail < period_size)
+        {
+            continue;
+        }
+
+        // any space beyond the period we were woken for is time the thread woke up late by
+        if (avail > period_size && snd_pcm_state(pcm) == SND_PCM_STATE_RUNNING)
+        {
+            auto jitter_us = static_cast<std::uint64_t>(static_cast<double>(avail - period_size) * period_us);
+            wakeup_jitter_us_.record(jitter_us);
+            update_max(max_wakeup_jitter_us_, jitter_us);
+        }
+
+        auto res = playback_.write_interleaved(converted_buffer_);
+        xruns_.store(playback_.xruns(), std::memory_order_relaxed);
+        if (!res)
+        {
+            stream_error_.store(res.code(), std::memory_order_relaxed);
+            break;
+        }
+        periods_.fetch_add(1, std::memory_order_relaxed);
+
+        render_next_period();
+    }
+
+    snd_pcm_drop(pcm);
+    snd_pcm_prepare(pcm);
+    running_.store(false, std::memory_order_release);
+}
+
+void alsa_engine::setup_thread()
+{
+    if (config_.cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config_.cpu, &cpus);
+        auto res = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (res != 0)
+        {
+            record_error(res);
+        }
+    }
+
+    if (config_.priority > 0)
+    {
+        sched_param param{};
+        param.sched_priority = config_.priority;
+        auto res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (res != 0)
+        {
+            record_error(res);
+        }
+    }
+
+    // touch a page at a time so that the compiler can't drop the writes
+    char stack[prefault_stack_size];
+    volatile char* stack_pages = stack;
+    for (std::size_t offset = 0; offset < prefault_stack_size; offset += prefault_page_size)
+    {
+        stack_pages[offset] = 0;
+    }
+}
+
+void alsa_engine::render_next_period()
+{
+    render_(render_span(render_buffer_));
+
+    auto start = std::chrono::steady_clock::now();
+    transform(render_buffer_.begin(), render_buffer_.end(), converted_buffer_.begin(), dither_gen_);
+    auto conversion_time_us = elapsed_us(start);
+    conversion_time_us_.record(conversion_time_us);
+    update_max(max_conversion_time_us_, conversion_time_us);
+}
+
+void alsa_engine::record_error(int error)
+{
+    auto expected = 0;
+    realtime_error_.compare_exchange_strong(expected, error, std::memory_order_relaxed);
+}
+
+void alsa_engine::update_max(std::atomic<std::uint64_t>& max, std::uint64_t value)
+{
+    auto current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+} // namespace alsa
+} // namespace example
+} // namespace ratl
@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_example_alsa_engine_
+#define _ratl_example_alsa_engine_
+
+// ratl includes
+#include "alsa_playback.hpp"
+
+#include <ratl/ratl.hpp>
+
+// other includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace ratl
+{
+namespace example
+{
+namespace alsa
+{
+struct engine_config
+{
+    std::string device = "default";
+    std::size_t channels = 2;
+    std::size_t rate = 48000;
+    std::size_t period_size = 256;
+
+    // SCHED_FIFO priority of the audio thread, 0 leaves the thread on the default scheduler
+    int priority = 0;
+
+    // CPU the audio thread is pinned to, -1 lets it run on any CPU
+    int cpu = -1;
+
+    // Locks every current and future page of the process into memory with mlockall
+    bool lock_memory = true;
+};
+
+// Histogram of durations in microseconds, bucket n counts durations in [2^(n - 1), 2^n), with bucket 0 counting
+// durations under 1us and the last bucket counting everything above the previous one
+class engine_histogram
+{
+public:
+    static constexpr std::size_t buckets = 16;
+
+    void record(std::uint64_t duration_us)
+    {
+        std::size_t bucket = 0;
+        while (duration_us > 0 && bucket < buckets - 1)
+        {
+            duration_us >>= 1;
+            ++bucket;
+        }
+        counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::array<std::uint64_t, buckets> counts() const
+    {
+        std::array<std::uint64_t, buckets> counts{};
+        for (std::size_t bucket = 0; bucket < buckets; ++bucket)
+        {
+            counts[bucket] = counts_[bucket].load(std::memory_order_relaxed);
+        }
+        return counts;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, buckets> counts_{};
+};
+
+struct engine_telemetry
+{
+    std::uint64_t periods;
+    std::uint64_t xruns;
+    std::uint64_t max_conversion_time_us;
+    std::uint64_t max_wakeup_jitter_us;
+    std::array<std::uint64_t, engine_histogram::buckets> conversion_time_us;
+    std::array<std::uint64_t, engine_histogram::buckets> wakeup_jitter_us;
+
+    // 0 if the audio thread got the scheduling and memory locking it asked for, otherwise the errno of the first
+    // request that failed. The engine keeps running without them.
+    int realtime_error;
+
+    // 0 while the stream runs, otherwise the ALSA error that stopped the audio thread
+    int stream_error;
+};
+
+// Plays the float samples produced by a render function through an ALSA playback PCM from a dedicated audio thread.
+// Conversion is double-buffered against the PCM ring: the audio thread renders and converts the next period as soon
+// as the current one has been handed to ALSA, so the conversion overlaps the DMA of the queued periods and a converted
+// period is already waiting when the PCM wakes the thread up. Everything the audio thread touches is allocated and
+// pre-faulted before it starts.
+class alsa_engine
+{
+public:
+    using render_span = interleaved_span<float32_t>;
+    using render_function = std::function<void(render_span)>;
+
+    alsa_engine(engine_config config, render_function render);
+    ~alsa_engine();
+
+    alsa_engine(const alsa_engine&) = delete;
+    alsa_engine& operator=(const alsa_engine&) = delete;
+
+    // Configures the PCM and starts the audio thread
+    result start();
+
+    // Stops the audio thread, pending periods are dropped
+    void stop();
+
+    bool running() const
+    {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    // Safe to call from any thread while the engine runs
+    engine_telemetry telemetry() const;
+
+private:
+    void run();
+    void setup_thread();
+    void render_next_period();
+    void record_error(int error);
+
+    static void update_max(std::atomic<std::uint64_t>& max, std::uint64_t value);
+
+    engine_config config_;
+    render_function render_;
+    alsa_playback playback_;
+
+    interleaved<float32_t> render_buffer_;
+    interleaved<int16_t> converted_buffer_;
+    dither_generator dither_gen_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> realtime_error_{0};
+    std::atomic<int> stream_error_{0};
+    std::atomic<std::uint64_t> periods_{0};
+    std::atomic<std::uint64_t> xruns_{0};
+    std::atomic<std::uint64_t> max_conversion_time_us_{0};
+    std::atomic<std::uint64_t> max_wakeup_jitter_us_{0};
+    engine_histogram conversion_time_us_;
+    engine_histogram wakeup_jitter_us_;
+};
+
+} // namespace alsa
+} // namespace example
+} // namespace ratl
+
+#endif // _ratl_example_alsa_engine_
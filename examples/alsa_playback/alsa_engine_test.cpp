@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl includes
+#include "alsa_engine.hpp"
+
+// other includes
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+
+// Drives alsa_engine through ALSA's null plugin, which consumes periods as fast as they are written, and checks that
+// every period was rendered, converted and written without stream errors
+
+static constexpr std::uint64_t TestPeriods = 2000;
+static constexpr auto Timeout = std::chrono::seconds(10);
+
+using histogram_counts = std::array<std::uint64_t, ratl::example::alsa::engine_histogram::buckets>;
+
+static void print_histogram(const char* name, const histogram_counts& counts)
+{
+    std::printf("%s:", name);
+    for (auto count : counts)
+    {
+        std::printf(" %llu", static_cast<unsigned long long>(count));
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    ratl::example::alsa::engine_config config;
+    config.device = argc > 1 ? argv[1] : "null";
+    config.priority = argc > 2 ? std::stoi(argv[2]) : 0;
+    config.cpu = argc > 3 ? std::stoi(argv[3]) : -1;
+    config.lock_memory = false;
+
+    std::size_t rendered_periods = 0;
+    double phase = 0.0;
+    ratl::example::alsa::alsa_engine engine(
+        config,
+        [&](ratl::example::alsa::alsa_engine::render_span span)
+        {
+            for (auto frame : span)
+            {
+                auto value = ratl::sample<ratl::float32_t>(static_cast<float>(std::sin(phase) * 0.5));
+                for (auto& sample : frame)
+                {
+                    sample = value;
+                }
+                phase += 0.05;
+            }
+            ++rendered_periods;
+        });
+
+    auto result = engine.start();
+    if (!result)
+    {
+        std::cout << "ERROR: Can't start engine: " << result.c_str() << std::endl;
+        return -1;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + Timeout;
+    while (engine.running() && engine.telemetry().periods < TestPeriods && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+
+    auto telemetry = engine.telemetry();
+    std::printf(
+        "periods %llu xruns %llu max conversion %lluus max jitter %lluus realtime error %d\n",
+        static_cast<unsigned long long>(telemetry.periods),
+        static_cast<unsigned long long>(telemetry.xruns),
+        static_cast<unsigned long long>(telemetry.max_conversion_time_us),
+        static_cast<unsigned long long>(telemetry.max_wakeup_jitter_us),
+        telemetry.realtime_error);
+    print_histogram("conversion time (us, log2 buckets)", telemetry.conversion_time_us);
+    print_histogram("wakeup jitter (us, log2 buckets)", telemetry.wakeup_jitter_us);
+
+    if (telemetry.stream_error != 0)
+    {
+        std::cout << "ERROR: Stream failed: " << snd_strerror(telemetry.stream_error) << std::endl;
+        return -1;
+    }
+    if (telemetry.periods < TestPeriods)
+    {
+        std::cout << "ERROR: Only " << telemetry.periods << " periods were written" << std::endl;
+        return -1;
+    }
+
+    // every written period was converted, and the period converted ahead of the stream was converted too
+    auto conversions = std::accumulate(
+        telemetry.conversion_time_us.begin(), telemetry.conversion_time_us.end(), static_cast<std::uint64_t>(0));
+    if (conversions != rendered_periods || (conversions != telemetry.periods && conversions != telemetry.periods + 1))
+    {
+        std::cout << "ERROR: " << conversions << " conversions for " << telemetry.periods << " periods" << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl includes
+#include "alsa_playback.hpp"
+
+#include <ratl/ratl.hpp>
+
+// other includes
+#include <alsa/asoundlib.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Measures the CPU time spent on each period when converting float samples for (or from) a PCM through the
+// snd_pcm_writei/snd_pcm_readi copy path and through the mmap path. ALSA's null plugin accepts and produces periods
+// as fast as they can be transferred, so it isolates the cost of the transfers from the sound hardware.
+
+static double thread_cpu_time_us()
+{
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return (static_cast<double>(time.tv_sec) * 1e6) + (static_cast<double>(time.tv_nsec) / 1e3);
+}
+
+static void report(const std::string& name, std::vector<double>& period_times)
+{
+    if (period_times.empty())
+    {
+        return;
+    }
+    std::sort(period_times.begin(), period_times.end());
+    auto total = 0.0;
+    for (auto period_time : period_times)
+    {
+        total += period_time;
+    }
+    auto percentile = [&](double fraction)
+    {
+        return period_times[static_cast<std::size_t>(fraction * static_cast<double>(period_times.size() - 1))];
+    };
+    std::printf(
+        "%-24s mean %8.2fus  p50 %8.2fus  p99 %8.2fus  max %8.2fus\n",
+        name.c_str(),
+        total / static_cast<double>(period_times.size()),
+        percentile(0.5),
+        percentile(0.99),
+        period_times.back());
+}
+
+static bool configure(
+    ratl::example::alsa::alsa_pcm& pcm, snd_pcm_access_t access, std::size_t channels, std::size_t rate)
+{
+    auto params = pcm.construct_hardware_params();
+    auto result = params.set_access(access);
+    if (!result)
+    {
+        std::cout << "ERROR: Can't set access: " << result.c_str() << std::endl;
+        return false;
+    }
+    result = params.set_format(SND_PCM_FORMAT_S16_LE);
+    if (!result)
+    {
+        std::cout << "ERROR: Can't set format: " << result.c_str() << std::endl;
+        return false;
+    }
+    result = params.set_channels(channels);
+    if (!result)
+    {
+        std::cout << "ERROR: Can't set channels: " << result.c_str() << std::endl;
+        return false;
+    }
+    result = params.set_rate(rate);
+    if (!result)
+    {
+        std::cout << "ERROR: Can't set rate: " << result.c_str() << std::endl;
+        return false;
+    }
+    result = pcm.write_hardware_params(params);
+    if (!result)
+    {
+        std::cout << "ERROR: Can't write hardware params: " << result.c_str() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+template<typename Fn>
+static bool time_periods(const std::string& name, std::size_t periods, Fn period_function)
+{
+    std::vector<double> period_times;
+    period_times.reserve(periods);
+    for (std::size_t period_num = 0; period_num < periods; ++period_num)
+    {
+        auto start = thread_cpu_time_us();
+        auto result = period_function();
+        period_times.push_back(thread_cpu_time_us() - start);
+        if (!result)
+        {
+            std::cout << "ERROR: " << name << " failed: " << result.c_str() << std::endl;
+            return false;
+        }
+    }
+    report(name, period_times);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 5)
+    {
+        std::cout << "Usage: " << argv[0] << " [<device> [<channels> [<sample_rate> [<periods>]]]]" << std::endl;
+        return -1;
+    }
+
+    auto device = std::string(argc > 1 ? argv[1] : "null");
+    auto channels = static_cast<std::size_t>(argc > 2 ? std::stoul(argv[2]) : 2);
+    auto rate = static_cast<std::size_t>(argc > 3 ? std::stoul(argv[3]) : 48000);
+    auto periods = static_cast<std::size_t>(argc > 4 ? std::stoul(argv[4]) : 10000);
+
+    ratl::dither_generator dither_gen;
+
+    {
+        ratl::example::alsa::alsa_playback playback(device);
+        if (!configure(playback, SND_PCM_ACCESS_RW_INTERLEAVED, channels, rate))
+        {
+            return -1;
+        }
+        ratl::interleaved<ratl::float32_t> float_interleaved(channels, playback.period_size());
+        ratl::interleaved<ratl::int16_t> int_interleaved(channels, playback.period_size());
+        if (!time_periods(
+                "playback copy",
+                periods,
+                [&]()
+                {
+                    ratl::transform(
+                        float_interleaved.begin(), float_interleaved.end(), int_interleaved.begin(), dither_gen);
+                    return playback.write_interleaved(int_interleaved);
+                }))
+        {
+            return -1;
+        }
+    }
+
+    {
+        ratl::example::alsa::alsa_playback playback(device);
+        if (!configure(playback, SND_PCM_ACCESS_MMAP_INTERLEAVED, channels, rate))
+        {
+            return -1;
+        }
+        ratl::interleaved<ratl::float32_t> float_interleaved(channels, playback.period_size());
+        if (!time_periods(
+                "playback mmap",
+                periods,
+                [&]()
+                {
+                    auto input = float_interleaved.cbegin();
+                    return playback.mmap_write_interleaved<ratl::sample<ratl::int16_t>>(
+                        [&](auto span)
+                        {
+                            auto input_end = input + static_cast<std::ptrdiff_t>(span.frames());
+                            ratl::transform(input, input_end, span.begin(), dither_gen);
+                            input = input_end;
+                        });
+                }))
+        {
+            return -1;
+        }
+    }
+
+    {
+        ratl::example::alsa::alsa_capture capture(device);
+        if (!configure(capture, SND_PCM_ACCESS_RW_INTERLEAVED, channels, rate))
+        {
+            return -1;
+        }
+        ratl::interleaved<ratl::int16_t> int_interleaved(channels, capture.period_size());
+        ratl::interleaved<ratl::float32_t> float_interleaved(channels, capture.period_size());
+        if (!time_periods(
+                "capture copy",
+                periods,
+                [&]()
+                {
+                    auto result = capture.read_interleaved(int_interleaved);
+                    ratl::transform(int_interleaved.begin(), int_interleaved.end(), float_interleaved.begin());
+                    return result;
+                }))
+        {
+            return -1;
+        }
+    }
+
+    {
+        ratl::example::alsa::alsa_capture capture(device);
+        if (!configure(capture, SND_PCM_ACCESS_MMAP_INTERLEAVED, channels, rate))
+        {
+            return -1;
+        }
+        ratl::interleaved<ratl::float32_t> float_interleaved(channels, capture.period_size());
+        if (!time_periods(
+                "capture mmap",
+                periods,
+                [&]()
+                {
+                    auto output = float_interleaved.begin();
+                    return capture.mmap_read_interleaved<ratl::sample<ratl::int16_t>>(
+                        [&](auto span)
+                        {
+                            output = ratl::transform(span.begin(), span.end(), output);
+                        });
+                }))
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
@@ -9,6 +9,7 @@
 #include "alsa_playback.hpp"
 
 // other includes
+#include <cerrno>
 #include <stdexcept>
 
 namespace ratl
@@ -22,12 +23,17 @@ result::operator bool() const
     return result_ == 0;
 }
 
+int result::code() const
+{
+    return result_;
+}
+
 const char* result::c_str() const
 {
     return result_ != 0 ? snd_strerror(result_) : nullptr;
 }
 
-optional_result<snd_pcm_access_t> alsa_playback::hardware_params::get_access()
+optional_result<snd_pcm_access_t> alsa_pcm::hardware_params::get_access()
 {
     snd_pcm_access_t access;
     auto res = snd_pcm_hw_params_get_access(pcm_hw_params_.get(), &access);
@@ -38,12 +44,12 @@ optional_result<snd_pcm_access_t> alsa_playback::hardware_params::get_access()
     return {optional_result<snd_pcm_access_t>::success{}, access};
 }
 
-result alsa_playback::hardware_params::set_access(snd_pcm_access_t access)
+result alsa_pcm::hardware_params::set_access(snd_pcm_access_t access)
 {
     return result(snd_pcm_hw_params_set_access(&pcm_handle_.get(), pcm_hw_params_.get(), access));
 }
 
-optional_result<snd_pcm_format_t> alsa_playback::hardware_params::get_format()
+optional_result<snd_pcm_format_t> alsa_pcm::hardware_params::get_format()
 {
     snd_pcm_format_t format;
     auto res = snd_pcm_hw_params_get_format(pcm_hw_params_.get(), &format);
@@ -54,12 +60,12 @@ optional_result<snd_pcm_format_t> alsa_playback::hardware_params::get_format()
     return {optional_result<snd_pcm_format_t>::success{}, format};
 }
 
-result alsa_playback::hardware_params::set_format(snd_pcm_format_t format)
+result alsa_pcm::hardware_params::set_format(snd_pcm_format_t format)
 {
     return result(snd_pcm_hw_params_set_format(&pcm_handle_.get(), pcm_hw_params_.get(), format));
 }
 
-optional_result<std::size_t> alsa_playback::hardware_params::get_channels()
+optional_result<std::size_t> alsa_pcm::hardware_params::get_channels()
 {
     unsigned int channels;
     auto res = snd_pcm_hw_params_get_channels(pcm_hw_params_.get(), &channels);
@@ -70,13 +76,13 @@ optional_result<std::size_t> alsa_playback::hardware_params::get_channels()
     return {optional_result<std::size_t>::success{}, static_cast<std::size_t>(channels)};
 }
 
-result alsa_playback::hardware_params::set_channels(std::size_t channels)
+result alsa_pcm::hardware_params::set_channels(std::size_t channels)
 {
     return result(
         snd_pcm_hw_params_set_channels(&pcm_handle_.get(), pcm_hw_params_.get(), static_cast<unsigned int>(channels)));
 }
 
-optional_result<std::size_t> alsa_playback::hardware_params::get_rate()
+optional_result<std::size_t> alsa_pcm::hardware_params::get_rate()
 {
     unsigned int rate;
     auto res = snd_pcm_hw_params_get_rate(pcm_hw_params_.get(), &rate, nullptr);
@@ -87,12 +93,12 @@ optional_result<std::size_t> alsa_playback::hardware_params::get_rate()
     return {optional_result<std::size_t>::success{}, static_cast<std::size_t>(rate)};
 }
 
-result alsa_playback::hardware_params::set_rate(std::size_t rate)
+result alsa_pcm::hardware_params::set_rate(std::size_t rate)
 {
     return result(snd_pcm_hw_params_set_rate(&pcm_handle_.get(), pcm_hw_params_.get(), rate, 0));
 }
 
-optional_result<std::size_t> alsa_playback::hardware_params::get_period_time()
+optional_result<std::size_t> alsa_pcm::hardware_params::get_period_time()
 {
     unsigned int period_time;
     auto res = snd_pcm_hw_params_get_period_time(pcm_hw_params_.get(), &period_time, nullptr);
@@ -103,13 +109,13 @@ optional_result<std::size_t> alsa_playback::hardware_params::get_period_time()
     return {optional_result<std::size_t>::success{}, static_cast<std::size_t>(period_time)};
 }
 
-result alsa_playback::hardware_params::set_period_time(std::size_t period_time)
+result alsa_pcm::hardware_params::set_period_time(std::size_t period_time)
 {
     return result(snd_pcm_hw_params_set_period_time(
         &pcm_handle_.get(), pcm_hw_params_.get(), static_cast<unsigned int>(period_time), 0));
 }
 
-optional_result<std::size_t> alsa_playback::hardware_params::get_period_size()
+optional_result<std::size_t> alsa_pcm::hardware_params::get_period_size()
 {
     snd_pcm_uframes_t period_size;
     auto res = snd_pcm_hw_params_get_period_size(pcm_hw_params_.get(), &period_size, nullptr);
@@ -120,23 +126,23 @@ optional_result<std::size_t> alsa_playback::hardware_params::get_period_size()
     return {optional_result<std::size_t>::success{}, static_cast<std::size_t>(period_size)};
 }
 
-result alsa_playback::hardware_params::set_period_size(std::size_t period_size)
+result alsa_pcm::hardware_params::set_period_size(std::size_t period_size)
 {
     return result(snd_pcm_hw_params_set_period_size(
         &pcm_handle_.get(), pcm_hw_params_.get(), static_cast<snd_pcm_uframes_t>(period_size), 0));
 }
 
-alsa_playback::hardware_params::hardware_params(pcm_ptr& pcm) :
+alsa_pcm::hardware_params::hardware_params(pcm_ptr& pcm) :
     pcm_handle_(*pcm), pcm_hw_params_(make_hardware_params_ptr(pcm_handle_))
 {
 }
 
-snd_pcm_hw_params_t* alsa_playback::hardware_params::get()
+snd_pcm_hw_params_t* alsa_pcm::hardware_params::get()
 {
     return pcm_hw_params_.get();
 }
 
-alsa_playback::hardware_params::pcm_hw_params_ptr alsa_playback::hardware_params::make_hardware_params_ptr(
+alsa_pcm::hardware_params::pcm_hw_params_ptr alsa_pcm::hardware_params::make_hardware_params_ptr(
     std::reference_wrapper<snd_pcm_t> pcm)
 {
     snd_pcm_hw_params_t* pcm_hw_params;
@@ -159,22 +165,53 @@ alsa_playback::hardware_params::pcm_hw_params_ptr alsa_playback::hardware_params
         }};
 }
 
-alsa_playback::alsa_playback(const std::string& device_name) : pcm_handle_(make_pcm_ptr(device_name)) {}
+alsa_pcm::alsa_pcm(const std::string& device_name, snd_pcm_stream_t stream) :
+    pcm_handle_(make_pcm_ptr(device_name, stream))
+{
+}
 
-alsa_playback::hardware_params alsa_playback::construct_hardware_params()
+alsa_pcm::hardware_params alsa_pcm::construct_hardware_params()
 {
     return hardware_params(pcm_handle_);
 }
 
-result alsa_playback::write_hardware_params(hardware_params& params)
+result alsa_pcm::write_hardware_params(hardware_params& params)
 {
-    return result(snd_pcm_hw_params(pcm_handle_.get(), params.get()));
+    auto res = result(snd_pcm_hw_params(pcm_handle_.get(), params.get()));
+    if (!res)
+    {
+        return res;
+    }
+
+    // keep hold of the period geometry for the mmap transfers
+    auto channels = params.get_channels();
+    if (!channels)
+    {
+        return result(-EINVAL);
+    }
+    auto period_size = params.get_period_size();
+    if (!period_size)
+    {
+        return result(-EINVAL);
+    }
+    channels_ = *channels;
+    period_size_ = *period_size;
+    return res;
 }
 
-alsa_playback::pcm_ptr alsa_playback::make_pcm_ptr(const std::string& device_name)
+result alsa_pcm::recover(long error)
+{
+    if (error == -EPIPE)
+    {
+        ++xruns_;
+    }
+    return result(snd_pcm_recover(pcm_handle_.get(), static_cast<int>(error), 1));
+}
+
+alsa_pcm::pcm_ptr alsa_pcm::make_pcm_ptr(const std::string& device_name, snd_pcm_stream_t stream)
 {
     snd_pcm_t* pcm;
-    auto result = snd_pcm_open(&pcm, device_name.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
+    auto result = snd_pcm_open(&pcm, device_name.c_str(), stream, 0);
     if (result < 0)
     {
         throw std::runtime_error(std::string() + "Can't open " + device_name + " PCM device: " + snd_strerror(result));
@@ -183,11 +220,23 @@ alsa_playback::pcm_ptr alsa_playback::make_pcm_ptr(const std::string& device_nam
         pcm,
         [](snd_pcm_t* pcm)
         {
-            snd_pcm_drain(pcm);
+            // pending playback frames are played out, pending capture frames are thrown away
+            if (snd_pcm_stream(pcm) == SND_PCM_STREAM_PLAYBACK)
+            {
+                snd_pcm_drain(pcm);
+            }
+            else
+            {
+                snd_pcm_drop(pcm);
+            }
             snd_pcm_close(pcm);
         }};
 }
 
+alsa_playback::alsa_playback(const std::string& device_name) : alsa_pcm(device_name, SND_PCM_STREAM_PLAYBACK) {}
+
+alsa_capture::alsa_capture(const std::string& device_name) : alsa_pcm(device_name, SND_PCM_STREAM_CAPTURE) {}
+
 } // namespace alsa
 } // namespace example
 } // namespace ratl
\ No newline at end of file
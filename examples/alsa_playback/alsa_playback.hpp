@@ -8,8 +8,15 @@
 #ifndef _ratl_example_alsa_playback_
 #define _ratl_example_alsa_playback_
 
+// ratl includes
+#include <ratl/ratl.hpp>
+
 // other includes
 #include <alsa/asoundlib.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -31,6 +38,8 @@ public:
 
     operator bool() const;
 
+    int code() const;
+
     const char* c_str() const;
 };
 
@@ -86,11 +95,85 @@ public:
     }
 };
 
-class alsa_playback
+// Builds spans over the channel areas handed out by snd_pcm_mmap_begin, so samples can be transformed straight into
+// (or out of) the DMA buffer. The areas must describe the layout the span expects, otherwise -EINVAL is returned.
+template<typename SampleType>
+class mmap_areas
 {
+    const snd_pcm_channel_area_t* areas_;
+    std::size_t channels_;
+    snd_pcm_uframes_t offset_;
+    snd_pcm_uframes_t frames_;
+
+public:
+    using sample_type = SampleType;
+    using sample_traits = detail::sample_traits<sample_type>;
+    using interleaved_span_type = basic_interleaved_span<sample_type, sample_traits>;
+    using noninterleaved_span_type = basic_noninterleaved_span<sample_type, sample_traits>;
+
+    mmap_areas(
+        const snd_pcm_channel_area_t* areas, std::size_t channels, snd_pcm_uframes_t offset, snd_pcm_uframes_t frames) :
+        areas_(areas), channels_(channels), offset_(offset), frames_(frames)
+    {
+    }
+
+    optional_result<interleaved_span_type> interleaved() const
+    {
+        static constexpr auto sample_bits = sizeof(sample_type) * 8;
+        for (std::size_t channel_num = 0; channel_num < channels_; ++channel_num)
+        {
+            const auto& area = areas_[channel_num];
+            if (area.addr != areas_[0].addr || area.first != areas_[0].first + (channel_num * sample_bits) ||
+                area.step != channels_ * sample_bits)
+            {
+                return {typename optional_result<interleaved_span_type>::fail{}, -EINVAL};
+            }
+        }
+        return {
+            typename optional_result<interleaved_span_type>::success{},
+            interleaved_span_type(channel_data(0), channels_, static_cast<std::size_t>(frames_))};
+    }
+
+    optional_result<noninterleaved_span_type> noninterleaved() const
+    {
+        static constexpr auto sample_bits = sizeof(sample_type) * 8;
+        auto pitch = static_cast<std::size_t>(frames_);
+        if (channels_ > 1)
+        {
+            pitch = static_cast<std::size_t>(channel_data(1) - channel_data(0));
+        }
+        for (std::size_t channel_num = 0; channel_num < channels_; ++channel_num)
+        {
+            if (areas_[channel_num].step != sample_bits ||
+                channel_data(channel_num) != channel_data(0) + (channel_num * pitch))
+            {
+                return {typename optional_result<noninterleaved_span_type>::fail{}, -EINVAL};
+            }
+        }
+        return {
+            typename optional_result<noninterleaved_span_type>::success{},
+            noninterleaved_span_type(channel_data(0), channels_, static_cast<std::size_t>(frames_), pitch)};
+    }
+
+private:
+    sample_type* channel_data(std::size_t channel_num) const
+    {
+        const auto& area = areas_[channel_num];
+        return reinterpret_cast<sample_type*>(
+            static_cast<char*>(area.addr) + (area.first / 8) + (offset_ * (area.step / 8)));
+    }
+};
+
+// Common parts of playback and capture PCMs
+class alsa_pcm
+{
+protected:
     using pcm_ptr = std::unique_ptr<snd_pcm_t, void (*)(snd_pcm_t*)>;
 
     pcm_ptr pcm_handle_;
+    std::size_t channels_{};
+    std::size_t period_size_{};
+    std::size_t xruns_{};
 
 public:
     class hardware_params
@@ -120,7 +203,7 @@ public:
         result set_period_size(std::size_t period_size);
 
     private:
-        friend alsa_playback;
+        friend alsa_pcm;
         explicit hardware_params(pcm_ptr& pcm);
 
         snd_pcm_hw_params_t* get();
@@ -128,32 +211,276 @@ public:
         static pcm_hw_params_ptr make_hardware_params_ptr(std::reference_wrapper<snd_pcm_t> pcm);
     };
 
-    explicit alsa_playback(const std::string& device_name);
-
     hardware_params construct_hardware_params();
     result write_hardware_params(hardware_params& params);
 
+    std::size_t channels() const
+    {
+        return channels_;
+    }
+
+    std::size_t period_size() const
+    {
+        return period_size_;
+    }
+
+    // Number of underruns or overruns that have been recovered from
+    std::size_t xruns() const
+    {
+        return xruns_;
+    }
+
+    snd_pcm_t* get()
+    {
+        return pcm_handle_.get();
+    }
+
+protected:
+    alsa_pcm(const std::string& device_name, snd_pcm_stream_t stream);
+
+    // Restarts the stream after an xrun or a suspend, any other error is returned
+    result recover(long error);
+
+    // Waits until a period can be transferred through the mmap buffer, then calls transfer_function with the
+    // mmap_areas of each contiguous part of the period. The buffer can wrap in the middle of a period, so
+    // transfer_function can be called more than once.
+    template<typename SampleType, typename Fn>
+    result mmap_transfer_period(Fn transfer_function)
+    {
+        auto pcm = pcm_handle_.get();
+        auto remaining = static_cast<snd_pcm_uframes_t>(period_size_);
+        while (remaining > 0)
+        {
+            auto avail = snd_pcm_avail_update(pcm);
+            if (avail < 0)
+            {
+                auto res = recover(avail);
+                if (!res)
+                {
+                    return res;
+                }
+                continue;
+            }
+            if (static_cast<snd_pcm_uframes_t>(avail) < remaining)
+            {
+                // capture has to be started explicitly, and playback is started early when the buffer can't take
+                // the whole period before the start threshold is reached
+                if (snd_pcm_state(pcm) == SND_PCM_STATE_PREPARED)
+                {
+                    auto res = snd_pcm_start(pcm);
+                    if (res < 0)
+                    {
+                        return result(res);
+                    }
+                    continue;
+                }
+                auto res = snd_pcm_wait(pcm, -1);
+                if (res < 0)
+                {
+                    auto recovered = recover(res);
+                    if (!recovered)
+                    {
+                        return recovered;
+                    }
+                }
+                continue;
+            }
+
+            const snd_pcm_channel_area_t* areas;
+            snd_pcm_uframes_t offset;
+            auto frames = remaining;
+            auto res = snd_pcm_mmap_begin(pcm, &areas, &offset, &frames);
+            if (res < 0)
+            {
+                auto recovered = recover(res);
+                if (!recovered)
+                {
+                    return recovered;
+                }
+                continue;
+            }
+
+            auto transfer_result = transfer_function(mmap_areas<SampleType>(areas, channels_, offset, frames));
+            if (!transfer_result)
+            {
+                snd_pcm_mmap_commit(pcm, offset, 0);
+                return transfer_result;
+            }
+
+            auto committed = snd_pcm_mmap_commit(pcm, offset, frames);
+            if (committed < 0 || static_cast<snd_pcm_uframes_t>(committed) != frames)
+            {
+                auto recovered = recover(committed >= 0 ? -EPIPE : committed);
+                if (!recovered)
+                {
+                    return recovered;
+                }
+                continue;
+            }
+            remaining -= frames;
+        }
+        return result();
+    }
+
+private:
+    static pcm_ptr make_pcm_ptr(const std::string& device_name, snd_pcm_stream_t stream);
+};
+
+class alsa_playback : public alsa_pcm
+{
+public:
+    explicit alsa_playback(const std::string& device_name);
+
+    // Copies a whole buffer of interleaved samples into the PCM with snd_pcm_writei
+    template<typename Interleaved>
+    result write_interleaved(const Interleaved& interleaved)
+    {
+        auto data = interleaved.data();
+        auto frames = static_cast<snd_pcm_uframes_t>(interleaved.frames());
+        while (frames > 0)
+        {
+            auto res = snd_pcm_writei(pcm_handle_.get(), data, frames);
+            if (res < 0)
+            {
+                auto recovered = recover(res);
+                if (!recovered)
+                {
+                    return recovered;
+                }
+                continue;
+            }
+            data += static_cast<std::size_t>(res) * interleaved.channels();
+            frames -= static_cast<snd_pcm_uframes_t>(res);
+        }
+        return result();
+    }
+
     template<typename Fn>
     result write_interleaved_loop(Fn write_function)
     {
         while (true)
         {
-            const auto& interleaved = write_function();
-            auto res = snd_pcm_writei(
-                pcm_handle_.get(), interleaved.data(), static_cast<snd_pcm_uframes_t>(interleaved.frames()));
-            if (res == -EPIPE)
+            auto res = write_interleaved(write_function());
+            if (!res)
             {
-                snd_pcm_prepare(pcm_handle_.get());
+                return res;
             }
-            else if (res < 0)
+        }
+    }
+
+    // Writes a period straight into the mmap buffer, which must use SND_PCM_ACCESS_MMAP_INTERLEAVED.
+    // write_function is called with an interleaved span of SampleType over each part of the period and must fill
+    // every frame of it.
+    template<typename SampleType, typename Fn>
+    result mmap_write_interleaved(Fn write_function)
+    {
+        return mmap_transfer_period<SampleType>(
+            [&](const mmap_areas<SampleType>& areas)
             {
-                return result(res);
+                auto span = areas.interleaved();
+                if (!span)
+                {
+                    return result(-EINVAL);
+                }
+                write_function(*span);
+                return result();
+            });
+    }
+
+    // As mmap_write_interleaved, for SND_PCM_ACCESS_MMAP_NONINTERLEAVED buffers
+    template<typename SampleType, typename Fn>
+    result mmap_write_noninterleaved(Fn write_function)
+    {
+        return mmap_transfer_period<SampleType>(
+            [&](const mmap_areas<SampleType>& areas)
+            {
+                auto span = areas.noninterleaved();
+                if (!span)
+                {
+                    return result(-EINVAL);
+                }
+                write_function(*span);
+                return result();
+            });
+    }
+
+    template<typename SampleType, typename Fn>
+    result mmap_write_interleaved_loop(Fn write_function)
+    {
+        while (true)
+        {
+            auto res = mmap_write_interleaved<SampleType>(std::ref(write_function));
+            if (!res)
+            {
+                return res;
             }
         }
     }
+};
 
-private:
-    static pcm_ptr make_pcm_ptr(const std::string& device_name);
+class alsa_capture : public alsa_pcm
+{
+public:
+    explicit alsa_capture(const std::string& device_name);
+
+    // Copies a whole buffer of interleaved samples out of the PCM with snd_pcm_readi
+    template<typename Interleaved>
+    result read_interleaved(Interleaved& interleaved)
+    {
+        auto data = interleaved.data();
+        auto frames = static_cast<snd_pcm_uframes_t>(interleaved.frames());
+        while (frames > 0)
+        {
+            auto res = snd_pcm_readi(pcm_handle_.get(), data, frames);
+            if (res < 0)
+            {
+                auto recovered = recover(res);
+                if (!recovered)
+                {
+                    return recovered;
+                }
+                continue;
+            }
+            data += static_cast<std::size_t>(res) * interleaved.channels();
+            frames -= static_cast<snd_pcm_uframes_t>(res);
+        }
+        return result();
+    }
+
+    // Reads a period straight out of the mmap buffer, which must use SND_PCM_ACCESS_MMAP_INTERLEAVED.
+    // read_function is called with an interleaved span of SampleType over each part of the period.
+    template<typename SampleType, typename Fn>
+    result mmap_read_interleaved(Fn read_function)
+    {
+        return mmap_transfer_period<SampleType>(
+            [&](const mmap_areas<SampleType>& areas)
+            {
+                auto span = areas.interleaved();
+                if (!span)
+                {
+                    return result(-EINVAL);
+                }
+                read_function(*span);
+                return result();
+            });
+    }
+
+    // As mmap_read_interleaved, for SND_PCM_ACCESS_MMAP_NONINTERLEAVED buffers
+    template<typename SampleType, typename Fn>
+    result mmap_read_noninterleaved(Fn read_function)
+    {
+        return mmap_transfer_period<SampleType>(
+            [&](const mmap_areas<SampleType>& areas)
+            {
+                auto span = areas.noninterleaved();
+                if (!span)
+                {
+                    return result(-EINVAL);
+                }
+                read_function(*span);
+                return result();
+            });
+    }
 };
 
 } // namespace alsa
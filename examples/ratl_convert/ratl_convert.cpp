@@ -0,0 +1,875 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl includes
+#include "ratl_convert.hpp"
+
+#include <ratl/ratl.hpp>
+
+// other includes
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ratl
+{
+namespace example
+{
+namespace convert
+{
+#if defined(RATL_CPP_BIG_ENDIAN)
+static constexpr bool host_big_endian = true;
+#else
+static constexpr bool host_big_endian = false;
+#endif
+
+// Headers are padded so the sample data starts on a page boundary, like wav_writer's
+static constexpr std::size_t header_size = detail::wav_writer_header_size;
+
+static std::size_t parse_size(const std::string& value, const std::string& format)
+{
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos || value.size() > 9)
+    {
+        throw std::invalid_argument("invalid format '" + format + "'");
+    }
+    return static_cast<std::size_t>(std::stoul(value));
+}
+
+raw_format parse_raw_format(const std::string& format)
+{
+    raw_format result;
+    auto fields_start = format.find(':');
+    auto name = format.substr(0, fields_start);
+    if (name.size() == 5 || name.size() == 3)
+    {
+        auto type = name.substr(0, 3);
+        if (type == "s16")
+        {
+            result.format = sample_format::int16;
+        }
+        else if (type == "s24")
+        {
+            result.format = sample_format::int24;
+        }
+        else if (type == "s32")
+        {
+            result.format = sample_format::int32;
+        }
+        else if (type == "f32")
+        {
+            result.format = sample_format::float32;
+        }
+        else
+        {
+            throw std::invalid_argument("invalid format '" + format + "'");
+        }
+
+        if (name.size() == 5)
+        {
+            auto order = name.substr(3);
+            if (order != "le" && order != "be")
+            {
+                throw std::invalid_argument("invalid format '" + format + "'");
+            }
+            result.big_endian = order == "be";
+            result.byte_order_set = true;
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("invalid format '" + format + "'");
+    }
+
+    if (fields_start != std::string::npos)
+    {
+        auto rate_start = format.find(':', fields_start + 1);
+        result.channels = parse_size(format.substr(fields_start + 1, rate_start - fields_start - 1), format);
+        if (result.channels == 0)
+        {
+            throw std::invalid_argument("invalid format '" + format + "', it has no channels");
+        }
+        if (rate_start != std::string::npos)
+        {
+            result.sample_rate = parse_size(format.substr(rate_start + 1), format);
+        }
+    }
+    return result;
+}
+
+std::string format_name(sample_format format, bool big_endian)
+{
+    static const char* const names[] = {"s16", "s24", "s32", "f32"};
+    return std::string(names[static_cast<int>(format)]) + (big_endian ? "be" : "le");
+}
+
+std::size_t sample_bytes(sample_format format) noexcept
+{
+    switch (format)
+    {
+    case sample_format::int16:
+        return 2;
+    case sample_format::int24:
+        return 3;
+    case sample_format::int32:
+    case sample_format::float32:
+        break;
+    }
+    return 4;
+}
+
+std::uint32_t chunk_dither_seed(std::uint32_t seed, std::uint64_t chunk_num) noexcept
+{
+    // splitmix64, so that neighbouring chunks get unrelated dither
+    auto state = ((static_cast<std::uint64_t>(seed) << 32) ^ chunk_num) + 0x9e3779b97f4a7c15;
+    state = (state ^ (state >> 30)) * 0xbf58476d1ce4e5b9;
+    state = (state ^ (state >> 27)) * 0x94d049bb133111eb;
+    return static_cast<std::uint32_t>(state ^ (state >> 31));
+}
+
+file_type file_type_for_path(const std::string& path)
+{
+    auto dot = path.rfind('.');
+    if (dot == std::string::npos || path.find('/', dot) != std::string::npos)
+    {
+        return file_type::raw;
+    }
+    auto extension = path.substr(dot + 1);
+    std::transform(
+        extension.begin(),
+        extension.end(),
+        extension.begin(),
+        [](char c) { return static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c); });
+    if (extension == "wav" || extension == "rf64" || extension == "bw64")
+    {
+        return file_type::wav;
+    }
+    if (extension == "aif" || extension == "aiff" || extension == "aifc")
+    {
+        return file_type::aiff;
+    }
+    return file_type::raw;
+}
+
+// The memory mapped input, whichever container it is in
+class input_file
+{
+private:
+    std::unique_ptr<wav_file> wav_;
+    std::unique_ptr<aiff_file> aiff_;
+    std::unique_ptr<caf_file> caf_;
+    // whichever of aiff_ and caf_ is open
+    const detail::mapped_sample_file* sample_file_ = nullptr;
+    std::unique_ptr<detail::mapped_file> raw_;
+    std::uint64_t raw_offset_ = 0;
+    const unsigned char* data_ = nullptr;
+    raw_format format_;
+    std::uint64_t frames_ = 0;
+    std::size_t frame_bytes_ = 0;
+
+public:
+    explicit input_file(const convert_config& config)
+    {
+        if (config.raw_input)
+        {
+            open_raw(config);
+        }
+        else
+        {
+            open_container(config.input_path);
+        }
+        frame_bytes_ = format_.channels * sample_bytes(format_.format);
+    }
+
+    const raw_format& format() const noexcept
+    {
+        return format_;
+    }
+
+    std::uint64_t frames() const noexcept
+    {
+        return frames_;
+    }
+
+    std::size_t frame_bytes() const noexcept
+    {
+        return frame_bytes_;
+    }
+
+    const unsigned char* frame(std::uint64_t frame_num) const noexcept
+    {
+        return data_ + (frame_num * frame_bytes_);
+    }
+
+    void will_need(std::uint64_t first_frame, std::size_t frames) const noexcept
+    {
+        if (wav_)
+        {
+            wav_->will_need(static_cast<std::size_t>(first_frame), frames);
+        }
+        else if (sample_file_ != nullptr)
+        {
+            sample_file_->will_need(static_cast<std::size_t>(first_frame), frames);
+        }
+        else
+        {
+            raw_->advise_will_need(
+                static_cast<std::size_t>(raw_offset_ + (first_frame * frame_bytes_)), frames * frame_bytes_);
+        }
+    }
+
+    void dont_need(std::uint64_t first_frame, std::size_t frames) const noexcept
+    {
+        if (wav_)
+        {
+            wav_->dont_need(static_cast<std::size_t>(first_frame), frames);
+        }
+        else if (sample_file_ != nullptr)
+        {
+            sample_file_->dont_need(static_cast<std::size_t>(first_frame), frames);
+        }
+        else
+        {
+            raw_->advise_dont_need(
+                static_cast<std::size_t>(raw_offset_ + (first_frame * frame_bytes_)), frames * frame_bytes_);
+        }
+    }
+
+private:
+    void open_raw(const convert_config& config)
+    {
+        format_ = config.raw_input_format;
+        if (format_.channels == 0)
+        {
+            throw std::invalid_argument("the raw input format must give the number of channels");
+        }
+        raw_.reset(new detail::mapped_file(config.input_path));
+        if (config.raw_input_offset > raw_->size())
+        {
+            throw std::invalid_argument("the raw input offset is past the end of the input");
+        }
+        if (config.raw_input_offset % sample_bytes(format_.format) != 0 && format_.format != sample_format::int24)
+        {
+            throw std::invalid_argument("the raw input offset isn't aligned for its samples");
+        }
+        raw_offset_ = config.raw_input_offset;
+        raw_->advise_sequential();
+        data_ = raw_->data() + raw_offset_;
+        frames_ = (raw_->size() - raw_offset_) / (format_.channels * sample_bytes(format_.format));
+    }
+
+    void open_container(const std::string& path)
+    {
+        unsigned char magic[4] = {};
+        auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        auto magic_bytes = ::pread(fd, magic, sizeof(magic), 0);
+        ::close(fd);
+
+        auto is = [&magic, magic_bytes](const char* id)
+        { return magic_bytes == sizeof(magic) && detail::chunk_id_equals(magic, id); };
+        if (is("RIFF") || is("RF64") || is("BW64"))
+        {
+            wav_.reset(new wav_file(path));
+            set_format(*wav_, false);
+            data_ = find_data(*wav_);
+        }
+        else if (is("FORM") || is("caff"))
+        {
+            if (is("FORM"))
+            {
+                aiff_.reset(new aiff_file(path));
+                sample_file_ = aiff_.get();
+            }
+            else
+            {
+                caf_.reset(new caf_file(path));
+                sample_file_ = caf_.get();
+            }
+            set_format(*sample_file_, sample_file_->is_big_endian());
+            data_ = find_data(*sample_file_);
+        }
+        else
+        {
+            throw std::runtime_error(path + " isn't a WAV, RF64, AIFF or CAF file, give --input-format for raw input");
+        }
+    }
+
+    template<typename File>
+    void set_format(const File& file, bool big_endian)
+    {
+        if (file.is_float())
+        {
+            format_.format = sample_format::float32;
+        }
+        else if (file.bits_per_sample() == 16)
+        {
+            format_.format = sample_format::int16;
+        }
+        else if (file.bits_per_sample() == 24)
+        {
+            format_.format = sample_format::int24;
+        }
+        else if (file.bits_per_sample() == 32)
+        {
+            format_.format = sample_format::int32;
+        }
+        else
+        {
+            throw std::runtime_error("only 16, 24 and 32 bit integer and 32 bit float samples are supported");
+        }
+        format_.big_endian = big_endian;
+        format_.byte_order_set = true;
+        format_.channels = file.channels();
+        format_.sample_rate = file.sample_rate();
+        frames_ = file.frames();
+    }
+
+    template<typename SampleValueType>
+    static const unsigned char* sample_data(const wav_file& file)
+    {
+        return reinterpret_cast<const unsigned char*>(file.samples<SampleValueType>().data());
+    }
+
+    template<typename SampleValueType>
+    static const unsigned char* sample_data(const detail::mapped_sample_file& file)
+    {
+        if (file.holds_network<SampleValueType>())
+        {
+            return reinterpret_cast<const unsigned char*>(file.network_samples<SampleValueType>().data());
+        }
+        return reinterpret_cast<const unsigned char*>(file.samples<SampleValueType>().data());
+    }
+
+    // Throws if the samples aren't aligned for their type
+    template<typename File>
+    const unsigned char* find_data(const File& file) const
+    {
+        switch (format_.format)
+        {
+        case sample_format::int16:
+            return sample_data<int16_t>(file);
+        case sample_format::int24:
+            return sample_data<int24_t>(file);
+        case sample_format::int32:
+            return sample_data<int32_t>(file);
+        case sample_format::float32:
+            break;
+        }
+        return sample_data<float32_t>(file);
+    }
+};
+
+// What every thread needs to convert a chunk
+struct chunk_context
+{
+    const input_file* input = nullptr;
+    std::vector<std::size_t> channels;
+    bool select_channels = false;
+    std::uint64_t frames = 0;
+    std::size_t chunk_frames = 0;
+    int output_fd = -1;
+    std::uint64_t output_offset = 0;
+    bool dither = false;
+    std::uint32_t dither_seed = 0;
+};
+
+// Each thread's own buffers, reused for every chunk it converts
+struct chunk_buffers
+{
+    std::vector<unsigned char> gathered;
+    std::vector<unsigned char> output;
+};
+
+using chunk_function = void (*)(const chunk_context&, std::uint64_t, chunk_buffers&);
+
+static void write_at(int fd, const unsigned char* data, std::size_t size, std::uint64_t offset)
+{
+    while (size > 0)
+    {
+        auto written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "write");
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+}
+
+template<typename InputIterator, typename OutputIterator>
+static void convert_samples(
+    const chunk_context& context,
+    std::uint64_t chunk_num,
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result)
+{
+    if (context.dither)
+    {
+        dither_generator dither_gen(chunk_dither_seed(context.dither_seed, chunk_num));
+        transform(first, last, result, dither_gen);
+    }
+    else
+    {
+        transform(first, last, result);
+    }
+}
+
+template<typename InputSample, typename OutputSample, bool Noninterleaved>
+static void convert_chunk(const chunk_context& context, std::uint64_t chunk_num, chunk_buffers& buffers)
+{
+    using input_span = basic_interleaved_span<
+        typename detail::sample_traits<InputSample>::const_sample_type,
+        detail::const_sample_traits_t<detail::sample_traits<InputSample>>>;
+    using interleaved_output_span = basic_interleaved_span<OutputSample, detail::sample_traits<OutputSample>>;
+    using noninterleaved_output_span = basic_noninterleaved_span<OutputSample, detail::sample_traits<OutputSample>>;
+
+    auto first_frame = chunk_num * context.chunk_frames;
+    auto frames = static_cast<std::size_t>(std::min<std::uint64_t>(context.chunk_frames, context.frames - first_frame));
+    const auto& input = *context.input;
+    auto input_channels = input.format().channels;
+    auto output_channels = context.channels.size();
+    const auto* input_data = input.frame(first_frame);
+
+    // the selected channels are gathered into a buffer of their own, still in the input's format
+    if (context.select_channels)
+    {
+        buffers.gathered.resize(frames * output_channels * sizeof(InputSample));
+        auto* gathered = buffers.gathered.data();
+        for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+        {
+            const auto* input_frame = input_data + (frame_num * input_channels * sizeof(InputSample));
+            for (auto channel_num : context.channels)
+            {
+                std::memcpy(gathered, input_frame + (channel_num * sizeof(InputSample)), sizeof(InputSample));
+                gathered += sizeof(InputSample);
+            }
+        }
+        input_data = buffers.gathered.data();
+    }
+
+    auto input_samples = input_span(input_data, output_channels, frames);
+    buffers.output.resize(frames * output_channels * sizeof(OutputSample));
+    auto* output_data = buffers.output.data();
+    if (Noninterleaved)
+    {
+        auto output = noninterleaved_output_span(output_data, output_channels, frames);
+        convert_samples(context, chunk_num, input_samples.begin(), input_samples.end(), output.begin());
+
+        // each channel is written to its own run of the file
+        auto channel_bytes = frames * sizeof(OutputSample);
+        for (std::size_t channel_num = 0; channel_num < output_channels; ++channel_num)
+        {
+            auto offset = ((channel_num * context.frames) + first_frame) * sizeof(OutputSample);
+            write_at(
+                context.output_fd,
+                output_data + (channel_num * channel_bytes),
+                channel_bytes,
+                context.output_offset + offset);
+        }
+    }
+    else
+    {
+        auto output = interleaved_output_span(output_data, output_channels, frames);
+        convert_samples(context, chunk_num, input_samples.begin(), input_samples.end(), output.begin());
+        write_at(
+            context.output_fd,
+            output_data,
+            buffers.output.size(),
+            context.output_offset + (first_frame * output_channels * sizeof(OutputSample)));
+    }
+}
+
+// Samples in either byte order can be read and written on any host, except little endian samples on a big endian host
+template<typename SampleValueType, typename Result>
+static Result with_byte_order(bool big_endian, Result host, Result network)
+{
+    if (big_endian == host_big_endian)
+    {
+        return host;
+    }
+    if (!big_endian)
+    {
+        throw std::runtime_error("little endian samples aren't supported on big endian hosts");
+    }
+    return network;
+}
+
+template<typename InputSample, typename OutputSample>
+static chunk_function select_layout(bool noninterleaved)
+{
+    return noninterleaved ? &convert_chunk<InputSample, OutputSample, true>
+                          : &convert_chunk<InputSample, OutputSample, false>;
+}
+
+template<typename InputSample, typename OutputSampleValueType>
+static chunk_function select_output_order(const raw_format& output, bool noninterleaved)
+{
+    return with_byte_order<OutputSampleValueType>(
+        output.big_endian,
+        select_layout<InputSample, sample<OutputSampleValueType>>(noninterleaved),
+        select_layout<InputSample, network_sample<OutputSampleValueType>>(noninterleaved));
+}
+
+template<typename InputSample>
+static chunk_function select_output(const raw_format& output, bool noninterleaved)
+{
+    switch (output.format)
+    {
+    case sample_format::int16:
+        return select_output_order<InputSample, int16_t>(output, noninterleaved);
+    case sample_format::int24:
+        return select_output_order<InputSample, int24_t>(output, noninterleaved);
+    case sample_format::int32:
+        return select_output_order<InputSample, int32_t>(output, noninterleaved);
+    case sample_format::float32:
+        break;
+    }
+    return select_output_order<InputSample, float32_t>(output, noninterleaved);
+}
+
+template<typename InputSampleValueType>
+static chunk_function select_input_order(const raw_format& input, const raw_format& output, bool noninterleaved)
+{
+    return with_byte_order<InputSampleValueType>(
+        input.big_endian,
+        select_output<sample<InputSampleValueType>>(output, noninterleaved),
+        select_output<network_sample<InputSampleValueType>>(output, noninterleaved));
+}
+
+// Picks the conversion for a pair of formats, every one of which is instantiated here
+static chunk_function select_chunk_function(const raw_format& input, const raw_format& output, bool noninterleaved)
+{
+    switch (input.format)
+    {
+    case sample_format::int16:
+        return select_input_order<int16_t>(input, output, noninterleaved);
+    case sample_format::int24:
+        return select_input_order<int24_t>(input, output, noninterleaved);
+    case sample_format::int32:
+        return select_input_order<int32_t>(input, output, noninterleaved);
+    case sample_format::float32:
+        break;
+    }
+    return select_input_order<float32_t>(input, output, noninterleaved);
+}
+
+// Writes the big endian 80 bit extended float sample rate of an AIFF COMM chunk
+static void write_extended_sample_rate(unsigned char* data, std::size_t sample_rate) noexcept
+{
+    std::memset(data, 0, 10);
+    if (sample_rate == 0)
+    {
+        return;
+    }
+    auto mantissa = static_cast<std::uint64_t>(sample_rate);
+    auto exponent = 16383 + 63;
+    while ((mantissa & (std::uint64_t(1) << 63)) == 0)
+    {
+        mantissa <<= 1;
+        --exponent;
+    }
+    data[0] = static_cast<unsigned char>(exponent >> 8);
+    data[1] = static_cast<unsigned char>(exponent & 0xff);
+    for (std::size_t byte_num = 0; byte_num < 8; ++byte_num)
+    {
+        data[2 + byte_num] = static_cast<unsigned char>(mantissa >> (56 - (byte_num * 8)));
+    }
+}
+
+static void write_big_endian(unsigned char* data, std::uint64_t value, std::size_t bytes) noexcept
+{
+    for (std::size_t byte_num = 0; byte_num < bytes; ++byte_num)
+    {
+        data[byte_num] = static_cast<unsigned char>(value >> ((bytes - 1 - byte_num) * 8));
+    }
+}
+
+// Fills in an AIFF header, or an AIFC header for float or little endian samples, with an SSND chunk whose samples
+// start at header_size
+static void write_aiff_header(unsigned char* header, const raw_format& format, std::uint64_t frames)
+{
+    auto bytes = sample_bytes(format.format);
+    auto data_bytes = frames * format.channels * bytes;
+    if (frames > 0xffffffff || data_bytes + header_size > 0xfffffff0)
+    {
+        throw std::invalid_argument("the output is too large for an AIFF file, use WAV (RF64) or raw output");
+    }
+    if (format.channels > 0xffff)
+    {
+        throw std::invalid_argument("AIFF files can't hold more than 65535 channels");
+    }
+
+    auto aifc = format.format == sample_format::float32 || !format.big_endian;
+    auto compression = format.format == sample_format::float32 ? "fl32" : "sowt";
+    // pascal strings, padded to an even length
+    static const char float_name[] = "\x15" "32-bit floating point";
+    static const char little_endian_name[] = "\x0d" "little endian";
+    const auto* compression_name = format.format == sample_format::float32 ? float_name : little_endian_name;
+    auto compression_name_bytes = format.format == sample_format::float32 ? sizeof(float_name) - 1
+                                                                          : sizeof(little_endian_name) - 1;
+
+    std::memset(header, 0, header_size);
+    auto* chunk = header;
+    detail::write_chunk_id(chunk, "FORM");
+    write_big_endian(chunk + 4, header_size - 8 + data_bytes + (data_bytes & 1), 4);
+    detail::write_chunk_id(chunk + 8, aifc ? "AIFC" : "AIFF");
+    chunk += 12;
+
+    if (aifc)
+    {
+        detail::write_chunk_id(chunk, "FVER");
+        write_big_endian(chunk + 4, 4, 4);
+        write_big_endian(chunk + 8, 0xa2805140, 4);
+        chunk += 12;
+    }
+
+    auto comm_bytes = aifc ? 22 + compression_name_bytes : 18;
+    detail::write_chunk_id(chunk, "COMM");
+    write_big_endian(chunk + 4, comm_bytes, 4);
+    write_big_endian(chunk + 8, format.channels, 2);
+    write_big_endian(chunk + 10, frames, 4);
+    write_big_endian(chunk + 14, bytes * 8, 2);
+    write_extended_sample_rate(chunk + 16, format.sample_rate);
+    if (aifc)
+    {
+        detail::write_chunk_id(chunk + 26, compression);
+        std::memcpy(chunk + 30, compression_name, compression_name_bytes);
+    }
+    chunk += 8 + comm_bytes;
+
+    // the SSND offset pads the samples out to header_size
+    auto ssnd_offset = static_cast<std::size_t>(header + header_size - (chunk + 16));
+    detail::write_chunk_id(chunk, "SSND");
+    write_big_endian(chunk + 4, 8 + ssnd_offset + data_bytes, 4);
+    write_big_endian(chunk + 8, ssnd_offset, 4);
+}
+
+// Fills in the output format from the input's and checks the output file type can hold it
+static raw_format output_format_for(const convert_config& config, const raw_format& input_format)
+{
+    auto format = config.output_format_set ? config.output_format : input_format;
+    format.channels = config.channels.empty() ? input_format.channels : config.channels.size();
+    format.sample_rate = input_format.sample_rate;
+    auto byte_order_set = config.output_format_set && config.output_format.byte_order_set;
+
+    if (config.output_noninterleaved && config.output_type != file_type::raw)
+    {
+        throw std::invalid_argument("only raw output can be noninterleaved");
+    }
+    switch (config.output_type)
+    {
+    case file_type::wav:
+        if (byte_order_set && format.big_endian)
+        {
+            throw std::invalid_argument("WAV files can't hold big endian samples");
+        }
+        if (format.channels > 0xffff)
+        {
+            throw std::invalid_argument("WAV files can't hold more than 65535 channels");
+        }
+        format.big_endian = false;
+        break;
+    case file_type::aiff:
+        format.big_endian = !byte_order_set || format.big_endian;
+        if (!format.big_endian && format.format == sample_format::float32)
+        {
+            throw std::invalid_argument("AIFF files can't hold little endian float samples");
+        }
+        break;
+    case file_type::raw:
+        format.big_endian = byte_order_set && format.big_endian;
+        break;
+    }
+    format.byte_order_set = true;
+    return format;
+}
+
+convert_stats convert_file(const convert_config& config)
+{
+    if (config.chunk_frames == 0)
+    {
+        throw std::invalid_argument("chunks must have at least one frame");
+    }
+
+    auto start_cpu = detail::process_cpu_seconds();
+    auto start = std::chrono::steady_clock::now();
+
+    input_file input(config);
+    const auto& input_format = input.format();
+    for (auto channel_num : config.channels)
+    {
+        if (channel_num >= input_format.channels)
+        {
+            throw std::invalid_argument(
+                "channel " + std::to_string(channel_num) + " isn't in the input, which has " +
+                std::to_string(input_format.channels) + " channels");
+        }
+    }
+    auto output_format = output_format_for(config, input_format);
+    auto convert = select_chunk_function(input_format, output_format, config.output_noninterleaved);
+
+    chunk_context context;
+    context.input = &input;
+    context.channels = config.channels;
+    if (context.channels.empty())
+    {
+        for (std::size_t channel_num = 0; channel_num < input_format.channels; ++channel_num)
+        {
+            context.channels.push_back(channel_num);
+        }
+    }
+    else
+    {
+        context.select_channels = true;
+    }
+    context.frames = input.frames();
+    context.chunk_frames = config.chunk_frames;
+    context.output_offset = config.output_type == file_type::raw ? 0 : header_size;
+    context.dither = config.dither;
+    context.dither_seed = config.dither_seed;
+
+    // the header and the file's final size are written first, so every chunk can be written straight to its place
+    std::vector<unsigned char> header(header_size);
+    auto output_sample_bytes = sample_bytes(output_format.format);
+    auto data_bytes = context.frames * output_format.channels * output_sample_bytes;
+    if (config.output_type == file_type::wav)
+    {
+        detail::write_wav_writer_header(
+            header.data(),
+            output_format.format == sample_format::float32 ? detail::wav_format_ieee_float : detail::wav_format_pcm,
+            output_format.channels,
+            output_format.sample_rate,
+            output_sample_bytes * 8,
+            false,
+            data_bytes);
+    }
+    else if (config.output_type == file_type::aiff)
+    {
+        write_aiff_header(header.data(), output_format, context.frames);
+    }
+    auto file_bytes = context.output_offset + data_bytes + (context.output_offset != 0 ? data_bytes & 1 : 0);
+
+    context.output_fd = ::open(config.output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (context.output_fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), config.output_path);
+    }
+    struct fd_closer
+    {
+        int fd;
+        ~fd_closer()
+        {
+            ::close(fd);
+        }
+    } output_closer{context.output_fd};
+    if (::ftruncate(context.output_fd, static_cast<off_t>(file_bytes)) != 0)
+    {
+        throw std::system_error(errno, std::generic_category(), config.output_path);
+    }
+    if (context.output_offset != 0)
+    {
+        write_at(context.output_fd, header.data(), header.size(), 0);
+    }
+
+    auto chunks = (context.frames + context.chunk_frames - 1) / context.chunk_frames;
+    auto threads = config.threads != 0 ? config.threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    threads = static_cast<std::size_t>(std::max<std::uint64_t>(std::min<std::uint64_t>(threads, chunks), 1));
+
+    std::atomic<std::uint64_t> next_chunk{0};
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto worker = [&]()
+    {
+        try
+        {
+            chunk_buffers buffers;
+            while (!failed.load(std::memory_order_relaxed))
+            {
+                auto chunk_num = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                if (chunk_num >= chunks)
+                {
+                    break;
+                }
+
+                // the chunk this thread is likely to claim next is read while this one is converted
+                auto ahead = (chunk_num + threads) * context.chunk_frames;
+                if (ahead < context.frames)
+                {
+                    input.will_need(ahead, static_cast<std::size_t>(
+                                               std::min<std::uint64_t>(context.chunk_frames, context.frames - ahead)));
+                }
+                convert(context, chunk_num, buffers);
+                auto first_frame = chunk_num * context.chunk_frames;
+                input.dont_need(first_frame, static_cast<std::size_t>(std::min<std::uint64_t>(
+                                                 context.chunk_frames, context.frames - first_frame)));
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    // the calling thread converts chunks too
+    std::vector<std::thread> pool;
+    for (std::size_t thread_num = 1; thread_num < threads; ++thread_num)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    convert_stats stats;
+    stats.frames = context.frames;
+    stats.input_format = input_format;
+    stats.output_format = output_format;
+    stats.output_type = config.output_type;
+    stats.bytes_read = context.frames * input.frame_bytes();
+    stats.bytes_written = file_bytes;
+    stats.threads = threads;
+    stats.chunks = chunks;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.cpu_seconds = detail::process_cpu_seconds() - start_cpu;
+    return stats;
+}
+
+} // namespace convert
+} // namespace example
+} // namespace ratl
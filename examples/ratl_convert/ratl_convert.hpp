@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_example_ratl_convert_
+#define _ratl_example_ratl_convert_
+
+// other includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ratl
+{
+namespace example
+{
+namespace convert
+{
+enum class sample_format
+{
+    int16,
+    int24,
+    int32,
+    float32
+};
+
+enum class file_type
+{
+    wav,
+    aiff,
+    raw
+};
+
+// How the samples of a file are stored. Format strings look like s16, s24be or f32le, optionally followed by
+// :<channels> and :<sample rate>, e.g. s24be:8:48000. Samples are little endian unless be is given.
+struct raw_format
+{
+    sample_format format = sample_format::int16;
+    bool big_endian = false;
+    // Whether the format string gave the byte order
+    bool byte_order_set = false;
+    std::size_t channels = 0;
+    std::size_t sample_rate = 48000;
+};
+
+// Throws std::invalid_argument if the string isn't a valid format string
+raw_format parse_raw_format(const std::string& format);
+
+// The format string for a sample format and byte order, e.g. s24be
+std::string format_name(sample_format format, bool big_endian);
+
+std::size_t sample_bytes(sample_format format) noexcept;
+
+// The seed of the dither for chunk chunk_num of a conversion seeded with seed
+std::uint32_t chunk_dither_seed(std::uint32_t seed, std::uint64_t chunk_num) noexcept;
+
+// The file type implied by a path's extension, raw if it isn't .wav, .rf64, .bw64, .aif, .aiff or .aifc
+file_type file_type_for_path(const std::string& path);
+
+struct convert_config
+{
+    std::string input_path;
+    std::string output_path;
+
+    // Raw input is described by raw_input_format, other input is detected from the file's header
+    bool raw_input = false;
+    raw_format raw_input_format;
+    std::uint64_t raw_input_offset = 0;
+
+    file_type output_type = file_type::wav;
+    // The output sample format is the input's unless output_format_set. WAV output is little endian, AIFF output is big
+    // endian unless a little endian integer format is asked for, and raw output is little endian unless big endian is
+    // asked for. The channels and sample rate of output_format are ignored.
+    bool output_format_set = false;
+    raw_format output_format;
+    // Raw output can hold each channel in turn instead of interleaved frames
+    bool output_noninterleaved = false;
+
+    // Input channels to convert, in output order. Empty converts every channel.
+    std::vector<std::size_t> channels;
+
+    bool dither = false;
+    std::uint32_t dither_seed = 0;
+
+    // 0 uses every core
+    std::size_t threads = 0;
+    std::size_t chunk_frames = 65536;
+};
+
+struct convert_stats
+{
+    std::uint64_t frames = 0;
+    raw_format input_format;
+    raw_format output_format;
+    file_type output_type = file_type::wav;
+    std::uint64_t bytes_read = 0;
+    std::uint64_t bytes_written = 0;
+    std::size_t threads = 0;
+    std::uint64_t chunks = 0;
+    double seconds = 0.0;
+    double cpu_seconds = 0.0;
+
+    double megabytes_per_second() const noexcept
+    {
+        return seconds > 0.0 ? static_cast<double>(bytes_read + bytes_written) / (seconds * 1e6) : 0.0;
+    }
+
+    // How many times faster than real time the audio was converted
+    double speed() const noexcept
+    {
+        return seconds > 0.0 && input_format.sample_rate != 0
+                   ? static_cast<double>(frames) / (seconds * static_cast<double>(input_format.sample_rate))
+                   : 0.0;
+    }
+};
+
+// Converts a file in chunks of chunk_frames frames, claimed in turn by a pool of threads that each view their chunk of
+// the memory mapped input, convert it into their own buffer and write it straight to its place in the output file.
+// Input pages are read ahead of each chunk and released behind it, so files much larger than memory can be converted.
+// Each chunk's dither is seeded from dither_seed and the chunk's index, so the output doesn't depend on the number of
+// threads or the order the chunks were converted in.
+// Throws std::invalid_argument for an invalid configuration, std::runtime_error for unsupported input and
+// std::system_error for I/O errors.
+convert_stats convert_file(const convert_config& config);
+
+} // namespace convert
+} // namespace example
+} // namespace ratl
+
+#endif // _ratl_example_ratl_convert_
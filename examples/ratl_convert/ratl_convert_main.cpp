@@ -0,0 +1,233 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl includes
+#include "ratl_convert.hpp"
+
+// other includes
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ratl-convert [options] <input> <output>
+// Converts WAV, RF64, AIFF, CAF or raw PCM files between sample formats, byte orders and layouts with ratl's
+// conversions, e.g.
+//   ratl-convert --format s16 --dither --channels 0,1 multitrack.wav stereo.wav
+//   ratl-convert --input-format s24be:8:48000 --format f32 --noninterleaved capture.raw planar.raw
+
+using namespace ratl::example::convert;
+
+static void print_usage()
+{
+    std::printf(
+        "usage: ratl-convert [options] <input> <output>\n"
+        "\n"
+        "  --input-format <format>  read the input as raw samples, e.g. s24be:8:48000\n"
+        "  --input-offset <bytes>   bytes to skip at the start of raw input\n"
+        "  --format <format>        output sample format and byte order, e.g. s16, f32, s24be (default: the input's)\n"
+        "  --type <wav|aiff|raw>    output file type (default: from the output extension, raw if it isn't known)\n"
+        "  --noninterleaved         write raw output one channel after another\n"
+        "  --channels <list>        comma separated input channels to keep, in output order, e.g. 2,0\n"
+        "  --dither                 add triangular dither\n"
+        "  --seed <number>          dither seed (default 0)\n"
+        "  --threads <number>       conversion threads (default: one per core)\n"
+        "  --chunk-frames <number>  frames converted at a time by each thread (default 65536)\n"
+        "  --quiet                  don't print statistics\n"
+        "\n"
+        "formats are s16, s24, s32 or f32, followed by le or be for the byte order\n");
+}
+
+static unsigned long long parse_number(const std::string& option, const std::string& value)
+{
+    char* end = nullptr;
+    auto number = std::strtoull(value.c_str(), &end, 0);
+    if (value.empty() || value[0] == '-' || end == nullptr || *end != '\0')
+    {
+        throw std::invalid_argument("invalid " + option + " '" + value + "'");
+    }
+    return number;
+}
+
+static std::vector<std::size_t> parse_channels(const std::string& list)
+{
+    std::vector<std::size_t> channels;
+    std::size_t start = 0;
+    while (start <= list.size())
+    {
+        auto end = list.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+        channels.push_back(static_cast<std::size_t>(parse_number("--channels", list.substr(start, end - start))));
+        start = end + 1;
+    }
+    return channels;
+}
+
+static const char* file_type_name(file_type type)
+{
+    switch (type)
+    {
+    case file_type::wav:
+        return "WAV";
+    case file_type::aiff:
+        return "AIFF";
+    case file_type::raw:
+        break;
+    }
+    return "raw";
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        convert_config config;
+        std::vector<std::string> paths;
+        auto type_set = false;
+        auto quiet = false;
+        for (auto arg_num = 1; arg_num < argc; ++arg_num)
+        {
+            std::string arg = argv[arg_num];
+            auto value = [&]() -> std::string
+            {
+                if (arg_num + 1 >= argc)
+                {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++arg_num];
+            };
+
+            if (arg == "--help" || arg == "-h")
+            {
+                print_usage();
+                return EXIT_SUCCESS;
+            }
+            else if (arg == "--input-format")
+            {
+                config.raw_input = true;
+                config.raw_input_format = parse_raw_format(value());
+            }
+            else if (arg == "--input-offset")
+            {
+                config.raw_input_offset = parse_number(arg, value());
+            }
+            else if (arg == "--format")
+            {
+                config.output_format_set = true;
+                config.output_format = parse_raw_format(value());
+            }
+            else if (arg == "--type")
+            {
+                auto type = value();
+                type_set = true;
+                if (type == "wav")
+                {
+                    config.output_type = file_type::wav;
+                }
+                else if (type == "aiff")
+                {
+                    config.output_type = file_type::aiff;
+                }
+                else if (type == "raw")
+                {
+                    config.output_type = file_type::raw;
+                }
+                else
+                {
+                    throw std::invalid_argument("invalid --type '" + type + "'");
+                }
+            }
+            else if (arg == "--noninterleaved")
+            {
+                config.output_noninterleaved = true;
+            }
+            else if (arg == "--channels")
+            {
+                config.channels = parse_channels(value());
+            }
+            else if (arg == "--dither")
+            {
+                config.dither = true;
+            }
+            else if (arg == "--seed")
+            {
+                config.dither_seed = static_cast<std::uint32_t>(parse_number(arg, value()));
+            }
+            else if (arg == "--threads")
+            {
+                config.threads = static_cast<std::size_t>(parse_number(arg, value()));
+            }
+            else if (arg == "--chunk-frames")
+            {
+                config.chunk_frames = static_cast<std::size_t>(parse_number(arg, value()));
+            }
+            else if (arg == "--quiet")
+            {
+                quiet = true;
+            }
+            else if (arg.size() > 1 && arg[0] == '-')
+            {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+            else
+            {
+                paths.push_back(arg);
+            }
+        }
+
+        if (paths.size() != 2)
+        {
+            print_usage();
+            return EXIT_FAILURE;
+        }
+        config.input_path = paths[0];
+        config.output_path = paths[1];
+        if (!type_set)
+        {
+            config.output_type = file_type_for_path(config.output_path);
+        }
+
+        auto stats = convert_file(config);
+        if (!quiet)
+        {
+            std::printf(
+                "%s: %zu channels of %s at %zu Hz\n",
+                config.input_path.c_str(),
+                stats.input_format.channels,
+                format_name(stats.input_format.format, stats.input_format.big_endian).c_str(),
+                stats.input_format.sample_rate);
+            std::printf(
+                "%s: %s, %zu channels of %s%s\n",
+                config.output_path.c_str(),
+                file_type_name(stats.output_type),
+                stats.output_format.channels,
+                format_name(stats.output_format.format, stats.output_format.big_endian).c_str(),
+                config.output_noninterleaved ? ", noninterleaved" : "");
+            std::printf(
+                "converted %llu frames in %.3f s with %zu threads (%llu chunks): %.1f MB/s, %.1fx real time, "
+                "%.2f cores busy\n",
+                static_cast<unsigned long long>(stats.frames),
+                stats.seconds,
+                stats.threads,
+                static_cast<unsigned long long>(stats.chunks),
+                stats.megabytes_per_second(),
+                stats.speed(),
+                stats.seconds > 0.0 ? stats.cpu_seconds / stats.seconds : 0.0);
+        }
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception& exception)
+    {
+        std::fprintf(stderr, "ratl-convert: %s\n", exception.what());
+        return EXIT_FAILURE;
+    }
+}
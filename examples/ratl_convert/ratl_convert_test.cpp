@@ -0,0 +1,339 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl includes
+#include "ratl_convert.hpp"
+
+#include <ratl/ratl.hpp>
+
+// other includes
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+// Converts small files through each output type and checks them against ratl's own conversions of the same samples,
+// that the output doesn't depend on how many threads converted it, and that bad configurations are rejected
+
+using namespace ratl::example::convert;
+
+static constexpr std::size_t TestChannels = 3;
+static constexpr std::size_t TestFrames = 10037;
+static constexpr std::size_t TestChunkFrames = 1000;
+
+static std::string test_path(const std::string& name)
+{
+    auto* tmp_dir = std::getenv("TMPDIR");
+    return std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") + "/ratl_convert_test_" + std::to_string(::getpid()) +
+           "_" + name;
+}
+
+static std::vector<unsigned char> read_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const std::string& path, const void* data, std::size_t size)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+static ratl::interleaved<ratl::int16_t> make_input()
+{
+    ratl::interleaved<ratl::float32_t> input(TestChannels, TestFrames);
+    for (std::size_t frame_num = 0; frame_num < TestFrames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < TestChannels; ++channel_num)
+        {
+            auto value = static_cast<float>((frame_num * 7 + channel_num * 131) % 2001) / 1000.0f - 1.0f;
+            input[frame_num][channel_num] = ratl::sample<ratl::float32_t>(value * 0.999f);
+        }
+    }
+    ratl::interleaved<ratl::int16_t> converted(TestChannels, TestFrames);
+    ratl::transform(input.begin(), input.end(), converted.begin());
+    return converted;
+}
+
+static bool check(bool condition, const std::string& message)
+{
+    if (!condition)
+    {
+        std::cout << "ERROR: " << message << std::endl;
+    }
+    return condition;
+}
+
+static convert_config make_config(const std::string& input_path, const std::string& output_path)
+{
+    convert_config config;
+    config.input_path = input_path;
+    config.output_path = output_path;
+    config.raw_input = true;
+    config.raw_input_format = parse_raw_format("s16le:3:44100");
+    config.chunk_frames = TestChunkFrames;
+    config.threads = 3;
+    return config;
+}
+
+// raw s16le -> WAV f32, read back with wav_file
+static bool test_wav(const ratl::interleaved<ratl::int16_t>& input, const std::string& input_path)
+{
+    auto output_path = test_path("output.wav");
+    auto config = make_config(input_path, output_path);
+    config.output_type = file_type::wav;
+    config.output_format_set = true;
+    config.output_format = parse_raw_format("f32");
+    auto stats = convert_file(config);
+
+    ratl::interleaved<ratl::float32_t> expected(TestChannels, TestFrames);
+    ratl::transform(input.begin(), input.end(), expected.begin());
+    ratl::wav_file output(output_path);
+    auto samples = output.samples<ratl::float32_t>();
+    auto result =
+        check(stats.frames == TestFrames && stats.chunks == 11 && stats.threads == 3, "wrong WAV stats") &&
+        check(output.channels() == TestChannels && output.frames() == TestFrames, "wrong WAV size") &&
+        check(output.sample_rate() == 44100, "wrong WAV sample rate") &&
+        check(std::memcmp(samples.data(), expected.data(), expected.samples() * sizeof(expected.data()[0])) == 0,
+              "wrong WAV samples");
+    ::unlink(output_path.c_str());
+    return result;
+}
+
+// raw f32 -> dithered AIFF s16, read back with aiff_file, with 1 and 4 threads
+static bool test_aiff_dither(const ratl::interleaved<ratl::int16_t>& input)
+{
+    // dither only changes integer samples that are narrower than the input, so the input is widened to float first
+    ratl::interleaved<ratl::float32_t> float_input(TestChannels, TestFrames);
+    ratl::transform(input.begin(), input.end(), float_input.begin());
+    for (auto frame : float_input)
+    {
+        for (auto& sample : frame)
+        {
+            sample = ratl::sample<ratl::float32_t>(sample.get() * 0.77f);
+        }
+    }
+    auto float_input_path = test_path("input_f32.raw");
+    write_file(float_input_path, float_input.data(), float_input.samples() * sizeof(float_input.data()[0]));
+
+    ratl::interleaved<ratl::int16_t> expected(TestChannels, TestFrames);
+    for (std::size_t first_frame = 0, chunk_num = 0; first_frame < TestFrames;
+         first_frame += TestChunkFrames, ++chunk_num)
+    {
+        auto frames = std::min(TestChunkFrames, TestFrames - first_frame);
+        auto offset = first_frame * TestChannels;
+        auto chunk_input = ratl::const_interleaved_span<ratl::float32_t>(
+            float_input.data() + offset, TestChannels, frames);
+        auto chunk_output = ratl::interleaved_span<ratl::int16_t>(expected.data() + offset, TestChannels, frames);
+        ratl::dither_generator dither_gen(chunk_dither_seed(1234, chunk_num));
+        ratl::transform(chunk_input.begin(), chunk_input.end(), chunk_output.begin(), dither_gen);
+    }
+    ratl::network_interleaved<ratl::int16_t> network_expected(TestChannels, TestFrames);
+    ratl::transform(expected.begin(), expected.end(), network_expected.begin());
+
+    auto result = true;
+    std::vector<unsigned char> first_output;
+    for (std::size_t threads : {1, 4})
+    {
+        auto output_path = test_path("output.aiff");
+        auto config = make_config(float_input_path, output_path);
+        config.raw_input_format = parse_raw_format("f32:3:96000");
+        config.output_type = file_type::aiff;
+        config.output_format_set = true;
+        config.output_format = parse_raw_format("s16");
+        config.dither = true;
+        config.dither_seed = 1234;
+        config.threads = threads;
+        convert_file(config);
+
+        ratl::aiff_file output(output_path);
+        auto samples = output.network_samples<ratl::int16_t>();
+        result = check(output.channels() == TestChannels && output.frames() == TestFrames, "wrong AIFF size") &&
+                 check(output.sample_rate() == 96000, "wrong AIFF sample rate") &&
+                 check(std::memcmp(samples.data(), network_expected.data(), TestFrames * TestChannels * 2) == 0,
+                       "wrong dithered AIFF samples with " + std::to_string(threads) + " threads") &&
+                 result;
+        auto bytes = read_file(output_path);
+        result = check(first_output.empty() || bytes == first_output, "AIFF output depends on the threads") && result;
+        first_output = bytes;
+        ::unlink(output_path.c_str());
+    }
+    ::unlink(float_input_path.c_str());
+    return result;
+}
+
+// raw s16le -> AIFC f32 and little endian s24, read back with aiff_file
+static bool test_aifc(const ratl::interleaved<ratl::int16_t>& input, const std::string& input_path)
+{
+    auto output_path = test_path("output.aifc");
+    auto config = make_config(input_path, output_path);
+    config.output_type = file_type::aiff;
+    config.output_format_set = true;
+    config.output_format = parse_raw_format("f32");
+    convert_file(config);
+
+    ratl::network_interleaved<ratl::float32_t> expected_float(TestChannels, TestFrames);
+    ratl::transform(input.begin(), input.end(), expected_float.begin());
+    auto result = true;
+    {
+        ratl::aiff_file output(output_path);
+        auto samples = output.network_samples<ratl::float32_t>();
+        result = check(output.is_aifc() && output.frames() == TestFrames, "wrong float AIFC size") &&
+                 check(std::memcmp(samples.data(), expected_float.data(), TestFrames * TestChannels * 4) == 0,
+                       "wrong float AIFC samples");
+    }
+
+    config.output_format = parse_raw_format("s24le");
+    convert_file(config);
+    ratl::interleaved<ratl::int24_t> expected_int24(TestChannels, TestFrames);
+    ratl::transform(input.begin(), input.end(), expected_int24.begin());
+    {
+        ratl::aiff_file output(output_path);
+        auto samples = output.samples<ratl::int24_t>();
+        result = check(output.is_aifc() && output.frames() == TestFrames, "wrong sowt AIFC size") &&
+                 check(std::memcmp(samples.data(), expected_int24.data(), TestFrames * TestChannels * 3) == 0,
+                       "wrong sowt AIFC samples") &&
+                 result;
+    }
+    ::unlink(output_path.c_str());
+    return result;
+}
+
+// raw s16le -> noninterleaved raw s32be of channels 2 and 0
+static bool test_raw_channels(const ratl::interleaved<ratl::int16_t>& input, const std::string& input_path)
+{
+    auto output_path = test_path("output.raw");
+    auto config = make_config(input_path, output_path);
+    config.output_type = file_type::raw;
+    config.output_format_set = true;
+    config.output_format = parse_raw_format("s32be");
+    config.output_noninterleaved = true;
+    config.channels = {2, 0};
+    convert_file(config);
+
+    ratl::interleaved<ratl::int16_t> selected(2, TestFrames);
+    for (std::size_t frame_num = 0; frame_num < TestFrames; ++frame_num)
+    {
+        selected[frame_num][0] = input[frame_num][2];
+        selected[frame_num][1] = input[frame_num][0];
+    }
+    ratl::network_noninterleaved<ratl::int32_t> expected(2, TestFrames);
+    ratl::transform(selected.begin(), selected.end(), expected.begin());
+    auto output = read_file(output_path);
+    auto result = check(output.size() == TestFrames * 2 * 4, "wrong raw output size") &&
+                  check(std::memcmp(output.data(), expected.data(), output.size()) == 0, "wrong raw output samples");
+    ::unlink(output_path.c_str());
+    return result;
+}
+
+template<typename Exception>
+static bool check_throws(const std::string& message, const convert_config& config)
+{
+    try
+    {
+        convert_file(config);
+    }
+    catch (const Exception&)
+    {
+        return true;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cout << "ERROR: " << message << " threw " << exception.what() << std::endl;
+        return false;
+    }
+    std::cout << "ERROR: " << message << " didn't throw" << std::endl;
+    return false;
+}
+
+static bool test_errors(const std::string& input_path)
+{
+    auto result = true;
+    for (auto format : {"", "s8", "s16xe", "u16", "s16:0", "s16:x", "s16:2:"})
+    {
+        try
+        {
+            parse_raw_format(format);
+            result = check(false, std::string("format '") + format + "' was accepted");
+        }
+        catch (const std::invalid_argument&)
+        {
+        }
+    }
+    auto format = parse_raw_format("s24be:8:48000");
+    result = check(
+                 format.format == sample_format::int24 && format.big_endian && format.byte_order_set &&
+                     format.channels == 8 && format.sample_rate == 48000,
+                 "s24be:8:48000 was parsed wrongly") &&
+             result;
+
+    auto output_path = test_path("errors.wav");
+    auto config = make_config(input_path, output_path);
+    config.channels = {0, 3};
+    result = check_throws<std::invalid_argument>("a missing channel", config) && result;
+
+    config = make_config(input_path, output_path);
+    config.output_noninterleaved = true;
+    result = check_throws<std::invalid_argument>("noninterleaved WAV output", config) && result;
+
+    config = make_config(input_path, output_path);
+    config.output_format_set = true;
+    config.output_format = parse_raw_format("s16be");
+    result = check_throws<std::invalid_argument>("big endian WAV output", config) && result;
+
+    config = make_config(input_path, output_path);
+    config.output_type = file_type::aiff;
+    config.output_format_set = true;
+    config.output_format = parse_raw_format("f32le");
+    result = check_throws<std::invalid_argument>("little endian float AIFF output", config) && result;
+
+    config = make_config(test_path("missing.raw"), output_path);
+    result = check_throws<std::system_error>("a missing input", config) && result;
+
+    config = make_config(input_path, output_path);
+    config.raw_input = false;
+    result = check_throws<std::runtime_error>("raw input without a format", config) && result;
+    ::unlink(output_path.c_str());
+    return result;
+}
+
+int main()
+{
+    auto input = make_input();
+    auto input_path = test_path("input.raw");
+    write_file(input_path, input.data(), input.samples() * sizeof(input.data()[0]));
+
+    auto result = true;
+    try
+    {
+        result = test_wav(input, input_path) && result;
+        result = test_aiff_dither(input) && result;
+        result = test_aifc(input, input_path) && result;
+        result = test_raw_channels(input, input_path) && result;
+        result = test_errors(input_path) && result;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cout << "ERROR: " << exception.what() << std::endl;
+        result = false;
+    }
+    ::unlink(input_path.c_str());
+    if (result)
+    {
+        std::printf("all conversions passed\n");
+    }
+    return result ? 0 : -1;
+}
@@ -0,0 +1,82 @@
+import numpy
+import sys
+import timeit
+
+sys.path.append(sys.argv[1])
+import ratl_numpy
+
+channels = 8
+frames = 48000 * 60
+repeats = 5
+
+
+def numpy_float32_to_int16(input):
+    return numpy.clip(numpy.round(input * 32767.0), -32768, 32767).astype(numpy.int16)
+
+
+def numpy_int16_to_float32(input):
+    return input.astype(numpy.float32) * numpy.float32(1.0 / 32768.0)
+
+
+def numpy_int16_to_network_int16(input):
+    return input.astype('>i2')
+
+
+def expect_rejected(input, output):
+    try:
+        ratl_numpy.transform(input, output)
+    except ValueError:
+        return
+    raise AssertionError('transform accepted arrays it can not convert safely')
+
+
+def report(name, function):
+    seconds = min(timeit.repeat(function, number=1, repeat=repeats))
+    megasamples = channels * frames / seconds / 1e6
+    print(f'{name:<48} {seconds * 1e3:10.2f} ms {megasamples:10.1f} Msamples/s')
+
+
+def main():
+    rng = numpy.random.default_rng(0)
+    float32_input = rng.uniform(-1.0, 1.0, (frames, channels)).astype(numpy.float32)
+    int16_input = rng.integers(-32768, 32767, (frames, channels), dtype=numpy.int16)
+    int16_output = numpy.empty((frames, channels), dtype=numpy.int16)
+    float32_output = numpy.empty((frames, channels), dtype=numpy.float32)
+    network_int16_output = numpy.empty((frames, channels), dtype='>i2')
+    int16_fortran_output = numpy.empty((frames, channels), dtype=numpy.int16, order='F')
+    int24_output = numpy.empty((frames, channels), dtype=ratl_numpy.int24_dtype())
+
+    # results must match NumPy to within the rounding of the float to int conversion
+    ratl_numpy.transform(float32_input, int16_output)
+    assert numpy.max(numpy.abs(int16_output.astype(numpy.int32) - numpy_float32_to_int16(float32_input))) <= 1
+    ratl_numpy.transform(int16_input, float32_output)
+    assert numpy.array_equal(float32_output, numpy_int16_to_float32(int16_input))
+    ratl_numpy.transform(int16_input, network_int16_output)
+    assert numpy.array_equal(network_int16_output, numpy_int16_to_network_int16(int16_input))
+
+    # reversed or broadcast channels, and outputs that overlap their input, are rejected
+    expect_rejected(numpy.asfortranarray(float32_input)[:, ::-1], int16_output)
+    expect_rejected(numpy.broadcast_to(numpy.asfortranarray(float32_input[:, :1]), (frames, channels)), int16_output)
+    expect_rejected(int16_input, int16_input)
+    shifted = numpy.empty(frames * channels + 1, dtype=numpy.int16)
+    expect_rejected(shifted[1:].reshape(frames, channels), shifted[:-1].reshape(frames, channels))
+
+    report('numpy float32 -> int16', lambda: numpy_float32_to_int16(float32_input))
+    report('ratl transform float32 -> int16', lambda: ratl_numpy.transform(float32_input, int16_output))
+    report('ratl fast_transform float32 -> int16', lambda: ratl_numpy.fast_transform(float32_input, int16_output))
+    report('ratl fast_transform float32 -> int16 dithered',
+           lambda: ratl_numpy.fast_transform(float32_input, int16_output, dither=True))
+    report('ratl fast_transform float32 -> int16 4 threads',
+           lambda: ratl_numpy.fast_transform(float32_input, int16_output, threads=4))
+    report('ratl fast_transform float32 -> int16 non-interleaved',
+           lambda: ratl_numpy.fast_transform(float32_input, int16_fortran_output))
+    report('ratl fast_transform float32 -> int24', lambda: ratl_numpy.fast_transform(float32_input, int24_output))
+    report('numpy int16 -> float32', lambda: numpy_int16_to_float32(int16_input))
+    report('ratl fast_transform int16 -> float32', lambda: ratl_numpy.fast_transform(int16_input, float32_output))
+    report('numpy int16 -> network int16', lambda: numpy_int16_to_network_int16(int16_input))
+    report('ratl fast_transform int16 -> network int16',
+           lambda: ratl_numpy.fast_transform(int16_input, network_int16_output))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,408 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl includes
+#include <ratl/ratl.hpp>
+
+// other includes
+#include <algorithm>
+#include <cstddef>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace ratl
+{
+namespace example
+{
+namespace numpy
+{
+// NumPy has no 24 bit integer type, so 24 bit samples are viewed through 3 byte structured types whose single field
+// name records the byte order of the samples
+static constexpr const char* int24_field = "int24";
+static constexpr const char* network_int24_field = "network_int24";
+
+// Arrays are only split across threads when each thread would get at least this many frames
+static constexpr std::size_t min_frames_per_thread = 16384;
+
+enum class sample_format
+{
+    int16,
+    int24,
+    int32,
+    float32
+};
+
+enum class transform_mode
+{
+    reference,
+    fast
+};
+
+// An array of samples viewed as either interleaved frames (C order) or non-interleaved channels (Fortran order)
+// 1 dimensional arrays are viewed as a single interleaved channel.
+struct array_view
+{
+    char* data;
+    sample_format format;
+    bool network;
+    bool interleaved;
+    std::size_t channels;
+    std::size_t frames;
+    std::size_t pitch;
+    std::size_t itemsize;
+};
+
+inline bool is_network_byte_order(char byteorder)
+{
+#if defined(RATL_CPP_LITTLE_ENDIAN)
+    return byteorder == '>';
+#else
+    return byteorder == '>' || byteorder == '=';
+#endif
+}
+
+inline bool is_host_byte_order(char byteorder)
+{
+#if defined(RATL_CPP_LITTLE_ENDIAN)
+    return byteorder == '=' || byteorder == '<' || byteorder == '|';
+#else
+    return byteorder == '=' || byteorder == '|';
+#endif
+}
+
+inline void read_format(const py::dtype& dtype, array_view& view)
+{
+    auto kind = dtype.kind();
+    auto itemsize = static_cast<std::size_t>(dtype.itemsize());
+    auto byteorder = dtype.attr("byteorder").cast<std::string>().at(0);
+
+    if (kind == 'V' && itemsize == 3 && !dtype.attr("names").is_none())
+    {
+        auto names = dtype.attr("names").cast<std::vector<std::string>>();
+        if (names.size() == 1 && (names[0] == int24_field || names[0] == network_int24_field))
+        {
+            view.format = sample_format::int24;
+            view.network = (names[0] == network_int24_field);
+            return;
+        }
+    }
+
+    if (!is_host_byte_order(byteorder) && !is_network_byte_order(byteorder))
+    {
+        throw std::invalid_argument("unsupported byte order");
+    }
+    view.network = is_network_byte_order(byteorder);
+
+    if (kind == 'i' && itemsize == 2)
+    {
+        view.format = sample_format::int16;
+    }
+    else if (kind == 'i' && itemsize == 4)
+    {
+        view.format = sample_format::int32;
+    }
+    else if (kind == 'f' && itemsize == 4)
+    {
+        view.format = sample_format::float32;
+    }
+    else
+    {
+        throw std::invalid_argument("unsupported sample type, expected int16, int24, int32 or float32");
+    }
+}
+
+// Views an array without copying it, arrays that can't be viewed as interleaved or non-interleaved are rejected
+inline array_view make_array_view(const py::array& array, bool writeable)
+{
+    if (writeable && !array.writeable())
+    {
+        throw std::invalid_argument("output array is read-only");
+    }
+
+    array_view view{};
+    read_format(array.dtype(), view);
+    view.data = static_cast<char*>(const_cast<void*>(array.data()));
+
+    auto itemsize = static_cast<py::ssize_t>(array.itemsize());
+    view.itemsize = static_cast<std::size_t>(itemsize);
+    if (array.ndim() == 1)
+    {
+        if (array.shape(0) > 1 && array.strides(0) != itemsize)
+        {
+            throw std::invalid_argument("1 dimensional arrays must be contiguous");
+        }
+        view.interleaved = true;
+        view.channels = 1;
+        view.frames = static_cast<std::size_t>(array.shape(0));
+        view.pitch = view.frames;
+    }
+    else if (array.ndim() == 2)
+    {
+        // shape is (frames, channels) for both layouts
+        view.frames = static_cast<std::size_t>(array.shape(0));
+        view.channels = static_cast<std::size_t>(array.shape(1));
+        if (array.strides(1) == itemsize && array.strides(0) == itemsize * array.shape(1))
+        {
+            view.interleaved = true;
+            view.pitch = view.frames;
+        }
+        else if (array.strides(0) == itemsize && view.channels == 1)
+        {
+            // the channel stride of a single channel is never used
+            view.interleaved = false;
+            view.pitch = view.frames;
+        }
+        else if (
+            array.strides(0) == itemsize && array.strides(1) > 0 && array.strides(1) % itemsize == 0 &&
+            array.strides(1) >= itemsize * array.shape(0))
+        {
+            // negative strides (reversed channels), zero strides (broadcast channels) and strides shorter than a
+            // channel would make channels run backwards through memory or overlap each other
+            view.interleaved = false;
+            view.pitch = static_cast<std::size_t>(array.strides(1) / itemsize);
+        }
+        else
+        {
+            throw std::invalid_argument("2 dimensional arrays must have contiguous frames or contiguous channels");
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("arrays must be 1 dimensional or 2 dimensional (frames, channels)");
+    }
+    return view;
+}
+
+// The bytes from the first sample of the array to the end of its last sample
+inline std::size_t array_view_bytes(const array_view& view)
+{
+    if (view.channels == 0 || view.frames == 0)
+    {
+        return 0;
+    }
+    if (view.interleaved)
+    {
+        return view.channels * view.frames * view.itemsize;
+    }
+    return (((view.channels - 1) * view.pitch) + view.frames) * view.itemsize;
+}
+
+inline bool array_views_overlap(const array_view& first, const array_view& second)
+{
+    auto first_bytes = array_view_bytes(first);
+    auto second_bytes = array_view_bytes(second);
+    return first_bytes != 0 && second_bytes != 0 && first.data < second.data + second_bytes &&
+           second.data < first.data + first_bytes;
+}
+
+template<typename SampleValueType, typename Function>
+inline void dispatch_byte_order(bool network, Function&& function)
+{
+    if (network)
+    {
+        function(network_sample<SampleValueType>());
+    }
+    else
+    {
+        function(sample<SampleValueType>());
+    }
+}
+
+template<typename Function>
+inline void dispatch_sample_type(const array_view& view, Function&& function)
+{
+    switch (view.format)
+    {
+    case sample_format::int16:
+        dispatch_byte_order<int16_t>(view.network, function);
+        break;
+    case sample_format::int24:
+        dispatch_byte_order<int24_t>(view.network, function);
+        break;
+    case sample_format::int32:
+        dispatch_byte_order<int32_t>(view.network, function);
+        break;
+    case sample_format::float32:
+        dispatch_byte_order<float32_t>(view.network, function);
+        break;
+    }
+}
+
+// Calls function with a span over frames [first_frame, first_frame + frames) of the array
+template<typename SampleType, typename Function>
+inline void with_span(const array_view& view, std::size_t first_frame, std::size_t frames, Function&& function)
+{
+    using sample_traits = detail::sample_traits<SampleType>;
+    auto data = reinterpret_cast<SampleType*>(view.data);
+    if (view.interleaved)
+    {
+        function(basic_interleaved_span<SampleType, sample_traits>(
+            data + (first_frame * view.channels), view.channels, frames));
+    }
+    else
+    {
+        function(basic_noninterleaved_span<SampleType, sample_traits>(
+            data + first_frame, view.channels, frames, view.pitch));
+    }
+}
+
+template<typename InputSampleType, typename OutputSampleType>
+inline void transform_frames(
+    const array_view& input,
+    const array_view& output,
+    std::size_t first_frame,
+    std::size_t frames,
+    transform_mode mode,
+    bool dither)
+{
+    with_span<InputSampleType>(
+        input,
+        first_frame,
+        frames,
+        [&](auto input_span)
+        {
+            with_span<OutputSampleType>(
+                output,
+                first_frame,
+                frames,
+                [&](auto output_span)
+                {
+                    // every thread has its own dither generator, as they aren't thread safe
+                    dither_generator dither_gen;
+                    if (mode == transform_mode::fast)
+                    {
+                        if (dither)
+                        {
+                            fast_transform(input_span.begin(), input_span.end(), output_span.begin(), dither_gen);
+                        }
+                        else
+                        {
+                            fast_transform(input_span.begin(), input_span.end(), output_span.begin());
+                        }
+                    }
+                    else
+                    {
+                        if (dither)
+                        {
+                            reference_transform(
+                                input_span.begin(), input_span.end(), output_span.begin(), dither_gen);
+                        }
+                        else
+                        {
+                            reference_transform(input_span.begin(), input_span.end(), output_span.begin());
+                        }
+                    }
+                });
+        });
+}
+
+inline void transform_arrays(
+    const py::array& input_array,
+    const py::array& output_array,
+    transform_mode mode,
+    bool dither,
+    std::size_t threads)
+{
+    auto input = make_array_view(input_array, false);
+    auto output = make_array_view(output_array, true);
+    if (input.channels != output.channels || input.frames != output.frames)
+    {
+        throw std::invalid_argument("input and output arrays must have the same shape");
+    }
+    if (array_views_overlap(input, output))
+    {
+        // samples would be read after other samples (or other threads) had already overwritten them
+        throw std::invalid_argument("input and output arrays must not overlap");
+    }
+
+    threads = std::max<std::size_t>(std::min(threads, input.frames / min_frames_per_thread), 1);
+    auto frames_per_thread = (input.frames + threads - 1) / threads;
+
+    dispatch_sample_type(
+        input,
+        [&](auto input_sample)
+        {
+            dispatch_sample_type(
+                output,
+                [&](auto output_sample)
+                {
+                    using input_sample_type = decltype(input_sample);
+                    using output_sample_type = decltype(output_sample);
+
+                    // the arrays are only accessed through raw pointers from here on, so other Python threads can run
+                    py::gil_scoped_release release;
+                    std::vector<std::thread> workers;
+                    for (std::size_t thread_num = 1; thread_num < threads; ++thread_num)
+                    {
+                        auto first_frame = thread_num * frames_per_thread;
+                        auto frames = std::min(frames_per_thread, input.frames - std::min(first_frame, input.frames));
+                        workers.emplace_back(
+                            [&, first_frame, frames]()
+                            {
+                                transform_frames<input_sample_type, output_sample_type>(
+                                    input, output, first_frame, frames, mode, dither);
+                            });
+                    }
+                    transform_frames<input_sample_type, output_sample_type>(
+                        input, output, 0, std::min(frames_per_thread, input.frames), mode, dither);
+                    for (auto& worker : workers)
+                    {
+                        worker.join();
+                    }
+                });
+        });
+}
+
+inline py::dtype int24_dtype(bool network)
+{
+    py::list fields;
+    fields.append(py::make_tuple(network ? network_int24_field : int24_field, "V3"));
+    return py::dtype::from_args(fields);
+}
+
+} // namespace numpy
+} // namespace example
+} // namespace ratl
+
+PYBIND11_MODULE(ratl_numpy, m)
+{
+    using namespace ratl::example::numpy;
+
+    m.doc() = "Zero-copy sample conversion between NumPy arrays. Arrays are shaped (frames, channels), C order arrays "
+              "are treated as interleaved and Fortran order arrays as non-interleaved. Big endian arrays hold network "
+              "order samples.";
+
+    m.def("int24_dtype", &int24_dtype, py::arg("network") = false, "Structured dtype for viewing 24 bit samples");
+    m.def(
+        "transform",
+        [](const py::array& input, const py::array& output, bool dither, std::size_t threads)
+        {
+            transform_arrays(input, output, transform_mode::reference, dither, threads);
+        },
+        py::arg("input"),
+        py::arg("output"),
+        py::arg("dither") = false,
+        py::arg("threads") = 1,
+        "Converts every sample of input into output with the reference converter, without holding the GIL");
+    m.def(
+        "fast_transform",
+        [](const py::array& input, const py::array& output, bool dither, std::size_t threads)
+        {
+            transform_arrays(input, output, transform_mode::fast, dither, threads);
+        },
+        py::arg("input"),
+        py::arg("output"),
+        py::arg("dither") = false,
+        py::arg("threads") = 1,
+        "Converts every sample of input into output with the fast converter, without holding the GIL");
+}
@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_aiff_file_
+#define _ratl_aiff_file_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/mapped_file.hpp>
+#include <ratl/detail/mapped_sample_file.hpp>
+
+// other includes
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace ratl
+{
+namespace detail
+{
+// Converts the 80 bit IEEE extended precision sample rate of an AIFF COMM chunk to a whole number of Hz
+inline std::size_t read_extended_sample_rate(const unsigned char* data) noexcept
+{
+    auto exponent = static_cast<int>(read_big_endian<std::uint16_t>(data) & 0x7fff);
+    auto mantissa = read_big_endian<std::uint64_t>(data + 2);
+    if ((data[0] & 0x80) != 0 || exponent == 0x7fff)
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>(std::llround(std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63)));
+}
+
+} // namespace detail
+
+// aiff_file
+// Memory maps an AIFF or AIFF-C file and views its sample data in place, without reading or copying it.
+// AIFF and AIFF-C 'NONE' and 'twos' files hold big endian integers and 'fl32' files big endian floats, which are
+// viewed with network_samples() as network order samples on any host, leaving the byte swap to the transform that
+// consumes them. AIFF-C 'sowt' files hold little endian integers, which are viewed with samples() on little endian
+// hosts. Samples of up to 16, 24 or 32 bits are stored in 16, 24 and 32 bit containers, 32 bit floats are supported.
+// Sample data that runs past the end of the file is truncated to the whole frames that are present.
+// Throws std::system_error if the file can't be mapped and std::runtime_error if it isn't a supported AIFF file.
+
+class aiff_file : public detail::mapped_sample_file
+{
+public:
+    explicit aiff_file(const std::string& path) : detail::mapped_sample_file(path)
+    {
+        parse();
+    }
+
+    bool is_aifc() const noexcept
+    {
+        return aifc_;
+    }
+
+private:
+    bool aifc_ = false;
+
+    void parse()
+    {
+        auto* bytes = file_data();
+        auto size = file_size();
+        if (size < 12 || !detail::chunk_id_equals(bytes, "FORM"))
+        {
+            throw std::runtime_error("aiff_file: not an AIFF file");
+        }
+        if (detail::chunk_id_equals(bytes + 8, "AIFC"))
+        {
+            aifc_ = true;
+        }
+        else if (!detail::chunk_id_equals(bytes + 8, "AIFF"))
+        {
+            throw std::runtime_error("aiff_file: not an AIFF file");
+        }
+
+        // the COMM chunk can come after the SSND chunk, so both are found before either is used
+        const unsigned char* comm = nullptr;
+        size_type ssnd_offset = 0;
+        std::uint64_t ssnd_bytes = 0;
+        size_type offset = 12;
+        while (size - offset >= 8)
+        {
+            auto* chunk = bytes + offset;
+            auto chunk_size = static_cast<std::uint64_t>(detail::read_big_endian<std::uint32_t>(chunk + 4));
+            auto body_offset = offset + 8;
+            auto available = static_cast<std::uint64_t>(size - body_offset);
+
+            if (detail::chunk_id_equals(chunk, "COMM"))
+            {
+                if (chunk_size < (aifc_ ? 22 : 18) || available < (aifc_ ? 22 : 18))
+                {
+                    throw std::runtime_error("aiff_file: COMM chunk is too small");
+                }
+                comm = bytes + body_offset;
+            }
+            else if (detail::chunk_id_equals(chunk, "SSND"))
+            {
+                if (chunk_size < 8 || available < 8)
+                {
+                    throw std::runtime_error("aiff_file: SSND chunk is too small");
+                }
+                auto data_offset = static_cast<std::uint64_t>(detail::read_big_endian<std::uint32_t>(chunk + 8));
+                if (data_offset > chunk_size - 8)
+                {
+                    throw std::runtime_error("aiff_file: SSND chunk is too small");
+                }
+                ssnd_offset = body_offset + 8 + static_cast<size_type>(data_offset);
+                ssnd_bytes = chunk_size - 8 - data_offset;
+            }
+
+            // chunks are padded to an even number of bytes
+            auto padded_size = chunk_size + (chunk_size & 1);
+            if (padded_size > available)
+            {
+                break;
+            }
+            offset = body_offset + static_cast<size_type>(padded_size);
+        }
+
+        if (comm == nullptr)
+        {
+            throw std::runtime_error("aiff_file: no COMM chunk");
+        }
+        if (ssnd_offset == 0)
+        {
+            throw std::runtime_error("aiff_file: no SSND chunk");
+        }
+
+        auto channels = static_cast<size_type>(detail::read_big_endian<std::uint16_t>(comm));
+        auto frames = static_cast<std::uint64_t>(detail::read_big_endian<std::uint32_t>(comm + 2));
+        auto bits_per_sample = static_cast<size_type>(detail::read_big_endian<std::uint16_t>(comm + 6));
+        auto sample_rate = detail::read_extended_sample_rate(comm + 8);
+
+        auto is_float = false;
+        auto is_big_endian = true;
+        if (aifc_)
+        {
+            auto* compression = comm + 18;
+            if (detail::chunk_id_equals(compression, "sowt"))
+            {
+                is_big_endian = false;
+            }
+            else if (detail::chunk_id_equals(compression, "fl32") || detail::chunk_id_equals(compression, "FL32"))
+            {
+                is_float = true;
+                bits_per_sample = 32;
+            }
+            else if (!detail::chunk_id_equals(compression, "NONE") && !detail::chunk_id_equals(compression, "twos"))
+            {
+                throw std::runtime_error("aiff_file: only NONE, twos, sowt and fl32 compression is supported");
+            }
+        }
+        if (bits_per_sample == 0 || bits_per_sample > 32)
+        {
+            throw std::runtime_error("aiff_file: invalid sample size");
+        }
+        if (channels != 0)
+        {
+            auto block_align = channels * ((bits_per_sample + 7) / 8);
+            frames = std::min(frames, ssnd_bytes / block_align);
+        }
+        set_sample_data(ssnd_offset, frames, channels, sample_rate, bits_per_sample, is_float, is_big_endian);
+    }
+};
+
+} // namespace ratl
+
+#endif // _ratl_aiff_file_
@@ -0,0 +1,261 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_arena_
+#define _ratl_arena_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+// other includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(RATL_HAS_MEMORY_RESOURCE)
+#    include <memory_resource>
+#endif
+
+namespace ratl
+{
+// Fixed-capacity arena suitable for allocating scratch buffers on a real-time thread
+// All of the arena's storage is either allocated once at construction or provided by the caller, after which allocate
+// and deallocate never lock, never make a system call and complete in a bounded number of steps. Every block is
+// aligned to alignment(), which is at least as large as the largest SIMD register and a cache line.
+// Blocks are carved from the storage monotonically and rounded up to a power of two multiple of alignment(), so
+// that deallocated blocks can be pushed onto a free list for their size class and reused by later allocations of the
+// same class. reset() reclaims all blocks at once, for example at the start of each audio callback.
+// An arena is not thread safe, each thread should use its own arena.
+class arena
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    static constexpr size_type num_size_classes = std::numeric_limits<size_type>::digits;
+
+    struct free_block
+    {
+        free_block* next_;
+    };
+
+    std::unique_ptr<unsigned char[]> owned_storage_;
+    unsigned char* storage_ = nullptr;
+    size_type capacity_ = 0;
+    size_type offset_ = 0;
+    std::array<free_block*, num_size_classes> free_lists_{};
+
+public:
+    // Allocates capacity bytes of storage from the free store
+    explicit arena(size_type capacity) :
+        owned_storage_(new unsigned char[capacity + alignment() - 1]),
+        storage_(align_storage(owned_storage_.get())),
+        capacity_(capacity)
+    {
+    }
+
+    // Uses size bytes of externally owned storage starting at buffer, which must outlive the arena
+    arena(void* buffer, size_type size) noexcept
+    {
+        auto start = align_storage(static_cast<unsigned char*>(buffer));
+        auto adjustment = static_cast<size_type>(start - static_cast<unsigned char*>(buffer));
+        if (adjustment < size)
+        {
+            storage_ = start;
+            capacity_ = size - adjustment;
+        }
+    }
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    static constexpr size_type alignment() noexcept
+    {
+        return RATL_ARENA_ALIGNMENT;
+    }
+
+    inline size_type capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    // Number of bytes carved from the storage since construction or the last reset, including those in free lists
+    inline size_type used() const noexcept
+    {
+        return offset_;
+    }
+
+    // Throws std::bad_alloc if there is no free block of the required size class and the arena is exhausted
+    inline void* allocate(size_type bytes)
+    {
+        auto size_class = get_size_class(bytes);
+        auto* block = free_lists_[size_class];
+        if (block != nullptr)
+        {
+            free_lists_[size_class] = block->next_;
+            return block;
+        }
+
+        if (RATL_UNLIKELY((size_type(1) << size_class) > (capacity_ - offset_) / alignment()))
+        {
+            throw std::bad_alloc();
+        }
+        auto* data = storage_ + offset_;
+        offset_ += alignment() << size_class;
+        return data;
+    }
+
+    inline void deallocate(void* data, size_type bytes) noexcept
+    {
+        auto size_class = get_size_class(bytes);
+        auto* block = ::new (data) free_block;
+        block->next_ = free_lists_[size_class];
+        free_lists_[size_class] = block;
+    }
+
+    // Invalidates every block allocated from the arena
+    inline void reset() noexcept
+    {
+        offset_ = 0;
+        free_lists_.fill(nullptr);
+    }
+
+private:
+    static inline unsigned char* align_storage(unsigned char* data) noexcept
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(data);
+        auto aligned_address = (address + alignment() - 1) & ~static_cast<std::uintptr_t>(alignment() - 1);
+        return data + (aligned_address - address);
+    }
+
+    // Returns the smallest n such that bytes fits in a block of alignment() << n bytes
+    static inline size_type get_size_class(size_type bytes) noexcept
+    {
+        auto blocks = (bytes + alignment() - 1) / alignment();
+        size_type size_class = 0;
+        while ((size_type(1) << size_class) < blocks)
+        {
+            ++size_class;
+        }
+        return size_class;
+    }
+};
+
+// Stateful allocator that allocates from a ratl::arena
+// This satisfies the Allocator requirements of basic_interleaved and basic_noninterleaved. The arena must outlive all
+// containers using it, and two arena_allocators only compare equal if they allocate from the same arena.
+template<typename Tp>
+class arena_allocator
+{
+public:
+    using value_type = Tp;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    static_assert(
+        alignof(Tp) <= arena::alignment(),
+        "value_type must not be more aligned than the arena alignment");
+
+private:
+    arena* arena_;
+
+public:
+    explicit arena_allocator(arena& arena) noexcept : arena_(&arena) {}
+
+    template<typename Up>
+    arena_allocator(const arena_allocator<Up>& other) noexcept : arena_(other.resource())
+    {
+    }
+
+    inline Tp* allocate(size_type n)
+    {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(Tp))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<Tp*>(arena_->allocate(n * sizeof(Tp)));
+    }
+
+    inline void deallocate(Tp* p, size_type n) noexcept
+    {
+        arena_->deallocate(p, n * sizeof(Tp));
+    }
+
+    inline arena* resource() const noexcept
+    {
+        return arena_;
+    }
+};
+
+template<typename Tp, typename Up>
+inline bool operator==(const arena_allocator<Tp>& a, const arena_allocator<Up>& b) noexcept
+{
+    return a.resource() == b.resource();
+}
+
+template<typename Tp, typename Up>
+inline bool operator!=(const arena_allocator<Tp>& a, const arena_allocator<Up>& b) noexcept
+{
+    return !(a == b);
+}
+
+#if defined(RATL_HAS_MEMORY_RESOURCE)
+
+namespace pmr
+{
+// std::pmr::memory_resource that allocates from a ratl::arena
+// Allocations requiring a greater alignment than arena::alignment() throw std::bad_alloc.
+class arena_resource : public std::pmr::memory_resource
+{
+private:
+    arena* arena_;
+
+public:
+    explicit arena_resource(arena& arena) noexcept : arena_(&arena) {}
+
+    inline arena* resource() const noexcept
+    {
+        return arena_;
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > arena::alignment())
+        {
+            throw std::bad_alloc();
+        }
+        return arena_->allocate(bytes);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t) override
+    {
+        arena_->deallocate(p, bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+} // namespace pmr
+
+#endif
+
+} // namespace ratl
+
+#endif // _ratl_arena_
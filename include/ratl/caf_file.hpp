@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_caf_file_
+#define _ratl_caf_file_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/mapped_file.hpp>
+#include <ratl/detail/mapped_sample_file.hpp>
+
+// other includes
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace ratl
+{
+namespace detail
+{
+// linear PCM format flags of a CAF desc chunk
+static constexpr std::uint32_t caf_format_flag_is_float = 0x1;
+static constexpr std::uint32_t caf_format_flag_is_little_endian = 0x2;
+
+// A data chunk size of -1 means that the data chunk runs to the end of the file
+static constexpr std::uint64_t caf_unknown_chunk_size = 0xffffffffffffffff;
+
+inline double read_big_endian_float64(const unsigned char* data) noexcept
+{
+    auto bits = read_big_endian<std::uint64_t>(data);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace detail
+
+// caf_file
+// Memory maps a Core Audio Format file holding linear PCM and views its data chunk in place, without reading or
+// copying it.
+// CAF files hold 16, 24 or 32 bit integers or 32 bit floats in either byte order. Big endian samples are viewed with
+// network_samples() as network order samples on any host, leaving the byte swap to the transform that consumes them,
+// and little endian samples are viewed with samples() on little endian hosts. A data chunk that runs past the end of
+// the file, or whose size was never filled in, is truncated to the whole frames that are present.
+// Throws std::system_error if the file can't be mapped and std::runtime_error if it isn't a supported CAF file.
+
+class caf_file : public detail::mapped_sample_file
+{
+public:
+    explicit caf_file(const std::string& path) : detail::mapped_sample_file(path)
+    {
+        parse();
+    }
+
+private:
+    void parse()
+    {
+        auto* bytes = file_data();
+        auto size = file_size();
+        if (size < 8 || !detail::chunk_id_equals(bytes, "caff") ||
+            detail::read_big_endian<std::uint16_t>(bytes + 4) != 1)
+        {
+            throw std::runtime_error("caf_file: not a CAF file");
+        }
+
+        // the desc chunk must be the first chunk
+        if (size < 52 || !detail::chunk_id_equals(bytes + 8, "desc") ||
+            detail::read_big_endian<std::uint64_t>(bytes + 12) < 32 ||
+            detail::read_big_endian<std::uint64_t>(bytes + 12) > size - 20)
+        {
+            throw std::runtime_error("caf_file: missing desc chunk");
+        }
+        auto* desc = bytes + 20;
+        if (!detail::chunk_id_equals(desc + 8, "lpcm"))
+        {
+            throw std::runtime_error("caf_file: only linear PCM data is supported");
+        }
+        auto sample_rate = detail::read_big_endian_float64(desc);
+        auto format_flags = detail::read_big_endian<std::uint32_t>(desc + 12);
+        auto bytes_per_packet = static_cast<size_type>(detail::read_big_endian<std::uint32_t>(desc + 16));
+        auto frames_per_packet = detail::read_big_endian<std::uint32_t>(desc + 20);
+        auto channels = static_cast<size_type>(detail::read_big_endian<std::uint32_t>(desc + 24));
+        auto bits_per_sample = static_cast<size_type>(detail::read_big_endian<std::uint32_t>(desc + 28));
+        if (!(sample_rate > 0) || frames_per_packet != 1 || channels == 0 || bits_per_sample == 0 ||
+            bits_per_sample > 32 || bytes_per_packet != channels * ((bits_per_sample + 7) / 8))
+        {
+            throw std::runtime_error("caf_file: packets don't match the channels and sample size");
+        }
+
+        auto offset = 20 + static_cast<size_type>(detail::read_big_endian<std::uint64_t>(bytes + 12));
+        while (size - offset >= 12)
+        {
+            auto* chunk = bytes + offset;
+            auto chunk_size = detail::read_big_endian<std::uint64_t>(chunk + 4);
+            auto body_offset = offset + 12;
+            auto available = static_cast<std::uint64_t>(size - body_offset);
+
+            if (detail::chunk_id_equals(chunk, "data"))
+            {
+                // the data chunk starts with an edit count
+                if (available < 4 || (chunk_size != detail::caf_unknown_chunk_size && chunk_size < 4))
+                {
+                    throw std::runtime_error("caf_file: data chunk is too small");
+                }
+                auto data_bytes = chunk_size == detail::caf_unknown_chunk_size ? available - 4 : chunk_size - 4;
+                set_sample_data(
+                    body_offset + 4,
+                    data_bytes / bytes_per_packet,
+                    channels,
+                    static_cast<size_type>(std::llround(sample_rate)),
+                    bits_per_sample,
+                    (format_flags & detail::caf_format_flag_is_float) != 0,
+                    (format_flags & detail::caf_format_flag_is_little_endian) == 0);
+                return;
+            }
+
+            // chunks aren't padded
+            if (chunk_size > available)
+            {
+                break;
+            }
+            offset = body_offset + static_cast<size_type>(chunk_size);
+        }
+        throw std::runtime_error("caf_file: no data chunk");
+    }
+};
+
+} // namespace ratl
+
+#endif // _ratl_caf_file_
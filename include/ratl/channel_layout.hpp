@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_channel_layout_
+#define _ratl_channel_layout_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+// other includes
+#include <cstddef>
+
+namespace ratl
+{
+// Channel layout policies for basic_noninterleaved
+// A layout decides the pitch of a buffer, i.e. the distance in samples between the start of consecutive channels.
+
+// Channels are stored back to back, so the pitch is equal to the number of frames
+struct packed_channel_layout
+{
+    template<typename SampleType>
+    static constexpr std::size_t pitch(std::size_t frames) noexcept
+    {
+        return frames;
+    }
+};
+
+// Each channel is padded so that it starts Alignment bytes after the start of the previous channel (or a multiple of
+// it), so every channel has the same alignment as the first. The padding is zeroed, so SIMD loads and stores can cover
+// the end of a channel with full vectors.
+template<std::size_t Alignment = RATL_SIMD_ALIGNMENT>
+struct aligned_channel_layout
+{
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2");
+
+    template<typename SampleType>
+    static constexpr std::size_t pitch(std::size_t frames) noexcept
+    {
+        return ((frames + pitch_multiple<SampleType>() - 1) / pitch_multiple<SampleType>()) *
+               pitch_multiple<SampleType>();
+    }
+
+private:
+    // Smallest number of samples that is a multiple of Alignment bytes, which handles samples whose size is not a
+    // power of 2 (e.g. packed 24 bit samples)
+    template<typename SampleType>
+    static constexpr std::size_t pitch_multiple() noexcept
+    {
+        return Alignment / gcd(Alignment, sizeof(SampleType));
+    }
+
+    static constexpr std::size_t gcd(std::size_t a, std::size_t b) noexcept
+    {
+        return b == 0 ? a : gcd(b, a % b);
+    }
+};
+
+} // namespace ratl
+
+#endif // _ratl_channel_layout_
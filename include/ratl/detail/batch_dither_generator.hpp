@@ -42,6 +42,13 @@ public:
 class batch_triangular_dither_generator : public triangular_dither_generator
 {
 public:
+    batch_triangular_dither_generator() = default;
+
+    explicit batch_triangular_dither_generator(std::uint32_t seed) noexcept :
+        triangular_dither_generator(seed), rng_(seed)
+    {
+    }
+
     inline detail::batch_sample_value_type_t<int32_t> generate_batch_int16() noexcept
     {
         return (xsimd::batch_cast<int32_t>(rng_()) >> static_cast<int32_t>(int16_shift())) +
@@ -82,6 +89,10 @@ private:
 class batch_shaped_dither_generator : public shaped_dither_generator
 {
 public:
+    batch_shaped_dither_generator() = default;
+
+    explicit batch_shaped_dither_generator(std::uint32_t seed) noexcept : shaped_dither_generator(seed), rng_(seed) {}
+
     inline detail::batch_sample_value_type_t<int32_t> generate_batch_int16() noexcept
     {
         return generate_high_pass() >> static_cast<int32_t>(int16_shift());
@@ -14,6 +14,7 @@
 #include <ratl/detail/batch_traits.hpp>
 #include <ratl/detail/batch_value_traits.hpp>
 #include <ratl/detail/config.hpp>
+#include <ratl/detail/endianness.hpp>
 
 // other includes
 #include <type_traits>
@@ -334,6 +335,114 @@ public:
     }
 };
 
+// batch_network_int24_to_int32_impl
+// Reverses each network int24 sample into the three most significant bytes of its 32 bit lane, which sign extends the
+// sample in the same shuffle that reverses it
+
+struct batch_network_int24_to_int32_impl
+{
+#    if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE3_VERSION
+#        if defined(RATL_CPP_VERSION_HAS_CPP17)
+private:
+    inline static const __m128i x4_mask = _mm_set_epi8(12, 13, 14, -1, 8, 9, 10, -1, 4, 5, 6, -1, 0, 1, 2, -1);
+
+public:
+#        endif
+    static inline xsimd::batch<std::uint32_t, 4> convert(const xsimd::batch<std::uint32_t, 4>& input) noexcept
+    {
+        static_assert(
+            std::is_same<
+                std::remove_cv_t<std::remove_reference_t<decltype(input)>>,
+                batch_network_sample_value_type_t<int24_t, 4>>::value,
+            "");
+#        if !defined(RATL_CPP_VERSION_HAS_CPP17)
+        static const __m128i x4_mask = _mm_set_epi8(12, 13, 14, -1, 8, 9, 10, -1, 4, 5, 6, -1, 0, 1, 2, -1);
+#        endif
+        return _mm_shuffle_epi8(input, x4_mask);
+    }
+#    endif
+
+#    if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+#        if defined(RATL_CPP_VERSION_HAS_CPP17)
+private:
+    // clang-format off
+    inline static const __m256i x8_mask = _mm256_set_epi8(
+        28, 29, 30, -1, 24, 25, 26, -1, 20, 21, 22, -1, 16, 17, 18, -1,
+        12, 13, 14, -1,  8,  9, 10, -1,  4,  5,  6, -1,  0,  1,  2, -1);
+    // clang-format on
+public:
+#        endif
+    static inline xsimd::batch<std::uint32_t, 8> convert(const xsimd::batch<std::uint32_t, 8>& input) noexcept
+    {
+        static_assert(
+            std::is_same<
+                std::remove_cv_t<std::remove_reference_t<decltype(input)>>,
+                batch_network_sample_value_type_t<int24_t, 8>>::value,
+            "");
+#        if !defined(RATL_CPP_VERSION_HAS_CPP17)
+        // clang-format off
+        static const __m256i x8_mask = _mm256_set_epi8(
+            28, 29, 30, -1, 24, 25, 26, -1, 20, 21, 22, -1, 16, 17, 18, -1,
+            12, 13, 14, -1,  8,  9, 10, -1,  4,  5,  6, -1,  0,  1,  2, -1);
+        // clang-format on
+#        endif
+        return _mm256_shuffle_epi8(input, x8_mask);
+    }
+#    endif
+
+#    if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX512_VERSION && defined(XSIMD_AVX512DQ_AVAILABLE)
+#        if defined(RATL_CPP_VERSION_HAS_CPP17)
+private:
+    // clang-format off
+    inline static const __m512i x16_mask = _mm512_set_epi8(
+        60, 61, 62, -1, 56, 57, 58, -1, 52, 53, 54, -1, 48, 49, 50, -1,
+        44, 45, 46, -1, 40, 41, 42, -1, 36, 37, 38, -1, 32, 33, 34, -1,
+        28, 29, 30, -1, 24, 25, 26, -1, 20, 21, 22, -1, 16, 17, 18, -1,
+        12, 13, 14, -1,  8,  9, 10, -1,  4,  5,  6, -1,  0,  1,  2, -1);
+    // clang-format on
+public:
+#        endif
+    static inline xsimd::batch<std::uint32_t, 16> convert(const xsimd::batch<std::uint32_t, 16>& input) noexcept
+    {
+        static_assert(
+            std::is_same<
+                std::remove_cv_t<std::remove_reference_t<decltype(input)>>,
+                batch_network_sample_value_type_t<int24_t, 16>>::value,
+            "");
+#        if !defined(RATL_CPP_VERSION_HAS_CPP17)
+        // clang-format off
+        static const __m512i x16_mask = _mm512_set_epi8(
+            60, 61, 62, -1, 56, 57, 58, -1, 52, 53, 54, -1, 48, 49, 50, -1,
+            44, 45, 46, -1, 40, 41, 42, -1, 36, 37, 38, -1, 32, 33, 34, -1,
+            28, 29, 30, -1, 24, 25, 26, -1, 20, 21, 22, -1, 16, 17, 18, -1,
+            12, 13, 14, -1,  8,  9, 10, -1,  4,  5,  6, -1,  0,  1,  2, -1);
+        // clang-format on
+#        endif
+        return _mm512_shuffle_epi8(input, x16_mask);
+    }
+#    endif
+
+#    if XSIMD_ARM_INSTR_SET >= XSIMD_ARM7_NEON_VERSION
+    static inline xsimd::batch<std::uint32_t, 4> convert(const xsimd::batch<std::uint32_t, 4>& input) noexcept
+    {
+        static_assert(
+            std::is_same<
+                std::remove_cv_t<std::remove_reference_t<decltype(input)>>,
+                batch_network_sample_value_type_t<int24_t, 4>>::value,
+            "");
+        return xsimd::bitwise_cast<xsimd::batch<std::uint32_t, 4>>(xsimd::batch<std::uint8_t, 16>(
+                   vrev32q_u8(xsimd::bitwise_cast<xsimd::batch<std::uint8_t, 16>>(input)))) &
+               0xffffff00;
+    }
+#    endif
+
+    template<class BatchNetworkSampleValueType>
+    static inline BatchNetworkSampleValueType convert(const BatchNetworkSampleValueType& input) noexcept
+    {
+        return ((input & 0x0000ff) << 24) | ((input & 0x00ff00) << 8) | ((input & 0xff0000) >> 8);
+    }
+};
+
 // batch_reverse_endianness
 
 template<typename NetworkSampleValueUnderlyingType, typename BatchNetworkSampleValueType>
@@ -386,6 +495,75 @@ inline batch_sample_value_type_t<SampleValueType> batch_network_sample_to_sample
         batch_network_to_host<network_sample_value_underlying_type_t<SampleValueType>>(input)));
 }
 
+// batch_network_int24_to_int32
+
+inline batch_sample_value_type_t<int32_t> batch_network_int24_to_int32(
+    const batch_network_sample_value_type_t<int24_t>& input) noexcept
+{
+#    if defined(RATL_CPP_LITTLE_ENDIAN)
+    return xsimd::bitwise_cast<batch_sample_value_type_t<int32_t>>(batch_network_int24_to_int32_impl::convert(input));
+#    else
+    return xsimd::bitwise_cast<batch_sample_value_type_t<int32_t>>(input << 8);
+#    endif
+}
+
+// batch_int32_to_network_int24
+
+// The int24 byte reversal shuffle reverses the three least significant bytes of each 32 bit lane and clears the most
+// significant byte, so it narrows a host int32 holding a 24 bit sample value to a network int24 sample in one shuffle
+inline batch_network_sample_value_type_t<int24_t> batch_int32_to_network_int24(
+    const batch_sample_value_type_t<int32_t>& input) noexcept
+{
+#    if defined(RATL_CPP_LITTLE_ENDIAN)
+    return batch_reverse_endianness<uint24_t>(xsimd::bitwise_cast<batch_network_sample_value_type_t<int24_t>>(input));
+#    else
+    return xsimd::bitwise_cast<batch_network_sample_value_type_t<int24_t>>(input) & 0xffffff;
+#    endif
+}
+
+// batch_network_sample_cast
+
+// Network samples of different widths can be held in batches with different lane widths, e.g. 16 bit lanes for int16
+// and 32 bit lanes for int24, so resizing them zero extends or truncates each lane
+template<typename OutputSampleValueType, typename BatchNetworkSampleValueType>
+inline std::enable_if_t<
+    std::is_same<batch_network_sample_value_type_t<OutputSampleValueType>, BatchNetworkSampleValueType>::value,
+    const BatchNetworkSampleValueType&>
+    batch_network_sample_cast(const BatchNetworkSampleValueType& input) noexcept
+{
+    return input;
+}
+
+template<typename OutputSampleValueType, typename BatchNetworkSampleValueType>
+inline std::enable_if_t<
+    !std::is_same<batch_network_sample_value_type_t<OutputSampleValueType>, BatchNetworkSampleValueType>::value,
+    batch_network_sample_value_type_t<OutputSampleValueType>>
+    batch_network_sample_cast(const BatchNetworkSampleValueType& input) noexcept
+{
+    return xsimd::batch_cast<typename batch_network_sample_value_type_t<OutputSampleValueType>::value_type>(input);
+}
+
+// batch_network_sample_resize
+
+template<typename OutputSampleValueType, typename InputSampleValueType>
+inline batch_network_sample_value_type_t<OutputSampleValueType> batch_network_sample_resize(
+    const batch_network_sample_value_type_t<InputSampleValueType>& input) noexcept
+{
+    using resize_traits = network_sample_resize_traits<OutputSampleValueType, InputSampleValueType>;
+    using input_value_type = typename batch_network_sample_value_type_t<InputSampleValueType>::value_type;
+
+    // the mask never keeps more bits than the input sample has, so it fits in the input lanes
+    constexpr auto mask = static_cast<input_value_type>(resize_traits::mask);
+#    if defined(RATL_CPP_LITTLE_ENDIAN)
+    return batch_network_sample_cast<OutputSampleValueType>(input & mask);
+#    else
+    // samples are only shifted right when they are narrowed and only shifted left when they are widened, so each shift
+    // is done at the wider of the two lane widths
+    return batch_network_sample_cast<OutputSampleValueType>((input & mask) >> resize_traits::right_shift)
+           << resize_traits::left_shift;
+#    endif
+}
+
 } // namespace detail
 } // namespace ratl
 
@@ -216,6 +216,29 @@ struct base_batch_fast_sample_converter_impl<sample<InputSampleType>, network_sa
     }
 };
 
+// float32 to network int24 rounds to 32 bit integers and narrows and reverses them in a single shuffle
+template<typename DitherGenerator>
+struct base_batch_fast_sample_converter_impl<sample<float32_t>, network_sample<int24_t>, DitherGenerator>
+{
+private:
+    static constexpr float32_t scaler =
+        asymmetric_float_convert_traits<int24_t>::float_to_int_scaler - DitherGenerator::float32_max;
+
+public:
+    static inline batch_network_sample_value_type_t<int24_t> batch_convert(
+        batch_sample_value_type_t<float32_t> input, DitherGenerator& dither_gen) noexcept
+    {
+        return batch_int32_to_network_int24(
+            batch_round<int32_t>((input * scaler) + dither_gen.generate_batch_float32()));
+    }
+};
+
+#    if !defined(RATL_CPP_VERSION_HAS_CPP17)
+template<typename DitherGenerator>
+constexpr float32_t
+    base_batch_fast_sample_converter_impl<sample<float32_t>, network_sample<int24_t>, DitherGenerator>::scaler;
+#    endif
+
 template<typename SampleValueType, typename DitherGenerator>
 struct base_batch_fast_sample_converter_impl<sample<SampleValueType>, network_sample<SampleValueType>, DitherGenerator>
 {
@@ -255,6 +278,89 @@ struct base_batch_fast_sample_converter_impl<network_sample<SampleValueType>, sa
     }
 };
 
+template<typename DitherGenerator>
+struct base_batch_fast_sample_converter_impl<network_sample<int24_t>, sample<int32_t>, DitherGenerator>
+{
+    static inline batch_sample_value_type_t<int32_t> batch_convert(
+        const batch_network_sample_value_type_t<int24_t>& input, DitherGenerator&) noexcept
+    {
+        return batch_network_int24_to_int32(input);
+    }
+};
+
+template<typename DitherGenerator>
+struct base_batch_fast_sample_converter_impl<network_sample<int24_t>, sample<float32_t>, DitherGenerator>
+{
+private:
+    // the int24 samples are scaled by 256, so they are converted with the int32 scaler
+    static constexpr float32_t scaler = asymmetric_float_convert_traits<int32_t>::int_to_float_scaler;
+
+public:
+    static inline batch_sample_value_type_t<float32_t> batch_convert(
+        const batch_network_sample_value_type_t<int24_t>& input, DitherGenerator&) noexcept
+    {
+        return xsimd::to_float(batch_network_int24_to_int32(input)) * scaler;
+    }
+};
+
+#    if !defined(RATL_CPP_VERSION_HAS_CPP17)
+template<typename DitherGenerator>
+constexpr float32_t
+    base_batch_fast_sample_converter_impl<network_sample<int24_t>, sample<float32_t>, DitherGenerator>::scaler;
+#    endif
+
+template<typename InputSampleType, typename OutputSampleType, typename DitherGenerator>
+struct base_batch_fast_sample_converter_impl<
+    network_sample<InputSampleType>,
+    network_sample<OutputSampleType>,
+    DitherGenerator>
+{
+private:
+    static inline batch_network_sample_value_type_t<OutputSampleType> batch_convert_impl(
+        const batch_network_sample_value_type_t<InputSampleType>& input, DitherGenerator&, std::true_type) noexcept
+    {
+        return batch_network_sample_resize<OutputSampleType, InputSampleType>(input);
+    }
+
+    static inline batch_network_sample_value_type_t<OutputSampleType> batch_convert_impl(
+        const batch_network_sample_value_type_t<InputSampleType>& input,
+        DitherGenerator& dither_gen,
+        std::false_type) noexcept
+    {
+        return base_batch_fast_sample_converter_impl<
+            sample<OutputSampleType>,
+            network_sample<OutputSampleType>,
+            DitherGenerator>::
+            batch_convert(
+                base_batch_fast_sample_converter_impl<
+                    network_sample<InputSampleType>,
+                    sample<OutputSampleType>,
+                    DitherGenerator>::batch_convert(input, dither_gen),
+                dither_gen);
+    }
+
+public:
+    static inline batch_network_sample_value_type_t<OutputSampleType> batch_convert(
+        const batch_network_sample_value_type_t<InputSampleType>& input, DitherGenerator& dither_gen) noexcept
+    {
+        return batch_convert_impl(
+            input, dither_gen, is_fast_network_sample_resize<InputSampleType, OutputSampleType, DitherGenerator>());
+    }
+};
+
+template<typename SampleValueType, typename DitherGenerator>
+struct base_batch_fast_sample_converter_impl<
+    network_sample<SampleValueType>,
+    network_sample<SampleValueType>,
+    DitherGenerator>
+{
+    static inline const batch_network_sample_value_type_t<SampleValueType>& batch_convert(
+        const batch_network_sample_value_type_t<SampleValueType>& input, DitherGenerator&) noexcept
+    {
+        return input;
+    }
+};
+
 // batch_fast_sample_converter_impl
 
 template<typename InputSampleType, typename OutputSampleType, typename DitherGenerator>
@@ -398,6 +398,41 @@ struct base_batch_reference_sample_converter_impl<
     }
 };
 
+template<typename InputSampleType, typename OutputSampleType, typename DitherGenerator>
+struct base_batch_reference_sample_converter_impl<
+    network_sample<InputSampleType>,
+    network_sample<OutputSampleType>,
+    DitherGenerator>
+{
+    static inline batch_network_sample_value_type_t<OutputSampleType> batch_convert(
+        const batch_network_sample_value_type_t<InputSampleType>& input, DitherGenerator& dither_gen) noexcept
+    {
+        return base_batch_reference_sample_converter_impl<
+            sample<OutputSampleType>,
+            network_sample<OutputSampleType>,
+            DitherGenerator>::
+            batch_convert(
+                base_batch_reference_sample_converter_impl<
+                    network_sample<InputSampleType>,
+                    sample<OutputSampleType>,
+                    DitherGenerator>::batch_convert(input, dither_gen),
+                dither_gen);
+    }
+};
+
+template<typename SampleValueType, typename DitherGenerator>
+struct base_batch_reference_sample_converter_impl<
+    network_sample<SampleValueType>,
+    network_sample<SampleValueType>,
+    DitherGenerator>
+{
+    static inline const batch_network_sample_value_type_t<SampleValueType>& batch_convert(
+        const batch_network_sample_value_type_t<SampleValueType>& input, DitherGenerator&) noexcept
+    {
+        return input;
+    }
+};
+
 // batch_reference_sample_converter_impl
 
 template<typename InputSampleType, typename OutputSampleType, typename DitherGenerator>
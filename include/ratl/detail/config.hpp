@@ -150,6 +150,60 @@
 #    define RATL_UNLIKELY(x) x
 #endif
 
+// cache line size
+// RATL_CACHE_LINE_SIZE
+
+#if !defined(RATL_CACHE_LINE_SIZE)
+#    if defined(RATL_CPP_ARCH_AARCH64) && defined(RATL_CPP_PLATFORM_MACOS)
+#        define RATL_CACHE_LINE_SIZE 128
+#    else
+#        define RATL_CACHE_LINE_SIZE 64
+#    endif
+#endif
+
+// simd alignment
+// RATL_SIMD_ALIGNMENT
+
+#if !defined(RATL_SIMD_ALIGNMENT)
+#    define RATL_SIMD_ALIGNMENT 64
+#endif
+
+// arena alignment
+// RATL_ARENA_ALIGNMENT
+
+#if !defined(RATL_ARENA_ALIGNMENT)
+#    if RATL_CACHE_LINE_SIZE > RATL_SIMD_ALIGNMENT
+#        define RATL_ARENA_ALIGNMENT RATL_CACHE_LINE_SIZE
+#    else
+#        define RATL_ARENA_ALIGNMENT RATL_SIMD_ALIGNMENT
+#    endif
+#endif
+
+// huge page size
+// RATL_HUGE_PAGE_SIZE
+
+#if !defined(RATL_HUGE_PAGE_SIZE)
+#    define RATL_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
+// polymorphic memory resources
+// RATL_HAS_MEMORY_RESOURCE
+
+#if defined(RATL_CPP_VERSION_HAS_CPP17) && defined(__has_include)
+#    if __has_include(<memory_resource>)
+#        define RATL_HAS_MEMORY_RESOURCE
+#    endif
+#endif
+
+// io_uring
+// RATL_HAS_IO_URING
+
+#if !defined(RATL_HAS_IO_URING) && defined(RATL_CPP_PLATFORM_LINUX) && defined(__has_include)
+#    if __has_include(<linux/io_uring.h>)
+#        define RATL_HAS_IO_URING
+#    endif
+#endif
+
 #if defined(RATL_CPP_COMPILER_MSVC) || defined(RATL_CPP_COMPILER_BACKEND_MSVC)
 #    if defined(RATL_CPP_VERSION_HAS_CPP20)
 #        define RATL_USE_INT24_MEMCPY_CONVERT
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_direct_file_
+#define _ratl_detail_direct_file_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/page_mapping.hpp>
+
+// other includes
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#endif
+
+namespace ratl
+{
+namespace detail
+{
+// Transfers to and from a direct file must be aligned to this many bytes in memory, in the file and in size
+static constexpr std::size_t direct_file_alignment = 4096;
+
+// File opened for writing at explicit offsets, bypassing the page cache where the platform and file system allow it
+// Bypassing the page cache stops long recordings from evicting everything else from memory, at the cost of requiring
+// every transfer to be aligned to direct_file_alignment. If the file system doesn't support unbuffered writes, the
+// file silently falls back to buffered writes, which have no alignment requirements.
+// The constructor throws std::system_error if the file can't be created, the other functions return an error code
+// rather than throwing, so they can be used from a thread that has no one to throw to.
+class direct_file
+{
+public:
+    using size_type = std::size_t;
+
+private:
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+    bool direct_ = false;
+
+public:
+    direct_file() noexcept = default;
+
+    direct_file(const std::string& path, bool direct)
+    {
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+        auto open = [&path](DWORD flags)
+        {
+            return CreateFileA(
+                path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, flags, nullptr);
+        };
+        if (direct)
+        {
+            file_ = open(FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING);
+            direct_ = (file_ != INVALID_HANDLE_VALUE);
+        }
+        if (file_ == INVALID_HANDLE_VALUE)
+        {
+            file_ = open(FILE_ATTRIBUTE_NORMAL);
+        }
+        if (file_ == INVALID_HANDLE_VALUE)
+        {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), path);
+        }
+#else
+        static constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC;
+        static constexpr mode_t mode = 0644;
+#    if defined(O_DIRECT)
+        if (direct)
+        {
+            fd_ = ::open(path.c_str(), flags | O_DIRECT, mode);
+            direct_ = (fd_ >= 0);
+        }
+#    endif
+        if (fd_ < 0)
+        {
+            fd_ = ::open(path.c_str(), flags, mode);
+        }
+        if (fd_ < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+#    if !defined(O_DIRECT) && defined(F_NOCACHE)
+        if (direct)
+        {
+            direct_ = (::fcntl(fd_, F_NOCACHE, 1) == 0);
+        }
+#    endif
+#endif
+        static_cast<void>(direct);
+    }
+
+    direct_file(const direct_file&) = delete;
+
+    direct_file(direct_file&& other) noexcept :
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+        file_(std::exchange(other.file_, INVALID_HANDLE_VALUE)),
+#else
+        fd_(std::exchange(other.fd_, -1)),
+#endif
+        direct_(other.direct_)
+    {
+    }
+
+    ~direct_file()
+    {
+        close();
+    }
+
+    direct_file& operator=(const direct_file&) = delete;
+
+    direct_file& operator=(direct_file&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+            file_ = std::exchange(other.file_, INVALID_HANDLE_VALUE);
+#else
+            fd_ = std::exchange(other.fd_, -1);
+#endif
+            direct_ = other.direct_;
+        }
+        return *this;
+    }
+
+    // Whether writes bypass the page cache, and so must be aligned
+    bool direct() const noexcept
+    {
+        return direct_;
+    }
+
+    // Writes size bytes at offset, returning 0 on success or the error that stopped the write
+    int write_at(const void* data, size_type size, std::uint64_t offset) noexcept
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        while (size > 0)
+        {
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset & 0xffffffff);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD written = 0;
+            auto chunk = static_cast<DWORD>(std::min<size_type>(size, 0x40000000));
+            if (!WriteFile(file_, bytes, chunk, &written, &overlapped))
+            {
+                return static_cast<int>(GetLastError());
+            }
+#else
+            auto written = ::pwrite(fd_, bytes, size, static_cast<off_t>(offset));
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return errno;
+            }
+#endif
+            bytes += written;
+            size -= static_cast<size_type>(written);
+            offset += static_cast<std::uint64_t>(written);
+        }
+        return 0;
+    }
+
+    // Sets the size of the file, returning 0 on success or the error
+    int truncate(std::uint64_t size) noexcept
+    {
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+        FILE_END_OF_FILE_INFO end_of_file{};
+        end_of_file.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFileInformationByHandle(file_, FileEndOfFileInfo, &end_of_file, sizeof(end_of_file)))
+        {
+            return static_cast<int>(GetLastError());
+        }
+        return 0;
+#else
+        return ::ftruncate(fd_, static_cast<off_t>(size)) == 0 ? 0 : errno;
+#endif
+    }
+
+    void close() noexcept
+    {
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+        if (file_ != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+    }
+};
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_direct_file_
@@ -44,6 +44,11 @@ public:
     static constexpr std::size_t int16_bits = 15;
     static constexpr float32_t float32_max = 1.0;
 
+    triangular_dither_generator() = default;
+
+    // Seeds the generator, e.g. so that blocks converted independently of each other each get their own dither
+    explicit triangular_dither_generator(std::uint32_t seed) noexcept : rng_(seed) {}
+
     inline constexpr int32_t generate_int16() noexcept
     {
         return (static_cast<int32_t>(rng_()) >> int16_shift) + (static_cast<int32_t>(rng_()) >> int16_shift);
@@ -71,6 +76,10 @@ public:
     static constexpr std::size_t int16_bits = 15;
     static constexpr float32_t float32_max = 1.0;
 
+    shaped_dither_generator() = default;
+
+    explicit shaped_dither_generator(std::uint32_t seed) noexcept : rng_(seed) {}
+
     inline constexpr int32_t generate_int16() noexcept
     {
         return generate_high_pass() >> int16_shift;
@@ -11,8 +11,10 @@
 // ratl includes
 #include <ratl/detail/cast.hpp>
 #include <ratl/detail/config.hpp>
+#include <ratl/sample_limits.hpp>
 
 // other includes
+#include <limits>
 #include <type_traits>
 
 namespace ratl
@@ -86,6 +88,90 @@ inline SampleValueType network_sample_to_sample(network_sample_value_type_t<Samp
         network_to_host(network_to_network_underlying_cast<SampleValueType>(input)));
 }
 
+// network_int24_to_int32
+
+// Converts a 24 bit network sample to a 32 bit host integer with the sample held in its three most significant bytes.
+// Reversing the byte order of the whole 32 bit word moves the sample's sign bit into the integer's sign bit, so there
+// is no separate sign extension step.
+inline int32_t network_int24_to_int32(network_sample_value_type_t<int24_t> input) noexcept
+{
+    auto value = static_cast<uint32_t>(network_to_network_underlying_cast<int24_t>(input));
+#if defined(RATL_CPP_LITTLE_ENDIAN)
+    return static_cast<int32_t>(reverse_endianness(value));
+#else
+    return static_cast<int32_t>(value << 8);
+#endif
+}
+
+// int32_to_network_int24
+
+// Converts a 32 bit host integer holding a 24 bit sample value to a 24 bit network sample in a single byte reversal
+inline network_sample_value_type_t<int24_t> int32_to_network_int24(int32_t input) noexcept
+{
+#if defined(RATL_CPP_LITTLE_ENDIAN)
+    return network_underlying_to_network_cast<int24_t>(
+        narrowing_cast<uint24_t>(reverse_endianness(static_cast<uint32_t>(input) << 8)));
+#else
+    return network_underlying_to_network_cast<int24_t>(
+        narrowing_cast<uint24_t>(static_cast<uint32_t>(input) & 0xffffff));
+#endif
+}
+
+// network_sample_resize_traits
+
+// Network samples of different widths only differ in the number of least significant bytes at the end of each sample,
+// so an integer network sample can be widened or truncated without reversing its byte order
+template<typename OutputSampleValueType, typename InputSampleValueType>
+struct network_sample_resize_traits
+{
+    static_assert(
+        sample_limits<InputSampleValueType>::is_integer && sample_limits<OutputSampleValueType>::is_integer,
+        "Only integer network samples can be resized");
+
+    static constexpr uint32_t input_bits = sample_limits<InputSampleValueType>::digits + 1;
+    static constexpr uint32_t output_bits = sample_limits<OutputSampleValueType>::digits + 1;
+
+#if defined(RATL_CPP_LITTLE_ENDIAN)
+    // The first byte in memory is the least significant byte of the host value, so the bytes of the sample that are
+    // kept are always the least significant bytes of the host value
+    static constexpr uint32_t mask =
+        std::numeric_limits<uint32_t>::max() >> (32 - (input_bits < output_bits ? input_bits : output_bits));
+    static constexpr uint32_t left_shift = 0;
+    static constexpr uint32_t right_shift = 0;
+#else
+    static constexpr uint32_t mask = std::numeric_limits<uint32_t>::max() >> (32 - input_bits);
+    static constexpr uint32_t left_shift = output_bits > input_bits ? output_bits - input_bits : 0;
+    static constexpr uint32_t right_shift = input_bits > output_bits ? input_bits - output_bits : 0;
+#endif
+};
+
+#if !defined(RATL_CPP_VERSION_HAS_CPP17)
+template<typename OutputSampleValueType, typename InputSampleValueType>
+constexpr uint32_t network_sample_resize_traits<OutputSampleValueType, InputSampleValueType>::input_bits;
+template<typename OutputSampleValueType, typename InputSampleValueType>
+constexpr uint32_t network_sample_resize_traits<OutputSampleValueType, InputSampleValueType>::output_bits;
+template<typename OutputSampleValueType, typename InputSampleValueType>
+constexpr uint32_t network_sample_resize_traits<OutputSampleValueType, InputSampleValueType>::mask;
+template<typename OutputSampleValueType, typename InputSampleValueType>
+constexpr uint32_t network_sample_resize_traits<OutputSampleValueType, InputSampleValueType>::left_shift;
+template<typename OutputSampleValueType, typename InputSampleValueType>
+constexpr uint32_t network_sample_resize_traits<OutputSampleValueType, InputSampleValueType>::right_shift;
+#endif
+
+// network_sample_resize
+
+// Widens an integer network sample by appending zeroed bytes, or truncates it by dropping its last bytes
+template<typename OutputSampleValueType, typename InputSampleValueType>
+inline network_sample_value_type_t<OutputSampleValueType> network_sample_resize(
+    network_sample_value_type_t<InputSampleValueType> input) noexcept
+{
+    using resize_traits = network_sample_resize_traits<OutputSampleValueType, InputSampleValueType>;
+    auto value = static_cast<uint32_t>(network_to_network_underlying_cast<InputSampleValueType>(input));
+    return network_underlying_to_network_cast<OutputSampleValueType>(
+        narrowing_cast<network_sample_value_underlying_type_t<OutputSampleValueType>>(
+            ((value & resize_traits::mask) << resize_traits::left_shift) >> resize_traits::right_shift));
+}
+
 } // namespace detail
 } // namespace ratl
 
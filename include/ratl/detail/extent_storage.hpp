@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_extent_storage_
+#define _ratl_detail_extent_storage_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/extent.hpp>
+
+// other includes
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace ratl
+{
+namespace detail
+{
+// Holds the number of channels of a span or iterator
+// Static extents take no storage and size() is a constant expression, so loops over channels can be fully unrolled.
+template<std::size_t Extent>
+class extent_storage
+{
+public:
+    constexpr extent_storage() noexcept = default;
+
+    constexpr explicit extent_storage(std::size_t size) noexcept
+    {
+        assert(size == Extent);
+        static_cast<void>(size);
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return Extent;
+    }
+};
+
+template<>
+class extent_storage<dynamic_extent>
+{
+    std::size_t size_ = 0;
+
+public:
+    constexpr extent_storage() noexcept = default;
+
+    constexpr explicit extent_storage(std::size_t size) noexcept : size_(size) {}
+
+    constexpr std::size_t size() const noexcept
+    {
+        return size_;
+    }
+};
+
+// An extent of From can be converted to an extent of To if they are the same or To is dynamic
+template<std::size_t From, std::size_t To>
+struct is_extent_convertible : std::integral_constant<bool, (From == To) || (To == dynamic_extent)>
+{
+};
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_extent_storage_
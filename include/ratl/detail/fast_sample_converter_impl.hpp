@@ -16,6 +16,7 @@
 #include <ratl/detail/round.hpp>
 #include <ratl/network_sample.hpp>
 #include <ratl/sample.hpp>
+#include <ratl/sample_limits.hpp>
 
 // other includes
 #include <cfenv>
@@ -26,6 +27,19 @@ namespace ratl
 {
 namespace detail
 {
+// is_fast_network_sample_resize
+
+// Fast integer widening conversions and undithered integer narrowing conversions only shift samples by whole bytes, so
+// between network samples they can be done by resizing the samples without converting them to host samples
+template<typename InputSampleValueType, typename OutputSampleValueType, typename DitherGenerator>
+struct is_fast_network_sample_resize :
+    std::integral_constant<
+        bool,
+        sample_limits<InputSampleValueType>::is_integer && sample_limits<OutputSampleValueType>::is_integer &&
+            (!std::is_same<OutputSampleValueType, int16_t>::value || DitherGenerator::int16_bits == 0)>
+{
+};
+
 // fast_sample_converter_impl
 
 template<typename InputSampleType, typename OutputSampleType, typename DitherGenerator, typename = void>
@@ -139,6 +153,28 @@ public:
     }
 };
 
+// float32 to network int24 rounds to a 32 bit integer and reverses its byte order in one step
+template<typename DitherGenerator>
+struct fast_sample_converter_impl<sample<float32_t>, network_sample<int24_t>, DitherGenerator>
+{
+private:
+    static constexpr float32_t scaler =
+        asymmetric_float_convert_traits<int24_t>::float_to_int_scaler - DitherGenerator::float32_max;
+
+public:
+    static inline network_sample_value_type_t<int24_t> convert(float32_t input, DitherGenerator& dither_gen) noexcept
+    {
+        return int32_to_network_int24(
+            round_float32_to_int32_fast((input * scaler) + dither_gen.generate_float32()));
+    }
+};
+
+#if !defined(RATL_CPP_VERSION_HAS_CPP17)
+template<typename DitherGenerator>
+constexpr float32_t
+    fast_sample_converter_impl<sample<float32_t>, network_sample<int24_t>, DitherGenerator>::scaler;
+#endif
+
 template<typename InputSampleType, typename OutputSampleType, typename DitherGenerator>
 struct fast_sample_converter_impl<sample<InputSampleType>, network_sample<OutputSampleType>, DitherGenerator>
 {
@@ -185,6 +221,76 @@ struct fast_sample_converter_impl<network_sample<SampleValueType>, sample<Sample
     }
 };
 
+// Network int24 samples are reversed straight into the most significant bytes of a 32 bit integer, which is both the
+// fast int24 to int32 conversion and a sign extended int24 sample scaled by 256
+template<typename DitherGenerator>
+struct fast_sample_converter_impl<network_sample<int24_t>, sample<int32_t>, DitherGenerator>
+{
+    static inline int32_t convert(network_sample_value_type_t<int24_t> input, DitherGenerator&) noexcept
+    {
+        return network_int24_to_int32(input);
+    }
+};
+
+template<typename DitherGenerator>
+struct fast_sample_converter_impl<network_sample<int24_t>, sample<float32_t>, DitherGenerator>
+{
+private:
+    // the int24 sample is scaled by 256, so it is converted with the int32 scaler
+    static constexpr float32_t scaler = asymmetric_float_convert_traits<int32_t>::int_to_float_scaler;
+
+public:
+    static inline float32_t convert(network_sample_value_type_t<int24_t> input, DitherGenerator&) noexcept
+    {
+        return static_cast<float32_t>(network_int24_to_int32(input)) * scaler;
+    }
+};
+
+#if !defined(RATL_CPP_VERSION_HAS_CPP17)
+template<typename DitherGenerator>
+constexpr float32_t
+    fast_sample_converter_impl<network_sample<int24_t>, sample<float32_t>, DitherGenerator>::scaler;
+#endif
+
+template<typename InputSampleType, typename OutputSampleType, typename DitherGenerator>
+struct fast_sample_converter_impl<network_sample<InputSampleType>, network_sample<OutputSampleType>, DitherGenerator>
+{
+private:
+    static inline network_sample_value_type_t<OutputSampleType> convert_impl(
+        network_sample_value_type_t<InputSampleType> input, DitherGenerator&, std::true_type) noexcept
+    {
+        return network_sample_resize<OutputSampleType, InputSampleType>(input);
+    }
+
+    static inline network_sample_value_type_t<OutputSampleType> convert_impl(
+        network_sample_value_type_t<InputSampleType> input, DitherGenerator& dither_gen, std::false_type) noexcept
+    {
+        return fast_sample_converter_impl<sample<OutputSampleType>, network_sample<OutputSampleType>, DitherGenerator>::
+            convert(
+                fast_sample_converter_impl<network_sample<InputSampleType>, sample<OutputSampleType>, DitherGenerator>::
+                    convert(input, dither_gen),
+                dither_gen);
+    }
+
+public:
+    static inline network_sample_value_type_t<OutputSampleType> convert(
+        network_sample_value_type_t<InputSampleType> input, DitherGenerator& dither_gen) noexcept
+    {
+        return convert_impl(
+            input, dither_gen, is_fast_network_sample_resize<InputSampleType, OutputSampleType, DitherGenerator>());
+    }
+};
+
+template<typename SampleValueType, typename DitherGenerator>
+struct fast_sample_converter_impl<network_sample<SampleValueType>, network_sample<SampleValueType>, DitherGenerator>
+{
+    static inline const network_sample_value_type_t<SampleValueType>& convert(
+        const network_sample_value_type_t<SampleValueType>& input, DitherGenerator&) noexcept
+    {
+        return input;
+    }
+};
+
 } // namespace detail
 } // namespace ratl
 
@@ -10,7 +10,9 @@
 
 // ratl includes
 #include <ratl/detail/config.hpp>
+#include <ratl/detail/extent_storage.hpp>
 #include <ratl/detail/operator_arrow_proxy.hpp>
+#include <ratl/extent.hpp>
 #include <ratl/frame_span.hpp>
 
 // other includes
@@ -20,7 +22,7 @@ namespace ratl
 {
 namespace detail
 {
-template<typename SampleType, typename SampleTraits>
+template<typename SampleType, typename SampleTraits, std::size_t Extent = dynamic_extent>
 class interleaved_iterator
 {
     static_assert(
@@ -31,7 +33,7 @@ class interleaved_iterator
     using sample_type = typename sample_traits::sample_type;
     using sample_pointer = typename sample_traits::pointer;
 
-    using frame_type = basic_frame_span<sample_type, sample_traits, std::true_type>;
+    using frame_type = basic_frame_span<sample_type, sample_traits, std::true_type, Extent>;
 
     using size_type = std::size_t;
 
@@ -46,7 +48,7 @@ public:
 
 private:
     sample_pointer data_ = nullptr;
-    size_type channels_ = 0;
+    extent_storage<Extent> channels_;
 
 public:
     interleaved_iterator() noexcept = default;
@@ -55,11 +57,17 @@ public:
 
     interleaved_iterator(const interleaved_iterator& other) noexcept = default;
 
+    // Also converts an iterator with a static extent to one with a dynamic extent
     template<
         typename ArgSampleType,
         typename ArgSampleTraits,
-        typename std::enable_if_t<std::is_same<const_sample_traits_t<ArgSampleTraits>, SampleTraits>::value, int> = 0>
-    interleaved_iterator(const interleaved_iterator<ArgSampleType, ArgSampleTraits>& other) noexcept :
+        std::size_t ArgExtent,
+        typename std::enable_if_t<
+            (std::is_same<const_sample_traits_t<ArgSampleTraits>, SampleTraits>::value ||
+             std::is_same<ArgSampleTraits, SampleTraits>::value) &&
+                is_extent_convertible<ArgExtent, Extent>::value,
+            int> = 0>
+    interleaved_iterator(const interleaved_iterator<ArgSampleType, ArgSampleTraits, ArgExtent>& other) noexcept :
         data_(other.base()), channels_(other.channels())
     {
         static_assert(
@@ -72,40 +80,46 @@ public:
     template<
         typename ArgSampleType,
         typename ArgSampleTraits,
-        typename std::enable_if_t<std::is_same<const_sample_traits_t<ArgSampleTraits>, SampleTraits>::value, int> = 0>
-    interleaved_iterator& operator=(const interleaved_iterator<ArgSampleType, ArgSampleTraits>& other) noexcept
+        std::size_t ArgExtent,
+        typename std::enable_if_t<
+            (std::is_same<const_sample_traits_t<ArgSampleTraits>, SampleTraits>::value ||
+             std::is_same<ArgSampleTraits, SampleTraits>::value) &&
+                is_extent_convertible<ArgExtent, Extent>::value,
+            int> = 0>
+    interleaved_iterator& operator=(
+        const interleaved_iterator<ArgSampleType, ArgSampleTraits, ArgExtent>& other) noexcept
     {
         static_assert(
             std::is_same<typename ArgSampleTraits::sample_type, ArgSampleType>::value,
             "sample_type in SampleTraits must be the same type as SampleType");
         data_ = other.base();
-        channels_ = other.channels();
+        channels_ = extent_storage<Extent>(other.channels());
         return *this;
     }
 
-    inline size_type channels() const noexcept
+    inline constexpr size_type channels() const noexcept
     {
-        return channels_;
+        return channels_.size();
     }
 
     inline reference operator*() const noexcept
     {
-        return reference(data_, channels_);
+        return reference(data_, channels());
     }
 
     inline pointer operator->() const noexcept
     {
-        return pointer(reference(data_, channels_));
+        return pointer(reference(data_, channels()));
     }
 
     inline reference operator[](difference_type n) const noexcept
     {
-        return reference(data_ + (n * channels_), channels_);
+        return reference(data_ + (n * channels()), channels());
     }
 
     inline interleaved_iterator& operator++() noexcept
     {
-        data_ += channels_;
+        data_ += channels();
         return *this;
     }
 
@@ -118,7 +132,7 @@ public:
 
     inline interleaved_iterator& operator--() noexcept
     {
-        data_ -= channels_;
+        data_ -= channels();
         return *this;
     }
 
@@ -138,7 +152,7 @@ public:
 
     inline interleaved_iterator& operator+=(difference_type n) noexcept
     {
-        data_ += static_cast<difference_type>(n * channels_);
+        data_ += static_cast<difference_type>(n * channels());
         return *this;
     }
 
@@ -211,7 +225,7 @@ public:
     friend inline typename interleaved_iterator::difference_type operator-(
         const interleaved_iterator& x, const interleaved_iterator& y)
     {
-        return (x.data_ - y.data_) / static_cast<typename interleaved_iterator::difference_type>(x.channels_);
+        return (x.data_ - y.data_) / static_cast<typename interleaved_iterator::difference_type>(x.channels());
     }
 
     inline sample_pointer base() const noexcept
@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_io_uring_
+#define _ratl_detail_io_uring_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+// other includes
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+#if defined(RATL_HAS_IO_URING)
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <sys/uio.h>
+#    include <unistd.h>
+#endif
+
+#if defined(RATL_HAS_IO_URING)
+
+namespace ratl
+{
+namespace detail
+{
+// Minimal io_uring submission and completion queue pair, driven through the raw system calls
+// Submissions are copied into the submission queue by push() and handed to the kernel by submit(), which can also
+// wait for completions. Completions are consumed with pop(). push() and submit() must not be called concurrently with
+// each other, and pop() must only be called from one thread, but a thread can wait in submit() while another pushes.
+// The constructor throws std::system_error if the kernel doesn't support io_uring or it has been disabled.
+class io_uring_queue
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    int fd_ = -1;
+    io_uring_params params_{};
+
+    void* sq_ring_ = nullptr;
+    size_type sq_ring_bytes_ = 0;
+    void* cq_ring_ = nullptr;
+    size_type cq_ring_bytes_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_type sqes_bytes_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned cq_mask_ = 0;
+
+    unsigned pending_ = 0;
+
+public:
+    explicit io_uring_queue(unsigned entries)
+    {
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params_));
+        if (fd_ < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+        }
+
+        sq_ring_bytes_ = params_.sq_off.array + (params_.sq_entries * sizeof(unsigned));
+        cq_ring_bytes_ = params_.cq_off.cqes + (params_.cq_entries * sizeof(io_uring_cqe));
+        sqes_bytes_ = params_.sq_entries * sizeof(io_uring_sqe);
+        sq_ring_ = map(sq_ring_bytes_, IORING_OFF_SQ_RING);
+        cq_ring_ = sq_ring_ != nullptr ? map(cq_ring_bytes_, IORING_OFF_CQ_RING) : nullptr;
+        void* sqes = cq_ring_ != nullptr ? map(sqes_bytes_, IORING_OFF_SQES) : nullptr;
+        if (sqes == nullptr)
+        {
+            auto error = errno;
+            close();
+            throw std::system_error(error, std::generic_category(), "io_uring mmap");
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq_ring = static_cast<unsigned char*>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq_ring + params_.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq_ring + params_.sq_off.tail);
+        sq_array_ = reinterpret_cast<unsigned*>(sq_ring + params_.sq_off.array);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq_ring + params_.sq_off.ring_mask);
+        auto* cq_ring = static_cast<unsigned char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq_ring + params_.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq_ring + params_.cq_off.tail);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring + params_.cq_off.cqes);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq_ring + params_.cq_off.ring_mask);
+    }
+
+    io_uring_queue(const io_uring_queue&) = delete;
+    io_uring_queue& operator=(const io_uring_queue&) = delete;
+
+    ~io_uring_queue()
+    {
+        close();
+    }
+
+    // Entries in the submission queue, which may be more than were asked for
+    size_type entries() const noexcept
+    {
+        return params_.sq_entries;
+    }
+
+    // Registers buffers for fixed reads and writes, returns false if they couldn't be registered (e.g. if they would
+    // exceed the locked memory limit)
+    bool register_buffers(const iovec* buffers, unsigned count) noexcept
+    {
+        return ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+    }
+
+    // Copies a submission into the queue, returns false if the queue is full
+    bool push(const io_uring_sqe& sqe) noexcept
+    {
+        auto tail = *sq_tail_;
+        if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= params_.sq_entries)
+        {
+            return false;
+        }
+        auto index = tail & sq_mask_;
+        sqes_[index] = sqe;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++pending_;
+        return true;
+    }
+
+    // Submissions pushed but not yet taken by the kernel
+    unsigned pending() const noexcept
+    {
+        return pending_;
+    }
+
+    // Takes back the submissions that the kernel hasn't taken
+    void discard_pending() noexcept
+    {
+        __atomic_store_n(sq_tail_, *sq_tail_ - pending_, __ATOMIC_RELEASE);
+        pending_ = 0;
+    }
+
+    // Hands the pending submissions to the kernel and, if wait_for is not 0, waits until at least that many
+    // completions are available. Returns 0 on success or the error, which is EINTR if a signal interrupted the wait.
+    int submit(unsigned wait_for = 0) noexcept
+    {
+        auto to_submit = pending_;
+        auto flags = wait_for != 0 ? IORING_ENTER_GETEVENTS : 0u;
+        auto submitted = ::syscall(__NR_io_uring_enter, fd_, to_submit, wait_for, flags, nullptr, 0);
+        if (submitted < 0)
+        {
+            return errno;
+        }
+        pending_ -= static_cast<unsigned>(submitted);
+        return 0;
+    }
+
+    // Waits until at least one completion is available, without submitting anything
+    int wait() noexcept
+    {
+        if (::syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0)
+        {
+            return errno;
+        }
+        return 0;
+    }
+
+    // Copies out and consumes the oldest completion, returns false if there are none
+    bool pop(io_uring_cqe& cqe) noexcept
+    {
+        auto head = *cq_head_;
+        if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+        {
+            return false;
+        }
+        cqe = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    void* map(size_type bytes, std::uint64_t offset) noexcept
+    {
+        auto* data =
+            ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, static_cast<off_t>(offset));
+        return data != MAP_FAILED ? data : nullptr;
+    }
+
+    void close() noexcept
+    {
+        if (sqes_ != nullptr)
+        {
+            ::munmap(sqes_, sqes_bytes_);
+        }
+        if (cq_ring_ != nullptr)
+        {
+            ::munmap(cq_ring_, cq_ring_bytes_);
+        }
+        if (sq_ring_ != nullptr)
+        {
+            ::munmap(sq_ring_, sq_ring_bytes_);
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+        sqes_ = nullptr;
+        cq_ring_ = nullptr;
+        sq_ring_ = nullptr;
+        fd_ = -1;
+    }
+};
+
+// Fills in a read or write of size bytes at offset, into or out of buffer buffer_index if it is registered
+inline io_uring_sqe make_io_uring_transfer(
+    bool read,
+    int fd,
+    void* data,
+    std::size_t size,
+    std::uint64_t offset,
+    int buffer_index,
+    std::uint64_t user_data) noexcept
+{
+    io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    if (buffer_index >= 0)
+    {
+        sqe.opcode = read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+        sqe.buf_index = static_cast<std::uint16_t>(buffer_index);
+    }
+    else
+    {
+        sqe.opcode = read ? IORING_OP_READ : IORING_OP_WRITE;
+    }
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uint64_t>(data);
+    sqe.len = static_cast<std::uint32_t>(size);
+    sqe.off = offset;
+    sqe.user_data = user_data;
+    return sqe;
+}
+
+} // namespace detail
+} // namespace ratl
+
+#endif
+
+#endif // _ratl_detail_io_uring_
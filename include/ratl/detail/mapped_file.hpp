@@ -0,0 +1,276 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_mapped_file_
+#define _ratl_detail_mapped_file_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/page_mapping.hpp>
+
+// other includes
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#endif
+
+namespace ratl
+{
+namespace detail
+{
+// Read-only mapping of a whole file
+// The mapping is shared with the page cache, so nothing is read until it is touched and pages can be dropped again
+// once they have been consumed. Throws std::system_error if the file can't be opened or mapped.
+class mapped_file
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_type size_ = 0;
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+
+public:
+    mapped_file() noexcept = default;
+
+    explicit mapped_file(const std::string& path)
+    {
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+        file_ = CreateFileA(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+        if (file_ == INVALID_HANDLE_VALUE)
+        {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), path);
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_, &file_size))
+        {
+            auto error = static_cast<int>(GetLastError());
+            close();
+            throw std::system_error(error, std::system_category(), path);
+        }
+        size_ = static_cast<size_type>(file_size.QuadPart);
+        if (size_ == 0)
+        {
+            return;
+        }
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr)
+        {
+            auto error = static_cast<int>(GetLastError());
+            close();
+            throw std::system_error(error, std::system_category(), path);
+        }
+        data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr)
+        {
+            auto error = static_cast<int>(GetLastError());
+            close();
+            throw std::system_error(error, std::system_category(), path);
+        }
+#else
+        auto fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        struct stat file_stat;
+        if (::fstat(fd, &file_stat) != 0)
+        {
+            auto error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+        size_ = static_cast<size_type>(file_stat.st_size);
+        if (size_ == 0)
+        {
+            ::close(fd);
+            return;
+        }
+        // the mapping keeps the file alive, so the descriptor isn't needed once it has been made
+        auto* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        auto error = errno;
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            size_ = 0;
+            throw std::system_error(error, std::generic_category(), path);
+        }
+        data_ = static_cast<const unsigned char*>(data);
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) noexcept :
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0))
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+        ,
+        file_(std::exchange(other.file_, INVALID_HANDLE_VALUE)),
+        mapping_(std::exchange(other.mapping_, nullptr))
+#endif
+    {
+    }
+
+    ~mapped_file()
+    {
+        close();
+    }
+
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+            file_ = std::exchange(other.file_, INVALID_HANDLE_VALUE);
+            mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    const unsigned char* data() const noexcept
+    {
+        return data_;
+    }
+
+    size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    // Hints that the file will be read from start to end, so the kernel reads ahead aggressively and drops pages
+    // behind the reader
+    void advise_sequential() const noexcept
+    {
+#if !defined(RATL_CPP_PLATFORM_WINDOWS) && defined(MADV_SEQUENTIAL)
+        advise(0, size_, MADV_SEQUENTIAL);
+#endif
+    }
+
+    // Starts reading [offset, offset + size) into the page cache without waiting for it
+    void advise_will_need(size_type offset, size_type size) const noexcept
+    {
+#if !defined(RATL_CPP_PLATFORM_WINDOWS) && defined(MADV_WILLNEED)
+        advise(offset, size, MADV_WILLNEED);
+#else
+        static_cast<void>(offset);
+        static_cast<void>(size);
+#endif
+    }
+
+    // Releases the pages of [offset, offset + size) once they have been consumed, they are read again if touched
+    void advise_dont_need(size_type offset, size_type size) const noexcept
+    {
+#if !defined(RATL_CPP_PLATFORM_WINDOWS) && defined(MADV_DONTNEED)
+        advise(offset, size, MADV_DONTNEED);
+#else
+        static_cast<void>(offset);
+        static_cast<void>(size);
+#endif
+    }
+
+private:
+    void close() noexcept
+    {
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+        if (data_ != nullptr)
+        {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_ != nullptr)
+        {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file_);
+        }
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<unsigned char*>(data_), size_);
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+    // madvise needs a page aligned start, so the range is widened to whole pages
+    void advise(size_type offset, size_type size, int advice) const noexcept
+    {
+        if (data_ == nullptr || offset >= size_)
+        {
+            return;
+        }
+        auto end = std::min(offset + size, size_);
+        auto start = offset - (offset % page_size());
+        ::madvise(const_cast<unsigned char*>(data_) + start, end - start, advice);
+    }
+#endif
+};
+
+// Little endian and big endian integers stored at arbitrary offsets in a file
+
+template<typename Tp>
+inline Tp read_little_endian(const unsigned char* data) noexcept
+{
+    Tp value = 0;
+    for (std::size_t byte_num = 0; byte_num < sizeof(Tp); ++byte_num)
+    {
+        value = static_cast<Tp>(value | (static_cast<Tp>(data[byte_num]) << (byte_num * 8)));
+    }
+    return value;
+}
+
+template<typename Tp>
+inline Tp read_big_endian(const unsigned char* data) noexcept
+{
+    Tp value = 0;
+    for (std::size_t byte_num = 0; byte_num < sizeof(Tp); ++byte_num)
+    {
+        value = static_cast<Tp>((value << 8) | static_cast<Tp>(data[byte_num]));
+    }
+    return value;
+}
+
+inline bool chunk_id_equals(const unsigned char* data, const char* id) noexcept
+{
+    return std::equal(data, data + 4, reinterpret_cast<const unsigned char*>(id));
+}
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_mapped_file_
@@ -0,0 +1,279 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_mapped_sample_file_
+#define _ratl_detail_mapped_sample_file_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/mapped_file.hpp>
+#include <ratl/interleaved_span.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/sample.hpp>
+#include <ratl/types.hpp>
+
+// other includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace ratl
+{
+namespace detail
+{
+template<typename SampleValueType>
+struct sample_file_format;
+
+template<>
+struct sample_file_format<int16_t>
+{
+    static constexpr bool is_float = false;
+    static constexpr std::size_t bits_per_sample = 16;
+};
+
+template<>
+struct sample_file_format<int24_t>
+{
+    static constexpr bool is_float = false;
+    static constexpr std::size_t bits_per_sample = 24;
+};
+
+template<>
+struct sample_file_format<int32_t>
+{
+    static constexpr bool is_float = false;
+    static constexpr std::size_t bits_per_sample = 32;
+};
+
+template<>
+struct sample_file_format<float32_t>
+{
+    static constexpr bool is_float = true;
+    static constexpr std::size_t bits_per_sample = 32;
+};
+
+// Memory mapped file holding a single block of interleaved samples in either byte order
+// Derived classes parse their container format and call set_sample_data once they have found the samples. The
+// samples can be viewed as host order samples if they are stored in host byte order, and as network order samples if
+// they are stored big endian, so big endian data can be read on any host with the byte swap left to whatever transform
+// consumes the span.
+class mapped_sample_file
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    mapped_file file_;
+    size_type channels_ = 0;
+    size_type frames_ = 0;
+    size_type sample_rate_ = 0;
+    size_type bits_per_sample_ = 0;
+    size_type valid_bits_per_sample_ = 0;
+    size_type block_align_ = 0;
+    size_type data_offset_ = 0;
+    bool is_float_ = false;
+    bool is_big_endian_ = false;
+
+public:
+    size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    size_type frames() const noexcept
+    {
+        return frames_;
+    }
+
+    size_type sample_rate() const noexcept
+    {
+        return sample_rate_;
+    }
+
+    // Size of each sample in the file
+    size_type bits_per_sample() const noexcept
+    {
+        return bits_per_sample_;
+    }
+
+    // Number of bits of each sample that hold audio, which can be fewer than bits_per_sample
+    size_type valid_bits_per_sample() const noexcept
+    {
+        return valid_bits_per_sample_;
+    }
+
+    bool is_float() const noexcept
+    {
+        return is_float_;
+    }
+
+    // Whether the samples are stored big endian, i.e. whether they can be viewed with network_samples()
+    bool is_big_endian() const noexcept
+    {
+        return is_big_endian_;
+    }
+
+    // Whether the file holds host order samples of SampleValueType, i.e. whether samples<SampleValueType>() will
+    // succeed
+    template<typename SampleValueType>
+    bool holds() const noexcept
+    {
+#if defined(RATL_CPP_BIG_ENDIAN)
+        auto host_order = is_big_endian_;
+#else
+        auto host_order = !is_big_endian_;
+#endif
+        return host_order && holds_format<SampleValueType, sample<SampleValueType>>();
+    }
+
+    // Whether the file holds network order samples of SampleValueType, i.e. whether network_samples<SampleValueType>()
+    // will succeed
+    template<typename SampleValueType>
+    bool holds_network() const noexcept
+    {
+        return is_big_endian_ && holds_format<SampleValueType, network_sample<SampleValueType>>();
+    }
+
+    // Views every frame as host order samples. Throws std::invalid_argument if the file doesn't hold host order
+    // samples of SampleValueType, or if the samples aren't aligned for them.
+    template<typename SampleValueType>
+    const_interleaved_span<SampleValueType> samples() const
+    {
+        return samples<SampleValueType>(0, frames_);
+    }
+
+    // Views frames [first_frame, first_frame + frames) as host order samples. Throws std::out_of_range if they aren't
+    // all in the file.
+    template<typename SampleValueType>
+    const_interleaved_span<SampleValueType> samples(size_type first_frame, size_type frames) const
+    {
+        if (!holds<SampleValueType>())
+        {
+            throw std::invalid_argument("mapped_sample_file: file doesn't hold the requested sample type");
+        }
+        check_frames(first_frame, frames);
+        return const_interleaved_span<SampleValueType>(
+            file_.data() + frame_offset(first_frame), channels_, frames);
+    }
+
+    // Views every frame as network order samples. Throws std::invalid_argument if the file doesn't hold big endian
+    // samples of SampleValueType, or if the samples aren't aligned for them.
+    template<typename SampleValueType>
+    const_network_interleaved_span<SampleValueType> network_samples() const
+    {
+        return network_samples<SampleValueType>(0, frames_);
+    }
+
+    // Views frames [first_frame, first_frame + frames) as network order samples. Throws std::out_of_range if they
+    // aren't all in the file.
+    template<typename SampleValueType>
+    const_network_interleaved_span<SampleValueType> network_samples(size_type first_frame, size_type frames) const
+    {
+        if (!holds_network<SampleValueType>())
+        {
+            throw std::invalid_argument("mapped_sample_file: file doesn't hold the requested sample type");
+        }
+        check_frames(first_frame, frames);
+        return const_network_interleaved_span<SampleValueType>(
+            file_.data() + frame_offset(first_frame), channels_, frames);
+    }
+
+    // Starts reading frames [first_frame, first_frame + frames) from disk without waiting for them
+    void will_need(size_type first_frame, size_type frames) const noexcept
+    {
+        file_.advise_will_need(frame_offset(first_frame), frames * block_align_);
+    }
+
+    // Releases frames [first_frame, first_frame + frames) from memory once they have been consumed
+    void dont_need(size_type first_frame, size_type frames) const noexcept
+    {
+        file_.advise_dont_need(frame_offset(first_frame), frames * block_align_);
+    }
+
+protected:
+    explicit mapped_sample_file(const std::string& path) : file_(path) {}
+
+    const unsigned char* file_data() const noexcept
+    {
+        return file_.data();
+    }
+
+    size_type file_size() const noexcept
+    {
+        return file_.size();
+    }
+
+    // Records where the samples are and how they are stored. valid_bits_per_sample is rounded up to a whole number of
+    // bytes to give the size of each sample. The frames are truncated to those that are present in the file.
+    void set_sample_data(
+        size_type data_offset,
+        std::uint64_t frames,
+        size_type channels,
+        size_type sample_rate,
+        size_type valid_bits_per_sample,
+        bool is_float,
+        bool is_big_endian)
+    {
+        auto bits_per_sample = ((valid_bits_per_sample + 7) / 8) * 8;
+        if (channels == 0)
+        {
+            throw std::runtime_error("mapped_sample_file: file has no channels");
+        }
+        if ((is_float && bits_per_sample != 32) ||
+            (!is_float && bits_per_sample != 16 && bits_per_sample != 24 && bits_per_sample != 32))
+        {
+            throw std::runtime_error("mapped_sample_file: only 16, 24 and 32 bit integer and 32 bit float samples are "
+                                     "supported");
+        }
+        if (data_offset > file_.size())
+        {
+            throw std::runtime_error("mapped_sample_file: sample data starts past the end of the file");
+        }
+
+        channels_ = channels;
+        sample_rate_ = sample_rate;
+        bits_per_sample_ = bits_per_sample;
+        valid_bits_per_sample_ = valid_bits_per_sample;
+        block_align_ = channels * (bits_per_sample / 8);
+        data_offset_ = data_offset;
+        is_float_ = is_float;
+        is_big_endian_ = is_big_endian;
+
+        auto available_frames = static_cast<std::uint64_t>((file_.size() - data_offset) / block_align_);
+        frames_ = static_cast<size_type>(std::min(frames, available_frames));
+        file_.advise_sequential();
+    }
+
+private:
+    template<typename SampleValueType, typename Sample>
+    bool holds_format() const noexcept
+    {
+        using sample_format = sample_file_format<SampleValueType>;
+        return is_float_ == sample_format::is_float && bits_per_sample_ == sample_format::bits_per_sample &&
+               reinterpret_cast<std::uintptr_t>(file_.data() + data_offset_) % alignof(Sample) == 0;
+    }
+
+    void check_frames(size_type first_frame, size_type frames) const
+    {
+        if (first_frame > frames_ || frames > frames_ - first_frame)
+        {
+            throw std::out_of_range("mapped_sample_file");
+        }
+    }
+
+    size_type frame_offset(size_type frame_num) const noexcept
+    {
+        return data_offset_ + (frame_num * block_align_);
+    }
+};
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_mapped_sample_file_
@@ -48,11 +48,29 @@ public:
 private:
     sample_pointer data_ = nullptr;
     size_type frames_ = 0;
+    size_type pitch_ = 0;
+    bool padded_ = false;
 
 public:
     noninterleaved_iterator() noexcept = default;
 
-    noninterleaved_iterator(sample_pointer data, size_type frames) noexcept : data_(data), frames_(frames) {}
+    noninterleaved_iterator(sample_pointer data, size_type frames) noexcept :
+        data_(data), frames_(frames), pitch_(frames)
+    {
+    }
+
+    // pitch is the distance in samples between the start of consecutive channels, which may be greater than frames
+    noninterleaved_iterator(sample_pointer data, size_type frames, size_type pitch) noexcept :
+        data_(data), frames_(frames), pitch_(pitch)
+    {
+    }
+
+    // padded is true if the samples between the end of each channel and the start of the next are padding that
+    // belongs to the buffer, rather than samples that another view may be using, so they can be overwritten
+    noninterleaved_iterator(sample_pointer data, size_type frames, size_type pitch, bool padded) noexcept :
+        data_(data), frames_(frames), pitch_(pitch), padded_(padded)
+    {
+    }
 
     noninterleaved_iterator(const noninterleaved_iterator& other) noexcept = default;
 
@@ -61,7 +79,7 @@ public:
         typename ArgSampleTraits,
         typename std::enable_if_t<std::is_same<const_sample_traits_t<ArgSampleTraits>, SampleTraits>::value, int> = 0>
     noninterleaved_iterator(const noninterleaved_iterator<ArgSampleType, ArgSampleTraits>& other) noexcept :
-        data_(other.base()), frames_(other.frames())
+        data_(other.base()), frames_(other.frames()), pitch_(other.pitch()), padded_(other.padded())
     {
         static_assert(
             std::is_same<typename ArgSampleTraits::sample_type, ArgSampleType>::value,
@@ -81,6 +99,8 @@ public:
             "sample_type in SampleTraits must be the same type as SampleType");
         data_ = other.base();
         frames_ = other.frames();
+        pitch_ = other.pitch();
+        padded_ = other.padded();
         return *this;
     }
 
@@ -89,6 +109,16 @@ public:
         return frames_;
     }
 
+    inline size_type pitch() const noexcept
+    {
+        return pitch_;
+    }
+
+    inline bool padded() const noexcept
+    {
+        return padded_;
+    }
+
     inline reference operator*() const noexcept
     {
         return reference(data_, frames_);
@@ -101,12 +131,12 @@ public:
 
     inline reference operator[](difference_type n) const noexcept
     {
-        return reference(data_ + (n * frames_), frames_);
+        return reference(data_ + (n * pitch_), frames_);
     }
 
     inline noninterleaved_iterator& operator++() noexcept
     {
-        data_ += frames_;
+        data_ += pitch_;
         return *this;
     }
 
@@ -119,7 +149,7 @@ public:
 
     inline noninterleaved_iterator& operator--() noexcept
     {
-        data_ -= frames_;
+        data_ -= pitch_;
         return *this;
     }
 
@@ -139,7 +169,7 @@ public:
 
     inline noninterleaved_iterator& operator+=(difference_type n) noexcept
     {
-        data_ += static_cast<difference_type>(n * frames_);
+        data_ += static_cast<difference_type>(n * pitch_);
         return *this;
     }
 
@@ -212,7 +242,7 @@ public:
     friend inline typename noninterleaved_iterator::difference_type operator-(
         const noninterleaved_iterator& x, const noninterleaved_iterator& y)
     {
-        return (x.data_ - y.data_) / static_cast<typename noninterleaved_iterator::difference_type>(x.frames_);
+        return (x.data_ - y.data_) / static_cast<typename noninterleaved_iterator::difference_type>(x.pitch_);
     }
 
     inline sample_pointer base() const noexcept
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_page_mapping_
+#define _ratl_detail_page_mapping_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+// other includes
+#include <cstddef>
+#include <cstdint>
+
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+#    if !defined(NOMINMAX)
+#        define NOMINMAX
+#        define RATL_UNDEF_NOMINMAX
+#    endif
+#    if !defined(WIN32_LEAN_AND_MEAN)
+#        define WIN32_LEAN_AND_MEAN
+#        define RATL_UNDEF_WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#    if defined(RATL_UNDEF_NOMINMAX)
+#        undef NOMINMAX
+#        undef RATL_UNDEF_NOMINMAX
+#    endif
+#    if defined(RATL_UNDEF_WIN32_LEAN_AND_MEAN)
+#        undef WIN32_LEAN_AND_MEAN
+#        undef RATL_UNDEF_WIN32_LEAN_AND_MEAN
+#    endif
+#else
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+namespace ratl
+{
+namespace detail
+{
+inline std::size_t page_size() noexcept
+{
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return static_cast<std::size_t>(system_info.dwPageSize);
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+inline std::size_t huge_page_size() noexcept
+{
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+    auto large_page_size = static_cast<std::size_t>(GetLargePageMinimum());
+    return large_page_size != 0 ? large_page_size : RATL_HUGE_PAGE_SIZE;
+#else
+    return RATL_HUGE_PAGE_SIZE;
+#endif
+}
+
+inline std::size_t round_up_to(std::size_t bytes, std::size_t alignment) noexcept
+{
+    return ((bytes + alignment - 1) / alignment) * alignment;
+}
+
+// Returns the number of bytes that are actually mapped for a request of the given size
+// Allocations of at least one huge page are rounded up to a whole number of huge pages regardless of whether huge
+// pages are requested, so that unmap_pages does not need to know how the pages were mapped.
+inline std::size_t page_mapping_size(std::size_t bytes) noexcept
+{
+    return round_up_to(bytes, bytes >= huge_page_size() ? huge_page_size() : page_size());
+}
+
+// Maps page_mapping_size(bytes) bytes of zeroed, readable and writable memory, or returns nullptr on failure
+// If huge_pages is true and the mapping is at least one huge page, explicit huge pages are tried first, falling back
+// to a huge page aligned mapping with transparent huge pages requested where supported.
+inline void* map_pages(std::size_t bytes, bool huge_pages) noexcept
+{
+    auto size = page_mapping_size(bytes);
+    auto use_huge_pages = huge_pages && (bytes >= huge_page_size());
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+    if (use_huge_pages && (GetLargePageMinimum() != 0))
+    {
+        auto* data = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (data != nullptr)
+        {
+            return data;
+        }
+    }
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    static constexpr int protection = PROT_READ | PROT_WRITE;
+    static constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (use_huge_pages)
+    {
+#    if defined(MAP_HUGETLB)
+        auto* huge_data = mmap(nullptr, size, protection, flags | MAP_HUGETLB, -1, 0);
+        if (huge_data != MAP_FAILED)
+        {
+            return huge_data;
+        }
+#    endif
+        // over-allocate so that the mapping can be trimmed to start on a huge page boundary, which is required for
+        // the kernel to back it with transparent huge pages
+        auto alignment = huge_page_size();
+        auto* base = mmap(nullptr, size + alignment, protection, flags, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        auto address = reinterpret_cast<std::uintptr_t>(base);
+        auto head = static_cast<std::size_t>(round_up_to(address, alignment) - address);
+        auto tail = alignment - head;
+        auto* data = static_cast<unsigned char*>(base) + head;
+        if (head != 0)
+        {
+            munmap(base, head);
+        }
+        if (tail != 0)
+        {
+            munmap(data + size, tail);
+        }
+#    if defined(MADV_HUGEPAGE)
+        madvise(data, size, MADV_HUGEPAGE);
+#    endif
+        return data;
+    }
+    auto* data = mmap(nullptr, size, protection, flags, -1, 0);
+    return data != MAP_FAILED ? data : nullptr;
+#endif
+}
+
+inline void unmap_pages(void* data, std::size_t bytes) noexcept
+{
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+    static_cast<void>(bytes);
+    VirtualFree(data, 0, MEM_RELEASE);
+#else
+    munmap(data, page_mapping_size(bytes));
+#endif
+}
+
+// Locks the mapped pages into physical memory, returns false on failure (e.g. if the lock limit would be exceeded)
+inline bool lock_pages(void* data, std::size_t bytes) noexcept
+{
+#if defined(RATL_CPP_PLATFORM_WINDOWS)
+    return VirtualLock(data, page_mapping_size(bytes)) != 0;
+#else
+    return mlock(data, page_mapping_size(bytes)) == 0;
+#endif
+}
+
+// Touches every page so that no page faults occur on first access
+inline void prefault_pages(void* data, std::size_t bytes) noexcept
+{
+    auto size = page_mapping_size(bytes);
+    auto stride = page_size();
+    auto* pages = static_cast<volatile unsigned char*>(data);
+    for (std::size_t offset = 0; offset < size; offset += stride)
+    {
+        pages[offset] = 0;
+    }
+}
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_page_mapping_
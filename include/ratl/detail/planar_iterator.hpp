@@ -0,0 +1,250 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_planar_iterator_
+#define _ratl_detail_planar_iterator_
+
+// ratl includes
+#include <ratl/channel_span.hpp>
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/operator_arrow_proxy.hpp>
+#include <ratl/detail/sample_traits.hpp>
+
+// other includes
+#include <type_traits>
+
+namespace ratl
+{
+namespace detail
+{
+// Iterates over the channels of an array of independent channel pointers
+// Each channel starts offset samples after the pointer held in the array, which allows a range of frames to be taken
+// without having to build a new array of pointers.
+template<typename SampleType, typename SampleTraits>
+class planar_iterator
+{
+    static_assert(
+        std::is_same<typename SampleTraits::sample_type, SampleType>::value,
+        "sample_type in SampleTraits must be the same type as SampleType");
+
+    using sample_traits = SampleTraits;
+    using sample_type = typename sample_traits::sample_type;
+    using sample_pointer = typename sample_traits::pointer;
+
+    using channel_type = basic_channel_span<sample_type, sample_traits, std::true_type>;
+
+    using size_type = std::size_t;
+
+public:
+    using channel_pointer = const sample_pointer*;
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = channel_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = detail::operator_arrow_proxy<channel_type>;
+    using reference = channel_type;
+
+private:
+    channel_pointer channels_ = nullptr;
+    size_type offset_ = 0;
+    size_type frames_ = 0;
+
+public:
+    planar_iterator() noexcept = default;
+
+    planar_iterator(channel_pointer channels, size_type frames) noexcept :
+        channels_(channels), offset_(0), frames_(frames)
+    {
+    }
+
+    planar_iterator(channel_pointer channels, size_type offset, size_type frames) noexcept :
+        channels_(channels), offset_(offset), frames_(frames)
+    {
+    }
+
+    planar_iterator(const planar_iterator& other) noexcept = default;
+
+    template<
+        typename ArgSampleType,
+        typename ArgSampleTraits,
+        typename std::enable_if_t<std::is_same<const_sample_traits_t<ArgSampleTraits>, SampleTraits>::value, int> = 0>
+    planar_iterator(const planar_iterator<ArgSampleType, ArgSampleTraits>& other) noexcept :
+        channels_(other.base()), offset_(other.offset()), frames_(other.frames())
+    {
+        static_assert(
+            std::is_same<typename ArgSampleTraits::sample_type, ArgSampleType>::value,
+            "sample_type in SampleTraits must be the same type as SampleType");
+    }
+
+    planar_iterator& operator=(const planar_iterator& other) noexcept = default;
+
+    template<
+        typename ArgSampleType,
+        typename ArgSampleTraits,
+        typename std::enable_if_t<std::is_same<const_sample_traits_t<ArgSampleTraits>, SampleTraits>::value, int> = 0>
+    planar_iterator& operator=(const planar_iterator<ArgSampleType, ArgSampleTraits>& other) noexcept
+    {
+        static_assert(
+            std::is_same<typename ArgSampleTraits::sample_type, ArgSampleType>::value,
+            "sample_type in SampleTraits must be the same type as SampleType");
+        channels_ = other.base();
+        offset_ = other.offset();
+        frames_ = other.frames();
+        return *this;
+    }
+
+    inline size_type offset() const noexcept
+    {
+        return offset_;
+    }
+
+    inline size_type frames() const noexcept
+    {
+        return frames_;
+    }
+
+    // Pointer to the first sample of the current channel
+    inline sample_pointer channel_base() const noexcept
+    {
+        return *channels_ + offset_;
+    }
+
+    inline reference operator*() const noexcept
+    {
+        return reference(*channels_ + offset_, frames_);
+    }
+
+    inline pointer operator->() const noexcept
+    {
+        return pointer(reference(*channels_ + offset_, frames_));
+    }
+
+    inline reference operator[](difference_type n) const noexcept
+    {
+        return reference(channels_[n] + offset_, frames_);
+    }
+
+    inline planar_iterator& operator++() noexcept
+    {
+        ++channels_;
+        return *this;
+    }
+
+    inline planar_iterator operator++(int) noexcept
+    {
+        auto&& tmp = planar_iterator(*this);
+        ++(*this);
+        return tmp;
+    }
+
+    inline planar_iterator& operator--() noexcept
+    {
+        --channels_;
+        return *this;
+    }
+
+    inline planar_iterator operator--(int) noexcept
+    {
+        auto&& tmp = planar_iterator(*this);
+        --(*this);
+        return tmp;
+    }
+
+    inline planar_iterator operator+(difference_type n) const noexcept
+    {
+        auto&& w = planar_iterator(*this);
+        w += n;
+        return w;
+    }
+
+    inline planar_iterator& operator+=(difference_type n) noexcept
+    {
+        channels_ += n;
+        return *this;
+    }
+
+    inline planar_iterator operator-(difference_type n) const noexcept
+    {
+        return *this + (-n);
+    }
+
+    inline planar_iterator& operator-=(difference_type n) noexcept
+    {
+        *this += -n;
+        return *this;
+    }
+
+#if defined(RATL_CPP_VERSION_HAS_CPP20)
+
+    inline bool operator==(const planar_iterator& other) const noexcept
+    {
+        return channels_ == other.channels_;
+    }
+
+    inline bool operator<(const planar_iterator& other) const noexcept
+    {
+        return channels_ < other.channels_;
+    }
+
+    inline auto operator<=>(const planar_iterator& other) const noexcept = default;
+
+#else
+
+    friend inline bool operator==(const planar_iterator& x, const planar_iterator& y) noexcept
+    {
+        return x.channels_ == y.channels_;
+    }
+
+    friend inline bool operator!=(const planar_iterator& x, const planar_iterator& y) noexcept
+    {
+        return !(x == y);
+    }
+
+    friend inline bool operator<(const planar_iterator& x, const planar_iterator& y) noexcept
+    {
+        return x.channels_ < y.channels_;
+    }
+
+    friend inline bool operator<=(const planar_iterator& x, const planar_iterator& y) noexcept
+    {
+        return !(x > y);
+    }
+
+    friend inline bool operator>(const planar_iterator& x, const planar_iterator& y) noexcept
+    {
+        return y < x;
+    }
+
+    friend inline bool operator>=(const planar_iterator& x, const planar_iterator& y) noexcept
+    {
+        return !(x < y);
+    }
+
+#endif
+
+    friend inline planar_iterator operator+(typename planar_iterator::difference_type n, planar_iterator x)
+    {
+        x += n;
+        return x;
+    }
+
+    friend inline typename planar_iterator::difference_type operator-(
+        const planar_iterator& x, const planar_iterator& y)
+    {
+        return x.channels_ - y.channels_;
+    }
+
+    inline channel_pointer base() const noexcept
+    {
+        return channels_;
+    }
+};
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_planar_iterator_
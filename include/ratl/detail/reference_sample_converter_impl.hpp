@@ -278,6 +278,41 @@ struct reference_sample_converter_impl<network_sample<SampleValueType>, sample<S
     }
 };
 
+template<typename InputSampleType, typename OutputSampleType, typename DitherGenerator>
+struct reference_sample_converter_impl<
+    network_sample<InputSampleType>,
+    network_sample<OutputSampleType>,
+    DitherGenerator>
+{
+    static inline network_sample_value_type_t<OutputSampleType> convert(
+        network_sample_value_type_t<InputSampleType> input, DitherGenerator& dither_gen) noexcept
+    {
+        return reference_sample_converter_impl<
+            sample<OutputSampleType>,
+            network_sample<OutputSampleType>,
+            DitherGenerator>::
+            convert(
+                reference_sample_converter_impl<
+                    network_sample<InputSampleType>,
+                    sample<OutputSampleType>,
+                    DitherGenerator>::convert(input, dither_gen),
+                dither_gen);
+    }
+};
+
+template<typename SampleValueType, typename DitherGenerator>
+struct reference_sample_converter_impl<
+    network_sample<SampleValueType>,
+    network_sample<SampleValueType>,
+    DitherGenerator>
+{
+    static inline network_sample_value_type_t<SampleValueType> convert(
+        network_sample_value_type_t<SampleValueType> input, DitherGenerator&) noexcept
+    {
+        return input;
+    }
+};
+
 } // namespace detail
 } // namespace ratl
 
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_relayout_
+#define _ratl_detail_relayout_
+
+// other includes
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace ratl
+{
+namespace detail
+{
+// relayout function
+// Rearranges a buffer in place for resizing without reallocating. The buffer is a run of blocks (frames of an
+// interleaved buffer, channels of a noninterleaved buffer) that start old_pitch samples apart and are moved to start
+// new_pitch samples apart. The first copy_samples samples of the first copy_blocks blocks keep their values, and every
+// other sample of the new_blocks blocks of new_pitch samples is zeroed.
+
+template<typename SamplePointer>
+inline void relayout(
+    SamplePointer data,
+    std::size_t old_pitch,
+    std::size_t new_pitch,
+    std::size_t copy_blocks,
+    std::size_t copy_samples,
+    std::size_t new_blocks) noexcept
+{
+    using sample_type = typename std::iterator_traits<SamplePointer>::value_type;
+
+    if (new_pitch > old_pitch)
+    {
+        // each block moves towards the end of the buffer, so work backwards to avoid overwriting blocks that are yet
+        // to be moved
+        for (auto block_num = copy_blocks; block_num-- > 0;)
+        {
+            auto input = data + (block_num * old_pitch);
+            auto output = data + (block_num * new_pitch);
+            if (block_num != 0)
+            {
+                std::copy_backward(input, input + copy_samples, output + copy_samples);
+            }
+            std::fill_n(output + copy_samples, new_pitch - copy_samples, sample_type());
+        }
+    }
+    else
+    {
+        // each block stays where it is or moves towards the start of the buffer, and the zeroed tail of a block ends
+        // before the start of the next block's old samples
+        for (std::size_t block_num = 0; block_num < copy_blocks; ++block_num)
+        {
+            auto output = data + (block_num * new_pitch);
+            if (new_pitch != old_pitch)
+            {
+                std::copy_n(data + (block_num * old_pitch), copy_samples, output);
+            }
+            std::fill_n(output + copy_samples, new_pitch - copy_samples, sample_type());
+        }
+    }
+    std::fill_n(data + (copy_blocks * new_pitch), (new_blocks - copy_blocks) * new_pitch, sample_type());
+}
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_relayout_
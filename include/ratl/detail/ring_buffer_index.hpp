@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_ring_buffer_index_
+#define _ratl_detail_ring_buffer_index_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+// other includes
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+namespace ratl
+{
+namespace detail
+{
+// Single-producer single-consumer frame indices for a ring buffer
+// The read and write indices grow monotonically and are only reduced modulo the capacity when converted into a
+// position, which means that a full ring buffer and an empty ring buffer can be told apart without wasting a frame.
+// Each index lives on its own cache line alongside the side-local cached copy of the opposing index, so that the
+// producer and consumer only contend on a cache line when one side actually needs to observe the other's progress.
+class ring_buffer_index
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    struct alignas(RATL_CACHE_LINE_SIZE) producer_state
+    {
+        std::atomic<size_type> write_index_{0};
+        size_type cached_read_index_{0};
+    };
+
+    struct alignas(RATL_CACHE_LINE_SIZE) consumer_state
+    {
+        std::atomic<size_type> read_index_{0};
+        size_type cached_write_index_{0};
+    };
+
+    size_type capacity_;
+    producer_state producer_;
+    consumer_state consumer_;
+
+public:
+    explicit ring_buffer_index(size_type capacity) noexcept : capacity_(capacity) {}
+
+    ring_buffer_index(const ring_buffer_index&) = delete;
+    ring_buffer_index& operator=(const ring_buffer_index&) = delete;
+
+    inline size_type capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    // producer side
+
+    inline size_type write_available() noexcept
+    {
+        auto write_index = producer_.write_index_.load(std::memory_order_relaxed);
+        producer_.cached_read_index_ = consumer_.read_index_.load(std::memory_order_acquire);
+        return capacity_ - (write_index - producer_.cached_read_index_);
+    }
+
+    inline size_type write_available(size_type frames) noexcept
+    {
+        auto write_index = producer_.write_index_.load(std::memory_order_relaxed);
+        auto available = capacity_ - (write_index - producer_.cached_read_index_);
+        if (available < frames)
+        {
+            producer_.cached_read_index_ = consumer_.read_index_.load(std::memory_order_acquire);
+            available = capacity_ - (write_index - producer_.cached_read_index_);
+        }
+        return std::min(available, frames);
+    }
+
+    inline size_type write_position() const noexcept
+    {
+        return producer_.write_index_.load(std::memory_order_relaxed) % capacity_;
+    }
+
+    inline void commit_write(size_type frames) noexcept
+    {
+        auto write_index = producer_.write_index_.load(std::memory_order_relaxed);
+        producer_.write_index_.store(write_index + frames, std::memory_order_release);
+    }
+
+    // consumer side
+
+    inline size_type read_available() noexcept
+    {
+        auto read_index = consumer_.read_index_.load(std::memory_order_relaxed);
+        consumer_.cached_write_index_ = producer_.write_index_.load(std::memory_order_acquire);
+        return consumer_.cached_write_index_ - read_index;
+    }
+
+    inline size_type read_available(size_type frames) noexcept
+    {
+        auto read_index = consumer_.read_index_.load(std::memory_order_relaxed);
+        auto available = consumer_.cached_write_index_ - read_index;
+        if (available < frames)
+        {
+            consumer_.cached_write_index_ = producer_.write_index_.load(std::memory_order_acquire);
+            available = consumer_.cached_write_index_ - read_index;
+        }
+        return std::min(available, frames);
+    }
+
+    inline size_type read_position() const noexcept
+    {
+        return consumer_.read_index_.load(std::memory_order_relaxed) % capacity_;
+    }
+
+    inline void commit_read(size_type frames) noexcept
+    {
+        auto read_index = consumer_.read_index_.load(std::memory_order_relaxed);
+        consumer_.read_index_.store(read_index + frames, std::memory_order_release);
+    }
+
+    // Not thread safe, must only be called while neither the producer nor consumer is active
+    inline void reset() noexcept
+    {
+        producer_.write_index_.store(0, std::memory_order_relaxed);
+        producer_.cached_read_index_ = 0;
+        consumer_.read_index_.store(0, std::memory_order_relaxed);
+        consumer_.cached_write_index_ = 0;
+    }
+};
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_ring_buffer_index_
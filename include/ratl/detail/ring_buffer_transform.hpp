@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_ring_buffer_transform_
+#define _ratl_detail_ring_buffer_transform_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/interleaved_iterator.hpp>
+#include <ratl/detail/noninterleaved_iterator.hpp>
+#include <ratl/detail/planar_iterator.hpp>
+#include <ratl/transform.hpp>
+
+// other includes
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+namespace ratl
+{
+namespace detail
+{
+// range_frames function
+
+template<typename SampleType, typename SampleTraits, std::size_t Extent>
+inline std::size_t range_frames(
+    interleaved_iterator<SampleType, SampleTraits, Extent> first,
+    interleaved_iterator<SampleType, SampleTraits, Extent> last) noexcept
+{
+    return static_cast<std::size_t>(last - first);
+}
+
+template<typename SampleType, typename SampleTraits>
+inline std::size_t range_frames(
+    noninterleaved_iterator<SampleType, SampleTraits> first, noninterleaved_iterator<SampleType, SampleTraits>) noexcept
+{
+    return first.frames();
+}
+
+template<typename SampleType, typename SampleTraits>
+inline std::size_t range_frames(
+    planar_iterator<SampleType, SampleTraits> first, planar_iterator<SampleType, SampleTraits>) noexcept
+{
+    return first.frames();
+}
+
+// frame_subrange function
+// Returns the iterator range covering frames [offset, offset + frames) of the range [first, last)
+
+template<typename SampleType, typename SampleTraits, std::size_t Extent>
+inline std::pair<
+    interleaved_iterator<SampleType, SampleTraits, Extent>,
+    interleaved_iterator<SampleType, SampleTraits, Extent>>
+frame_subrange(
+    interleaved_iterator<SampleType, SampleTraits, Extent> first,
+    interleaved_iterator<SampleType, SampleTraits, Extent>,
+    std::size_t offset,
+    std::size_t frames) noexcept
+{
+    auto sub_first = first + static_cast<std::ptrdiff_t>(offset);
+    return {sub_first, sub_first + static_cast<std::ptrdiff_t>(frames)};
+}
+
+template<typename SampleType, typename SampleTraits>
+inline std::pair<noninterleaved_iterator<SampleType, SampleTraits>, noninterleaved_iterator<SampleType, SampleTraits>>
+frame_subrange(
+    noninterleaved_iterator<SampleType, SampleTraits> first,
+    noninterleaved_iterator<SampleType, SampleTraits> last,
+    std::size_t offset,
+    std::size_t frames) noexcept
+{
+    auto sub_first = noninterleaved_iterator<SampleType, SampleTraits>(first.base() + offset, frames, first.pitch());
+    return {sub_first, sub_first + (last - first)};
+}
+
+template<typename SampleType, typename SampleTraits>
+inline std::pair<planar_iterator<SampleType, SampleTraits>, planar_iterator<SampleType, SampleTraits>> frame_subrange(
+    planar_iterator<SampleType, SampleTraits> first,
+    planar_iterator<SampleType, SampleTraits> last,
+    std::size_t offset,
+    std::size_t frames) noexcept
+{
+    auto sub_first = planar_iterator<SampleType, SampleTraits>(first.base(), first.offset() + offset, frames);
+    return {sub_first, sub_first + (last - first)};
+}
+
+// ring_buffer_write function
+
+template<
+    template<typename, typename, typename>
+    class Transformer,
+    typename InputIterator,
+    typename RingBuffer,
+    typename... Args>
+inline std::size_t ring_buffer_write(InputIterator first, InputIterator last, RingBuffer& ring, Args&... args)
+{
+    auto region = ring.write_region(range_frames(first, last));
+    auto offset = std::size_t(0);
+    for (const auto& span : {region.first(), region.second()})
+    {
+        if (!span.empty())
+        {
+            auto input = frame_subrange(first, last, offset, span.frames());
+            auto output = span;
+            transform_impl<Transformer>(input.first, input.second, output.begin(), args...);
+            offset += span.frames();
+        }
+    }
+    ring.commit_write(region.frames());
+    return region.frames();
+}
+
+// ring_buffer_read function
+
+template<
+    template<typename, typename, typename>
+    class Transformer,
+    typename RingBuffer,
+    typename OutputIterator,
+    typename... Args>
+inline std::size_t ring_buffer_read(RingBuffer& ring, OutputIterator first, OutputIterator last, Args&... args)
+{
+    auto region = ring.read_region(range_frames(first, last));
+    auto offset = std::size_t(0);
+    for (const auto& span : {region.first(), region.second()})
+    {
+        if (!span.empty())
+        {
+            auto output = frame_subrange(first, last, offset, span.frames());
+            transform_impl<Transformer>(span.begin(), span.end(), output.first, args...);
+            offset += span.frames();
+        }
+    }
+    ring.commit_read(region.frames());
+    return region.frames();
+}
+
+} // namespace detail
+} // namespace ratl
+
+#endif // _ratl_detail_ring_buffer_transform_
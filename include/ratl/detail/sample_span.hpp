@@ -134,12 +134,12 @@ public:
 
     inline reference back()
     {
-        return *(data() + (samples() * (stride() - 1)));
+        return *(data() + ((samples() - 1) * stride()));
     }
 
     inline const_reference back() const
     {
-        return *(data() + (samples() * (stride() - 1)));
+        return *(data() + ((samples() - 1) * stride()));
     }
 
     // iterators
@@ -301,12 +301,12 @@ public:
 
     inline reference back() noexcept
     {
-        return *(data() - 1);
+        return *(data() + (samples() - 1));
     }
 
     inline const_reference back() const noexcept
     {
-        return *(data() - 1);
+        return *(data() + (samples() - 1));
     }
 
     // iterators
@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_detail_shared_memory_
+#define _ratl_detail_shared_memory_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+// other includes
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+#    include <fcntl.h>
+#    include <signal.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#if defined(RATL_CPP_PLATFORM_LINUX)
+#    include <linux/futex.h>
+#    include <sys/syscall.h>
+#    include <time.h>
+#endif
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+
+namespace ratl
+{
+namespace detail
+{
+// Read-write mapping of a whole POSIX shared memory object
+// create makes a new object of the given size, failing if one with the name already exists, and open maps an
+// existing object at whatever size it was created with. Throws std::system_error if the object can't be created,
+// opened or mapped.
+class shared_memory
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    unsigned char* data_ = nullptr;
+    size_type size_ = 0;
+
+public:
+    shared_memory() noexcept = default;
+
+    static shared_memory create(const std::string& name, size_type size)
+    {
+        auto fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), name);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            auto error = errno;
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw std::system_error(error, std::generic_category(), name);
+        }
+        return shared_memory(fd, size, name, true);
+    }
+
+    static shared_memory open(const std::string& name)
+    {
+        auto fd = ::shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), name);
+        }
+        struct stat object_stat;
+        if (::fstat(fd, &object_stat) != 0)
+        {
+            auto error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), name);
+        }
+        return shared_memory(fd, static_cast<size_type>(object_stat.st_size), name, false);
+    }
+
+    // Removes the name, the object itself lives on until every mapping of it has gone
+    static void unlink(const std::string& name) noexcept
+    {
+        ::shm_unlink(name.c_str());
+    }
+
+    shared_memory(const shared_memory&) = delete;
+
+    shared_memory(shared_memory&& other) noexcept :
+        data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    ~shared_memory()
+    {
+        close();
+    }
+
+    shared_memory& operator=(const shared_memory&) = delete;
+
+    shared_memory& operator=(shared_memory&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    unsigned char* data() const noexcept
+    {
+        return data_;
+    }
+
+    size_type size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    shared_memory(int fd, size_type size, const std::string& name, bool created) : size_(size)
+    {
+        if (size == 0)
+        {
+            ::close(fd);
+            if (created)
+            {
+                ::shm_unlink(name.c_str());
+            }
+            throw std::system_error(EINVAL, std::generic_category(), name);
+        }
+        // the mapping keeps the object alive, so the descriptor isn't needed once it has been made
+        auto* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        auto error = errno;
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            size_ = 0;
+            if (created)
+            {
+                ::shm_unlink(name.c_str());
+            }
+            throw std::system_error(error, std::generic_category(), name);
+        }
+        data_ = static_cast<unsigned char*>(data);
+    }
+
+    void close() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(data_, size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+};
+
+// Whether the process that had the given pid has exited
+inline bool process_exited(std::int32_t pid) noexcept
+{
+    return pid > 0 && ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+}
+
+// Waits on a word in memory shared between processes, returning when it is woken by futex_wake_all, when the word
+// no longer holds expected, after timeout, or spuriously. Platforms without futexes poll instead.
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected, std::chrono::nanoseconds timeout)
+{
+    if (timeout.count() <= 0)
+    {
+        return;
+    }
+#if defined(RATL_CPP_PLATFORM_LINUX)
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex words must be 32 bits");
+    timespec relative_timeout;
+    relative_timeout.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    relative_timeout.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &relative_timeout, nullptr, 0);
+#else
+    if (word.load(std::memory_order_acquire) == expected)
+    {
+        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::microseconds(500)));
+    }
+#endif
+}
+
+inline void futex_wake_all(std::atomic<std::uint32_t>& word) noexcept
+{
+#if defined(RATL_CPP_PLATFORM_LINUX)
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    static_cast<void>(word);
+#endif
+}
+
+} // namespace detail
+} // namespace ratl
+
+#endif
+
+#endif // _ratl_detail_shared_memory_
@@ -14,11 +14,15 @@
 #include <ratl/detail/config.hpp>
 #include <ratl/detail/interleaved_iterator.hpp>
 #include <ratl/detail/noninterleaved_iterator.hpp>
+#include <ratl/detail/planar_iterator.hpp>
 #include <ratl/detail/sample_converter.hpp>
 #include <ratl/detail/sample_iterator.hpp>
+#include <ratl/detail/sample_traits.hpp>
 #include <ratl/detail/utility.hpp>
+#include <ratl/extent.hpp>
 
 // other includes
+#include <algorithm>
 #include <type_traits>
 
 namespace ratl
@@ -315,6 +319,256 @@ private:
     transformer transformer_;
 };
 
+// Channel n starts at data + (n * pitch)
+template<typename SamplePointer>
+struct pitched_channels
+{
+    SamplePointer data;
+    std::size_t pitch;
+
+    inline SamplePointer operator[](std::size_t channel_num) const noexcept
+    {
+        return data + (channel_num * pitch);
+    }
+};
+
+// Channel n starts at data[n]
+template<typename SamplePointer, std::size_t Channels>
+struct planar_channels
+{
+    SamplePointer data[Channels];
+
+    inline SamplePointer operator[](std::size_t channel_num) const noexcept
+    {
+        return data[channel_num];
+    }
+};
+
+// Relative cost of shuffling samples of a given size. Packed 24 bit samples don't fit evenly into vector lanes, so are
+// only shuffled when the other sample type is packed too.
+constexpr std::size_t shuffle_cost(std::size_t sample_size) noexcept
+{
+    return ((sample_size & (sample_size - 1)) == 0) ? sample_size : sample_size + 16;
+}
+
+// Transforms between interleaved and noninterleaved layouts frame by frame, for a number of channels that is known at
+// compile time
+// The loop over channels is fully unrolled, which lets the compiler turn each frame into a few shuffles (e.g. a stereo
+// deinterleave becomes an unpacklo/unpackhi pair) rather than walking each channel with a strided iterator.
+// When the sample types differ the frames are transformed a chunk at a time through a small scratch buffer, so that
+// the conversion runs over contiguous samples through basic_transformer_impl (and so through the batch converters when
+// they are available). The shuffle is done on whichever of the input and output sample types is cheaper to shuffle,
+// as that moves fewer bytes and fits more channels in each vector.
+template<
+    template<typename, typename, typename>
+    class SampleConverter,
+    typename InputSampleType,
+    typename OutputSampleType,
+    typename DitherGenerator,
+    std::size_t Channels>
+class static_extent_transformer
+{
+    using transformer_impl =
+        basic_transformer_impl<SampleConverter, InputSampleType, OutputSampleType, DitherGenerator>;
+
+    struct copy_tag
+    {
+    };
+
+    struct shuffle_input_tag
+    {
+    };
+
+    struct shuffle_output_tag
+    {
+    };
+
+    using convert_tag = std::conditional_t<
+        (shuffle_cost(sizeof(InputSampleType)) <= shuffle_cost(sizeof(OutputSampleType))),
+        shuffle_input_tag,
+        shuffle_output_tag>;
+
+    using dispatch_tag =
+        std::conditional_t<std::is_same<InputSampleType, OutputSampleType>::value, copy_tag, convert_tag>;
+
+    // Sized so that the scratch buffer stays in L1 cache alongside the input and output
+    static constexpr std::size_t scratch_bytes = 4096;
+    static constexpr std::size_t chunk_frames = std::max<std::size_t>(
+        scratch_bytes / (Channels * std::max(sizeof(InputSampleType), sizeof(OutputSampleType))),
+        1);
+
+public:
+    explicit static_extent_transformer(DitherGenerator& dither_gen) : transformer_(dither_gen) {}
+
+    // Channel n of the output starts at output + (n * pitch)
+    template<typename InputPointer, typename OutputPointer>
+    inline void deinterleave(InputPointer input, OutputPointer output, std::size_t frames, std::size_t pitch)
+        const noexcept
+    {
+        deinterleave_impl(input, pitched_channels<OutputPointer>{output, pitch}, frames, dispatch_tag());
+    }
+
+    // Channel n of the input starts at input + (n * pitch)
+    template<typename InputPointer, typename OutputPointer>
+    inline void interleave(InputPointer input, OutputPointer output, std::size_t frames, std::size_t pitch)
+        const noexcept
+    {
+        interleave_impl(pitched_channels<InputPointer>{input, pitch}, output, frames, dispatch_tag());
+    }
+
+    // Channel n of the output starts at outputs[n] + offset
+    template<typename InputPointer, typename OutputPointer>
+    inline void deinterleave_planar(
+        InputPointer input, const OutputPointer* outputs, std::size_t offset, std::size_t frames) const noexcept
+    {
+        // Copy the channel pointers so that the compiler can keep them in registers
+        planar_channels<OutputPointer, Channels> output;
+        for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+        {
+            output.data[channel_num] = outputs[channel_num] + offset;
+        }
+        deinterleave_impl(input, output, frames, dispatch_tag());
+    }
+
+    // Channel n of the input starts at inputs[n] + offset
+    template<typename InputPointer, typename OutputPointer>
+    inline void interleave_planar(
+        const InputPointer* inputs, std::size_t offset, OutputPointer output, std::size_t frames) const noexcept
+    {
+        // Copy the channel pointers so that the compiler can keep them in registers
+        planar_channels<InputPointer, Channels> input;
+        for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+        {
+            input.data[channel_num] = inputs[channel_num] + offset;
+        }
+        interleave_impl(input, output, frames, dispatch_tag());
+    }
+
+private:
+    template<typename SamplePointer>
+    static inline auto make_blit_iterator(SamplePointer pointer) noexcept
+    {
+        using sample_type = std::remove_reference_t<decltype(*pointer)>;
+        return blit_iterator<sample_type, sample_traits<sample_type, SamplePointer, SamplePointer>>(pointer);
+    }
+
+    // Converts a contiguous run of samples
+    template<typename InputPointer, typename OutputPointer>
+    inline void convert(InputPointer input, std::size_t samples, OutputPointer output) const noexcept
+    {
+        auto first = make_blit_iterator(input);
+        transformer_.transform(first, first + samples, make_blit_iterator(output));
+    }
+
+    // The shuffles copy the underlying values rather than the sample objects, because the compiler won't vectorise
+    // loops of aggregate copies
+    template<typename InputPointer, typename OutputChannels>
+    static inline void deinterleave_samples(
+        InputPointer input, const OutputChannels& output, std::size_t offset, std::size_t frames) noexcept
+    {
+        for (std::size_t frame_num = 0; frame_num < frames; ++frame_num, input += Channels)
+        {
+            for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+            {
+                output[channel_num][offset + frame_num].get() = input[channel_num].get();
+            }
+        }
+    }
+
+    template<typename InputChannels, typename OutputPointer>
+    static inline void interleave_samples(
+        const InputChannels& input, std::size_t offset, OutputPointer output, std::size_t frames) noexcept
+    {
+        for (std::size_t frame_num = 0; frame_num < frames; ++frame_num, output += Channels)
+        {
+            for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+            {
+                output[channel_num].get() = input[channel_num][offset + frame_num].get();
+            }
+        }
+    }
+
+    template<typename InputPointer, typename OutputChannels>
+    inline void deinterleave_impl(InputPointer input, const OutputChannels& output, std::size_t frames, copy_tag)
+        const noexcept
+    {
+        deinterleave_samples(input, output, 0, frames);
+    }
+
+    // Deinterleaves each chunk into the scratch buffer, then converts each channel of it into the output
+    template<typename InputPointer, typename OutputChannels>
+    inline void deinterleave_impl(
+        InputPointer input, const OutputChannels& output, std::size_t frames, shuffle_input_tag) const noexcept
+    {
+        alignas(RATL_SIMD_ALIGNMENT) InputSampleType scratch[Channels * chunk_frames];
+        auto scratch_channels = pitched_channels<InputSampleType*>{scratch, chunk_frames};
+        for (std::size_t frame_num = 0; frame_num < frames; frame_num += chunk_frames)
+        {
+            auto chunk = std::min(static_cast<std::size_t>(chunk_frames), frames - frame_num);
+            deinterleave_samples(input + (frame_num * Channels), scratch_channels, 0, chunk);
+            for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+            {
+                convert(scratch_channels[channel_num], chunk, output[channel_num] + frame_num);
+            }
+        }
+    }
+
+    // Converts each chunk into the scratch buffer, then deinterleaves it into the output
+    template<typename InputPointer, typename OutputChannels>
+    inline void deinterleave_impl(
+        InputPointer input, const OutputChannels& output, std::size_t frames, shuffle_output_tag) const noexcept
+    {
+        alignas(RATL_SIMD_ALIGNMENT) OutputSampleType scratch[Channels * chunk_frames];
+        for (std::size_t frame_num = 0; frame_num < frames; frame_num += chunk_frames)
+        {
+            auto chunk = std::min(static_cast<std::size_t>(chunk_frames), frames - frame_num);
+            convert(input + (frame_num * Channels), chunk * Channels, scratch);
+            deinterleave_samples(scratch, output, frame_num, chunk);
+        }
+    }
+
+    template<typename InputChannels, typename OutputPointer>
+    inline void interleave_impl(const InputChannels& input, OutputPointer output, std::size_t frames, copy_tag)
+        const noexcept
+    {
+        interleave_samples(input, 0, output, frames);
+    }
+
+    // Interleaves each chunk into the scratch buffer, then converts it into the output
+    template<typename InputChannels, typename OutputPointer>
+    inline void interleave_impl(
+        const InputChannels& input, OutputPointer output, std::size_t frames, shuffle_input_tag) const noexcept
+    {
+        alignas(RATL_SIMD_ALIGNMENT) InputSampleType scratch[Channels * chunk_frames];
+        for (std::size_t frame_num = 0; frame_num < frames; frame_num += chunk_frames)
+        {
+            auto chunk = std::min(static_cast<std::size_t>(chunk_frames), frames - frame_num);
+            interleave_samples(input, frame_num, scratch, chunk);
+            convert(scratch, chunk * Channels, output + (frame_num * Channels));
+        }
+    }
+
+    // Converts each channel of each chunk into the scratch buffer, then interleaves it into the output
+    template<typename InputChannels, typename OutputPointer>
+    inline void interleave_impl(
+        const InputChannels& input, OutputPointer output, std::size_t frames, shuffle_output_tag) const noexcept
+    {
+        alignas(RATL_SIMD_ALIGNMENT) OutputSampleType scratch[Channels * chunk_frames];
+        auto scratch_channels = pitched_channels<OutputSampleType*>{scratch, chunk_frames};
+        for (std::size_t frame_num = 0; frame_num < frames; frame_num += chunk_frames)
+        {
+            auto chunk = std::min(static_cast<std::size_t>(chunk_frames), frames - frame_num);
+            for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+            {
+                convert(input[channel_num] + frame_num, chunk, scratch_channels[channel_num]);
+            }
+            interleave_samples(scratch_channels, 0, output + (frame_num * Channels), chunk);
+        }
+    }
+
+    transformer_impl transformer_;
+};
+
 // basic_transformer class
 
 template<
@@ -325,6 +579,49 @@ template<
     typename DitherGenerator>
 class basic_transformer;
 
+// Transforms between two non-interleaved layouts channel by channel, for layouts whose channels can't be blitted as a
+// single block of samples (e.g. channels held in independent allocations)
+// Each channel is contiguous, so each one is still transformed with the fastest available sample transformer.
+template<
+    template<typename, typename, typename>
+    class SampleConverter,
+    class InputIterator,
+    class OutputIterator,
+    typename DitherGenerator>
+class channelwise_transformer
+{
+    using input_channel = typename InputIterator::value_type;
+    using output_channel = typename OutputIterator::value_type;
+
+    using input_channel_iterator = typename input_channel::const_iterator;
+    using output_channel_iterator = typename output_channel::iterator;
+
+    using channel_transformer =
+        basic_transformer<SampleConverter, input_channel_iterator, output_channel_iterator, DitherGenerator>;
+
+public:
+    explicit channelwise_transformer(DitherGenerator& dither_gen) : dither_gen_(dither_gen) {}
+
+    inline OutputIterator operator()(InputIterator first, InputIterator last, OutputIterator result) const noexcept
+    {
+        auto transformer = channel_transformer(dither_gen_);
+        auto min_frames = std::min(first.frames(), result.frames());
+        return detail::apply_binary_op(
+            first,
+            last,
+            result,
+            [&transformer, min_frames](input_channel input, output_channel output)
+            {
+                auto input_begin = input.cbegin();
+                auto input_end = std::next(input_begin, min_frames);
+                transformer(input_begin, input_end, output.begin());
+            });
+    }
+
+private:
+    std::reference_wrapper<DitherGenerator> dither_gen_;
+};
+
 // transformer for interleaved_iterator
 
 template<
@@ -332,17 +629,19 @@ template<
     class SampleConverter,
     typename InputSampleType,
     typename InputSampleTraits,
+    std::size_t InputExtent,
     typename OutputSampleType,
     typename OutputSampleTraits,
+    std::size_t OutputExtent,
     typename DitherGenerator>
 class basic_transformer<
     SampleConverter,
-    interleaved_iterator<InputSampleType, InputSampleTraits>,
-    interleaved_iterator<OutputSampleType, OutputSampleTraits>,
+    interleaved_iterator<InputSampleType, InputSampleTraits, InputExtent>,
+    interleaved_iterator<OutputSampleType, OutputSampleTraits, OutputExtent>,
     DitherGenerator>
 {
-    using input_iterator = interleaved_iterator<InputSampleType, InputSampleTraits>;
-    using output_iterator = interleaved_iterator<OutputSampleType, OutputSampleTraits>;
+    using input_iterator = interleaved_iterator<InputSampleType, InputSampleTraits, InputExtent>;
+    using output_iterator = interleaved_iterator<OutputSampleType, OutputSampleTraits, OutputExtent>;
 
     using input_blit_iterator = blit_iterator<InputSampleType, InputSampleTraits>;
     using output_blit_iterator = blit_iterator<OutputSampleType, OutputSampleTraits>;
@@ -445,9 +744,10 @@ public:
 
     inline output_iterator operator()(input_iterator first, input_iterator last, output_iterator result) const noexcept
     {
-        if (first.frames() == result.frames())
+        if ((first.frames() == result.frames()) && (first.pitch() == first.frames()) &&
+            (result.pitch() == result.frames()))
         {
-            // Input and output have same number of frames, so blit samples
+            // Input and output have same number of frames and channels are tightly packed, so blit samples
 
             return output_iterator(
                 transformer_impl(dither_gen_)
@@ -458,9 +758,34 @@ public:
                     .base(),
                 result.frames());
         }
+        else if (
+            (first.frames() == result.frames()) && (first.pitch() == result.pitch()) && first.padded() &&
+            result.padded())
+        {
+            // Input and output have same number of frames and pitch, and the padding between channels belongs to both
+            // buffers, so blit the channels and their padding as a single block. With aligned channel layouts this
+            // ends on a whole number of vectors, so there is no partial vector at the end of each channel.
+
+            auto frames = result.frames();
+            auto pitch = result.pitch();
+            auto result_last = transformer_impl(dither_gen_)
+                                   .transform(
+                                       input_blit_iterator(first.base()),
+                                       input_blit_iterator(last.base()),
+                                       output_blit_iterator(result.base()))
+                                   .base();
+
+            // dither can make converted padding non-zero, so it is zeroed again
+            for (auto channel = result.base(); channel != result_last; channel += pitch)
+            {
+                std::fill_n(channel + frames, pitch - frames, base_output_sample_type());
+            }
+            return output_iterator(result_last, frames, pitch, true);
+        }
         else
         {
-            // Input and output don't have same number of frames, so must transform channel by channel
+            // Input and output don't have same number of frames or channels are padded, so must transform channel by
+            // channel
 
             auto transformer = channel_transformer(dither_gen_);
             auto min_frames = std::min(first.frames(), result.frames());
@@ -488,16 +813,17 @@ template<
     class SampleConverter,
     typename InputSampleType,
     typename InputSampleTraits,
+    std::size_t InputExtent,
     typename OutputSampleType,
     typename OutputSampleTraits,
     typename DitherGenerator>
 class basic_transformer<
     SampleConverter,
-    interleaved_iterator<InputSampleType, InputSampleTraits>,
+    interleaved_iterator<InputSampleType, InputSampleTraits, InputExtent>,
     noninterleaved_iterator<OutputSampleType, OutputSampleTraits>,
     DitherGenerator>
 {
-    using input_iterator = interleaved_iterator<InputSampleType, InputSampleTraits>;
+    using input_iterator = interleaved_iterator<InputSampleType, InputSampleTraits, InputExtent>;
     using output_iterator = noninterleaved_iterator<OutputSampleType, OutputSampleTraits>;
 
     using input_channel = basic_channel_span<InputSampleType, InputSampleTraits>;
@@ -509,10 +835,34 @@ class basic_transformer<
     using channel_transformer =
         basic_transformer<SampleConverter, input_channel_iterator, output_channel_iterator, DitherGenerator>;
 
+    using frame_transformer = static_extent_transformer<
+        SampleConverter,
+        std::remove_cv_t<InputSampleType>,
+        std::remove_cv_t<OutputSampleType>,
+        DitherGenerator,
+        InputExtent>;
+
 public:
     explicit basic_transformer(DitherGenerator& dither_gen) : dither_gen_(dither_gen) {}
 
     inline output_iterator operator()(input_iterator first, input_iterator last, output_iterator result) const noexcept
+    {
+        return transform(first, last, result, std::integral_constant<bool, InputExtent != dynamic_extent>());
+    }
+
+private:
+    // Number of channels is known at compile time, so transform frame by frame
+    inline output_iterator transform(
+        input_iterator first, input_iterator last, output_iterator result, std::true_type) const noexcept
+    {
+        auto frames = std::min(static_cast<std::size_t>(std::distance(first, last)), result.frames());
+        frame_transformer(dither_gen_).deinterleave(first.base(), result.base(), frames, result.pitch());
+        return result + static_cast<typename output_iterator::difference_type>(InputExtent);
+    }
+
+    // Number of channels is only known at runtime, so transform channel by channel
+    inline output_iterator transform(
+        input_iterator first, input_iterator last, output_iterator result, std::false_type) const noexcept
     {
         auto transformer = channel_transformer(dither_gen_);
         auto channels = first.channels();
@@ -526,7 +876,6 @@ public:
         return result;
     }
 
-private:
     std::reference_wrapper<DitherGenerator> dither_gen_;
 };
 
@@ -539,15 +888,16 @@ template<
     typename InputSampleTraits,
     typename OutputSampleType,
     typename OutputSampleTraits,
+    std::size_t OutputExtent,
     typename DitherGenerator>
 class basic_transformer<
     SampleConverter,
     noninterleaved_iterator<InputSampleType, InputSampleTraits>,
-    interleaved_iterator<OutputSampleType, OutputSampleTraits>,
+    interleaved_iterator<OutputSampleType, OutputSampleTraits, OutputExtent>,
     DitherGenerator>
 {
     using input_iterator = noninterleaved_iterator<InputSampleType, InputSampleTraits>;
-    using output_iterator = interleaved_iterator<OutputSampleType, OutputSampleTraits>;
+    using output_iterator = interleaved_iterator<OutputSampleType, OutputSampleTraits, OutputExtent>;
 
     using input_frame = basic_frame_span<InputSampleType, InputSampleTraits>;
     using output_frame = typename output_iterator::value_type;
@@ -558,24 +908,297 @@ class basic_transformer<
     using frame_transformer =
         basic_transformer<SampleConverter, input_frame_iterator, output_frame_iterator, DitherGenerator>;
 
+    using static_frame_transformer = static_extent_transformer<
+        SampleConverter,
+        std::remove_cv_t<InputSampleType>,
+        std::remove_cv_t<OutputSampleType>,
+        DitherGenerator,
+        OutputExtent>;
+
 public:
     explicit basic_transformer(DitherGenerator& dither_gen) : dither_gen_(dither_gen) {}
 
     inline output_iterator operator()(input_iterator first, input_iterator last, output_iterator result) const noexcept
+    {
+        return transform(first, last, result, std::integral_constant<bool, OutputExtent != dynamic_extent>());
+    }
+
+private:
+    // Number of channels is known at compile time, so all channels can be interleaved at once unless the input has too
+    // few channels to fill each output frame
+    inline output_iterator transform(
+        input_iterator first, input_iterator last, output_iterator result, std::true_type) const noexcept
+    {
+        if (static_cast<std::size_t>(std::distance(first, last)) < OutputExtent)
+        {
+            return transform(first, last, result, std::false_type());
+        }
+        auto frames = first.frames();
+        static_frame_transformer(dither_gen_).interleave(first.base(), result.base(), frames, first.pitch());
+        return result + static_cast<typename output_iterator::difference_type>(frames);
+    }
+
+    // Number of channels is only known at runtime, so transform each frame with a strided iterator
+    inline output_iterator transform(
+        input_iterator first, input_iterator last, output_iterator result, std::false_type) const noexcept
     {
         auto transformer = frame_transformer(dither_gen_);
         auto channels = std::min(static_cast<std::size_t>(std::distance(first, last)), result.channels());
         auto frames = first.frames();
+        auto pitch = first.pitch();
         auto end_frame_base = first.base() + frames;
         for (auto frame_base = first.base(); frame_base < end_frame_base; ++frame_base, (void)++result)
         {
-            auto input = input_frame(frame_base, channels, frames);
+            auto input = input_frame(frame_base, channels, pitch);
             transformer(input.begin(), input.end(), result->begin());
         }
         return result;
     }
 
+    std::reference_wrapper<DitherGenerator> dither_gen_;
+};
+
+// transformer for planar_iterator
+
+template<
+    template<typename, typename, typename>
+    class SampleConverter,
+    typename InputSampleType,
+    typename InputSampleTraits,
+    typename OutputSampleType,
+    typename OutputSampleTraits,
+    typename DitherGenerator>
+class basic_transformer<
+    SampleConverter,
+    planar_iterator<InputSampleType, InputSampleTraits>,
+    planar_iterator<OutputSampleType, OutputSampleTraits>,
+    DitherGenerator>
+    : public channelwise_transformer<
+          SampleConverter,
+          planar_iterator<InputSampleType, InputSampleTraits>,
+          planar_iterator<OutputSampleType, OutputSampleTraits>,
+          DitherGenerator>
+{
+    using transformer = channelwise_transformer<
+        SampleConverter,
+        planar_iterator<InputSampleType, InputSampleTraits>,
+        planar_iterator<OutputSampleType, OutputSampleTraits>,
+        DitherGenerator>;
+
+public:
+    using transformer::transformer;
+};
+
+// transformer for noninterleaved_iterator to planar_iterator
+
+template<
+    template<typename, typename, typename>
+    class SampleConverter,
+    typename InputSampleType,
+    typename InputSampleTraits,
+    typename OutputSampleType,
+    typename OutputSampleTraits,
+    typename DitherGenerator>
+class basic_transformer<
+    SampleConverter,
+    noninterleaved_iterator<InputSampleType, InputSampleTraits>,
+    planar_iterator<OutputSampleType, OutputSampleTraits>,
+    DitherGenerator>
+    : public channelwise_transformer<
+          SampleConverter,
+          noninterleaved_iterator<InputSampleType, InputSampleTraits>,
+          planar_iterator<OutputSampleType, OutputSampleTraits>,
+          DitherGenerator>
+{
+    using transformer = channelwise_transformer<
+        SampleConverter,
+        noninterleaved_iterator<InputSampleType, InputSampleTraits>,
+        planar_iterator<OutputSampleType, OutputSampleTraits>,
+        DitherGenerator>;
+
+public:
+    using transformer::transformer;
+};
+
+// transformer for planar_iterator to noninterleaved_iterator
+
+template<
+    template<typename, typename, typename>
+    class SampleConverter,
+    typename InputSampleType,
+    typename InputSampleTraits,
+    typename OutputSampleType,
+    typename OutputSampleTraits,
+    typename DitherGenerator>
+class basic_transformer<
+    SampleConverter,
+    planar_iterator<InputSampleType, InputSampleTraits>,
+    noninterleaved_iterator<OutputSampleType, OutputSampleTraits>,
+    DitherGenerator>
+    : public channelwise_transformer<
+          SampleConverter,
+          planar_iterator<InputSampleType, InputSampleTraits>,
+          noninterleaved_iterator<OutputSampleType, OutputSampleTraits>,
+          DitherGenerator>
+{
+    using transformer = channelwise_transformer<
+        SampleConverter,
+        planar_iterator<InputSampleType, InputSampleTraits>,
+        noninterleaved_iterator<OutputSampleType, OutputSampleTraits>,
+        DitherGenerator>;
+
+public:
+    using transformer::transformer;
+};
+
+// transformer for interleaved_iterator to planar_iterator
+
+template<
+    template<typename, typename, typename>
+    class SampleConverter,
+    typename InputSampleType,
+    typename InputSampleTraits,
+    std::size_t InputExtent,
+    typename OutputSampleType,
+    typename OutputSampleTraits,
+    typename DitherGenerator>
+class basic_transformer<
+    SampleConverter,
+    interleaved_iterator<InputSampleType, InputSampleTraits, InputExtent>,
+    planar_iterator<OutputSampleType, OutputSampleTraits>,
+    DitherGenerator>
+{
+    using input_iterator = interleaved_iterator<InputSampleType, InputSampleTraits, InputExtent>;
+    using output_iterator = planar_iterator<OutputSampleType, OutputSampleTraits>;
+
+    using input_channel = basic_channel_span<InputSampleType, InputSampleTraits>;
+    using output_channel = typename output_iterator::value_type;
+
+    using input_channel_iterator = typename input_channel::const_iterator;
+    using output_channel_iterator = typename output_channel::iterator;
+
+    using channel_transformer =
+        basic_transformer<SampleConverter, input_channel_iterator, output_channel_iterator, DitherGenerator>;
+
+    using frame_transformer = static_extent_transformer<
+        SampleConverter,
+        std::remove_cv_t<InputSampleType>,
+        std::remove_cv_t<OutputSampleType>,
+        DitherGenerator,
+        InputExtent>;
+
+public:
+    explicit basic_transformer(DitherGenerator& dither_gen) : dither_gen_(dither_gen) {}
+
+    inline output_iterator operator()(input_iterator first, input_iterator last, output_iterator result) const noexcept
+    {
+        return transform(first, last, result, std::integral_constant<bool, InputExtent != dynamic_extent>());
+    }
+
+private:
+    // Number of channels is known at compile time, so transform frame by frame
+    inline output_iterator transform(
+        input_iterator first, input_iterator last, output_iterator result, std::true_type) const noexcept
+    {
+        auto frames = std::min(static_cast<std::size_t>(std::distance(first, last)), result.frames());
+        frame_transformer(dither_gen_).deinterleave_planar(first.base(), result.base(), result.offset(), frames);
+        return result + static_cast<typename output_iterator::difference_type>(InputExtent);
+    }
+
+    // Number of channels is only known at runtime, so transform channel by channel
+    inline output_iterator transform(
+        input_iterator first, input_iterator last, output_iterator result, std::false_type) const noexcept
+    {
+        auto transformer = channel_transformer(dither_gen_);
+        auto channels = first.channels();
+        auto frames = std::min(static_cast<std::size_t>(std::distance(first, last)), result.frames());
+        auto end_channel_base = first.base() + channels;
+        for (auto channel_base = first.base(); channel_base < end_channel_base; ++channel_base, (void)++result)
+        {
+            auto input = input_channel(channel_base, frames, channels);
+            transformer(input.begin(), input.end(), result->begin());
+        }
+        return result;
+    }
+
+    std::reference_wrapper<DitherGenerator> dither_gen_;
+};
+
+// transformer for planar_iterator to interleaved_iterator
+
+template<
+    template<typename, typename, typename>
+    class SampleConverter,
+    typename InputSampleType,
+    typename InputSampleTraits,
+    typename OutputSampleType,
+    typename OutputSampleTraits,
+    std::size_t OutputExtent,
+    typename DitherGenerator>
+class basic_transformer<
+    SampleConverter,
+    planar_iterator<InputSampleType, InputSampleTraits>,
+    interleaved_iterator<OutputSampleType, OutputSampleTraits, OutputExtent>,
+    DitherGenerator>
+{
+    using input_iterator = planar_iterator<InputSampleType, InputSampleTraits>;
+    using output_iterator = interleaved_iterator<OutputSampleType, OutputSampleTraits, OutputExtent>;
+
+    using input_channel = typename input_iterator::value_type;
+    using output_channel = basic_channel_span<OutputSampleType, OutputSampleTraits>;
+
+    using input_channel_iterator = typename input_channel::const_iterator;
+    using output_channel_iterator = typename output_channel::iterator;
+
+    using channel_transformer =
+        basic_transformer<SampleConverter, input_channel_iterator, output_channel_iterator, DitherGenerator>;
+
+    using frame_transformer = static_extent_transformer<
+        SampleConverter,
+        std::remove_cv_t<InputSampleType>,
+        std::remove_cv_t<OutputSampleType>,
+        DitherGenerator,
+        OutputExtent>;
+
+public:
+    explicit basic_transformer(DitherGenerator& dither_gen) : dither_gen_(dither_gen) {}
+
+    inline output_iterator operator()(input_iterator first, input_iterator last, output_iterator result) const noexcept
+    {
+        return transform(first, last, result, std::integral_constant<bool, OutputExtent != dynamic_extent>());
+    }
+
 private:
+    // Number of channels is known at compile time, so all channels can be interleaved at once unless the input has too
+    // few channels to fill each output frame
+    inline output_iterator transform(
+        input_iterator first, input_iterator last, output_iterator result, std::true_type) const noexcept
+    {
+        if (static_cast<std::size_t>(std::distance(first, last)) < OutputExtent)
+        {
+            return transform(first, last, result, std::false_type());
+        }
+        auto frames = first.frames();
+        frame_transformer(dither_gen_).interleave_planar(first.base(), first.offset(), result.base(), frames);
+        return result + static_cast<typename output_iterator::difference_type>(frames);
+    }
+
+    // Number of channels is only known at runtime, so transform each channel into a strided output channel
+    inline output_iterator transform(
+        input_iterator first, input_iterator last, output_iterator result, std::false_type) const noexcept
+    {
+        auto transformer = channel_transformer(dither_gen_);
+        auto channels = std::min(static_cast<std::size_t>(std::distance(first, last)), result.channels());
+        auto frames = first.frames();
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num, (void)++first)
+        {
+            auto input = *first;
+            auto output = output_channel(result.base() + channel_num, frames, result.channels());
+            transformer(input.cbegin(), input.cend(), output.begin());
+        }
+        return result + static_cast<typename output_iterator::difference_type>(frames);
+    }
+
     std::reference_wrapper<DitherGenerator> dither_gen_;
 };
 
@@ -0,0 +1,26 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_extent_
+#define _ratl_extent_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+// other includes
+#include <cstddef>
+#include <limits>
+
+namespace ratl
+{
+// Extent of a span whose number of channels is only known at runtime
+// Spans and iterators with any other extent have that number of channels fixed at compile time, as with std::span.
+static constexpr std::size_t dynamic_extent = std::numeric_limits<std::size_t>::max();
+
+} // namespace ratl
+
+#endif // _ratl_extent_
@@ -0,0 +1,27 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_for_overwrite_
+#define _ratl_for_overwrite_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+namespace ratl
+{
+// Tag type used to select the constructors and resize functions of the owning buffer types that leave newly allocated
+// samples uninitialised, for use when every sample is about to be overwritten (e.g. by ratl::transform)
+struct for_overwrite_t
+{
+    explicit for_overwrite_t() = default;
+};
+
+static constexpr for_overwrite_t for_overwrite{};
+
+} // namespace ratl
+
+#endif // _ratl_for_overwrite_
@@ -9,18 +9,28 @@
 #define _ratl_frame_span_
 
 // ratl includes
+#include <ratl/detail/extent_storage.hpp>
 #include <ratl/detail/frame_iterator.hpp>
 #include <ratl/detail/sample_span.hpp>
+#include <ratl/extent.hpp>
 #include <ratl/frame.hpp>
 #include <ratl/network_sample.hpp>
 #include <ratl/sample.hpp>
 
 namespace ratl
 {
-template<typename SampleType, typename SampleTraits, typename Contiguous = std::false_type>
+template<
+    typename SampleType,
+    typename SampleTraits,
+    typename Contiguous = std::false_type,
+    std::size_t Extent = dynamic_extent>
 class basic_frame_span
 {
     using data_impl_type = sample_span<SampleType, SampleTraits, Contiguous, detail::frame_iterator>;
+    using extent_type = detail::extent_storage<Extent>;
+
+    template<typename, typename, typename, std::size_t>
+    friend class basic_frame_span;
 
 public:
     using sample_type = typename data_impl_type::sample_type;
@@ -55,14 +65,15 @@ public:
     template<
         typename DummyContiguous = Contiguous,
         std::enable_if_t<std::is_same<DummyContiguous, std::false_type>::value, bool> = true>
-    basic_frame_span(sample_pointer data, size_type channels, size_type stride) noexcept : data_(data, channels, stride)
+    basic_frame_span(sample_pointer data, size_type channels, size_type stride) noexcept :
+        data_(data, extent_type(channels).size(), stride)
     {
     }
 
     template<
         typename DummyContiguous = Contiguous,
         std::enable_if_t<std::is_same<DummyContiguous, std::true_type>::value, bool> = true>
-    basic_frame_span(sample_pointer data, size_type channels) noexcept : data_(data, channels)
+    basic_frame_span(sample_pointer data, size_type channels) noexcept : data_(data, extent_type(channels).size())
     {
     }
 
@@ -70,7 +81,7 @@ public:
         typename DummyContiguous = Contiguous,
         std::enable_if_t<std::is_same<DummyContiguous, std::false_type>::value, bool> = true>
     basic_frame_span(char_pointer data, size_type channels, size_type stride) noexcept :
-        data_(reinterpret_cast<sample_pointer>(data), channels, stride)
+        data_(reinterpret_cast<sample_pointer>(data), extent_type(channels).size(), stride)
     {
     }
 
@@ -78,7 +89,7 @@ public:
         typename DummyContiguous = Contiguous,
         std::enable_if_t<std::is_same<DummyContiguous, std::true_type>::value, bool> = true>
     basic_frame_span(char_pointer data, size_type channels) noexcept :
-        data_(reinterpret_cast<sample_pointer>(data), channels)
+        data_(reinterpret_cast<sample_pointer>(data), extent_type(channels).size())
     {
     }
 
@@ -86,7 +97,8 @@ public:
         class Sample,
         typename Allocator,
         std::enable_if_t<std::is_same<Sample, std::remove_const_t<sample_type>>::value, bool> = true>
-    basic_frame_span(basic_frame<Sample, Allocator>& frame) noexcept : data_(frame.data(), frame.channels())
+    basic_frame_span(basic_frame<Sample, Allocator>& frame) noexcept :
+        data_(frame.data(), extent_type(frame.channels()).size())
     {
     }
 
@@ -96,10 +108,30 @@ public:
         std::enable_if_t<
             std::is_same<typename detail::sample_traits<Sample>::const_sample_type, sample_type>::value,
             bool> = true>
-    basic_frame_span(const basic_frame<Sample, Allocator>& frame) noexcept : data_(frame.data(), frame.channels())
+    basic_frame_span(const basic_frame<Sample, Allocator>& frame) noexcept :
+        data_(frame.data(), extent_type(frame.channels()).size())
+    {
+    }
+
+    // A span with a static extent can be converted to one with a dynamic extent
+    template<
+        std::size_t ArgExtent,
+        std::enable_if_t<(ArgExtent != Extent) && detail::is_extent_convertible<ArgExtent, Extent>::value, bool> = true>
+    basic_frame_span(const basic_frame_span<SampleType, SampleTraits, Contiguous, ArgExtent>& other) noexcept :
+        data_(other.data_)
     {
     }
 
+    // The number of channels in other must be equal to Extent
+    template<
+        std::size_t ArgExtent,
+        std::enable_if_t<(ArgExtent == dynamic_extent) && (Extent != dynamic_extent), bool> = true>
+    explicit basic_frame_span(const basic_frame_span<SampleType, SampleTraits, Contiguous, ArgExtent>& other) noexcept :
+        data_(other.data_)
+    {
+        assert(other.channels() == Extent);
+    }
+
     basic_frame_span& operator=(const basic_frame_span&) noexcept = default;
 
     void swap(basic_frame_span& other)
@@ -114,7 +146,7 @@ public:
 
     inline size_type channels() const noexcept
     {
-        return data_.samples();
+        return Extent == dynamic_extent ? data_.samples() : Extent;
     }
 
     inline size_type stride() const noexcept
@@ -225,11 +257,12 @@ public:
     }
 };
 
-template<typename SampleType, typename SampleTraits, typename Contiguous>
-inline typename basic_frame_span<SampleType, SampleTraits, Contiguous>::reference basic_frame_span<
+template<typename SampleType, typename SampleTraits, typename Contiguous, std::size_t Extent>
+inline typename basic_frame_span<SampleType, SampleTraits, Contiguous, Extent>::reference basic_frame_span<
     SampleType,
     SampleTraits,
-    Contiguous>::at(size_type n)
+    Contiguous,
+    Extent>::at(size_type n)
 {
     if (n >= channels())
     {
@@ -238,11 +271,12 @@ inline typename basic_frame_span<SampleType, SampleTraits, Contiguous>::referenc
     return (*this)[n];
 }
 
-template<typename SampleType, typename SampleTraits, typename Contiguous>
-inline typename basic_frame_span<SampleType, SampleTraits, Contiguous>::const_reference basic_frame_span<
+template<typename SampleType, typename SampleTraits, typename Contiguous, std::size_t Extent>
+inline typename basic_frame_span<SampleType, SampleTraits, Contiguous, Extent>::const_reference basic_frame_span<
     SampleType,
     SampleTraits,
-    Contiguous>::at(size_type n) const
+    Contiguous,
+    Extent>::at(size_type n) const
 {
     if (n >= channels())
     {
@@ -251,22 +285,30 @@ inline typename basic_frame_span<SampleType, SampleTraits, Contiguous>::const_re
     return (*this)[n];
 }
 
-template<typename SampleValueType>
-using frame_span = basic_frame_span<sample<SampleValueType>, detail::sample_traits<sample<SampleValueType>>>;
+template<typename SampleValueType, std::size_t Extent = dynamic_extent>
+using frame_span =
+    basic_frame_span<sample<SampleValueType>, detail::sample_traits<sample<SampleValueType>>, std::false_type, Extent>;
 
-template<typename SampleValueType>
+template<typename SampleValueType, std::size_t Extent = dynamic_extent>
 using const_frame_span = basic_frame_span<
     typename detail::sample_traits<sample<SampleValueType>>::const_sample_type,
-    detail::const_sample_traits_t<detail::sample_traits<sample<SampleValueType>>>>;
-
-template<typename SampleValueType>
-using network_frame_span =
-    basic_frame_span<network_sample<SampleValueType>, detail::sample_traits<network_sample<SampleValueType>>>;
-
-template<typename SampleValueType>
+    detail::const_sample_traits_t<detail::sample_traits<sample<SampleValueType>>>,
+    std::false_type,
+    Extent>;
+
+template<typename SampleValueType, std::size_t Extent = dynamic_extent>
+using network_frame_span = basic_frame_span<
+    network_sample<SampleValueType>,
+    detail::sample_traits<network_sample<SampleValueType>>,
+    std::false_type,
+    Extent>;
+
+template<typename SampleValueType, std::size_t Extent = dynamic_extent>
 using const_network_frame_span = basic_frame_span<
     typename detail::sample_traits<network_sample<SampleValueType>>::const_sample_type,
-    detail::const_sample_traits_t<detail::sample_traits<network_sample<SampleValueType>>>>;
+    detail::const_sample_traits_t<detail::sample_traits<network_sample<SampleValueType>>>,
+    std::false_type,
+    Extent>;
 
 } // namespace ratl
 
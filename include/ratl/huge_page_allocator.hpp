@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_huge_page_allocator_
+#define _ratl_huge_page_allocator_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/page_mapping.hpp>
+
+// other includes
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace ratl
+{
+// Options controlling how a huge_page_allocator maps memory
+// huge_pages backs allocations of at least one huge page with huge pages where the platform supports it, which
+// reduces TLB misses when streaming through large buffers. lock locks the pages into physical memory so that they can
+// never be paged out, and prefault touches every page at allocation time so that the first access does not fault.
+struct page_options
+{
+    bool huge_pages = true;
+    bool lock = false;
+    bool prefault = false;
+
+    // Memory that is guaranteed to be resident once allocated, suitable for access from a real-time thread
+    static constexpr page_options realtime() noexcept
+    {
+        return page_options{true, true, true};
+    }
+};
+
+// Allocator that maps memory directly from the operating system in whole pages
+// Intended for large, long-lived buffers such as multi-channel capture buffers; every allocation is rounded up to a
+// whole number of pages (or huge pages for allocations of at least one huge page), so it is wasteful for small
+// allocations. Allocation is not real-time safe, however when page_options::realtime() is used the allocated memory
+// can be accessed from a real-time thread without incurring page faults. Throws std::bad_alloc if the memory cannot
+// be mapped or, if requested, locked.
+template<typename Tp>
+class huge_page_allocator
+{
+public:
+    using value_type = Tp;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+private:
+    page_options options_;
+
+public:
+    huge_page_allocator() noexcept = default;
+
+    explicit huge_page_allocator(const page_options& options) noexcept : options_(options) {}
+
+    template<typename Up>
+    huge_page_allocator(const huge_page_allocator<Up>& other) noexcept : options_(other.options())
+    {
+    }
+
+    inline Tp* allocate(size_type n)
+    {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(Tp))
+        {
+            throw std::bad_alloc();
+        }
+        auto bytes = n * sizeof(Tp);
+        auto* data = detail::map_pages(bytes, options_.huge_pages);
+        if (data == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        if (options_.lock && !detail::lock_pages(data, bytes))
+        {
+            detail::unmap_pages(data, bytes);
+            throw std::bad_alloc();
+        }
+        if (options_.prefault)
+        {
+            detail::prefault_pages(data, bytes);
+        }
+        return static_cast<Tp*>(data);
+    }
+
+    inline void deallocate(Tp* p, size_type n) noexcept
+    {
+        detail::unmap_pages(p, n * sizeof(Tp));
+    }
+
+    inline const page_options& options() const noexcept
+    {
+        return options_;
+    }
+};
+
+// All huge_page_allocators can deallocate memory allocated by any other, the options only affect allocation
+template<typename Tp, typename Up>
+inline bool operator==(const huge_page_allocator<Tp>&, const huge_page_allocator<Up>&) noexcept
+{
+    return true;
+}
+
+template<typename Tp, typename Up>
+inline bool operator!=(const huge_page_allocator<Tp>& a, const huge_page_allocator<Up>& b) noexcept
+{
+    return !(a == b);
+}
+
+} // namespace ratl
+
+#endif // _ratl_huge_page_allocator_
@@ -14,16 +14,23 @@
 #include <ratl/detail/config.hpp>
 #include <ratl/detail/interleaved_iterator.hpp>
 #include <ratl/detail/operator_arrow_proxy.hpp>
+#include <ratl/detail/relayout.hpp>
 #include <ratl/detail/sample_traits.hpp>
+#include <ratl/for_overwrite.hpp>
 #include <ratl/frame_span.hpp>
 #include <ratl/network_sample.hpp>
 #include <ratl/sample.hpp>
 
 // other includes
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 
+#if defined(RATL_HAS_MEMORY_RESOURCE)
+#    include <memory_resource>
+#endif
+
 namespace ratl
 {
 template<typename SampleType, typename Allocator = ratl::allocator<SampleType>>
@@ -75,18 +82,21 @@ private:
         sample_pointer start_;
         size_type channels_;
         size_type frames_;
+        size_type capacity_;
 
-        data_impl() noexcept : start_(), channels_(), frames_() {}
+        data_impl() noexcept : start_(), channels_(), frames_(), capacity_() {}
 
-        data_impl(size_type channels, size_type frames) : start_(), channels_(channels), frames_(frames) {}
+        data_impl(size_type channels, size_type frames) : start_(), channels_(channels), frames_(frames), capacity_() {}
 
         data_impl(const data_impl& other) noexcept = default;
 
-        data_impl(data_impl&& other) noexcept : start_(other.start_), channels_(other.channels_), frames_(other.frames_)
+        data_impl(data_impl&& other) noexcept :
+            start_(other.start_), channels_(other.channels_), frames_(other.frames_), capacity_(other.capacity_)
         {
             other.start_ = nullptr;
             other.channels_ = 0;
             other.frames_ = 0;
+            other.capacity_ = 0;
         }
 
         void copy(const data_impl& other) noexcept
@@ -94,6 +104,7 @@ private:
             start_ = other.start_;
             channels_ = other.channels_;
             frames_ = other.frames_;
+            capacity_ = other.capacity_;
         }
 
         void move(data_impl& other) noexcept
@@ -107,6 +118,7 @@ private:
             std::swap(start_, other.start_);
             std::swap(channels_, other.channels_);
             std::swap(frames_, other.frames_);
+            std::swap(capacity_, other.capacity_);
         }
     };
 
@@ -122,6 +134,11 @@ public:
 
     basic_interleaved(size_type channels, size_type frames, const allocator_type& alloc);
 
+    // The samples are left uninitialised
+    basic_interleaved(for_overwrite_t, size_type channels, size_type frames);
+
+    basic_interleaved(for_overwrite_t, size_type channels, size_type frames, const allocator_type& alloc);
+
     basic_interleaved(const basic_interleaved& other);
 
     basic_interleaved(const basic_interleaved& other, const allocator_type& alloc);
@@ -191,6 +208,24 @@ public:
         return (channels() == 0) || (frames() == 0);
     }
 
+    // Number of samples that can be held without reallocating
+    inline size_type capacity() const noexcept
+    {
+        return data_.capacity_;
+    }
+
+    void reserve(size_type new_capacity);
+
+    // Samples that are in both the old and new dimensions keep their value and any other samples are zeroed
+    // Does not reallocate if the new number of samples fits within capacity().
+    void resize(size_type channels, size_type frames);
+
+    // The values of all samples are unspecified after resizing
+    // Does not reallocate if the new number of samples fits within capacity().
+    void resize(for_overwrite_t, size_type channels, size_type frames);
+
+    void shrink_to_fit();
+
     inline frame_type frame(size_type n)
     {
         return frame_type(data() + (n * channels()), channels());
@@ -319,14 +354,19 @@ private:
     void allocate()
     {
         data_.start_ = alloc_traits::allocate(alloc_, samples());
+        data_.capacity_ = samples();
         // we don't need to default construct the samples as sample types are trivially default constructable
     }
 
     void deallocate()
     {
-        alloc_traits::deallocate(alloc_, data_.start_, samples());
+        alloc_traits::deallocate(alloc_, data_.start_, capacity());
     }
 
+    void reallocate(size_type new_capacity);
+
+    void relayout(size_type channels, size_type frames) noexcept;
+
     void copy_assign_alloc(const basic_interleaved& other)
     {
         copy_assign_alloc(other, typename alloc_traits::propagate_on_container_copy_assignment());
@@ -390,6 +430,27 @@ basic_interleaved<SampleType, Allocator>::basic_interleaved(
     }
 }
 
+template<typename SampleType, typename Allocator>
+basic_interleaved<SampleType, Allocator>::basic_interleaved(for_overwrite_t, size_type channels, size_type frames) :
+    data_(channels, frames)
+{
+    if (!empty())
+    {
+        allocate();
+    }
+}
+
+template<typename SampleType, typename Allocator>
+basic_interleaved<SampleType, Allocator>::basic_interleaved(
+    for_overwrite_t, size_type channels, size_type frames, const allocator_type& alloc) :
+    alloc_(alloc), data_(channels, frames)
+{
+    if (!empty())
+    {
+        allocate();
+    }
+}
+
 template<typename SampleType, typename Allocator>
 basic_interleaved<SampleType, Allocator>::basic_interleaved(const basic_interleaved& other) :
     alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)), data_(other.channels(), other.frames())
@@ -469,7 +530,7 @@ void basic_interleaved<SampleType, Allocator>::move_assign(basic_interleaved& ot
         {
             deallocate();
         }
-        data_.swap(other.data_);
+        data_.copy(data_impl(other.channels(), other.frames()));
         if (samples() > 0)
         {
             allocate();
@@ -489,6 +550,88 @@ void basic_interleaved<SampleType, Allocator>::swap(basic_interleaved& other)
     data_.swap(other.data_);
 }
 
+template<typename SampleType, typename Allocator>
+void basic_interleaved<SampleType, Allocator>::reserve(size_type new_capacity)
+{
+    if (new_capacity > capacity())
+    {
+        reallocate(new_capacity);
+    }
+}
+
+template<typename SampleType, typename Allocator>
+void basic_interleaved<SampleType, Allocator>::resize(size_type channels, size_type frames)
+{
+    if ((channels * frames) > capacity())
+    {
+        basic_interleaved other(for_overwrite, channels, frames, alloc_);
+        auto copy_channels = std::min(channels, this->channels());
+        auto copy_frames = std::min(frames, this->frames());
+        for (size_type frame_num = 0; frame_num < copy_frames; ++frame_num)
+        {
+            auto output = other.data() + (frame_num * channels);
+            std::copy_n(data() + (frame_num * this->channels()), copy_channels, output);
+            std::fill_n(output + copy_channels, channels - copy_channels, sample_type());
+        }
+        std::fill_n(other.data() + (copy_frames * channels), (frames - copy_frames) * channels, sample_type());
+        data_.swap(other.data_);
+    }
+    else
+    {
+        relayout(channels, frames);
+        data_.channels_ = channels;
+        data_.frames_ = frames;
+    }
+}
+
+template<typename SampleType, typename Allocator>
+void basic_interleaved<SampleType, Allocator>::resize(for_overwrite_t, size_type channels, size_type frames)
+{
+    if ((channels * frames) > capacity())
+    {
+        basic_interleaved(for_overwrite, channels, frames, alloc_).data_.swap(data_);
+    }
+    else
+    {
+        data_.channels_ = channels;
+        data_.frames_ = frames;
+    }
+}
+
+template<typename SampleType, typename Allocator>
+void basic_interleaved<SampleType, Allocator>::shrink_to_fit()
+{
+    if (capacity() > samples())
+    {
+        reallocate(samples());
+    }
+}
+
+template<typename SampleType, typename Allocator>
+void basic_interleaved<SampleType, Allocator>::reallocate(size_type new_capacity)
+{
+    auto new_start = (new_capacity > 0) ? alloc_traits::allocate(alloc_, new_capacity) : sample_pointer();
+    if (data() != nullptr)
+    {
+        std::copy_n(data(), samples(), new_start);
+        deallocate();
+    }
+    data_.start_ = new_start;
+    data_.capacity_ = new_capacity;
+}
+
+template<typename SampleType, typename Allocator>
+void basic_interleaved<SampleType, Allocator>::relayout(size_type channels, size_type frames) noexcept
+{
+    detail::relayout(
+        data(),
+        this->channels(),
+        channels,
+        std::min(frames, this->frames()),
+        std::min(channels, this->channels()),
+        frames);
+}
+
 template<typename SampleType, typename Allocator>
 inline typename basic_interleaved<SampleType, Allocator>::reference basic_interleaved<SampleType, Allocator>::at(
     size_type n)
@@ -532,6 +675,23 @@ using interleaved = basic_interleaved<sample<SampleValueType>>;
 template<typename SampleValueType>
 using network_interleaved = basic_interleaved<network_sample<SampleValueType>>;
 
+#if defined(RATL_HAS_MEMORY_RESOURCE)
+
+namespace pmr
+{
+template<typename SampleValueType>
+using interleaved =
+    basic_interleaved<sample<SampleValueType>, std::pmr::polymorphic_allocator<sample<SampleValueType>>>;
+
+template<typename SampleValueType>
+using network_interleaved = basic_interleaved<
+    network_sample<SampleValueType>,
+    std::pmr::polymorphic_allocator<network_sample<SampleValueType>>>;
+
+} // namespace pmr
+
+#endif
+
 } // namespace ratl
 
 #endif // _ratl_interleaved_
@@ -11,22 +11,27 @@
 // ratl includes
 #include <ratl/channel_span.hpp>
 #include <ratl/detail/config.hpp>
+#include <ratl/detail/extent_storage.hpp>
 #include <ratl/detail/interleaved_iterator.hpp>
 #include <ratl/detail/operator_arrow_proxy.hpp>
 #include <ratl/detail/sample_traits.hpp>
+#include <ratl/extent.hpp>
 #include <ratl/frame_span.hpp>
 #include <ratl/interleaved.hpp>
 #include <ratl/network_sample.hpp>
 #include <ratl/sample.hpp>
 
 // other includes
+#include <cassert>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 
 namespace ratl
 {
-template<typename SampleType, typename SampleTraits>
+// Extent is the number of channels if it is known at compile time, or dynamic_extent if it is not
+// With a static extent, transform is able to use kernels that are specialised for that number of channels.
+template<typename SampleType, typename SampleTraits, std::size_t Extent = dynamic_extent>
 class basic_interleaved_span
 {
     static_assert(
@@ -44,8 +49,8 @@ public:
 
     using channel_type = basic_channel_span<sample_type, sample_traits, std::false_type>;
     using const_channel_type = basic_channel_span<const_sample_type, const_sample_traits, std::false_type>;
-    using frame_type = basic_frame_span<sample_type, sample_traits, std::true_type>;
-    using const_frame_type = basic_frame_span<const_sample_type, const_sample_traits, std::true_type>;
+    using frame_type = basic_frame_span<sample_type, sample_traits, std::true_type, Extent>;
+    using const_frame_type = basic_frame_span<const_sample_type, const_sample_traits, std::true_type, Extent>;
 
     using char_pointer = std::conditional_t<std::is_const<sample_type>::value, const unsigned char*, unsigned char*>;
 
@@ -58,14 +63,14 @@ public:
     using reference = frame_type;
     using const_reference = const_frame_type;
 
-    using iterator = detail::interleaved_iterator<sample_type, sample_traits>;
-    using const_iterator = detail::interleaved_iterator<const_sample_type, const_sample_traits>;
+    using iterator = detail::interleaved_iterator<sample_type, sample_traits, Extent>;
+    using const_iterator = detail::interleaved_iterator<const_sample_type, const_sample_traits, Extent>;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 private:
     sample_pointer start_;
-    size_type channels_;
+    detail::extent_storage<Extent> channels_;
     size_type frames_;
 
 public:
@@ -86,6 +91,24 @@ public:
     {
     }
 
+    // A span with a static extent can be converted to one with a dynamic extent
+    template<
+        std::size_t ArgExtent,
+        std::enable_if_t<(ArgExtent != Extent) && detail::is_extent_convertible<ArgExtent, Extent>::value, bool> = true>
+    basic_interleaved_span(const basic_interleaved_span<SampleType, SampleTraits, ArgExtent>& other) noexcept :
+        start_(other.data()), channels_(other.channels()), frames_(other.frames())
+    {
+    }
+
+    // The number of channels in other must be equal to Extent
+    template<
+        std::size_t ArgExtent,
+        std::enable_if_t<(ArgExtent == dynamic_extent) && (Extent != dynamic_extent), bool> = true>
+    explicit basic_interleaved_span(const basic_interleaved_span<SampleType, SampleTraits, ArgExtent>& other) noexcept :
+        start_(other.data()), channels_(other.channels()), frames_(other.frames())
+    {
+    }
+
     template<
         class Sample,
         typename Allocator,
@@ -117,7 +140,7 @@ public:
 
     inline size_type channels() const noexcept
     {
-        return channels_;
+        return channels_.size();
     }
 
     inline size_type frames() const noexcept
@@ -253,18 +276,19 @@ public:
     }
 };
 
-template<typename SampleType, typename SampleTraits>
-inline void basic_interleaved_span<SampleType, SampleTraits>::swap(basic_interleaved_span& other) noexcept
+template<typename SampleType, typename SampleTraits, std::size_t Extent>
+inline void basic_interleaved_span<SampleType, SampleTraits, Extent>::swap(basic_interleaved_span& other) noexcept
 {
     std::swap(start_, other.start_);
     std::swap(channels_, other.channels_);
     std::swap(frames_, other.frames_);
 }
 
-template<typename SampleType, typename SampleTraits>
-inline typename basic_interleaved_span<SampleType, SampleTraits>::reference basic_interleaved_span<
+template<typename SampleType, typename SampleTraits, std::size_t Extent>
+inline typename basic_interleaved_span<SampleType, SampleTraits, Extent>::reference basic_interleaved_span<
     SampleType,
-    SampleTraits>::at(size_type n)
+    SampleTraits,
+    Extent>::at(size_type n)
 {
     if (n >= frames())
     {
@@ -273,10 +297,11 @@ inline typename basic_interleaved_span<SampleType, SampleTraits>::reference basi
     return (*this)[n];
 }
 
-template<typename SampleType, typename SampleTraits>
-inline typename basic_interleaved_span<SampleType, SampleTraits>::const_reference basic_interleaved_span<
+template<typename SampleType, typename SampleTraits, std::size_t Extent>
+inline typename basic_interleaved_span<SampleType, SampleTraits, Extent>::const_reference basic_interleaved_span<
     SampleType,
-    SampleTraits>::at(size_type n) const
+    SampleTraits,
+    Extent>::at(size_type n) const
 {
     if (n >= frames())
     {
@@ -285,23 +310,27 @@ inline typename basic_interleaved_span<SampleType, SampleTraits>::const_referenc
     return (*this)[n];
 }
 
-template<typename SampleValueType>
+template<typename SampleValueType, std::size_t Extent = dynamic_extent>
 using interleaved_span =
-    basic_interleaved_span<sample<SampleValueType>, detail::sample_traits<sample<SampleValueType>>>;
+    basic_interleaved_span<sample<SampleValueType>, detail::sample_traits<sample<SampleValueType>>, Extent>;
 
-template<typename SampleValueType>
+template<typename SampleValueType, std::size_t Extent = dynamic_extent>
 using const_interleaved_span = basic_interleaved_span<
     typename detail::sample_traits<sample<SampleValueType>>::const_sample_type,
-    detail::const_sample_traits_t<detail::sample_traits<sample<SampleValueType>>>>;
+    detail::const_sample_traits_t<detail::sample_traits<sample<SampleValueType>>>,
+    Extent>;
 
-template<typename SampleValueType>
-using network_interleaved_span =
-    basic_interleaved_span<network_sample<SampleValueType>, detail::sample_traits<network_sample<SampleValueType>>>;
+template<typename SampleValueType, std::size_t Extent = dynamic_extent>
+using network_interleaved_span = basic_interleaved_span<
+    network_sample<SampleValueType>,
+    detail::sample_traits<network_sample<SampleValueType>>,
+    Extent>;
 
-template<typename SampleValueType>
+template<typename SampleValueType, std::size_t Extent = dynamic_extent>
 using const_network_interleaved_span = basic_interleaved_span<
     typename detail::sample_traits<network_sample<SampleValueType>>::const_sample_type,
-    detail::const_sample_traits_t<detail::sample_traits<network_sample<SampleValueType>>>>;
+    detail::const_sample_traits_t<detail::sample_traits<network_sample<SampleValueType>>>,
+    Extent>;
 
 } // namespace ratl
 
@@ -0,0 +1,446 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_jitter_buffer_
+#define _ratl_jitter_buffer_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/interleaved.hpp>
+#include <ratl/interleaved_span.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/noninterleaved.hpp>
+#include <ratl/noninterleaved_span.hpp>
+#include <ratl/rtp.hpp>
+#include <ratl/sample.hpp>
+#include <ratl/transform.hpp>
+#include <ratl/types.hpp>
+
+// other includes
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace ratl
+{
+// How a jitter_buffer fills in for a packet that hasn't arrived in time
+enum class jitter_concealment
+{
+    // play silence
+    silence,
+    // repeat the previous packet fading out, then fade the next packet that arrives back in
+    repeat
+};
+
+// Options controlling how far a jitter_buffer plays behind the packets it receives
+struct jitter_buffer_options
+{
+    // How far behind the first packet's timestamp playback starts, which is how much jitter can be absorbed
+    std::size_t latency_frames = 480;
+
+    // Number of frames of packets that can be held, which bounds how far ahead of playback a packet can arrive
+    std::size_t capacity_frames = 8192;
+
+    // Largest number of frames that read() will be asked for at once
+    std::size_t max_period_frames = 1024;
+
+    jitter_concealment concealment = jitter_concealment::repeat;
+};
+
+// jitter_buffer
+// Receives fixed size packets of network order samples tagged with RTP timestamps and sequence numbers on a network
+// thread, and plays them back on an audio thread a period at a time, converted to the device's sample format.
+// Each packet is copied into the slot for its timestamp, so packets that arrive out of order are put back in order, and
+// duplicates, packets that arrive after they were due and packets that arrive too far ahead to be held are dropped.
+// Packets that haven't arrived when they are due are concealed as set by jitter_buffer_options::concealment.
+// Playback starts latency_frames behind the first packet received, and plays silence until then.
+// push() may only be called from one thread and read() from one other thread. Neither allocates, locks or makes a
+// system call: the slots are handed between the threads by their timestamps, and the network thread only writes to
+// slots that the audio thread has finished reading.
+
+template<typename SampleValueType>
+class jitter_buffer
+{
+public:
+    using size_type = std::size_t;
+    using sample_type = network_sample<SampleValueType>;
+    using payload_span = const_network_interleaved_span<SampleValueType>;
+
+private:
+    // How each packet is played, decided once as the audio thread reaches it
+    enum class packet_state
+    {
+        received,
+        faded_in,
+        repeated,
+        silent
+    };
+
+    size_type channels_;
+    size_type frames_per_packet_;
+    jitter_buffer_options options_;
+    size_type capacity_packets_;
+    size_type capacity_frames_;
+    network_interleaved<SampleValueType> slots_;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> slot_timestamps_;
+    std::unique_ptr<std::atomic<bool>[]> slot_valid_;
+
+    // network thread state
+    bool network_started_ = false;
+    std::uint16_t highest_sequence_number_ = 0;
+    std::uint32_t base_timestamp_ = 0;
+
+    // audio thread state
+    bool audio_started_ = false;
+    std::int64_t read_position_ = 0;
+    std::int64_t packet_position_ = 0;
+    packet_state packet_state_ = packet_state::silent;
+    bool concealing_ = false;
+    interleaved<float32_t> scratch_;
+
+    // shared state
+    std::atomic<bool> started_{false};
+    std::atomic<std::int64_t> published_read_position_{0};
+    std::atomic<std::uint64_t> received_packets_{0};
+    std::atomic<std::uint64_t> dropped_packets_{0};
+    std::atomic<std::uint64_t> reordered_packets_{0};
+    std::atomic<std::uint64_t> concealed_packets_{0};
+
+public:
+    jitter_buffer(
+        size_type channels,
+        size_type frames_per_packet,
+        const jitter_buffer_options& options = jitter_buffer_options()) :
+        channels_(channels),
+        frames_per_packet_(frames_per_packet),
+        options_(options),
+        capacity_packets_(
+            frames_per_packet == 0 ? 0 : (options.capacity_frames + frames_per_packet - 1) / frames_per_packet),
+        capacity_frames_(capacity_packets_ * frames_per_packet),
+        slots_(channels, capacity_frames_),
+        slot_timestamps_(new std::atomic<std::uint32_t>[capacity_packets_]),
+        slot_valid_(new std::atomic<bool>[capacity_packets_]),
+        scratch_(channels, frames_per_packet)
+    {
+        if (channels == 0 || frames_per_packet == 0)
+        {
+            throw std::invalid_argument("jitter_buffer: packets must hold at least one channel and frame");
+        }
+        if (options.latency_frames + options.max_period_frames + (2 * frames_per_packet) > capacity_frames_)
+        {
+            throw std::invalid_argument("jitter_buffer: capacity is too small for the latency and period");
+        }
+        for (size_type slot_num = 0; slot_num < capacity_packets_; ++slot_num)
+        {
+            slot_timestamps_[slot_num].store(0, std::memory_order_relaxed);
+            slot_valid_[slot_num].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    size_type frames_per_packet() const noexcept
+    {
+        return frames_per_packet_;
+    }
+
+    // Packets accepted by push()
+    std::uint64_t received_packets() const noexcept
+    {
+        return received_packets_.load(std::memory_order_relaxed);
+    }
+
+    // Packets that push() dropped as duplicates, as too late or too early to be played, or as the wrong size
+    std::uint64_t dropped_packets() const noexcept
+    {
+        return dropped_packets_.load(std::memory_order_relaxed);
+    }
+
+    // Packets that arrived after a packet with a later sequence number
+    std::uint64_t reordered_packets() const noexcept
+    {
+        return reordered_packets_.load(std::memory_order_relaxed);
+    }
+
+    // Packets that hadn't arrived by the time they were played
+    std::uint64_t concealed_packets() const noexcept
+    {
+        return concealed_packets_.load(std::memory_order_relaxed);
+    }
+
+    // Called from the network thread with a received packet, returns whether it was accepted
+    bool push(const rtp_packet<SampleValueType>& packet) noexcept
+    {
+        return push(packet.header.sequence_number, packet.header.timestamp, packet.payload);
+    }
+
+    bool push(std::uint16_t sequence_number, std::uint32_t timestamp, const payload_span& payload) noexcept
+    {
+        if (payload.channels() != channels_ || payload.frames() != frames_per_packet_)
+        {
+            dropped_packets_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (!network_started_)
+        {
+            // the audio thread takes over the read position once it sees that the stream has started
+            network_started_ = true;
+            highest_sequence_number_ = sequence_number;
+            base_timestamp_ = timestamp;
+            published_read_position_.store(
+                -static_cast<std::int64_t>(options_.latency_frames), std::memory_order_relaxed);
+            started_.store(true, std::memory_order_release);
+        }
+        else if (static_cast<std::int16_t>(sequence_number - highest_sequence_number_) < 0)
+        {
+            reordered_packets_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            highest_sequence_number_ = sequence_number;
+        }
+
+        // the slot for this timestamp is free once the audio thread is past the packet that last used it, and the one
+        // after it which may repeat it, so packets are accepted from the read position up to a period and two packets
+        // short of the capacity beyond it. A packet the audio thread has started playing is already too late.
+        auto read_position = published_read_position_.load(std::memory_order_acquire);
+        auto ahead = static_cast<std::int64_t>(static_cast<std::int32_t>(timestamp - timestamp_at(read_position)));
+        auto position = read_position + ahead;
+        auto slot_num = slot_for(position);
+        if (ahead < 0 ||
+            ahead >= static_cast<std::int64_t>(
+                         capacity_frames_ - options_.max_period_frames - (2 * frames_per_packet_)) ||
+            packet_start(position) != position ||
+            (slot_valid_[slot_num].load(std::memory_order_relaxed) &&
+             slot_timestamps_[slot_num].load(std::memory_order_relaxed) == timestamp))
+        {
+            dropped_packets_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slot_valid_[slot_num].store(false, std::memory_order_relaxed);
+        std::memcpy(slot_data(slot_num), payload.data(), channels_ * frames_per_packet_ * sizeof(sample_type));
+        slot_timestamps_[slot_num].store(timestamp, std::memory_order_relaxed);
+        slot_valid_[slot_num].store(true, std::memory_order_release);
+        received_packets_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Called from the audio thread to play the next output.frames() frames into output
+    template<typename SampleType, typename SampleTraits, std::size_t Extent>
+    void read(basic_interleaved_span<SampleType, SampleTraits, Extent> output)
+    {
+        read_frames(
+            output.frames(),
+            [&output](size_type first_frame, size_type frames)
+            {
+                return basic_interleaved_span<SampleType, SampleTraits, Extent>(
+                    output.data() + (first_frame * output.channels()), output.channels(), frames);
+            });
+    }
+
+    template<typename SampleType, typename SampleTraits>
+    void read(basic_noninterleaved_span<SampleType, SampleTraits> output)
+    {
+        read_frames(
+            output.frames(),
+            [&output](size_type first_frame, size_type frames)
+            {
+                return basic_noninterleaved_span<SampleType, SampleTraits>(
+                    output.data() + first_frame, output.channels(), frames, output.pitch());
+            });
+    }
+
+    template<typename Sample, typename Allocator>
+    void read(basic_interleaved<Sample, Allocator>& output)
+    {
+        using sample_traits = detail::sample_traits<Sample>;
+        read(basic_interleaved_span<typename sample_traits::sample_type, sample_traits>(output));
+    }
+
+    template<typename Sample, typename Allocator, typename ChannelLayout>
+    void read(basic_noninterleaved<Sample, Allocator, ChannelLayout>& output)
+    {
+        using sample_traits = detail::sample_traits<Sample>;
+        read(basic_noninterleaved_span<typename sample_traits::sample_type, sample_traits>(output));
+    }
+
+private:
+    // Positions count frames from the first packet received in 64 bits, so that packet boundaries and slots stay put
+    // when the 32 bit RTP timestamps wrap
+    std::int64_t packet_start(std::int64_t position) const noexcept
+    {
+        auto remainder = position % static_cast<std::int64_t>(frames_per_packet_);
+        return position - remainder - (remainder < 0 ? static_cast<std::int64_t>(frames_per_packet_) : 0);
+    }
+
+    std::uint32_t timestamp_at(std::int64_t position) const noexcept
+    {
+        return base_timestamp_ + static_cast<std::uint32_t>(position);
+    }
+
+    size_type slot_for(std::int64_t packet_position) const noexcept
+    {
+        auto capacity_packets = static_cast<std::int64_t>(capacity_packets_);
+        auto slot_num = (packet_position / static_cast<std::int64_t>(frames_per_packet_)) % capacity_packets;
+        return static_cast<size_type>(slot_num < 0 ? slot_num + capacity_packets : slot_num);
+    }
+
+    sample_type* slot_data(size_type slot_num) noexcept
+    {
+        return slots_.data() + (slot_num * frames_per_packet_ * channels_);
+    }
+
+    // The payload of the packet at the given position, or an empty span if it hasn't been received
+    payload_span received_payload(std::int64_t packet_position) noexcept
+    {
+        auto slot_num = slot_for(packet_position);
+        if (!slot_valid_[slot_num].load(std::memory_order_acquire) ||
+            slot_timestamps_[slot_num].load(std::memory_order_relaxed) != timestamp_at(packet_position))
+        {
+            return payload_span();
+        }
+        return payload_span(slot_data(slot_num), channels_, frames_per_packet_);
+    }
+
+    template<typename MakeSpan>
+    void read_frames(size_type frames, MakeSpan make_span)
+    {
+        if (frames > options_.max_period_frames)
+        {
+            throw std::invalid_argument("jitter_buffer: period is larger than max_period_frames");
+        }
+
+        if (!audio_started_)
+        {
+            if (!started_.load(std::memory_order_acquire))
+            {
+                // scratch_ only holds a packet, so the period is silenced a packet at a time
+                for (size_type frame_num = 0; frame_num < frames; frame_num += frames_per_packet_)
+                {
+                    write_silence(make_span(frame_num, std::min(frames - frame_num, frames_per_packet_)));
+                }
+                return;
+            }
+            audio_started_ = true;
+            read_position_ = published_read_position_.load(std::memory_order_relaxed);
+            packet_position_ = std::numeric_limits<std::int64_t>::min();
+        }
+
+        size_type frame_num = 0;
+        while (frame_num < frames)
+        {
+            // the read position may be part way through a packet, or before the first packet
+            auto position = packet_start(read_position_);
+            auto offset = static_cast<size_type>(read_position_ - position);
+            auto segment_frames = std::min(frames - frame_num, frames_per_packet_ - offset);
+            auto output = make_span(frame_num, segment_frames);
+
+            if (position != packet_position_)
+            {
+                start_packet(position);
+            }
+            switch (packet_state_)
+            {
+            case packet_state::received:
+            {
+                auto payload = received_payload(position);
+                auto input = payload_span(payload.data() + (offset * channels_), channels_, segment_frames);
+                transform(input.begin(), input.end(), output.begin());
+                break;
+            }
+            case packet_state::faded_in:
+                write_faded(received_payload(position), offset, segment_frames, true, output);
+                break;
+            case packet_state::repeated:
+                write_faded(
+                    received_payload(position - static_cast<std::int64_t>(frames_per_packet_)),
+                    offset,
+                    segment_frames,
+                    false,
+                    output);
+                break;
+            case packet_state::silent:
+                write_silence(output);
+                break;
+            }
+
+            frame_num += segment_frames;
+            read_position_ += static_cast<std::int64_t>(segment_frames);
+        }
+
+        // the network thread may reuse the slots of every packet before the new read position
+        published_read_position_.store(read_position_, std::memory_order_release);
+    }
+
+    void start_packet(std::int64_t position) noexcept
+    {
+        auto repeat = options_.concealment == jitter_concealment::repeat;
+
+        packet_position_ = position;
+        if (received_payload(position).data() != nullptr)
+        {
+            packet_state_ = (concealing_ && repeat) ? packet_state::faded_in : packet_state::received;
+            concealing_ = false;
+        }
+        else if (position < 0)
+        {
+            // the latency before the first packet isn't concealment
+            packet_state_ = packet_state::silent;
+        }
+        else
+        {
+            concealed_packets_.fetch_add(1, std::memory_order_relaxed);
+            auto previous_payload = received_payload(position - static_cast<std::int64_t>(frames_per_packet_));
+            packet_state_ = (!concealing_ && repeat && previous_payload.data() != nullptr) ? packet_state::repeated
+                                                                                           : packet_state::silent;
+            concealing_ = true;
+        }
+    }
+
+    // Converts frames [offset, offset + frames) of payload to float, applies a linear fade in or out over the whole
+    // packet, and converts the result to the output format
+    template<typename Output>
+    void write_faded(const payload_span& payload, size_type offset, size_type frames, bool fade_in, Output output)
+    {
+        auto input = payload_span(payload.data() + (offset * channels_), channels_, frames);
+        auto faded = interleaved_span<float32_t>(scratch_.data(), channels_, frames);
+        transform(input.begin(), input.end(), faded.begin());
+        for (size_type frame_num = 0; frame_num < frames; ++frame_num)
+        {
+            auto position = static_cast<float32_t>(offset + frame_num + 1) / static_cast<float32_t>(frames_per_packet_);
+            auto gain = fade_in ? position : 1.0f - position;
+            for (auto& value : faded[frame_num])
+            {
+                value = sample<float32_t>(value.get() * gain);
+            }
+        }
+        transform(faded.begin(), faded.end(), output.begin());
+    }
+
+    // Output can be at most a packet long
+    template<typename Output>
+    void write_silence(Output output)
+    {
+        auto silence = interleaved_span<float32_t>(scratch_.data(), channels_, output.frames());
+        std::fill(silence.data(), silence.data() + silence.samples(), sample<float32_t>(0.0f));
+        transform(silence.begin(), silence.end(), output.begin());
+    }
+};
+
+} // namespace ratl
+
+#endif // _ratl_jitter_buffer_
@@ -10,27 +10,42 @@
 
 // ratl includes
 #include <ratl/allocator.hpp>
+#include <ratl/channel_layout.hpp>
 #include <ratl/channel_span.hpp>
 #include <ratl/detail/config.hpp>
 #include <ratl/detail/noninterleaved_iterator.hpp>
 #include <ratl/detail/operator_arrow_proxy.hpp>
+#include <ratl/detail/relayout.hpp>
 #include <ratl/detail/sample_traits.hpp>
+#include <ratl/for_overwrite.hpp>
 #include <ratl/frame_span.hpp>
 #include <ratl/network_sample.hpp>
 #include <ratl/sample.hpp>
 
 // other includes
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 
+#if defined(RATL_HAS_MEMORY_RESOURCE)
+#    include <memory_resource>
+#endif
+
 namespace ratl
 {
-template<typename SampleType, typename Allocator = ratl::allocator<SampleType>>
+// ChannelLayout decides the pitch of the buffer, i.e. the distance in samples between the start of consecutive channels
+// With packed_channel_layout the pitch is equal to frames(), with aligned_channel_layout each channel is padded so that
+// it has the same alignment as the first channel.
+template<
+    typename SampleType,
+    typename Allocator = ratl::allocator<SampleType>,
+    typename ChannelLayout = packed_channel_layout>
 class basic_noninterleaved
 {
 public:
     using allocator_type = Allocator;
+    using channel_layout = ChannelLayout;
 
     static_assert(
         std::is_same<std::remove_cv_t<SampleType>, SampleType>::value,
@@ -75,18 +90,21 @@ private:
         sample_pointer start_;
         size_type channels_;
         size_type frames_;
+        size_type capacity_;
 
-        data_impl() noexcept : start_(), channels_(), frames_() {}
+        data_impl() noexcept : start_(), channels_(), frames_(), capacity_() {}
 
-        data_impl(size_type channels, size_type frames) : start_(), channels_(channels), frames_(frames) {}
+        data_impl(size_type channels, size_type frames) : start_(), channels_(channels), frames_(frames), capacity_() {}
 
         data_impl(const data_impl& other) noexcept = default;
 
-        data_impl(data_impl&& other) noexcept : start_(other.start_), channels_(other.channels_), frames_(other.frames_)
+        data_impl(data_impl&& other) noexcept :
+            start_(other.start_), channels_(other.channels_), frames_(other.frames_), capacity_(other.capacity_)
         {
             other.start_ = nullptr;
             other.channels_ = 0;
             other.frames_ = 0;
+            other.capacity_ = 0;
         }
 
         void copy(const data_impl& other) noexcept
@@ -94,6 +112,7 @@ private:
             start_ = other.start_;
             channels_ = other.channels_;
             frames_ = other.frames_;
+            capacity_ = other.capacity_;
         }
 
         void move(data_impl& other) noexcept
@@ -107,6 +126,7 @@ private:
             std::swap(start_, other.start_);
             std::swap(channels_, other.channels_);
             std::swap(frames_, other.frames_);
+            std::swap(capacity_, other.capacity_);
         }
     };
 
@@ -122,6 +142,11 @@ public:
 
     basic_noninterleaved(size_type channels, size_type frames, const allocator_type& alloc);
 
+    // The samples are left uninitialised, but any padding between channels is zeroed
+    basic_noninterleaved(for_overwrite_t, size_type channels, size_type frames);
+
+    basic_noninterleaved(for_overwrite_t, size_type channels, size_type frames, const allocator_type& alloc);
+
     basic_noninterleaved(const basic_noninterleaved& other);
 
     basic_noninterleaved(const basic_noninterleaved& other, const allocator_type& alloc);
@@ -186,29 +211,53 @@ public:
         return channels() * frames();
     }
 
+    // Distance in samples between the start of consecutive channels
+    inline size_type pitch() const noexcept
+    {
+        return channel_layout::template pitch<sample_type>(frames());
+    }
+
     inline bool empty() const noexcept
     {
         return (channels() == 0) || (frames() == 0);
     }
 
+    // Number of samples, including any padding between channels, that can be held without reallocating
+    inline size_type capacity() const noexcept
+    {
+        return data_.capacity_;
+    }
+
+    void reserve(size_type new_capacity);
+
+    // Samples that are in both the old and new dimensions keep their value and any other samples are zeroed
+    // Does not reallocate if the new number of samples (including padding) fits within capacity().
+    void resize(size_type channels, size_type frames);
+
+    // The values of all samples are unspecified after resizing, but any padding between channels is zeroed
+    // Does not reallocate if the new number of samples (including padding) fits within capacity().
+    void resize(for_overwrite_t, size_type channels, size_type frames);
+
+    void shrink_to_fit();
+
     inline frame_type frame(size_type n)
     {
-        return frame_type(data_.start_ + n, channels(), frames());
+        return frame_type(data_.start_ + n, channels(), pitch());
     }
 
     inline const_frame_type frame(size_type n) const
     {
-        return const_frame_type(data_.start_ + n, channels(), frames());
+        return const_frame_type(data_.start_ + n, channels(), pitch());
     }
 
     inline channel_type channel(size_type n)
     {
-        return channel_type(data_.start_ + (n * frames()), frames());
+        return channel_type(data_.start_ + (n * pitch()), frames());
     }
 
     inline const_channel_type channel(size_type n) const
     {
-        return const_channel_type(data_.start_ + (n * frames()), frames());
+        return const_channel_type(data_.start_ + (n * pitch()), frames());
     }
 
     inline reference operator[](size_type n) noexcept
@@ -237,33 +286,33 @@ public:
 
     inline reference back() noexcept
     {
-        return reference(data_.start_ + ((channels() - 1) * frames()), frames());
+        return reference(data_.start_ + ((channels() - 1) * pitch()), frames());
     }
 
     inline const_reference back() const noexcept
     {
-        return reference(data_.start_ + ((channels() - 1) * frames()), frames());
+        return const_reference(data_.start_ + ((channels() - 1) * pitch()), frames());
     }
 
     // iterators
     inline iterator begin() noexcept
     {
-        return iterator(data_.start_, frames());
+        return iterator(data_.start_, frames(), pitch(), true);
     }
 
     inline const_iterator begin() const noexcept
     {
-        return const_iterator(data_.start_, frames());
+        return const_iterator(data_.start_, frames(), pitch(), true);
     }
 
     inline iterator end() noexcept
     {
-        return iterator(data_.start_ + (channels() * frames()), frames());
+        return iterator(data_.start_ + (channels() * pitch()), frames(), pitch(), true);
     }
 
     inline const_iterator end() const noexcept
     {
-        return const_iterator(data_.start_ + (channels() * frames()), frames());
+        return const_iterator(data_.start_ + (channels() * pitch()), frames(), pitch(), true);
     }
 
     // reverse iterators
@@ -316,15 +365,44 @@ private:
 
     basic_noninterleaved(basic_noninterleaved&& other, const allocator_type& alloc, std::false_type);
 
+    // Number of samples in the buffer including any padding between channels
+    inline size_type storage_samples() const noexcept
+    {
+        return storage_samples(channels(), frames());
+    }
+
+    static size_type storage_samples(size_type channels, size_type frames) noexcept
+    {
+        return channels * channel_layout::template pitch<sample_type>(frames);
+    }
+
     void allocate()
     {
-        data_.start_ = alloc_traits::allocate(alloc_, samples());
+        data_.start_ = alloc_traits::allocate(alloc_, storage_samples());
+        data_.capacity_ = storage_samples();
         // we don't need to default construct the samples as sample types are trivially default constructable
     }
 
     void deallocate()
     {
-        alloc_traits::deallocate(alloc_, data_.start_, samples());
+        alloc_traits::deallocate(alloc_, data_.start_, capacity());
+    }
+
+    void reallocate(size_type new_capacity);
+
+    void relayout(size_type channels, size_type frames) noexcept;
+
+    // Zeroes the padding between the end of each channel and the start of the next
+    void zero_padding() noexcept
+    {
+        auto pitch = this->pitch();
+        if (pitch != frames())
+        {
+            for (size_type channel_num = 0; channel_num < channels(); ++channel_num)
+            {
+                std::fill_n(data() + (channel_num * pitch) + frames(), pitch - frames(), sample_type());
+            }
+        }
     }
 
     void copy_assign_alloc(const basic_noninterleaved& other)
@@ -367,54 +445,78 @@ private:
     void swap_alloc(basic_noninterleaved&, std::false_type) noexcept {}
 };
 
-template<typename SampleType, typename Allocator>
-basic_noninterleaved<SampleType, Allocator>::basic_noninterleaved(size_type channels, size_type frames) :
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>::basic_noninterleaved(size_type channels, size_type frames) :
     data_(channels, frames)
 {
     if (!empty())
     {
         allocate();
-        std::fill_n(data(), samples(), sample_type());
+        std::fill_n(data(), storage_samples(), sample_type());
     }
 }
 
-template<typename SampleType, typename Allocator>
-basic_noninterleaved<SampleType, Allocator>::basic_noninterleaved(
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>::basic_noninterleaved(
     size_type channels, size_type frames, const allocator_type& alloc) :
     alloc_(alloc), data_(channels, frames)
 {
     if (!empty())
     {
         allocate();
-        std::fill_n(data(), samples(), sample_type());
+        std::fill_n(data(), storage_samples(), sample_type());
+    }
+}
+
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>::basic_noninterleaved(
+    for_overwrite_t, size_type channels, size_type frames) :
+    data_(channels, frames)
+{
+    if (!empty())
+    {
+        allocate();
+        zero_padding();
+    }
+}
+
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>::basic_noninterleaved(
+    for_overwrite_t, size_type channels, size_type frames, const allocator_type& alloc) :
+    alloc_(alloc), data_(channels, frames)
+{
+    if (!empty())
+    {
+        allocate();
+        zero_padding();
     }
 }
 
-template<typename SampleType, typename Allocator>
-basic_noninterleaved<SampleType, Allocator>::basic_noninterleaved(const basic_noninterleaved& other) :
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>::basic_noninterleaved(const basic_noninterleaved& other) :
     alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)), data_(other.channels(), other.frames())
 {
     if (!empty())
     {
         allocate();
-        std::copy_n(other.data(), other.samples(), data());
+        std::copy_n(other.data(), other.storage_samples(), data());
     }
 }
 
-template<typename SampleType, typename Allocator>
-basic_noninterleaved<SampleType, Allocator>::basic_noninterleaved(
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>::basic_noninterleaved(
     const basic_noninterleaved& other, const allocator_type& alloc) :
     alloc_(alloc), data_(other.channels(), other.frames())
 {
     if (!empty())
     {
         allocate();
-        std::copy_n(other.data(), other.samples(), data());
+        std::copy_n(other.data(), other.storage_samples(), data());
     }
 }
 
-template<typename SampleType, typename Allocator>
-basic_noninterleaved<SampleType, Allocator>::basic_noninterleaved(
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>::basic_noninterleaved(
     basic_noninterleaved&& other, const allocator_type& alloc, std::false_type) :
     alloc_(alloc)
 {
@@ -424,14 +526,15 @@ basic_noninterleaved<SampleType, Allocator>::basic_noninterleaved(
     }
     else if (!other.empty())
     {
+        data_.copy(data_impl(other.channels(), other.frames()));
         allocate();
-        std::copy_n(other.data(), other.samples(), data());
+        std::copy_n(other.data(), other.storage_samples(), data());
     }
 }
 
-template<typename SampleType, typename Allocator>
-basic_noninterleaved<SampleType, Allocator>& basic_noninterleaved<SampleType, Allocator>::operator=(
-    const basic_noninterleaved& other)
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>& basic_noninterleaved<SampleType, Allocator, ChannelLayout>::
+operator=(const basic_noninterleaved& other)
 {
     if (this != &other)
     {
@@ -441,16 +544,17 @@ basic_noninterleaved<SampleType, Allocator>& basic_noninterleaved<SampleType, Al
     return *this;
 }
 
-template<typename SampleType, typename Allocator>
-basic_noninterleaved<SampleType, Allocator>& basic_noninterleaved<SampleType, Allocator>::operator=(
-    basic_noninterleaved&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value)
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+basic_noninterleaved<SampleType, Allocator, ChannelLayout>& basic_noninterleaved<SampleType, Allocator, ChannelLayout>::
+operator=(basic_noninterleaved&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value)
 {
     move_assign(other, typename alloc_traits::propagate_on_container_move_assignment());
     return *this;
 }
 
-template<typename SampleType, typename Allocator>
-void basic_noninterleaved<SampleType, Allocator>::move_assign(basic_noninterleaved& other, std::true_type) noexcept
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::move_assign(
+    basic_noninterleaved& other, std::true_type) noexcept
 {
     if (data() != nullptr)
     {
@@ -460,8 +564,9 @@ void basic_noninterleaved<SampleType, Allocator>::move_assign(basic_noninterleav
     data_.move(other.data_);
 }
 
-template<typename SampleType, typename Allocator>
-void basic_noninterleaved<SampleType, Allocator>::move_assign(basic_noninterleaved& other, std::false_type)
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::move_assign(
+    basic_noninterleaved& other, std::false_type)
 {
     if (alloc_ != other.alloc_)
     {
@@ -469,11 +574,11 @@ void basic_noninterleaved<SampleType, Allocator>::move_assign(basic_noninterleav
         {
             deallocate();
         }
-        data_.swap(other.data_);
-        if (samples() > 0)
+        data_.copy(data_impl(other.channels(), other.frames()));
+        if (storage_samples() > 0)
         {
             allocate();
-            std::copy_n(other.data(), other.samples(), data());
+            std::copy_n(other.data(), other.storage_samples(), data());
         }
     }
     else
@@ -482,16 +587,104 @@ void basic_noninterleaved<SampleType, Allocator>::move_assign(basic_noninterleav
     }
 }
 
-template<typename SampleType, typename Allocator>
-void basic_noninterleaved<SampleType, Allocator>::swap(basic_noninterleaved& other)
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::swap(basic_noninterleaved& other)
 {
     swap_alloc(other, typename alloc_traits::propagate_on_container_swap());
     data_.swap(other.data_);
 }
 
-template<typename SampleType, typename Allocator>
-inline typename basic_noninterleaved<SampleType, Allocator>::reference basic_noninterleaved<SampleType, Allocator>::at(
-    size_type n)
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::reserve(size_type new_capacity)
+{
+    if (new_capacity > capacity())
+    {
+        reallocate(new_capacity);
+    }
+}
+
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::resize(size_type channels, size_type frames)
+{
+    if (storage_samples(channels, frames) > capacity())
+    {
+        basic_noninterleaved other(for_overwrite, channels, frames, alloc_);
+        auto pitch = other.pitch();
+        auto copy_channels = std::min(channels, this->channels());
+        auto copy_frames = std::min(frames, this->frames());
+        for (size_type channel_num = 0; channel_num < copy_channels; ++channel_num)
+        {
+            auto output = other.data() + (channel_num * pitch);
+            std::copy_n(data() + (channel_num * this->pitch()), copy_frames, output);
+            std::fill_n(output + copy_frames, pitch - copy_frames, sample_type());
+        }
+        std::fill_n(other.data() + (copy_channels * pitch), (channels - copy_channels) * pitch, sample_type());
+        data_.swap(other.data_);
+    }
+    else
+    {
+        relayout(channels, frames);
+        data_.channels_ = channels;
+        data_.frames_ = frames;
+    }
+}
+
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::resize(
+    for_overwrite_t, size_type channels, size_type frames)
+{
+    if (storage_samples(channels, frames) > capacity())
+    {
+        basic_noninterleaved(for_overwrite, channels, frames, alloc_).data_.swap(data_);
+    }
+    else
+    {
+        data_.channels_ = channels;
+        data_.frames_ = frames;
+        zero_padding();
+    }
+}
+
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::shrink_to_fit()
+{
+    if (capacity() > storage_samples())
+    {
+        reallocate(storage_samples());
+    }
+}
+
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::reallocate(size_type new_capacity)
+{
+    auto new_start = (new_capacity > 0) ? alloc_traits::allocate(alloc_, new_capacity) : sample_pointer();
+    if (data() != nullptr)
+    {
+        std::copy_n(data(), storage_samples(), new_start);
+        deallocate();
+    }
+    data_.start_ = new_start;
+    data_.capacity_ = new_capacity;
+}
+
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+void basic_noninterleaved<SampleType, Allocator, ChannelLayout>::relayout(
+    size_type channels, size_type frames) noexcept
+{
+    detail::relayout(
+        data(),
+        pitch(),
+        channel_layout::template pitch<sample_type>(frames),
+        std::min(channels, this->channels()),
+        std::min(frames, this->frames()),
+        channels);
+}
+
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+inline typename basic_noninterleaved<SampleType, Allocator, ChannelLayout>::reference basic_noninterleaved<
+    SampleType,
+    Allocator,
+    ChannelLayout>::at(size_type n)
 {
     if (n >= channels())
     {
@@ -500,10 +693,11 @@ inline typename basic_noninterleaved<SampleType, Allocator>::reference basic_non
     return (*this)[n];
 }
 
-template<typename SampleType, typename Allocator>
-inline typename basic_noninterleaved<SampleType, Allocator>::const_reference basic_noninterleaved<
+template<typename SampleType, typename Allocator, typename ChannelLayout>
+inline typename basic_noninterleaved<SampleType, Allocator, ChannelLayout>::const_reference basic_noninterleaved<
     SampleType,
-    Allocator>::at(size_type n) const
+    Allocator,
+    ChannelLayout>::at(size_type n) const
 {
     if (n >= channels())
     {
@@ -512,19 +706,41 @@ inline typename basic_noninterleaved<SampleType, Allocator>::const_reference bas
     return (*this)[n];
 }
 
-template<typename SampleType, typename AllocatorA, typename AllocatorB>
+template<
+    typename SampleType,
+    typename AllocatorA,
+    typename ChannelLayoutA,
+    typename AllocatorB,
+    typename ChannelLayoutB>
 inline bool operator==(
-    const basic_noninterleaved<SampleType, AllocatorA>& a,
-    const basic_noninterleaved<SampleType, AllocatorB>& b) noexcept
+    const basic_noninterleaved<SampleType, AllocatorA, ChannelLayoutA>& a,
+    const basic_noninterleaved<SampleType, AllocatorB, ChannelLayoutB>& b) noexcept
 {
-    return (a.channels() == b.channels()) && (a.frames() == b.frames()) &&
-           std::equal(a.data(), a.data() + a.samples(), b.data());
+    if ((a.channels() != b.channels()) || (a.frames() != b.frames()))
+    {
+        return false;
+    }
+    // padding between channels is not compared
+    for (std::size_t channel_num = 0; channel_num < a.channels(); ++channel_num)
+    {
+        auto a_channel = a.data() + (channel_num * a.pitch());
+        if (!std::equal(a_channel, a_channel + a.frames(), b.data() + (channel_num * b.pitch())))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
-template<typename SampleType, typename AllocatorA, typename AllocatorB>
+template<
+    typename SampleType,
+    typename AllocatorA,
+    typename ChannelLayoutA,
+    typename AllocatorB,
+    typename ChannelLayoutB>
 inline bool operator!=(
-    const basic_noninterleaved<SampleType, AllocatorA>& a,
-    const basic_noninterleaved<SampleType, AllocatorB>& b) noexcept
+    const basic_noninterleaved<SampleType, AllocatorA, ChannelLayoutA>& a,
+    const basic_noninterleaved<SampleType, AllocatorB, ChannelLayoutB>& b) noexcept
 {
     return !(a == b);
 }
@@ -535,6 +751,33 @@ using noninterleaved = basic_noninterleaved<sample<SampleValueType>>;
 template<typename SampleValueType>
 using network_noninterleaved = basic_noninterleaved<network_sample<SampleValueType>>;
 
+template<typename SampleValueType>
+using aligned_noninterleaved =
+    basic_noninterleaved<sample<SampleValueType>, ratl::allocator<sample<SampleValueType>>, aligned_channel_layout<>>;
+
+template<typename SampleValueType>
+using network_aligned_noninterleaved = basic_noninterleaved<
+    network_sample<SampleValueType>,
+    ratl::allocator<network_sample<SampleValueType>>,
+    aligned_channel_layout<>>;
+
+#if defined(RATL_HAS_MEMORY_RESOURCE)
+
+namespace pmr
+{
+template<typename SampleValueType>
+using noninterleaved =
+    basic_noninterleaved<sample<SampleValueType>, std::pmr::polymorphic_allocator<sample<SampleValueType>>>;
+
+template<typename SampleValueType>
+using network_noninterleaved = basic_noninterleaved<
+    network_sample<SampleValueType>,
+    std::pmr::polymorphic_allocator<network_sample<SampleValueType>>>;
+
+} // namespace pmr
+
+#endif
+
 } // namespace ratl
 
 #endif // _ratl_noninterleaved_
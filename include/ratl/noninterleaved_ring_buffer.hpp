@@ -0,0 +1,229 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_noninterleaved_ring_buffer_
+#define _ratl_noninterleaved_ring_buffer_
+
+// ratl includes
+#include <ratl/allocator.hpp>
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/ring_buffer_index.hpp>
+#include <ratl/detail/ring_buffer_transform.hpp>
+#include <ratl/detail/sample_traits.hpp>
+#include <ratl/noninterleaved.hpp>
+#include <ratl/noninterleaved_span.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/ring_buffer_region.hpp>
+#include <ratl/sample.hpp>
+
+// other includes
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+namespace ratl
+{
+// Lock-free single-producer single-consumer ring buffer of noninterleaved channels
+// Each channel occupies capacity() samples, so the spans in each region have a pitch of capacity() rather than
+// frames().
+// The producer thread may only call write_available, write_region and commit_write, the consumer thread may only call
+// read_available, read_region and commit_read. None of these allocate or block.
+template<typename SampleType, typename Allocator = ratl::allocator<SampleType>>
+class basic_noninterleaved_ring_buffer
+{
+public:
+    using allocator_type = Allocator;
+
+private:
+    using buffer_type = basic_noninterleaved<SampleType, Allocator>;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+    using sample_traits = detail::sample_traits_from_alloc_traits_t<alloc_traits>;
+    using const_sample_traits = detail::const_sample_traits_t<sample_traits>;
+
+public:
+    using sample_type = typename sample_traits::sample_type;
+    using const_sample_type = typename sample_traits::const_sample_type;
+
+    using span_type = basic_noninterleaved_span<sample_type, sample_traits>;
+    using const_span_type = basic_noninterleaved_span<const_sample_type, const_sample_traits>;
+    using region_type = ring_buffer_region<span_type>;
+    using const_region_type = ring_buffer_region<const_span_type>;
+
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    buffer_type buffer_;
+    detail::ring_buffer_index index_;
+
+public:
+    basic_noninterleaved_ring_buffer(size_type channels, size_type capacity) :
+        buffer_(channels, capacity), index_(capacity)
+    {
+    }
+
+    basic_noninterleaved_ring_buffer(size_type channels, size_type capacity, const allocator_type& alloc) :
+        buffer_(channels, capacity, alloc), index_(capacity)
+    {
+    }
+
+    basic_noninterleaved_ring_buffer(const basic_noninterleaved_ring_buffer&) = delete;
+    basic_noninterleaved_ring_buffer& operator=(const basic_noninterleaved_ring_buffer&) = delete;
+
+    allocator_type get_allocator() const noexcept
+    {
+        return buffer_.get_allocator();
+    }
+
+    inline size_type channels() const noexcept
+    {
+        return buffer_.channels();
+    }
+
+    inline size_type capacity() const noexcept
+    {
+        return index_.capacity();
+    }
+
+    // producer
+
+    inline size_type write_available() noexcept
+    {
+        return index_.write_available();
+    }
+
+    inline region_type write_region() noexcept
+    {
+        return make_region<span_type>(index_.write_position(), index_.write_available());
+    }
+
+    inline region_type write_region(size_type frames) noexcept
+    {
+        return make_region<span_type>(index_.write_position(), index_.write_available(frames));
+    }
+
+    inline void commit_write(size_type frames) noexcept
+    {
+        index_.commit_write(frames);
+    }
+
+    // consumer
+
+    inline size_type read_available() noexcept
+    {
+        return index_.read_available();
+    }
+
+    inline const_region_type read_region() noexcept
+    {
+        return make_region<const_span_type>(index_.read_position(), index_.read_available());
+    }
+
+    inline const_region_type read_region(size_type frames) noexcept
+    {
+        return make_region<const_span_type>(index_.read_position(), index_.read_available(frames));
+    }
+
+    inline void commit_read(size_type frames) noexcept
+    {
+        index_.commit_read(frames);
+    }
+
+    // Not thread safe, must only be called while neither the producer nor consumer is active
+    inline void reset() noexcept
+    {
+        index_.reset();
+    }
+
+private:
+    template<typename SpanType>
+    inline ring_buffer_region<SpanType> make_region(size_type position, size_type frames) noexcept
+    {
+        if (frames == 0)
+        {
+            return ring_buffer_region<SpanType>();
+        }
+        auto first_frames = std::min(frames, capacity() - position);
+        return ring_buffer_region<SpanType>(
+            SpanType(buffer_.data() + position, channels(), first_frames, capacity()),
+            SpanType(buffer_.data(), channels(), frames - first_frames, capacity()));
+    }
+};
+
+template<typename SampleValueType>
+using noninterleaved_ring_buffer = basic_noninterleaved_ring_buffer<sample<SampleValueType>>;
+
+template<typename SampleValueType>
+using network_noninterleaved_ring_buffer = basic_noninterleaved_ring_buffer<network_sample<SampleValueType>>;
+
+// transform into and out of basic_noninterleaved_ring_buffer
+// Both directions transfer as many frames as are available in the ring buffer, up to the number of frames in the
+// given range, and return the number of frames transferred. No intermediate buffer is used.
+
+template<typename InputIterator, typename SampleType, typename Allocator, typename... Args>
+inline std::size_t transform(
+    InputIterator first,
+    InputIterator last,
+    basic_noninterleaved_ring_buffer<SampleType, Allocator>& ring,
+    Args&&... args)
+{
+    return detail::ring_buffer_write<detail::default_transformer>(first, last, ring, args...);
+}
+
+template<typename SampleType, typename Allocator, typename OutputIterator, typename... Args>
+inline std::size_t transform(
+    basic_noninterleaved_ring_buffer<SampleType, Allocator>& ring,
+    OutputIterator first,
+    OutputIterator last,
+    Args&&... args)
+{
+    return detail::ring_buffer_read<detail::default_transformer>(ring, first, last, args...);
+}
+
+template<typename InputIterator, typename SampleType, typename Allocator, typename... Args>
+inline std::size_t reference_transform(
+    InputIterator first,
+    InputIterator last,
+    basic_noninterleaved_ring_buffer<SampleType, Allocator>& ring,
+    Args&&... args)
+{
+    return detail::ring_buffer_write<detail::reference_transformer>(first, last, ring, args...);
+}
+
+template<typename SampleType, typename Allocator, typename OutputIterator, typename... Args>
+inline std::size_t reference_transform(
+    basic_noninterleaved_ring_buffer<SampleType, Allocator>& ring,
+    OutputIterator first,
+    OutputIterator last,
+    Args&&... args)
+{
+    return detail::ring_buffer_read<detail::reference_transformer>(ring, first, last, args...);
+}
+
+template<typename InputIterator, typename SampleType, typename Allocator, typename... Args>
+inline std::size_t fast_transform(
+    InputIterator first,
+    InputIterator last,
+    basic_noninterleaved_ring_buffer<SampleType, Allocator>& ring,
+    Args&&... args)
+{
+    return detail::ring_buffer_write<detail::fast_transformer>(first, last, ring, args...);
+}
+
+template<typename SampleType, typename Allocator, typename OutputIterator, typename... Args>
+inline std::size_t fast_transform(
+    basic_noninterleaved_ring_buffer<SampleType, Allocator>& ring,
+    OutputIterator first,
+    OutputIterator last,
+    Args&&... args)
+{
+    return detail::ring_buffer_read<detail::fast_transformer>(ring, first, last, args...);
+}
+
+} // namespace ratl
+
+#endif // _ratl_noninterleaved_ring_buffer_
@@ -67,42 +67,61 @@ private:
     sample_pointer start_;
     size_type channels_;
     size_type frames_;
+    size_type pitch_;
 
 public:
-    basic_noninterleaved_span() noexcept : start_(), channels_(), frames_() {}
+    basic_noninterleaved_span() noexcept : start_(), channels_(), frames_(), pitch_() {}
 
     basic_noninterleaved_span(sample_pointer data, size_type channels, size_type frames) noexcept :
-        start_(data), channels_(channels), frames_(frames)
+        start_(data), channels_(channels), frames_(frames), pitch_(frames)
     {
     }
 
     basic_noninterleaved_span(char_pointer data, size_type channels, size_type frames) noexcept :
-        start_(reinterpret_cast<sample_pointer>(data)), channels_(channels), frames_(frames)
+        start_(reinterpret_cast<sample_pointer>(data)), channels_(channels), frames_(frames), pitch_(frames)
+    {
+    }
+
+    basic_noninterleaved_span(sample_pointer data, size_type channels, size_type frames, size_type pitch) noexcept :
+        start_(data), channels_(channels), frames_(frames), pitch_(pitch)
+    {
+    }
+
+    basic_noninterleaved_span(char_pointer data, size_type channels, size_type frames, size_type pitch) noexcept :
+        start_(reinterpret_cast<sample_pointer>(data)), channels_(channels), frames_(frames), pitch_(pitch)
     {
     }
 
     basic_noninterleaved_span(const basic_noninterleaved_span& other) noexcept :
-        start_(other.data()), channels_(other.channels()), frames_(other.frames())
+        start_(other.data()), channels_(other.channels()), frames_(other.frames()), pitch_(other.pitch())
     {
     }
 
     template<
         typename Sample,
         typename Allocator,
+        typename ChannelLayout,
         std::enable_if_t<std::is_same<Sample, std::remove_const_t<sample_type>>::value, bool> = true>
-    basic_noninterleaved_span(basic_interleaved<Sample, Allocator>& noninterleaved) noexcept :
-        start_(noninterleaved.data()), channels_(noninterleaved.channels()), frames_(noninterleaved.frames())
+    basic_noninterleaved_span(basic_noninterleaved<Sample, Allocator, ChannelLayout>& noninterleaved) noexcept :
+        start_(noninterleaved.data()),
+        channels_(noninterleaved.channels()),
+        frames_(noninterleaved.frames()),
+        pitch_(noninterleaved.pitch())
     {
     }
 
     template<
         typename Sample,
         typename Allocator,
+        typename ChannelLayout,
         std::enable_if_t<
             std::is_same<typename detail::sample_traits<Sample>::const_sample_type, sample_type>::value,
             bool> = true>
-    basic_noninterleaved_span(const basic_interleaved<Sample, Allocator>& noninterleaved) noexcept :
-        start_(noninterleaved.data()), channels_(noninterleaved.channels()), frames_(noninterleaved.frames())
+    basic_noninterleaved_span(const basic_noninterleaved<Sample, Allocator, ChannelLayout>& noninterleaved) noexcept :
+        start_(noninterleaved.data()),
+        channels_(noninterleaved.channels()),
+        frames_(noninterleaved.frames()),
+        pitch_(noninterleaved.pitch())
     {
     }
 
@@ -125,6 +144,11 @@ public:
         return frames_;
     }
 
+    inline size_type pitch() const noexcept
+    {
+        return pitch_;
+    }
+
     inline size_type samples() const noexcept
     {
         return channels() * frames();
@@ -137,22 +161,22 @@ public:
 
     inline frame_type frame(size_type n)
     {
-        return frame_type(start_ + n, channels(), frames());
+        return frame_type(start_ + n, channels(), pitch());
     }
 
     inline const_frame_type frame(size_type n) const
     {
-        return const_frame_type(start_ + n, channels(), frames());
+        return const_frame_type(start_ + n, channels(), pitch());
     }
 
     inline channel_type channel(size_type n)
     {
-        return channel_type(start_ + (n * frames()), frames());
+        return channel_type(start_ + (n * pitch()), frames());
     }
 
     inline const_channel_type channel(size_type n) const
     {
-        return const_channel_type(start_ + (n * frames()), frames());
+        return const_channel_type(start_ + (n * pitch()), frames());
     }
 
     inline reference operator[](size_type n) noexcept
@@ -181,33 +205,33 @@ public:
 
     inline reference back() noexcept
     {
-        return reference(start_ + ((channels() - 1) * frames()), frames());
+        return reference(start_ + ((channels() - 1) * pitch()), frames());
     }
 
     inline const_reference back() const noexcept
     {
-        return reference(start_ + ((channels() - 1) * frames()), frames());
+        return const_reference(start_ + ((channels() - 1) * pitch()), frames());
     }
 
     // iterators
     inline iterator begin() noexcept
     {
-        return iterator(start_, frames());
+        return iterator(start_, frames(), pitch());
     }
 
     inline const_iterator begin() const noexcept
     {
-        return const_iterator(start_, frames());
+        return const_iterator(start_, frames(), pitch());
     }
 
     inline iterator end() noexcept
     {
-        return iterator(start_ + (channels() * frames()), frames());
+        return iterator(start_ + (channels() * pitch()), frames(), pitch());
     }
 
     inline const_iterator end() const noexcept
     {
-        return const_iterator(start_ + (channels() * frames()), frames());
+        return const_iterator(start_ + (channels() * pitch()), frames(), pitch());
     }
 
     // reverse iterators
@@ -259,6 +283,7 @@ inline void basic_noninterleaved_span<SampleType, SampleTraits>::swap(basic_noni
     std::swap(start_, other.start_);
     std::swap(channels_, other.channels_);
     std::swap(frames_, other.frames_);
+    std::swap(pitch_, other.pitch_);
 }
 
 template<typename SampleType, typename SampleTraits>
@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_planar_span_
+#define _ratl_planar_span_
+
+// ratl includes
+#include <ratl/channel_span.hpp>
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/operator_arrow_proxy.hpp>
+#include <ratl/detail/planar_iterator.hpp>
+#include <ratl/detail/sample_traits.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/sample.hpp>
+
+// other includes
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ratl
+{
+// Non-owning view of a non-interleaved buffer whose channels are held in independent allocations and referred to by
+// an array of channel pointers, as handed out by plugin and audio server APIs (e.g. VST3, CLAP, LV2 and JACK)
+// Neither the array of channel pointers nor the channels themselves are copied, so both must outlive the span.
+template<typename SampleType, typename SampleTraits>
+class basic_planar_span
+{
+    static_assert(
+        std::is_same<typename SampleTraits::sample_type, SampleType>::value,
+        "sample_type in SampleTraits must be the same type as SampleType");
+
+    using sample_traits = SampleTraits;
+    using const_sample_traits = detail::const_sample_traits_t<sample_traits>;
+
+public:
+    using sample_type = typename sample_traits::sample_type;
+    using const_sample_type = typename sample_traits::const_sample_type;
+    using sample_pointer = typename sample_traits::pointer;
+    using const_sample_pointer = typename sample_traits::const_pointer;
+
+    using channel_type = basic_channel_span<sample_type, sample_traits, std::true_type>;
+    using const_channel_type = basic_channel_span<const_sample_type, const_sample_traits, std::true_type>;
+
+    using channel_pointer = const sample_pointer*;
+    using value_pointer = std::conditional_t<
+        std::is_const<sample_type>::value,
+        const typename std::remove_const_t<sample_type>::value_type*,
+        typename sample_type::value_type*>;
+
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using value_type = channel_type;
+    using pointer = detail::operator_arrow_proxy<channel_type>;
+    using const_pointer = const detail::operator_arrow_proxy<channel_type>;
+    using reference = channel_type;
+    using const_reference = const_channel_type;
+
+    using iterator = detail::planar_iterator<sample_type, sample_traits>;
+    using const_iterator = detail::planar_iterator<const_sample_type, const_sample_traits>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    channel_pointer channels_data_;
+    size_type channels_;
+    size_type frames_;
+
+public:
+    basic_planar_span() noexcept : channels_data_(), channels_(), frames_() {}
+
+    basic_planar_span(channel_pointer data, size_type channels, size_type frames) noexcept :
+        channels_data_(data), channels_(channels), frames_(frames)
+    {
+    }
+
+    // Views an array of pointers to the underlying sample values (e.g. float** for 32 bit floating point samples)
+    basic_planar_span(const value_pointer* data, size_type channels, size_type frames) noexcept :
+        channels_data_(reinterpret_cast<channel_pointer>(data)), channels_(channels), frames_(frames)
+    {
+    }
+
+    basic_planar_span(const basic_planar_span& other) noexcept = default;
+
+    template<
+        typename ArgSampleType,
+        typename ArgSampleTraits,
+        std::enable_if_t<std::is_same<detail::const_sample_traits_t<ArgSampleTraits>, sample_traits>::value, bool> =
+            true>
+    basic_planar_span(const basic_planar_span<ArgSampleType, ArgSampleTraits>& other) noexcept :
+        channels_data_(other.data()), channels_(other.channels()), frames_(other.frames())
+    {
+    }
+
+    basic_planar_span& operator=(const basic_planar_span& other) noexcept = default;
+
+    inline void swap(basic_planar_span& other) noexcept;
+
+    inline channel_pointer data() const noexcept
+    {
+        return channels_data_;
+    }
+
+    inline size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    inline size_type frames() const noexcept
+    {
+        return frames_;
+    }
+
+    inline size_type samples() const noexcept
+    {
+        return channels() * frames();
+    }
+
+    inline bool empty() const noexcept
+    {
+        return (channels() == 0) || (frames() == 0);
+    }
+
+    inline channel_type channel(size_type n)
+    {
+        return channel_type(channels_data_[n], frames());
+    }
+
+    inline const_channel_type channel(size_type n) const
+    {
+        return const_channel_type(channels_data_[n], frames());
+    }
+
+    inline reference operator[](size_type n) noexcept
+    {
+        return channel(n);
+    }
+
+    inline const_reference operator[](size_type n) const noexcept
+    {
+        return channel(n);
+    }
+
+    inline reference at(size_type n);
+
+    inline const_reference at(size_type n) const;
+
+    inline reference front() noexcept
+    {
+        return channel(0);
+    }
+
+    inline const_reference front() const noexcept
+    {
+        return channel(0);
+    }
+
+    inline reference back() noexcept
+    {
+        return channel(channels() - 1);
+    }
+
+    inline const_reference back() const noexcept
+    {
+        return channel(channels() - 1);
+    }
+
+    // iterators
+    inline iterator begin() noexcept
+    {
+        return iterator(channels_data_, frames());
+    }
+
+    inline const_iterator begin() const noexcept
+    {
+        return const_iterator(channels_data_, frames());
+    }
+
+    inline iterator end() noexcept
+    {
+        return iterator(channels_data_ + channels(), frames());
+    }
+
+    inline const_iterator end() const noexcept
+    {
+        return const_iterator(channels_data_ + channels(), frames());
+    }
+
+    // reverse iterators
+    inline reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    inline const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    inline reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    inline const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    // const iterators
+    inline const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    inline const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    inline const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+
+    inline const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+};
+
+template<typename SampleType, typename SampleTraits>
+inline void basic_planar_span<SampleType, SampleTraits>::swap(basic_planar_span& other) noexcept
+{
+    std::swap(channels_data_, other.channels_data_);
+    std::swap(channels_, other.channels_);
+    std::swap(frames_, other.frames_);
+}
+
+template<typename SampleType, typename SampleTraits>
+inline typename basic_planar_span<SampleType, SampleTraits>::reference basic_planar_span<SampleType, SampleTraits>::at(
+    size_type n)
+{
+    if (n >= channels())
+    {
+        throw std::out_of_range("planar");
+    }
+    return (*this)[n];
+}
+
+template<typename SampleType, typename SampleTraits>
+inline typename basic_planar_span<SampleType, SampleTraits>::const_reference basic_planar_span<
+    SampleType,
+    SampleTraits>::at(size_type n) const
+{
+    if (n >= channels())
+    {
+        throw std::out_of_range("planar");
+    }
+    return (*this)[n];
+}
+
+template<typename SampleValueType>
+using planar_span = basic_planar_span<sample<SampleValueType>, detail::sample_traits<sample<SampleValueType>>>;
+
+template<typename SampleValueType>
+using const_planar_span = basic_planar_span<
+    typename detail::sample_traits<sample<SampleValueType>>::const_sample_type,
+    detail::const_sample_traits_t<detail::sample_traits<sample<SampleValueType>>>>;
+
+template<typename SampleValueType>
+using network_planar_span =
+    basic_planar_span<network_sample<SampleValueType>, detail::sample_traits<network_sample<SampleValueType>>>;
+
+template<typename SampleValueType>
+using const_network_planar_span = basic_planar_span<
+    typename detail::sample_traits<network_sample<SampleValueType>>::const_sample_type,
+    detail::const_sample_traits_t<detail::sample_traits<network_sample<SampleValueType>>>>;
+
+} // namespace ratl
+
+#endif // _ratl_planar_span_
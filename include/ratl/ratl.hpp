@@ -8,21 +8,41 @@
 #ifndef _ratl_
 #define _ratl_
 
+#include <ratl/aiff_file.hpp>
 #include <ratl/allocator.hpp>
+#include <ratl/arena.hpp>
+#include <ratl/caf_file.hpp>
 #include <ratl/channel.hpp>
+#include <ratl/channel_layout.hpp>
 #include <ratl/channel_span.hpp>
 #include <ratl/convert.hpp>
 #include <ratl/detail/config.hpp>
 #include <ratl/dither_generator.hpp>
+#include <ratl/extent.hpp>
+#include <ratl/for_overwrite.hpp>
 #include <ratl/frame.hpp>
 #include <ratl/frame_span.hpp>
+#include <ratl/huge_page_allocator.hpp>
 #include <ratl/interleaved.hpp>
+#include <ratl/interleaved_ring_buffer.hpp>
 #include <ratl/interleaved_span.hpp>
+#include <ratl/jitter_buffer.hpp>
 #include <ratl/network_sample.hpp>
 #include <ratl/noninterleaved.hpp>
+#include <ratl/noninterleaved_ring_buffer.hpp>
 #include <ratl/noninterleaved_span.hpp>
+#include <ratl/planar_span.hpp>
+#include <ratl/ring_buffer_region.hpp>
+#include <ratl/rtp.hpp>
 #include <ratl/sample.hpp>
+#include <ratl/shm_ring.hpp>
+#include <ratl/static_interleaved.hpp>
+#include <ratl/static_noninterleaved.hpp>
+#include <ratl/stream_converter.hpp>
 #include <ratl/transform.hpp>
+#include <ratl/transform_inplace.hpp>
 #include <ratl/types.hpp>
+#include <ratl/wav_file.hpp>
+#include <ratl/wav_writer.hpp>
 
 #endif // _ratl_
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_ring_buffer_region_
+#define _ratl_ring_buffer_region_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+
+// other includes
+#include <cstddef>
+
+namespace ratl
+{
+// A contiguous run of frames in a ring buffer, split into at most two spans at the point where the ring buffer wraps
+// The first span always starts at the current read or write position, the second span (if not empty) always starts
+// at the beginning of the ring buffer's storage.
+template<typename SpanType>
+class ring_buffer_region
+{
+public:
+    using span_type = SpanType;
+    using size_type = std::size_t;
+
+private:
+    span_type first_;
+    span_type second_;
+
+public:
+    ring_buffer_region() noexcept = default;
+
+    ring_buffer_region(const span_type& first, const span_type& second) noexcept : first_(first), second_(second) {}
+
+    inline const span_type& first() const noexcept
+    {
+        return first_;
+    }
+
+    inline const span_type& second() const noexcept
+    {
+        return second_;
+    }
+
+    inline size_type frames() const noexcept
+    {
+        return first_.frames() + second_.frames();
+    }
+
+    inline bool empty() const noexcept
+    {
+        return frames() == 0;
+    }
+
+    inline bool wraps() const noexcept
+    {
+        return second_.frames() != 0;
+    }
+};
+
+} // namespace ratl
+
+#endif // _ratl_ring_buffer_region_
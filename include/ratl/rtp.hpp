@@ -0,0 +1,321 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_rtp_
+#define _ratl_rtp_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/dither_generator.hpp>
+#include <ratl/interleaved.hpp>
+#include <ratl/interleaved_span.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/noninterleaved.hpp>
+#include <ratl/noninterleaved_span.hpp>
+#include <ratl/transform.hpp>
+#include <ratl/types.hpp>
+
+// other includes
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ratl
+{
+// Size of an RTP header without CSRCs or extensions, as written by rtp_packetiser
+static constexpr std::size_t rtp_header_size = 12;
+
+// The fields of an RTP header that describe the stream and the packet's place in it
+struct rtp_header
+{
+    std::uint8_t payload_type = 0;
+    bool marker = false;
+    std::uint16_t sequence_number = 0;
+    std::uint32_t timestamp = 0;
+    std::uint32_t ssrc = 0;
+};
+
+// Number of frames in each packet of a stream with the given sample rate and packet time, e.g. 48 frames for the
+// AES67 default of 1ms at 48kHz and 6 frames for its 125us low latency packet time
+inline std::size_t rtp_packet_frames(std::size_t sample_rate, std::chrono::nanoseconds packet_time) noexcept
+{
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(sample_rate) * packet_time.count()) / 1000000000);
+}
+
+namespace detail
+{
+template<typename SampleValueType>
+struct is_rtp_sample_value_type : std::integral_constant<bool,
+                                                         std::is_same<SampleValueType, int16_t>::value ||
+                                                             std::is_same<SampleValueType, int24_t>::value>
+{
+};
+
+inline void write_rtp_header(unsigned char* packet, const rtp_header& header) noexcept
+{
+    // version 2, no padding, extension or CSRCs
+    packet[0] = 0x80;
+    packet[1] = static_cast<unsigned char>((header.marker ? 0x80 : 0x00) | (header.payload_type & 0x7f));
+    packet[2] = static_cast<unsigned char>(header.sequence_number >> 8);
+    packet[3] = static_cast<unsigned char>(header.sequence_number & 0xff);
+    for (std::size_t byte_num = 0; byte_num < 4; ++byte_num)
+    {
+        packet[4 + byte_num] = static_cast<unsigned char>((header.timestamp >> ((3 - byte_num) * 8)) & 0xff);
+        packet[8 + byte_num] = static_cast<unsigned char>((header.ssrc >> ((3 - byte_num) * 8)) & 0xff);
+    }
+}
+
+inline std::uint32_t read_rtp_uint32(const unsigned char* data) noexcept
+{
+    return (static_cast<std::uint32_t>(data[0]) << 24) | (static_cast<std::uint32_t>(data[1]) << 16) |
+           (static_cast<std::uint32_t>(data[2]) << 8) | static_cast<std::uint32_t>(data[3]);
+}
+
+} // namespace detail
+
+// rtp_packetiser
+// Writes RTP packets of L16 (SampleValueType int16_t) or L24 (int24_t) audio, as used by AES67. The payload of an L16
+// or L24 packet is exactly a network_interleaved_span, so write_packet converts (and dithers) the input buffer
+// straight into the caller's preallocated packet, with the byte swap fused into the conversion.
+// Each packet holds frames_per_packet() frames, and the sequence number and timestamp advance with each packet.
+// write_packet doesn't allocate, lock or make a system call, so it can be called from an audio thread.
+
+template<typename SampleValueType>
+class rtp_packetiser
+{
+    static_assert(
+        detail::is_rtp_sample_value_type<SampleValueType>::value,
+        "RTP L16 and L24 payloads hold int16_t or int24_t samples");
+
+public:
+    using size_type = std::size_t;
+    using sample_type = network_sample<SampleValueType>;
+
+private:
+    size_type channels_;
+    size_type frames_per_packet_;
+    rtp_header header_;
+    dither_generator dither_gen_;
+
+public:
+    rtp_packetiser(
+        size_type channels,
+        size_type frames_per_packet,
+        std::uint8_t payload_type,
+        std::uint32_t ssrc,
+        std::uint16_t sequence_number = 0,
+        std::uint32_t timestamp = 0) :
+        channels_(channels), frames_per_packet_(frames_per_packet)
+    {
+        if (channels == 0 || frames_per_packet == 0)
+        {
+            throw std::invalid_argument("rtp_packetiser: packets must hold at least one channel and frame");
+        }
+        header_.payload_type = payload_type;
+        header_.sequence_number = sequence_number;
+        header_.timestamp = timestamp;
+        header_.ssrc = ssrc;
+    }
+
+    size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    size_type frames_per_packet() const noexcept
+    {
+        return frames_per_packet_;
+    }
+
+    // Size of each packet written by write_packet
+    size_type packet_bytes() const noexcept
+    {
+        return rtp_header_size + (channels_ * frames_per_packet_ * sizeof(sample_type));
+    }
+
+    // The header of the next packet to be written
+    const rtp_header& next_header() const noexcept
+    {
+        return header_;
+    }
+
+    // Writes the next packet to packet, which must hold packet_bytes() bytes and be aligned for sample_type, and
+    // returns its size. The input must hold frames_per_packet() frames of channels() channels. marker flags the first
+    // packet after a discontinuity.
+    template<typename SampleType, typename SampleTraits, std::size_t Extent>
+    size_type write_packet(
+        const basic_interleaved_span<SampleType, SampleTraits, Extent>& input,
+        unsigned char* packet,
+        bool marker = false)
+    {
+        check_input(input.channels(), input.frames());
+        write_header(packet, marker);
+        transform(input.begin(), input.end(), payload(packet).begin(), dither_gen_);
+        return packet_bytes();
+    }
+
+    template<typename SampleType, typename SampleTraits>
+    size_type write_packet(
+        const basic_noninterleaved_span<SampleType, SampleTraits>& input, unsigned char* packet, bool marker = false)
+    {
+        check_input(input.channels(), input.frames());
+        write_header(packet, marker);
+        transform(input.begin(), input.end(), payload(packet).begin(), dither_gen_);
+        return packet_bytes();
+    }
+
+    template<typename Sample, typename Allocator>
+    size_type write_packet(
+        const basic_interleaved<Sample, Allocator>& input, unsigned char* packet, bool marker = false)
+    {
+        using sample_traits = detail::const_sample_traits_t<detail::sample_traits<Sample>>;
+        return write_packet(
+            basic_interleaved_span<typename sample_traits::sample_type, sample_traits>(input), packet, marker);
+    }
+
+    template<typename Sample, typename Allocator, typename ChannelLayout>
+    size_type write_packet(
+        const basic_noninterleaved<Sample, Allocator, ChannelLayout>& input, unsigned char* packet, bool marker = false)
+    {
+        using sample_traits = detail::const_sample_traits_t<detail::sample_traits<Sample>>;
+        return write_packet(
+            basic_noninterleaved_span<typename sample_traits::sample_type, sample_traits>(input), packet, marker);
+    }
+
+private:
+    void check_input(size_type channels, size_type frames) const
+    {
+        if (channels != channels_ || frames != frames_per_packet_)
+        {
+            throw std::invalid_argument("rtp_packetiser: input doesn't match the packet's channels and frames");
+        }
+    }
+
+    void write_header(unsigned char* packet, bool marker) noexcept
+    {
+        header_.marker = marker;
+        detail::write_rtp_header(packet, header_);
+        ++header_.sequence_number;
+        header_.timestamp += static_cast<std::uint32_t>(frames_per_packet_);
+    }
+
+    network_interleaved_span<SampleValueType> payload(unsigned char* packet) const noexcept
+    {
+        return network_interleaved_span<SampleValueType>(packet + rtp_header_size, channels_, frames_per_packet_);
+    }
+};
+
+// A received RTP packet, with its payload viewed in place in the packet
+template<typename SampleValueType>
+struct rtp_packet
+{
+    rtp_header header;
+    const_network_interleaved_span<SampleValueType> payload;
+};
+
+// rtp_depacketiser
+// Parses received RTP packets of L16 or L24 audio, viewing their payloads as const_network_interleaved_spans without
+// copying them, ready to be converted by transform. CSRCs, header extensions and padding are skipped.
+// read_packet returns false rather than throwing for packets that don't belong to the stream, as they are expected on
+// a network.
+
+template<typename SampleValueType>
+class rtp_depacketiser
+{
+    static_assert(
+        detail::is_rtp_sample_value_type<SampleValueType>::value,
+        "RTP L16 and L24 payloads hold int16_t or int24_t samples");
+
+public:
+    using size_type = std::size_t;
+    using sample_type = network_sample<SampleValueType>;
+
+private:
+    size_type channels_;
+    std::uint8_t payload_type_;
+
+public:
+    rtp_depacketiser(size_type channels, std::uint8_t payload_type) : channels_(channels), payload_type_(payload_type)
+    {
+        if (channels == 0)
+        {
+            throw std::invalid_argument("rtp_depacketiser: packets must hold at least one channel");
+        }
+    }
+
+    size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    // Parses the size bytes of data into packet, returning false if they aren't a valid RTP packet of the stream's
+    // payload type, or if the payload isn't a whole number of aligned frames
+    bool read_packet(const void* data, size_type size, rtp_packet<SampleValueType>& packet) const noexcept
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        if (size < rtp_header_size || (bytes[0] >> 6) != 2 || (bytes[1] & 0x7f) != payload_type_)
+        {
+            return false;
+        }
+
+        // the CSRCs, extension header and padding all have their lengths in the packet, so each is checked against
+        // the packet's size before it is skipped
+        auto payload_offset = rtp_header_size + ((bytes[0] & 0x0f) * 4);
+        if (payload_offset > size)
+        {
+            return false;
+        }
+        if ((bytes[0] & 0x10) != 0)
+        {
+            // the extension header holds its length in 32 bit words
+            if (size - payload_offset < 4)
+            {
+                return false;
+            }
+            auto extension_words = (static_cast<size_type>(bytes[payload_offset + 2]) << 8) | bytes[payload_offset + 3];
+            if (size - payload_offset - 4 < extension_words * 4)
+            {
+                return false;
+            }
+            payload_offset += 4 + (extension_words * 4);
+        }
+        auto payload_end = size;
+        if ((bytes[0] & 0x20) != 0)
+        {
+            // the last byte of the padding holds its length, which counts itself so can't be 0
+            size_type padding = bytes[size - 1];
+            if (padding == 0 || padding > size - payload_offset)
+            {
+                return false;
+            }
+            payload_end -= padding;
+        }
+
+        auto frame_bytes = channels_ * sizeof(sample_type);
+        auto payload_bytes = payload_end - payload_offset;
+        if (payload_bytes % frame_bytes != 0 ||
+            reinterpret_cast<std::uintptr_t>(bytes + payload_offset) % alignof(sample_type) != 0)
+        {
+            return false;
+        }
+
+        packet.header.marker = (bytes[1] & 0x80) != 0;
+        packet.header.payload_type = static_cast<std::uint8_t>(bytes[1] & 0x7f);
+        packet.header.sequence_number = static_cast<std::uint16_t>((bytes[2] << 8) | bytes[3]);
+        packet.header.timestamp = detail::read_rtp_uint32(bytes + 4);
+        packet.header.ssrc = detail::read_rtp_uint32(bytes + 8);
+        packet.payload = const_network_interleaved_span<SampleValueType>(
+            bytes + payload_offset, channels_, payload_bytes / frame_bytes);
+        return true;
+    }
+};
+
+} // namespace ratl
+
+#endif // _ratl_rtp_
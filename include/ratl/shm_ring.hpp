@@ -0,0 +1,533 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_shm_ring_
+#define _ratl_shm_ring_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/ring_buffer_transform.hpp>
+#include <ratl/detail/sample_traits.hpp>
+#include <ratl/detail/shared_memory.hpp>
+#include <ratl/interleaved_span.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/ring_buffer_region.hpp>
+#include <ratl/sample.hpp>
+
+// other includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+
+namespace ratl
+{
+namespace detail
+{
+// "ratl" read as a little endian word
+static constexpr std::uint32_t shm_ring_magic = 0x6c746172;
+static constexpr std::uint32_t shm_ring_version = 1;
+
+static constexpr std::uint32_t shm_ring_reader_free = 0;
+static constexpr std::uint32_t shm_ring_reader_claiming = 1;
+static constexpr std::uint32_t shm_ring_reader_active = 2;
+
+// Describes the samples held by a ring, so that a reader built for a different format is refused
+template<typename SampleType>
+constexpr std::uint32_t shm_ring_sample_format() noexcept
+{
+    using sample_value_type = typename SampleType::sample_value_type;
+    return static_cast<std::uint32_t>(sizeof(SampleType) * 8) |
+           (std::is_floating_point<sample_value_type>::value ? 0x100u : 0u) |
+           (std::is_same<SampleType, network_sample<sample_value_type>>::value ? 0x200u : 0u);
+}
+
+// Each reader's progress, on its own cache line
+struct alignas(RATL_CACHE_LINE_SIZE) shm_ring_reader_slot
+{
+    std::atomic<std::uint32_t> state;
+    std::atomic<std::int32_t> pid;
+    std::atomic<std::uint64_t> read_index;
+};
+
+// Start of the shared memory object, followed by max_readers reader slots and then capacity interleaved frames
+// The fields before the first aligned member are written once by the writer before it publishes magic.
+struct alignas(RATL_CACHE_LINE_SIZE) shm_ring_header
+{
+    std::atomic<std::uint32_t> magic;
+    std::uint32_t version;
+    std::uint32_t sample_format;
+    std::uint32_t channels;
+    std::uint64_t capacity;
+    std::uint32_t max_readers;
+    std::int32_t writer_pid;
+    std::atomic<std::uint32_t> closed;
+
+    // written by the writer, futex waited on by readers
+    alignas(RATL_CACHE_LINE_SIZE) std::atomic<std::uint64_t> write_index;
+    std::atomic<std::uint32_t> write_sequence;
+    std::atomic<std::uint32_t> readers_waiting;
+
+    // written by readers, futex waited on by the writer
+    alignas(RATL_CACHE_LINE_SIZE) std::atomic<std::uint32_t> read_sequence;
+    std::atomic<std::uint32_t> writer_waiting;
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "shm_ring needs address free atomics");
+
+inline std::size_t shm_ring_data_offset(std::size_t max_readers) noexcept
+{
+    return sizeof(shm_ring_header) + (max_readers * sizeof(shm_ring_reader_slot));
+}
+
+template<typename RingBuffer>
+inline ring_buffer_region<typename RingBuffer::span_type> make_shm_ring_region(
+    typename RingBuffer::sample_type* data,
+    std::size_t channels,
+    std::size_t capacity,
+    std::uint64_t index,
+    std::size_t frames) noexcept
+{
+    using span_type = typename RingBuffer::span_type;
+    if (frames == 0)
+    {
+        return ring_buffer_region<span_type>();
+    }
+    auto position = static_cast<std::size_t>(index % capacity);
+    auto first_frames = std::min(frames, capacity - position);
+    return ring_buffer_region<span_type>(
+        span_type(data + (position * channels), channels, first_frames),
+        span_type(data, channels, frames - first_frames));
+}
+
+} // namespace detail
+
+// basic_shm_ring_writer
+// Creates a lock-free ring of interleaved frames in a POSIX shared memory object, so that processes on the same host
+// can pass audio without copying it through a socket. There is one writer, and up to max_readers readers in other
+// processes (or threads) each see every frame written after they joined; with one reader it is an SPSC ring.
+// The object starts with a header describing the sample format, channels and capacity, which readers check against
+// their own sample type. The writer unlinks the object's name when it is destroyed, and readers see it as closed.
+// write_available, write_region and commit_write don't allocate, lock or block, and only make a system call to wake
+// readers that are waiting in wait_read. The writer is held back by the slowest reader; readers whose process has
+// exited without detaching are released by release_exited_readers, which wait_write calls while it waits.
+// Names follow shm_open, e.g. "/mixer-bus-1".
+
+template<typename SampleType>
+class basic_shm_ring_writer
+{
+    static_assert(detail::is_sample<SampleType>::value, "SampleType must be a sample or network_sample");
+
+public:
+    using sample_type = SampleType;
+    using size_type = std::size_t;
+    using span_type = basic_interleaved_span<sample_type, detail::sample_traits<sample_type>>;
+    using region_type = ring_buffer_region<span_type>;
+
+private:
+    std::string name_;
+    detail::shared_memory memory_;
+    detail::shm_ring_header* header_;
+    detail::shm_ring_reader_slot* slots_;
+    sample_type* data_;
+    size_type channels_;
+    size_type capacity_;
+    size_type max_readers_;
+    std::uint64_t write_index_ = 0;
+    std::uint64_t cached_read_index_ = 0;
+
+public:
+    basic_shm_ring_writer(const std::string& name, size_type channels, size_type capacity, size_type max_readers = 1) :
+        name_(name), channels_(channels), capacity_(capacity), max_readers_(max_readers)
+    {
+        if (channels == 0 || capacity == 0 || max_readers == 0)
+        {
+            throw std::invalid_argument("shm_ring: channels, capacity and max_readers must be at least one");
+        }
+        memory_ = detail::shared_memory::create(
+            name, detail::shm_ring_data_offset(max_readers) + (channels * capacity * sizeof(sample_type)));
+
+        // the object is zero filled, which is a valid state for every atomic in it
+        header_ = new (memory_.data()) detail::shm_ring_header;
+        slots_ = new (memory_.data() + sizeof(detail::shm_ring_header)) detail::shm_ring_reader_slot[max_readers];
+        data_ = reinterpret_cast<sample_type*>(memory_.data() + detail::shm_ring_data_offset(max_readers));
+        header_->version = detail::shm_ring_version;
+        header_->sample_format = detail::shm_ring_sample_format<sample_type>();
+        header_->channels = static_cast<std::uint32_t>(channels);
+        header_->capacity = capacity;
+        header_->max_readers = static_cast<std::uint32_t>(max_readers);
+        header_->writer_pid = static_cast<std::int32_t>(::getpid());
+        header_->magic.store(detail::shm_ring_magic, std::memory_order_release);
+    }
+
+    basic_shm_ring_writer(const basic_shm_ring_writer&) = delete;
+    basic_shm_ring_writer& operator=(const basic_shm_ring_writer&) = delete;
+
+    ~basic_shm_ring_writer()
+    {
+        header_->closed.store(1, std::memory_order_seq_cst);
+        header_->write_sequence.fetch_add(1, std::memory_order_seq_cst);
+        detail::futex_wake_all(header_->write_sequence);
+        detail::shared_memory::unlink(name_);
+    }
+
+    const std::string& name() const noexcept
+    {
+        return name_;
+    }
+
+    size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    size_type capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    size_type max_readers() const noexcept
+    {
+        return max_readers_;
+    }
+
+    // Number of readers currently attached
+    size_type readers() const noexcept
+    {
+        size_type readers = 0;
+        for (size_type slot_num = 0; slot_num < max_readers_; ++slot_num)
+        {
+            readers += slots_[slot_num].state.load(std::memory_order_acquire) == detail::shm_ring_reader_active;
+        }
+        return readers;
+    }
+
+    size_type write_available() noexcept
+    {
+        cached_read_index_ = slowest_read_index();
+        return capacity_ - static_cast<size_type>(write_index_ - cached_read_index_);
+    }
+
+    size_type write_available(size_type frames) noexcept
+    {
+        auto available = capacity_ - static_cast<size_type>(write_index_ - cached_read_index_);
+        if (available < frames)
+        {
+            available = write_available();
+        }
+        return std::min(available, frames);
+    }
+
+    region_type write_region() noexcept
+    {
+        return detail::make_shm_ring_region<basic_shm_ring_writer>(
+            data_, channels_, capacity_, write_index_, write_available());
+    }
+
+    region_type write_region(size_type frames) noexcept
+    {
+        return detail::make_shm_ring_region<basic_shm_ring_writer>(
+            data_, channels_, capacity_, write_index_, write_available(frames));
+    }
+
+    void commit_write(size_type frames) noexcept
+    {
+        write_index_ += frames;
+        header_->write_index.store(write_index_, std::memory_order_seq_cst);
+        if (header_->readers_waiting.load(std::memory_order_seq_cst) != 0)
+        {
+            header_->write_sequence.fetch_add(1, std::memory_order_seq_cst);
+            detail::futex_wake_all(header_->write_sequence);
+        }
+    }
+
+    // Waits until frames frames can be written, returning false if they still can't be after timeout
+    bool wait_write(size_type frames, std::chrono::nanoseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (write_available(frames) < frames)
+        {
+            release_exited_readers();
+            header_->writer_waiting.store(1, std::memory_order_seq_cst);
+            auto sequence = header_->read_sequence.load(std::memory_order_seq_cst);
+            if (write_available(frames) >= frames)
+            {
+                break;
+            }
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero())
+            {
+                header_->writer_waiting.store(0, std::memory_order_relaxed);
+                return false;
+            }
+            // wake up now and again to look for readers that have exited
+            detail::futex_wait(
+                header_->read_sequence,
+                sequence,
+                std::min<std::chrono::nanoseconds>(remaining, std::chrono::milliseconds(100)));
+        }
+        header_->writer_waiting.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Detaches readers whose process has exited, so that they no longer hold the writer back, and returns how many
+    // were detached. Makes a system call for each attached reader.
+    size_type release_exited_readers() noexcept
+    {
+        size_type released = 0;
+        for (size_type slot_num = 0; slot_num < max_readers_; ++slot_num)
+        {
+            auto& slot = slots_[slot_num];
+            auto state = detail::shm_ring_reader_active;
+            if (slot.state.load(std::memory_order_acquire) == state &&
+                detail::process_exited(slot.pid.load(std::memory_order_relaxed)) &&
+                slot.state.compare_exchange_strong(state, detail::shm_ring_reader_free))
+            {
+                ++released;
+            }
+        }
+        return released;
+    }
+
+private:
+    // The read index of the reader furthest behind, or the write index if there are no readers
+    std::uint64_t slowest_read_index() const noexcept
+    {
+        auto read_index = write_index_;
+        for (size_type slot_num = 0; slot_num < max_readers_; ++slot_num)
+        {
+            const auto& slot = slots_[slot_num];
+            if (slot.state.load(std::memory_order_seq_cst) == detail::shm_ring_reader_active)
+            {
+                read_index = std::min(read_index, slot.read_index.load(std::memory_order_acquire));
+            }
+        }
+        return read_index;
+    }
+};
+
+// basic_shm_ring_reader
+// Attaches to a ring created by basic_shm_ring_writer, possibly in another process, and views its frames in place as
+// const interleaved spans, or const network order spans for network_sample rings. Throws std::system_error if the
+// ring doesn't exist, and std::runtime_error if it holds a different sample type or has no free reader slot.
+// A reader starts at the writer's current position. read_available, read_region and commit_read don't allocate,
+// lock or block, and only make a system call to wake the writer if it is waiting in wait_write.
+
+template<typename SampleType>
+class basic_shm_ring_reader
+{
+    static_assert(detail::is_sample<SampleType>::value, "SampleType must be a sample or network_sample");
+
+    using const_sample_traits = detail::const_sample_traits_t<detail::sample_traits<SampleType>>;
+
+public:
+    using sample_type = const SampleType;
+    using size_type = std::size_t;
+    using span_type = basic_interleaved_span<const SampleType, const_sample_traits>;
+    using region_type = ring_buffer_region<span_type>;
+
+private:
+    detail::shared_memory memory_;
+    detail::shm_ring_header* header_;
+    detail::shm_ring_reader_slot* slot_ = nullptr;
+    sample_type* data_;
+    size_type channels_;
+    size_type capacity_;
+    std::uint64_t read_index_ = 0;
+    std::uint64_t cached_write_index_ = 0;
+
+public:
+    explicit basic_shm_ring_reader(const std::string& name) : memory_(detail::shared_memory::open(name))
+    {
+        header_ = reinterpret_cast<detail::shm_ring_header*>(memory_.data());
+        if (memory_.size() < sizeof(detail::shm_ring_header) ||
+            header_->magic.load(std::memory_order_acquire) != detail::shm_ring_magic ||
+            header_->version != detail::shm_ring_version)
+        {
+            throw std::runtime_error("shm_ring: " + name + " is not a ratl shared memory ring");
+        }
+        if (header_->sample_format != detail::shm_ring_sample_format<SampleType>())
+        {
+            throw std::runtime_error("shm_ring: " + name + " holds a different sample type");
+        }
+        channels_ = header_->channels;
+        capacity_ = static_cast<size_type>(header_->capacity);
+        auto data_offset = detail::shm_ring_data_offset(header_->max_readers);
+        if (memory_.size() < data_offset + (channels_ * capacity_ * sizeof(SampleType)))
+        {
+            throw std::runtime_error("shm_ring: " + name + " is truncated");
+        }
+        data_ = reinterpret_cast<sample_type*>(memory_.data() + data_offset);
+
+        // take a free slot, or the slot of a reader whose process has exited
+        auto* slots = reinterpret_cast<detail::shm_ring_reader_slot*>(memory_.data() + sizeof(detail::shm_ring_header));
+        for (std::uint32_t slot_num = 0; slot_num < header_->max_readers && slot_ == nullptr; ++slot_num)
+        {
+            auto state = detail::shm_ring_reader_free;
+            if (slots[slot_num].state.compare_exchange_strong(state, detail::shm_ring_reader_claiming) ||
+                (state == detail::shm_ring_reader_active &&
+                 detail::process_exited(slots[slot_num].pid.load(std::memory_order_relaxed)) &&
+                 slots[slot_num].state.compare_exchange_strong(state, detail::shm_ring_reader_claiming)))
+            {
+                slot_ = &slots[slot_num];
+            }
+        }
+        if (slot_ == nullptr)
+        {
+            throw std::runtime_error("shm_ring: " + name + " has no free reader slot");
+        }
+        read_index_ = header_->write_index.load(std::memory_order_acquire);
+        cached_write_index_ = read_index_;
+        slot_->pid.store(static_cast<std::int32_t>(::getpid()), std::memory_order_relaxed);
+        slot_->read_index.store(read_index_, std::memory_order_relaxed);
+        slot_->state.store(detail::shm_ring_reader_active, std::memory_order_seq_cst);
+    }
+
+    basic_shm_ring_reader(const basic_shm_ring_reader&) = delete;
+    basic_shm_ring_reader& operator=(const basic_shm_ring_reader&) = delete;
+
+    ~basic_shm_ring_reader()
+    {
+        slot_->state.store(detail::shm_ring_reader_free, std::memory_order_seq_cst);
+        wake_writer();
+    }
+
+    size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    size_type capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    // Whether the writer has been destroyed or its process has exited, once it has the frames still available can be
+    // read but no more will arrive
+    bool writer_closed() const noexcept
+    {
+        return header_->closed.load(std::memory_order_acquire) != 0 || detail::process_exited(header_->writer_pid);
+    }
+
+    size_type read_available() noexcept
+    {
+        cached_write_index_ = header_->write_index.load(std::memory_order_acquire);
+        return static_cast<size_type>(cached_write_index_ - read_index_);
+    }
+
+    size_type read_available(size_type frames) noexcept
+    {
+        auto available = static_cast<size_type>(cached_write_index_ - read_index_);
+        if (available < frames)
+        {
+            available = read_available();
+        }
+        return std::min(available, frames);
+    }
+
+    region_type read_region() noexcept
+    {
+        return detail::make_shm_ring_region<basic_shm_ring_reader>(
+            data_, channels_, capacity_, read_index_, read_available());
+    }
+
+    region_type read_region(size_type frames) noexcept
+    {
+        return detail::make_shm_ring_region<basic_shm_ring_reader>(
+            data_, channels_, capacity_, read_index_, read_available(frames));
+    }
+
+    void commit_read(size_type frames) noexcept
+    {
+        read_index_ += frames;
+        slot_->read_index.store(read_index_, std::memory_order_seq_cst);
+        if (header_->writer_waiting.load(std::memory_order_seq_cst) != 0)
+        {
+            wake_writer();
+        }
+    }
+
+    // Waits until frames frames can be read, returning false if they still can't be after timeout or if the writer
+    // closes first
+    bool wait_read(size_type frames, std::chrono::nanoseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        auto ready = true;
+        header_->readers_waiting.fetch_add(1, std::memory_order_seq_cst);
+        while (read_available(frames) < frames)
+        {
+            auto sequence = header_->write_sequence.load(std::memory_order_seq_cst);
+            if (read_available(frames) >= frames)
+            {
+                break;
+            }
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero() || writer_closed())
+            {
+                ready = false;
+                break;
+            }
+            // wake up now and again in case the writer's process has exited
+            detail::futex_wait(
+                header_->write_sequence,
+                sequence,
+                std::min<std::chrono::nanoseconds>(remaining, std::chrono::milliseconds(100)));
+        }
+        header_->readers_waiting.fetch_sub(1, std::memory_order_seq_cst);
+        return ready;
+    }
+
+private:
+    void wake_writer() noexcept
+    {
+        header_->read_sequence.fetch_add(1, std::memory_order_seq_cst);
+        detail::futex_wake_all(header_->read_sequence);
+    }
+};
+
+template<typename SampleValueType>
+using shm_ring_writer = basic_shm_ring_writer<sample<SampleValueType>>;
+
+template<typename SampleValueType>
+using network_shm_ring_writer = basic_shm_ring_writer<network_sample<SampleValueType>>;
+
+template<typename SampleValueType>
+using shm_ring_reader = basic_shm_ring_reader<sample<SampleValueType>>;
+
+template<typename SampleValueType>
+using network_shm_ring_reader = basic_shm_ring_reader<network_sample<SampleValueType>>;
+
+// transform into basic_shm_ring_writer and out of basic_shm_ring_reader
+// As for the in-process ring buffers, as many frames as are available are transferred, up to the number of frames in
+// the given range, and the number of frames transferred is returned.
+
+template<typename InputIterator, typename SampleType, typename... Args>
+inline std::size_t transform(
+    InputIterator first, InputIterator last, basic_shm_ring_writer<SampleType>& ring, Args&&... args)
+{
+    return detail::ring_buffer_write<detail::default_transformer>(first, last, ring, args...);
+}
+
+template<typename SampleType, typename OutputIterator, typename... Args>
+inline std::size_t transform(
+    basic_shm_ring_reader<SampleType>& ring, OutputIterator first, OutputIterator last, Args&&... args)
+{
+    return detail::ring_buffer_read<detail::default_transformer>(ring, first, last, args...);
+}
+
+} // namespace ratl
+
+#endif
+
+#endif // _ratl_shm_ring_
@@ -0,0 +1,359 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_static_noninterleaved_
+#define _ratl_static_noninterleaved_
+
+// ratl includes
+#include <ratl/channel_span.hpp>
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/noninterleaved_iterator.hpp>
+#include <ratl/detail/operator_arrow_proxy.hpp>
+#include <ratl/detail/relayout.hpp>
+#include <ratl/detail/sample_traits.hpp>
+#include <ratl/for_overwrite.hpp>
+#include <ratl/frame_span.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/sample.hpp>
+
+// other includes
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ratl
+{
+// Noninterleaved buffer of up to MaxChannels channels and MaxFrames frames, stored inside the object itself
+// The storage is aligned to RATL_SIMD_ALIGNMENT, and the buffer can be resized to any dimensions up to MaxChannels x
+// MaxFrames without allocating. It has the same iterators as basic_noninterleaved, so can be used with
+// ratl::transform in exactly the same way.
+template<typename SampleType, std::size_t MaxChannels, std::size_t MaxFrames>
+class basic_static_noninterleaved
+{
+    static_assert(
+        std::is_same<std::remove_cv_t<SampleType>, SampleType>::value,
+        "sample_type must be non-const and non-volatile");
+    static_assert((MaxChannels > 0) && (MaxFrames > 0), "MaxChannels and MaxFrames must be greater than zero");
+
+private:
+    using sample_traits = detail::sample_traits<SampleType>;
+    using const_sample_traits = detail::const_sample_traits_t<sample_traits>;
+
+public:
+    using sample_type = typename sample_traits::sample_type;
+    using const_sample_type = typename sample_traits::const_sample_type;
+    using sample_pointer = typename sample_traits::pointer;
+    using const_sample_pointer = typename sample_traits::const_pointer;
+
+    using channel_type = basic_channel_span<sample_type, sample_traits, std::true_type>;
+    using const_channel_type = basic_channel_span<const_sample_type, const_sample_traits, std::true_type>;
+    using frame_type = basic_frame_span<sample_type, sample_traits, std::false_type>;
+    using const_frame_type = basic_frame_span<const_sample_type, const_sample_traits, std::false_type>;
+
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using value_type = channel_type;
+    using pointer = detail::operator_arrow_proxy<channel_type>;
+    using const_pointer = const detail::operator_arrow_proxy<channel_type>;
+    using reference = channel_type;
+    using const_reference = const_channel_type;
+
+    using iterator = detail::noninterleaved_iterator<sample_type, sample_traits>;
+    using const_iterator = detail::noninterleaved_iterator<const_sample_type, const_sample_traits>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    alignas(RATL_SIMD_ALIGNMENT) sample_type storage_[MaxChannels * MaxFrames];
+    size_type channels_;
+    size_type frames_;
+
+public:
+    // Constructs a zeroed buffer of MaxChannels channels and MaxFrames frames
+    basic_static_noninterleaved() noexcept : basic_static_noninterleaved(MaxChannels, MaxFrames) {}
+
+    // Throws std::length_error if channels is greater than MaxChannels or frames is greater than MaxFrames
+    basic_static_noninterleaved(size_type channels, size_type frames) :
+        basic_static_noninterleaved(for_overwrite, channels, frames)
+    {
+        std::fill_n(data(), samples(), sample_type());
+    }
+
+    // The samples are left uninitialised
+    basic_static_noninterleaved(for_overwrite_t, size_type channels, size_type frames) :
+        channels_(channels), frames_(frames)
+    {
+        check_dimensions(channels, frames);
+    }
+
+    basic_static_noninterleaved(const basic_static_noninterleaved& other) noexcept :
+        channels_(other.channels_), frames_(other.frames_)
+    {
+        std::copy_n(other.data(), other.samples(), data());
+    }
+
+    basic_static_noninterleaved& operator=(const basic_static_noninterleaved& other) noexcept
+    {
+        channels_ = other.channels_;
+        frames_ = other.frames_;
+        std::copy_n(other.data(), other.samples(), data());
+        return *this;
+    }
+
+    inline sample_pointer data() noexcept
+    {
+        return storage_;
+    }
+
+    inline const_sample_pointer data() const noexcept
+    {
+        return storage_;
+    }
+
+    inline size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    inline size_type frames() const noexcept
+    {
+        return frames_;
+    }
+
+    inline size_type samples() const noexcept
+    {
+        return channels() * frames();
+    }
+
+    inline bool empty() const noexcept
+    {
+        return (channels() == 0) || (frames() == 0);
+    }
+
+    static constexpr size_type max_channels() noexcept
+    {
+        return MaxChannels;
+    }
+
+    static constexpr size_type max_frames() noexcept
+    {
+        return MaxFrames;
+    }
+
+    static constexpr size_type capacity() noexcept
+    {
+        return MaxChannels * MaxFrames;
+    }
+
+    // Samples that are in both the old and new dimensions keep their value and any other samples are zeroed
+    // Throws std::length_error if channels is greater than MaxChannels or frames is greater than MaxFrames.
+    void resize(size_type channels, size_type frames);
+
+    // The values of all samples are unspecified after resizing
+    // Throws std::length_error if channels is greater than MaxChannels or frames is greater than MaxFrames.
+    void resize(for_overwrite_t, size_type channels, size_type frames)
+    {
+        check_dimensions(channels, frames);
+        channels_ = channels;
+        frames_ = frames;
+    }
+
+    inline frame_type frame(size_type n)
+    {
+        return frame_type(data() + n, channels(), frames());
+    }
+
+    inline const_frame_type frame(size_type n) const
+    {
+        return const_frame_type(data() + n, channels(), frames());
+    }
+
+    inline channel_type channel(size_type n)
+    {
+        return channel_type(data() + (n * frames()), frames());
+    }
+
+    inline const_channel_type channel(size_type n) const
+    {
+        return const_channel_type(data() + (n * frames()), frames());
+    }
+
+    inline reference operator[](size_type n) noexcept
+    {
+        return channel(n);
+    }
+
+    inline const_reference operator[](size_type n) const noexcept
+    {
+        return channel(n);
+    }
+
+    inline reference at(size_type n)
+    {
+        if (n >= channels())
+        {
+            throw std::out_of_range("static_noninterleaved");
+        }
+        return (*this)[n];
+    }
+
+    inline const_reference at(size_type n) const
+    {
+        if (n >= channels())
+        {
+            throw std::out_of_range("static_noninterleaved");
+        }
+        return (*this)[n];
+    }
+
+    inline reference front() noexcept
+    {
+        return reference(data(), frames());
+    }
+
+    inline const_reference front() const noexcept
+    {
+        return const_reference(data(), frames());
+    }
+
+    inline reference back() noexcept
+    {
+        return reference(data() + ((channels() - 1) * frames()), frames());
+    }
+
+    inline const_reference back() const noexcept
+    {
+        return const_reference(data() + ((channels() - 1) * frames()), frames());
+    }
+
+    // iterators
+    inline iterator begin() noexcept
+    {
+        return iterator(data(), frames());
+    }
+
+    inline const_iterator begin() const noexcept
+    {
+        return const_iterator(data(), frames());
+    }
+
+    inline iterator end() noexcept
+    {
+        return iterator(data() + (channels() * frames()), frames());
+    }
+
+    inline const_iterator end() const noexcept
+    {
+        return const_iterator(data() + (channels() * frames()), frames());
+    }
+
+    // reverse iterators
+    inline reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    inline const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    inline reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    inline const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    // const iterators
+    inline const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    inline const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    inline const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+
+    inline const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+
+private:
+    static void check_dimensions(size_type channels, size_type frames)
+    {
+        if ((channels > MaxChannels) || (frames > MaxFrames))
+        {
+            throw std::length_error("static_noninterleaved");
+        }
+    }
+};
+
+template<typename SampleType, std::size_t MaxChannels, std::size_t MaxFrames>
+void basic_static_noninterleaved<SampleType, MaxChannels, MaxFrames>::resize(size_type channels, size_type frames)
+{
+    check_dimensions(channels, frames);
+    detail::relayout(
+        data(),
+        this->frames(),
+        frames,
+        std::min(channels, this->channels()),
+        std::min(frames, this->frames()),
+        channels);
+    channels_ = channels;
+    frames_ = frames;
+}
+
+template<
+    typename SampleType,
+    std::size_t MaxChannelsA,
+    std::size_t MaxFramesA,
+    std::size_t MaxChannelsB,
+    std::size_t MaxFramesB>
+inline bool operator==(
+    const basic_static_noninterleaved<SampleType, MaxChannelsA, MaxFramesA>& a,
+    const basic_static_noninterleaved<SampleType, MaxChannelsB, MaxFramesB>& b) noexcept
+{
+    return (a.channels() == b.channels()) && (a.frames() == b.frames()) &&
+           std::equal(a.data(), a.data() + a.samples(), b.data());
+}
+
+template<
+    typename SampleType,
+    std::size_t MaxChannelsA,
+    std::size_t MaxFramesA,
+    std::size_t MaxChannelsB,
+    std::size_t MaxFramesB>
+inline bool operator!=(
+    const basic_static_noninterleaved<SampleType, MaxChannelsA, MaxFramesA>& a,
+    const basic_static_noninterleaved<SampleType, MaxChannelsB, MaxFramesB>& b) noexcept
+{
+    return !(a == b);
+}
+
+template<typename SampleValueType, std::size_t MaxChannels, std::size_t MaxFrames>
+using static_noninterleaved = basic_static_noninterleaved<sample<SampleValueType>, MaxChannels, MaxFrames>;
+
+template<typename SampleValueType, std::size_t MaxChannels, std::size_t MaxFrames>
+using network_static_noninterleaved =
+    basic_static_noninterleaved<network_sample<SampleValueType>, MaxChannels, MaxFrames>;
+
+} // namespace ratl
+
+#endif // _ratl_static_noninterleaved_
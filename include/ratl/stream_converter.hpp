@@ -0,0 +1,787 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_stream_converter_
+#define _ratl_stream_converter_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/io_uring.hpp>
+#include <ratl/detail/page_mapping.hpp>
+#include <ratl/detail/sample_traits.hpp>
+#include <ratl/dither_generator.hpp>
+#include <ratl/interleaved_span.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/sample.hpp>
+#include <ratl/transform.hpp>
+
+// other includes
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+#    include <sys/resource.h>
+#    include <sys/uio.h>
+#    include <unistd.h>
+#endif
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+
+namespace ratl
+{
+// How a stream_converter reads and writes its files
+// automatic uses io_uring where the kernel supports it and threads otherwise, io_uring fails if it isn't supported.
+enum class stream_io_backend
+{
+    automatic,
+    io_uring,
+    threads
+};
+
+// Options controlling how a stream_converter splits a conversion into blocks and overlaps their I/O
+// blocks is both how many blocks can be in flight at once and the depth of the io_uring queue. io_threads is the
+// number of threads reading and writing for the threads backend.
+struct stream_converter_options
+{
+    std::size_t block_frames = 16384;
+    std::size_t blocks = 16;
+    stream_io_backend backend = stream_io_backend::automatic;
+    std::size_t io_threads = 4;
+    bool dither = false;
+};
+
+// Statistics of one stream_converter conversion
+// cpu_seconds is the user and system time of the whole process over the conversion, so cpu_utilisation() counts
+// every core that was kept busy, including by the kernel's io_uring workers.
+struct stream_converter_stats
+{
+    stream_io_backend backend = stream_io_backend::threads;
+    std::uint64_t frames = 0;
+    std::uint64_t bytes_read = 0;
+    std::uint64_t bytes_written = 0;
+    double seconds = 0.0;
+    double cpu_seconds = 0.0;
+
+    // Bytes read and written per second, in millions
+    double megabytes_per_second() const noexcept
+    {
+        return seconds > 0.0 ? static_cast<double>(bytes_read + bytes_written) / (seconds * 1.0e6) : 0.0;
+    }
+
+    // CPU time per second of wall clock time, 1.0 is one core kept busy
+    double cpu_utilisation() const noexcept
+    {
+        return seconds > 0.0 ? cpu_seconds / seconds : 0.0;
+    }
+};
+
+namespace detail
+{
+enum class stream_block_state
+{
+    free,
+    reading,
+    read,
+    writing
+};
+
+struct stream_block
+{
+    unsigned char* input = nullptr;
+    unsigned char* output = nullptr;
+    std::uint64_t index = 0;
+    std::size_t frames = 0;
+    std::size_t transferred = 0;
+    stream_block_state state = stream_block_state::free;
+};
+
+inline double process_cpu_seconds() noexcept
+{
+    rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0.0;
+    }
+    auto seconds = [](const timeval& time)
+    {
+        return static_cast<double>(time.tv_sec) + (static_cast<double>(time.tv_usec) * 1.0e-6);
+    };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+// Reads blocks of a file, converts each block on a worker thread and writes the converted blocks to another file
+// Block i always uses buffer i % blocks, so blocks are read and converted in order, which keeps dithering
+// deterministic, while their reads and writes complete in whatever order the storage likes. The io_uring backend
+// drives every transfer from the calling thread through one queue, the threads backend hands them to a pool of
+// threads making blocking pread and pwrite calls.
+class stream_pipeline
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    stream_converter_options options_;
+    size_type input_frame_bytes_;
+    size_type output_frame_bytes_;
+    size_type input_block_bytes_ = 0;
+    size_type output_block_bytes_ = 0;
+    unsigned char* buffers_ = nullptr;
+    size_type buffers_bytes_ = 0;
+    std::vector<stream_block> blocks_;
+    stream_io_backend backend_ = stream_io_backend::threads;
+#if defined(RATL_HAS_IO_URING)
+    std::unique_ptr<io_uring_queue> ring_;
+    bool registered_ = false;
+    std::mutex submit_mutex_;
+#endif
+
+    // per conversion state, guarded by mutex_
+    std::mutex mutex_;
+    std::condition_variable convert_cv_;
+    std::condition_variable jobs_cv_;
+    std::condition_variable progress_cv_;
+    std::deque<stream_block*> jobs_;
+    int input_fd_ = -1;
+    int output_fd_ = -1;
+    std::uint64_t input_offset_ = 0;
+    std::uint64_t output_offset_ = 0;
+    std::uint64_t frames_ = 0;
+    std::uint64_t total_blocks_ = 0;
+    std::uint64_t next_read_ = 0;
+    std::uint64_t next_convert_ = 0;
+    std::uint64_t written_blocks_ = 0;
+    size_type in_flight_ = 0;
+    int error_ = 0;
+    bool stopping_ = false;
+
+public:
+    stream_pipeline(
+        size_type input_frame_bytes,
+        size_type output_frame_bytes,
+        const stream_converter_options& options) :
+        options_(options), input_frame_bytes_(input_frame_bytes), output_frame_bytes_(output_frame_bytes)
+    {
+        if (input_frame_bytes_ == 0 || output_frame_bytes_ == 0)
+        {
+            throw std::invalid_argument("stream_converter: channels must be greater than 0");
+        }
+        if (options_.block_frames == 0 || options_.blocks == 0)
+        {
+            throw std::invalid_argument("stream_converter: block_frames and blocks must be greater than 0");
+        }
+        options_.io_threads = std::max<size_type>(options_.io_threads, 1);
+
+        // page aligned buffers are SIMD aligned and suitable for direct I/O, they are touched now so that the first
+        // conversion doesn't page fault on them
+        input_block_bytes_ = round_up_to(options_.block_frames * input_frame_bytes_, page_size());
+        output_block_bytes_ = round_up_to(options_.block_frames * output_frame_bytes_, page_size());
+        buffers_bytes_ = options_.blocks * (input_block_bytes_ + output_block_bytes_);
+        buffers_ = static_cast<unsigned char*>(map_pages(buffers_bytes_, true));
+        if (buffers_ == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        prefault_pages(buffers_, buffers_bytes_);
+        blocks_.resize(options_.blocks);
+        for (size_type block_num = 0; block_num < options_.blocks; ++block_num)
+        {
+            blocks_[block_num].input = buffers_ + (block_num * input_block_bytes_);
+            blocks_[block_num].output =
+                buffers_ + (options_.blocks * input_block_bytes_) + (block_num * output_block_bytes_);
+        }
+
+        try
+        {
+            open_backend();
+        }
+        catch (...)
+        {
+            unmap_pages(buffers_, buffers_bytes_);
+            throw;
+        }
+    }
+
+    stream_pipeline(const stream_pipeline&) = delete;
+    stream_pipeline& operator=(const stream_pipeline&) = delete;
+
+    ~stream_pipeline()
+    {
+#if defined(RATL_HAS_IO_URING)
+        // the buffers must outlive their registration
+        ring_.reset();
+#endif
+        unmap_pages(buffers_, buffers_bytes_);
+    }
+
+    stream_io_backend backend() const noexcept
+    {
+        return backend_;
+    }
+
+    // Converts frames frames read from input_fd at input_offset, writing them to output_fd at output_offset
+    // convert(input, output, frames) is called on a worker thread for each block, in order.
+    template<typename Convert>
+    stream_converter_stats run(
+        int input_fd,
+        std::uint64_t input_offset,
+        int output_fd,
+        std::uint64_t output_offset,
+        std::uint64_t frames,
+        Convert convert)
+    {
+        input_fd_ = input_fd;
+        output_fd_ = output_fd;
+        input_offset_ = input_offset;
+        output_offset_ = output_offset;
+        frames_ = frames;
+        total_blocks_ = (frames + options_.block_frames - 1) / options_.block_frames;
+        next_read_ = 0;
+        next_convert_ = 0;
+        written_blocks_ = 0;
+        in_flight_ = 0;
+        error_ = 0;
+        stopping_ = false;
+        for (auto& block : blocks_)
+        {
+            block.state = stream_block_state::free;
+        }
+
+        auto start_cpu = process_cpu_seconds();
+        auto start = std::chrono::steady_clock::now();
+        std::thread converter(
+            [this, &convert]()
+            {
+                convert_blocks(convert);
+            });
+        try
+        {
+#if defined(RATL_HAS_IO_URING)
+            if (backend_ == stream_io_backend::io_uring)
+            {
+                run_io_uring();
+            }
+            else
+#endif
+            {
+                run_threads();
+            }
+        }
+        catch (...)
+        {
+            converter.join();
+            throw;
+        }
+        converter.join();
+
+        stream_converter_stats stats;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.cpu_seconds = process_cpu_seconds() - start_cpu;
+        if (error_ != 0)
+        {
+            throw std::system_error(error_, std::generic_category(), "stream_converter");
+        }
+        stats.backend = backend_;
+        stats.frames = frames;
+        stats.bytes_read = frames * input_frame_bytes_;
+        stats.bytes_written = frames * output_frame_bytes_;
+        return stats;
+    }
+
+private:
+    void open_backend()
+    {
+#if defined(RATL_HAS_IO_URING)
+        if (options_.backend != stream_io_backend::threads)
+        {
+            try
+            {
+                ring_.reset(new io_uring_queue(static_cast<unsigned>(options_.blocks)));
+                backend_ = stream_io_backend::io_uring;
+            }
+            catch (const std::system_error&)
+            {
+                if (options_.backend == stream_io_backend::io_uring)
+                {
+                    throw;
+                }
+            }
+        }
+        if (ring_)
+        {
+            // fixed transfers save the kernel from mapping every buffer on every transfer, but count against the
+            // locked memory limit, so they are optional
+            std::vector<iovec> buffers;
+            for (auto& block : blocks_)
+            {
+                buffers.push_back(iovec{block.input, input_block_bytes_});
+                buffers.push_back(iovec{block.output, output_block_bytes_});
+            }
+            registered_ = ring_->register_buffers(buffers.data(), static_cast<unsigned>(buffers.size()));
+        }
+#else
+        if (options_.backend == stream_io_backend::io_uring)
+        {
+            throw std::system_error(ENOSYS, std::generic_category(), "io_uring");
+        }
+#endif
+    }
+
+    size_type block_bytes(const stream_block& block) const noexcept
+    {
+        return block.frames * (block.state == stream_block_state::reading ? input_frame_bytes_ : output_frame_bytes_);
+    }
+
+    unsigned char* block_data(const stream_block& block) const noexcept
+    {
+        return block.state == stream_block_state::reading ? block.input : block.output;
+    }
+
+    std::uint64_t block_offset(const stream_block& block) const noexcept
+    {
+        return block.state == stream_block_state::reading ?
+                   input_offset_ + (block.index * options_.block_frames * input_frame_bytes_) :
+                   output_offset_ + (block.index * options_.block_frames * output_frame_bytes_);
+    }
+
+    bool finished() const noexcept
+    {
+        return error_ != 0 || written_blocks_ == total_blocks_;
+    }
+
+    // Starts reading every block whose buffer is free, in order
+    void claim_reads(std::vector<stream_block*>& reads)
+    {
+        while (error_ == 0 && next_read_ < total_blocks_)
+        {
+            auto& block = blocks_[static_cast<size_type>(next_read_ % options_.blocks)];
+            if (block.state != stream_block_state::free)
+            {
+                break;
+            }
+            block.index = next_read_++;
+            block.frames = static_cast<size_type>(
+                std::min<std::uint64_t>(options_.block_frames, frames_ - (block.index * options_.block_frames)));
+            block.transferred = 0;
+            block.state = stream_block_state::reading;
+            ++in_flight_;
+            reads.push_back(&block);
+        }
+    }
+
+    // Called with mutex_ held when a block has been read or written, or has failed
+    void complete(stream_block& block, int error, std::vector<stream_block*>& reads)
+    {
+        --in_flight_;
+        if (error != 0)
+        {
+            if (error_ == 0)
+            {
+                error_ = error;
+            }
+            convert_cv_.notify_one();
+        }
+        else if (block.state == stream_block_state::reading)
+        {
+            block.state = stream_block_state::read;
+            convert_cv_.notify_one();
+        }
+        else
+        {
+            block.state = stream_block_state::free;
+            ++written_blocks_;
+            claim_reads(reads);
+        }
+        progress_cv_.notify_all();
+    }
+
+    template<typename Convert>
+    void convert_blocks(Convert& convert)
+    {
+        while (true)
+        {
+            stream_block* block = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                convert_cv_.wait(
+                    lock,
+                    [this]()
+                    {
+                        return error_ != 0 || next_convert_ == total_blocks_ ||
+                               blocks_[static_cast<size_type>(next_convert_ % options_.blocks)].state ==
+                                   stream_block_state::read;
+                    });
+                if (error_ != 0 || next_convert_ == total_blocks_)
+                {
+                    return;
+                }
+                block = &blocks_[static_cast<size_type>(next_convert_++ % options_.blocks)];
+            }
+
+            convert(static_cast<const unsigned char*>(block->input), block->output, block->frames);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (error_ != 0)
+            {
+                return;
+            }
+            block->state = stream_block_state::writing;
+            block->transferred = 0;
+            ++in_flight_;
+#if defined(RATL_HAS_IO_URING)
+            if (backend_ == stream_io_backend::io_uring)
+            {
+                // the driver may be waiting for something to be in flight before it waits for completions
+                lock.unlock();
+                progress_cv_.notify_all();
+                submit({block});
+                continue;
+            }
+#endif
+            jobs_.push_back(block);
+            jobs_cv_.notify_one();
+        }
+    }
+
+#if defined(RATL_HAS_IO_URING)
+    // Queues the remaining part of each block's transfer and hands them all to the kernel at once
+    void submit(const std::vector<stream_block*>& blocks)
+    {
+        if (blocks.empty())
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+        for (auto* block : blocks)
+        {
+            auto buffer_index = -1;
+            if (registered_)
+            {
+                buffer_index = static_cast<int>(2 * static_cast<size_type>(block - blocks_.data())) +
+                               (block->state == stream_block_state::reading ? 0 : 1);
+            }
+            // every block has at most one transfer in flight, so the queue never fills
+            ring_->push(make_io_uring_transfer(
+                block->state == stream_block_state::reading,
+                block->state == stream_block_state::reading ? input_fd_ : output_fd_,
+                block_data(*block) + block->transferred,
+                block_bytes(*block) - block->transferred,
+                block_offset(*block) + block->transferred,
+                buffer_index,
+                static_cast<std::uint64_t>(block - blocks_.data())));
+        }
+
+        auto error = 0;
+        do
+        {
+            error = ring_->submit();
+        } while (error == EINTR || (error == 0 && ring_->pending() != 0) || error == EAGAIN || error == EBUSY);
+        if (error != 0)
+        {
+            // the transfers that the kernel didn't take will never complete
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_flight_ -= ring_->pending();
+            ring_->discard_pending();
+            if (error_ == 0)
+            {
+                error_ = error;
+            }
+            convert_cv_.notify_one();
+            progress_cv_.notify_all();
+        }
+    }
+
+    void run_io_uring()
+    {
+        std::vector<stream_block*> transfers;
+        transfers.reserve(options_.blocks);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            claim_reads(transfers);
+        }
+        submit(transfers);
+
+        while (true)
+        {
+            {
+                // nothing can complete while every block is waiting to be converted
+                std::unique_lock<std::mutex> lock(mutex_);
+                progress_cv_.wait(
+                    lock,
+                    [this]()
+                    {
+                        return in_flight_ > 0 || finished();
+                    });
+                if (in_flight_ == 0)
+                {
+                    break;
+                }
+            }
+
+            // a failed wait (e.g. one interrupted by a signal) just waits again, the buffers can't be released until
+            // every transfer in flight has completed
+            ring_->wait();
+            transfers.clear();
+            io_uring_cqe cqe;
+            while (ring_->pop(cqe))
+            {
+                auto& block = blocks_[static_cast<size_type>(cqe.user_data)];
+                auto error = cqe.res < 0 ? -cqe.res : 0;
+                if (error == EINTR || error == EAGAIN)
+                {
+                    transfers.push_back(&block);
+                    continue;
+                }
+                if (error == 0)
+                {
+                    if (cqe.res == 0)
+                    {
+                        // the input ended before the frames that were asked for
+                        error = EIO;
+                    }
+                    else
+                    {
+                        block.transferred += static_cast<size_type>(cqe.res);
+                        if (block.transferred < block_bytes(block))
+                        {
+                            transfers.push_back(&block);
+                            continue;
+                        }
+                    }
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                complete(block, error, transfers);
+            }
+            submit(transfers);
+        }
+    }
+#endif
+
+    // Reads or writes the whole of a block with blocking calls, returning 0 or the error
+    int transfer(stream_block& block) noexcept
+    {
+        auto reading = block.state == stream_block_state::reading;
+        auto* data = block_data(block);
+        auto size = block_bytes(block);
+        auto offset = block_offset(block);
+        while (block.transferred < size)
+        {
+            auto transferred =
+                reading ? ::pread(input_fd_, data + block.transferred, size - block.transferred,
+                                  static_cast<off_t>(offset + block.transferred)) :
+                          ::pwrite(output_fd_, data + block.transferred, size - block.transferred,
+                                   static_cast<off_t>(offset + block.transferred));
+            if (transferred < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return errno;
+            }
+            if (transferred == 0)
+            {
+                return EIO;
+            }
+            block.transferred += static_cast<size_type>(transferred);
+        }
+        return 0;
+    }
+
+    void run_threads()
+    {
+        std::vector<std::thread> io_threads;
+        auto stop = [this, &io_threads]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            jobs_cv_.notify_all();
+            for (auto& io_thread : io_threads)
+            {
+                io_thread.join();
+            }
+        };
+
+        try
+        {
+            for (size_type thread_num = 0; thread_num < options_.io_threads; ++thread_num)
+            {
+                io_threads.emplace_back(
+                    [this]()
+                    {
+                        run_io_thread();
+                    });
+            }
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = EAGAIN;
+            }
+            convert_cv_.notify_one();
+            stop();
+            throw;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            std::vector<stream_block*> reads;
+            claim_reads(reads);
+            jobs_.insert(jobs_.end(), reads.begin(), reads.end());
+            jobs_cv_.notify_all();
+            progress_cv_.wait(
+                lock,
+                [this]()
+                {
+                    return in_flight_ == 0 && finished();
+                });
+        }
+        stop();
+    }
+
+    void run_io_thread()
+    {
+        std::vector<stream_block*> reads;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            jobs_cv_.wait(
+                lock,
+                [this]()
+                {
+                    return stopping_ || !jobs_.empty();
+                });
+            if (jobs_.empty())
+            {
+                return;
+            }
+            auto* block = jobs_.front();
+            jobs_.pop_front();
+
+            // once a transfer has failed the rest are abandoned
+            auto error = ECANCELED;
+            if (error_ == 0)
+            {
+                lock.unlock();
+                error = transfer(*block);
+                lock.lock();
+            }
+
+            reads.clear();
+            complete(*block, error, reads);
+            if (!reads.empty())
+            {
+                jobs_.insert(jobs_.end(), reads.begin(), reads.end());
+                jobs_cv_.notify_all();
+            }
+        }
+    }
+};
+
+} // namespace detail
+
+// basic_stream_converter
+// Converts interleaved samples from one file to another in large blocks, overlapping reading, converting and writing.
+// Blocks are read into a pool of page aligned buffers with io_uring where it is available (with the buffers
+// registered with the kernel, and every block in flight at once) or a pool of threads otherwise. A worker thread
+// converts each block as soon as it has been read, and its write is queued as soon as it has been converted, so on
+// a fast enough disk the conversion runs at the speed of whichever of the three stages is slowest.
+// Input and output files are given as descriptors and offsets, so headers can be read and written around the sample
+// data by the caller, e.g. with wav_file. The output file is written with pwrite semantics and isn't truncated.
+// The constructor throws std::invalid_argument for 0 channels, block_frames or blocks, std::bad_alloc if the buffers
+// can't be allocated, and std::system_error if the io_uring backend was asked for and isn't supported.
+// convert() throws std::system_error if a read or write fails, or if the input ends early.
+
+template<typename InputSampleType, typename OutputSampleType>
+class basic_stream_converter
+{
+public:
+    using input_sample_type = InputSampleType;
+    using output_sample_type = OutputSampleType;
+    using size_type = std::size_t;
+
+private:
+    using input_traits = detail::const_sample_traits_t<detail::sample_traits<InputSampleType>>;
+    using output_traits = detail::sample_traits<OutputSampleType>;
+    using input_span = basic_interleaved_span<const InputSampleType, input_traits>;
+    using output_span = basic_interleaved_span<OutputSampleType, output_traits>;
+
+    size_type channels_;
+    bool dither_;
+    dither_generator dither_gen_;
+    detail::stream_pipeline pipeline_;
+
+public:
+    basic_stream_converter(size_type channels, const stream_converter_options& options = stream_converter_options()) :
+        channels_(channels),
+        dither_(options.dither),
+        pipeline_(channels * sizeof(InputSampleType), channels * sizeof(OutputSampleType), options)
+    {
+    }
+
+    size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    // The backend in use, which is never automatic
+    stream_io_backend backend() const noexcept
+    {
+        return pipeline_.backend();
+    }
+
+    stream_converter_stats convert(
+        int input_fd,
+        std::uint64_t input_offset,
+        int output_fd,
+        std::uint64_t output_offset,
+        std::uint64_t frames)
+    {
+        return pipeline_.run(
+            input_fd,
+            input_offset,
+            output_fd,
+            output_offset,
+            frames,
+            [this](const unsigned char* input, unsigned char* output, size_type frames)
+            {
+                auto input_samples = input_span(reinterpret_cast<const InputSampleType*>(input), channels_, frames);
+                auto output_samples = output_span(reinterpret_cast<OutputSampleType*>(output), channels_, frames);
+                if (dither_)
+                {
+                    transform(input_samples.begin(), input_samples.end(), output_samples.begin(), dither_gen_);
+                }
+                else
+                {
+                    transform(input_samples.begin(), input_samples.end(), output_samples.begin());
+                }
+            });
+    }
+};
+
+template<typename InputSampleValueType, typename OutputSampleValueType>
+using stream_converter = basic_stream_converter<sample<InputSampleValueType>, sample<OutputSampleValueType>>;
+
+} // namespace ratl
+
+#endif
+
+#endif // _ratl_stream_converter_
@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_transform_inplace_
+#define _ratl_transform_inplace_
+
+// ratl includes
+#include <ratl/detail/blit_iterator.hpp>
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/sample_traits.hpp>
+#include <ratl/detail/transformer.hpp>
+#include <ratl/extent.hpp>
+#include <ratl/interleaved_span.hpp>
+#include <ratl/network_sample.hpp>
+#include <ratl/noninterleaved_span.hpp>
+#include <ratl/sample.hpp>
+#include <ratl/transform.hpp>
+
+// other includes
+#include <cstring>
+#include <type_traits>
+
+namespace ratl
+{
+namespace detail
+{
+// reverse_endianness_sample
+
+template<typename SampleType>
+struct reverse_endianness_sample;
+
+template<typename SampleValueType>
+struct reverse_endianness_sample<sample<SampleValueType>>
+{
+    using type = network_sample<SampleValueType>;
+};
+
+template<typename SampleValueType>
+struct reverse_endianness_sample<network_sample<SampleValueType>>
+{
+    using type = sample<SampleValueType>;
+};
+
+template<typename SampleType>
+using reverse_endianness_sample_t = typename reverse_endianness_sample<SampleType>::type;
+
+// transform_samples_inplace function
+// Transforms samples [first, first + samples) into the same storage, starting at result, which must not be after first
+// Each output sample is never larger than an input sample and iteration only ever moves forwards, so every output
+// sample is written over input samples that have already been read.
+
+template<
+    template<typename, typename, typename>
+    class Transformer,
+    typename OutputSampleType,
+    typename InputSampleType,
+    typename InputSampleTraits,
+    typename... Args>
+inline void transform_samples_inplace_impl(
+    InputSampleType* first, std::size_t samples, OutputSampleType* result, std::false_type, Args&... args)
+{
+    using input_iterator = blit_iterator<InputSampleType, InputSampleTraits>;
+    using output_iterator = blit_iterator<OutputSampleType, sample_traits<OutputSampleType>>;
+    transform_impl<Transformer>(
+        input_iterator(first), input_iterator(first + samples), output_iterator(result), args...);
+}
+
+// Input and output are the same type, so samples only need to be moved if the output starts before the input
+template<
+    template<typename, typename, typename>
+    class Transformer,
+    typename OutputSampleType,
+    typename InputSampleType,
+    typename InputSampleTraits,
+    typename... Args>
+inline void transform_samples_inplace_impl(
+    InputSampleType* first, std::size_t samples, OutputSampleType* result, std::true_type, Args&...)
+{
+    if (static_cast<void*>(result) != static_cast<void*>(first))
+    {
+        std::memmove(result, first, samples * sizeof(InputSampleType));
+    }
+}
+
+template<
+    template<typename, typename, typename>
+    class Transformer,
+    typename OutputSampleType,
+    typename InputSampleType,
+    typename InputSampleTraits,
+    typename... Args>
+inline void transform_samples_inplace(
+    InputSampleType* first, std::size_t samples, OutputSampleType* result, Args&... args)
+{
+    static_assert(!std::is_const<InputSampleType>::value, "In-place transforms require mutable samples");
+    static_assert(
+        sizeof(OutputSampleType) <= sizeof(InputSampleType) && alignof(OutputSampleType) <= alignof(InputSampleType),
+        "In-place transforms can only convert to samples that are no larger than the input samples");
+    transform_samples_inplace_impl<Transformer, OutputSampleType, InputSampleType, InputSampleTraits>(
+        first, samples, result, std::is_same<OutputSampleType, InputSampleType>(), args...);
+}
+
+// transform_inplace_impl function
+
+template<
+    template<typename, typename, typename>
+    class Transformer,
+    typename OutputSampleType,
+    typename SampleType,
+    typename SampleTraits,
+    std::size_t Extent,
+    typename... Args>
+inline basic_interleaved_span<OutputSampleType, sample_traits<OutputSampleType>, Extent> transform_inplace_impl(
+    basic_interleaved_span<SampleType, SampleTraits, Extent> span, Args&... args)
+{
+    auto result = reinterpret_cast<OutputSampleType*>(span.data());
+    transform_samples_inplace<Transformer, OutputSampleType, SampleType, SampleTraits>(
+        span.data(), span.samples(), result, args...);
+    return basic_interleaved_span<OutputSampleType, sample_traits<OutputSampleType>, Extent>(
+        result, span.channels(), span.frames());
+}
+
+template<
+    template<typename, typename, typename>
+    class Transformer,
+    typename OutputSampleType,
+    typename SampleType,
+    typename SampleTraits,
+    typename... Args>
+inline basic_noninterleaved_span<OutputSampleType, sample_traits<OutputSampleType>> transform_inplace_impl(
+    basic_noninterleaved_span<SampleType, SampleTraits> span, Args&... args)
+{
+    auto result = reinterpret_cast<OutputSampleType*>(span.data());
+    if (span.pitch() == span.frames())
+    {
+        transform_samples_inplace<Transformer, OutputSampleType, SampleType, SampleTraits>(
+            span.data(), span.samples(), result, args...);
+    }
+    else
+    {
+        // Channels are padded, so pack the output channels as each one is transformed
+        for (std::size_t channel_num = 0; channel_num < span.channels(); ++channel_num)
+        {
+            transform_samples_inplace<Transformer, OutputSampleType, SampleType, SampleTraits>(
+                span.data() + (channel_num * span.pitch()),
+                span.frames(),
+                result + (channel_num * span.frames()),
+                args...);
+        }
+    }
+    return basic_noninterleaved_span<OutputSampleType, sample_traits<OutputSampleType>>(
+        result, span.channels(), span.frames());
+}
+
+} // namespace detail
+
+// transform_inplace
+// Transforms the samples of a span into OutputSampleType, reusing the span's storage, and returns a span of the
+// transformed samples. OutputSampleType must be no larger than the span's sample type (e.g. int32 to float32, float32
+// to int16 or sample to network_sample of the same width). The input span must not be used afterwards.
+// A non-interleaved span with padded channels is returned with tightly packed channels.
+
+template<typename OutputSampleType, typename Span, typename... Args>
+inline auto transform_inplace(Span span, Args&&... args)
+{
+    return detail::transform_inplace_impl<detail::default_transformer, OutputSampleType>(span, args...);
+}
+
+// reference_transform_inplace
+
+template<typename OutputSampleType, typename Span, typename... Args>
+inline auto reference_transform_inplace(Span span, Args&&... args)
+{
+    return detail::transform_inplace_impl<detail::reference_transformer, OutputSampleType>(span, args...);
+}
+
+// fast_transform_inplace
+
+template<typename OutputSampleType, typename Span, typename... Args>
+inline auto fast_transform_inplace(Span span, Args&&... args)
+{
+    return detail::transform_inplace_impl<detail::fast_transformer, OutputSampleType>(span, args...);
+}
+
+// reverse_endianness_inplace
+// Swaps the byte order of every sample of a span in place, converting between sample and network_sample, and returns
+// a span of the swapped samples. When xsimd is available each batch of samples is swapped with a single shuffle.
+
+template<typename Span>
+inline auto reverse_endianness_inplace(Span span)
+{
+    using output_sample_type = detail::reverse_endianness_sample_t<typename Span::sample_type>;
+    return detail::transform_inplace_impl<detail::default_transformer, output_sample_type>(span);
+}
+
+} // namespace ratl
+
+#endif // _ratl_transform_inplace_
@@ -0,0 +1,326 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_wav_file_
+#define _ratl_wav_file_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/mapped_file.hpp>
+#include <ratl/interleaved_span.hpp>
+#include <ratl/sample.hpp>
+#include <ratl/types.hpp>
+
+// other includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace ratl
+{
+namespace detail
+{
+// wav format tags
+static constexpr std::uint16_t wav_format_pcm = 0x0001;
+static constexpr std::uint16_t wav_format_ieee_float = 0x0003;
+static constexpr std::uint16_t wav_format_extensible = 0xfffe;
+
+// Chunk sizes of 0xffffffff mean that the real size is in the ds64 chunk of an RF64 file, or that the writer never
+// came back to fill the size in
+static constexpr std::uint32_t wav_unknown_chunk_size = 0xffffffff;
+
+// The fmt chunk fields that are needed to view the data chunk
+struct wav_format
+{
+    std::uint16_t format_tag;
+    std::size_t channels;
+    std::size_t sample_rate;
+    std::size_t block_align;
+    std::size_t bits_per_sample;
+    std::size_t valid_bits_per_sample;
+};
+
+inline wav_format read_wav_format(const unsigned char* chunk, std::size_t chunk_size)
+{
+    if (chunk_size < 16)
+    {
+        throw std::runtime_error("wav_file: fmt chunk is too small");
+    }
+
+    wav_format format{};
+    format.format_tag = read_little_endian<std::uint16_t>(chunk);
+    format.channels = read_little_endian<std::uint16_t>(chunk + 2);
+    format.sample_rate = read_little_endian<std::uint32_t>(chunk + 4);
+    format.block_align = read_little_endian<std::uint16_t>(chunk + 12);
+    format.bits_per_sample = read_little_endian<std::uint16_t>(chunk + 14);
+    format.valid_bits_per_sample = format.bits_per_sample;
+
+    // WAVE_FORMAT_EXTENSIBLE keeps the real format tag in the first two bytes of the sub format GUID
+    if (format.format_tag == wav_format_extensible)
+    {
+        if (chunk_size < 40)
+        {
+            throw std::runtime_error("wav_file: extensible fmt chunk is too small");
+        }
+        format.valid_bits_per_sample = read_little_endian<std::uint16_t>(chunk + 18);
+        format.format_tag = read_little_endian<std::uint16_t>(chunk + 24);
+    }
+
+    if (format.format_tag != wav_format_pcm && format.format_tag != wav_format_ieee_float)
+    {
+        throw std::runtime_error("wav_file: only PCM and IEEE float data is supported");
+    }
+    if (format.format_tag == wav_format_pcm && format.bits_per_sample != 16 && format.bits_per_sample != 24 &&
+        format.bits_per_sample != 32)
+    {
+        throw std::runtime_error("wav_file: only 16, 24 and 32 bit PCM data is supported");
+    }
+    if (format.format_tag == wav_format_ieee_float && format.bits_per_sample != 32)
+    {
+        throw std::runtime_error("wav_file: only 32 bit IEEE float data is supported");
+    }
+    if (format.channels == 0 || format.block_align != format.channels * (format.bits_per_sample / 8))
+    {
+        throw std::runtime_error("wav_file: block alignment doesn't match the channels and sample size");
+    }
+    return format;
+}
+
+template<typename SampleValueType>
+struct wav_sample_format;
+
+template<>
+struct wav_sample_format<int16_t>
+{
+    static constexpr std::uint16_t format_tag = wav_format_pcm;
+    static constexpr std::size_t bits_per_sample = 16;
+};
+
+template<>
+struct wav_sample_format<int24_t>
+{
+    static constexpr std::uint16_t format_tag = wav_format_pcm;
+    static constexpr std::size_t bits_per_sample = 24;
+};
+
+template<>
+struct wav_sample_format<int32_t>
+{
+    static constexpr std::uint16_t format_tag = wav_format_pcm;
+    static constexpr std::size_t bits_per_sample = 32;
+};
+
+template<>
+struct wav_sample_format<float32_t>
+{
+    static constexpr std::uint16_t format_tag = wav_format_ieee_float;
+    static constexpr std::size_t bits_per_sample = 32;
+};
+
+} // namespace detail
+
+// wav_file
+// Memory maps a WAV (RIFF), RF64 or BW64 file and views its data chunk in place, without reading or copying it.
+// 16, 24 and 32 bit PCM and 32 bit IEEE float data are supported, described either by a plain fmt chunk or by
+// WAVE_FORMAT_EXTENSIBLE. WAV data is little endian, so the samples are viewed as host byte order samples on little
+// endian hosts, and the constructor throws on big endian hosts. A data chunk that runs past the end of the file (e.g.
+// from an interrupted recording) is truncated to the whole frames that are present.
+// The file is advised for sequential access as it is opened. will_need and dont_need let a reader stream through
+// files much larger than memory by reading ahead of the conversion and releasing pages behind it.
+// Throws std::system_error if the file can't be mapped and std::runtime_error if it isn't a supported WAV file.
+
+class wav_file
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    detail::mapped_file file_;
+    detail::wav_format format_{};
+    size_type data_offset_ = 0;
+    size_type frames_ = 0;
+    bool rf64_ = false;
+
+public:
+    explicit wav_file(const std::string& path) : file_(path)
+    {
+#if defined(RATL_CPP_BIG_ENDIAN)
+        throw std::runtime_error("wav_file: little endian samples can't be viewed in place on a big endian host");
+#endif
+        parse();
+        file_.advise_sequential();
+    }
+
+    size_type channels() const noexcept
+    {
+        return format_.channels;
+    }
+
+    size_type frames() const noexcept
+    {
+        return frames_;
+    }
+
+    size_type sample_rate() const noexcept
+    {
+        return format_.sample_rate;
+    }
+
+    // Size of each sample in the file
+    size_type bits_per_sample() const noexcept
+    {
+        return format_.bits_per_sample;
+    }
+
+    // Number of bits of each sample that hold audio, which can be fewer than bits_per_sample with an extensible fmt
+    size_type valid_bits_per_sample() const noexcept
+    {
+        return format_.valid_bits_per_sample;
+    }
+
+    bool is_float() const noexcept
+    {
+        return format_.format_tag == detail::wav_format_ieee_float;
+    }
+
+    bool is_rf64() const noexcept
+    {
+        return rf64_;
+    }
+
+    // Whether the data chunk holds samples of SampleValueType, i.e. whether samples<SampleValueType>() will succeed
+    template<typename SampleValueType>
+    bool holds() const noexcept
+    {
+        using sample_format = detail::wav_sample_format<SampleValueType>;
+        return format_.format_tag == sample_format::format_tag &&
+               format_.bits_per_sample == sample_format::bits_per_sample &&
+               reinterpret_cast<std::uintptr_t>(data()) % alignof(sample<SampleValueType>) == 0;
+    }
+
+    // Views every frame of the data chunk. Throws std::invalid_argument if the file doesn't hold samples of
+    // SampleValueType, or if the data chunk isn't aligned for them.
+    template<typename SampleValueType>
+    const_interleaved_span<SampleValueType> samples() const
+    {
+        return samples<SampleValueType>(0, frames_);
+    }
+
+    // Views frames [first_frame, first_frame + frames) of the data chunk. Throws std::out_of_range if they aren't all
+    // in the file.
+    template<typename SampleValueType>
+    const_interleaved_span<SampleValueType> samples(size_type first_frame, size_type frames) const
+    {
+        if (!holds<SampleValueType>())
+        {
+            throw std::invalid_argument("wav_file: file doesn't hold the requested sample type");
+        }
+        if (first_frame > frames_ || frames > frames_ - first_frame)
+        {
+            throw std::out_of_range("wav_file");
+        }
+        return const_interleaved_span<SampleValueType>(
+            data() + (first_frame * format_.block_align), format_.channels, frames);
+    }
+
+    // Starts reading frames [first_frame, first_frame + frames) from disk without waiting for them
+    void will_need(size_type first_frame, size_type frames) const noexcept
+    {
+        file_.advise_will_need(frame_offset(first_frame), frames * format_.block_align);
+    }
+
+    // Releases frames [first_frame, first_frame + frames) from memory once they have been consumed
+    void dont_need(size_type first_frame, size_type frames) const noexcept
+    {
+        file_.advise_dont_need(frame_offset(first_frame), frames * format_.block_align);
+    }
+
+private:
+    const unsigned char* data() const noexcept
+    {
+        return file_.data() + data_offset_;
+    }
+
+    size_type frame_offset(size_type frame_num) const noexcept
+    {
+        return data_offset_ + (frame_num * format_.block_align);
+    }
+
+    void parse()
+    {
+        auto* bytes = file_.data();
+        auto size = file_.size();
+        if (size < 12 || !detail::chunk_id_equals(bytes + 8, "WAVE"))
+        {
+            throw std::runtime_error("wav_file: not a WAV file");
+        }
+        if (detail::chunk_id_equals(bytes, "RF64") || detail::chunk_id_equals(bytes, "BW64"))
+        {
+            rf64_ = true;
+        }
+        else if (!detail::chunk_id_equals(bytes, "RIFF"))
+        {
+            throw std::runtime_error("wav_file: not a WAV file");
+        }
+
+        auto have_format = false;
+        std::uint64_t ds64_data_size = 0;
+        size_type offset = 12;
+        while (size - offset >= 8)
+        {
+            auto* chunk = bytes + offset;
+            auto chunk_size = static_cast<std::uint64_t>(detail::read_little_endian<std::uint32_t>(chunk + 4));
+            auto body_offset = offset + 8;
+            auto available = static_cast<std::uint64_t>(size - body_offset);
+
+            if (detail::chunk_id_equals(chunk, "ds64"))
+            {
+                if (!rf64_ || chunk_size < 24 || available < 24)
+                {
+                    throw std::runtime_error("wav_file: invalid ds64 chunk");
+                }
+                ds64_data_size = detail::read_little_endian<std::uint64_t>(bytes + body_offset + 8);
+            }
+            else if (detail::chunk_id_equals(chunk, "fmt "))
+            {
+                format_ = detail::read_wav_format(
+                    bytes + body_offset, static_cast<size_type>(std::min(chunk_size, available)));
+                have_format = true;
+            }
+            else if (detail::chunk_id_equals(chunk, "data"))
+            {
+                if (!have_format)
+                {
+                    throw std::runtime_error("wav_file: data chunk comes before the fmt chunk");
+                }
+                if (chunk_size == detail::wav_unknown_chunk_size)
+                {
+                    chunk_size = rf64_ ? ds64_data_size : available;
+                }
+                data_offset_ = body_offset;
+                frames_ = static_cast<size_type>(std::min(chunk_size, available) / format_.block_align);
+                return;
+            }
+
+            // chunks are padded to an even number of bytes
+            auto padded_size = chunk_size + (chunk_size & 1);
+            if (padded_size > available)
+            {
+                break;
+            }
+            offset = body_offset + static_cast<size_type>(padded_size);
+        }
+        throw std::runtime_error("wav_file: no data chunk");
+    }
+};
+
+} // namespace ratl
+
+#endif // _ratl_wav_file_
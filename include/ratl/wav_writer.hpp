@@ -0,0 +1,457 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef _ratl_wav_writer_
+#define _ratl_wav_writer_
+
+// ratl includes
+#include <ratl/detail/config.hpp>
+#include <ratl/detail/direct_file.hpp>
+#include <ratl/detail/page_mapping.hpp>
+#include <ratl/dither_generator.hpp>
+#include <ratl/interleaved.hpp>
+#include <ratl/interleaved_span.hpp>
+#include <ratl/noninterleaved.hpp>
+#include <ratl/noninterleaved_span.hpp>
+#include <ratl/sample.hpp>
+#include <ratl/transform.hpp>
+#include <ratl/wav_file.hpp>
+
+// other includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace ratl
+{
+// Options controlling how a wav_writer stages samples and writes them to disk
+// Each staging block is rounded to a whole number of frames and of direct_file_alignment bytes. Together the blocks
+// bound how far the disk can fall behind the producer before frames are dropped.
+struct wav_writer_options
+{
+    std::size_t block_bytes = 1024 * 1024;
+    std::size_t blocks = 8;
+    bool direct_io = true;
+
+    // How long the background thread sleeps when it finds no full blocks to write
+    std::chrono::microseconds poll_interval = std::chrono::milliseconds(1);
+};
+
+namespace detail
+{
+// Every wav_writer file starts with a header of exactly one direct I/O block, so that the data chunk, and every block
+// written to it, is aligned for direct I/O. The header reserves room for an RF64 ds64 chunk with a JUNK chunk, which
+// is converted to ds64 if the file grows past 4GB, then pads itself out with another JUNK chunk.
+static constexpr std::size_t wav_writer_header_size = direct_file_alignment;
+static constexpr std::size_t wav_writer_ds64_offset = 12;
+static constexpr std::size_t wav_writer_ds64_size = 28;
+static constexpr std::size_t wav_writer_fmt_offset = wav_writer_ds64_offset + 8 + wav_writer_ds64_size;
+static constexpr std::size_t wav_writer_fmt_size = 40;
+static constexpr std::size_t wav_writer_pad_offset = wav_writer_fmt_offset + 8 + wav_writer_fmt_size;
+static constexpr std::size_t wav_writer_data_offset = wav_writer_header_size - 8;
+
+inline void write_little_endian(unsigned char* data, std::uint64_t value, std::size_t bytes) noexcept
+{
+    for (std::size_t byte_num = 0; byte_num < bytes; ++byte_num)
+    {
+        data[byte_num] = static_cast<unsigned char>((value >> (byte_num * 8)) & 0xff);
+    }
+}
+
+inline void write_chunk_id(unsigned char* data, const char* id) noexcept
+{
+    std::memcpy(data, id, 4);
+}
+
+// Fills in a wav_writer header for data_bytes bytes of data. The sizes of a recording that is still in progress are
+// unknown, which wav readers (including wav_file) treat as running to the end of the file.
+inline void write_wav_writer_header(
+    unsigned char* header,
+    std::uint16_t format_tag,
+    std::size_t channels,
+    std::size_t sample_rate,
+    std::size_t bits_per_sample,
+    bool in_progress,
+    std::uint64_t data_bytes)
+{
+    std::memset(header, 0, wav_writer_header_size);
+    auto block_align = channels * (bits_per_sample / 8);
+    auto riff_bytes = static_cast<std::uint64_t>(wav_writer_header_size - 8) + data_bytes + (data_bytes & 1);
+    auto rf64 = !in_progress && riff_bytes > wav_unknown_chunk_size - 1;
+
+    write_chunk_id(header, rf64 ? "RF64" : "RIFF");
+    write_little_endian(header + 4, in_progress || rf64 ? wav_unknown_chunk_size : riff_bytes, 4);
+    write_chunk_id(header + 8, "WAVE");
+
+    auto* ds64 = header + wav_writer_ds64_offset;
+    write_chunk_id(ds64, rf64 ? "ds64" : "JUNK");
+    write_little_endian(ds64 + 4, wav_writer_ds64_size, 4);
+    if (rf64)
+    {
+        write_little_endian(ds64 + 8, riff_bytes, 8);
+        write_little_endian(ds64 + 16, data_bytes, 8);
+        write_little_endian(ds64 + 24, data_bytes / block_align, 8);
+    }
+
+    // WAVE_FORMAT_EXTENSIBLE, with the real format tag at the start of the sub format GUID
+    static const unsigned char guid_tail[] = {
+        0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71};
+    auto* fmt = header + wav_writer_fmt_offset;
+    write_chunk_id(fmt, "fmt ");
+    write_little_endian(fmt + 4, wav_writer_fmt_size, 4);
+    write_little_endian(fmt + 8, wav_format_extensible, 2);
+    write_little_endian(fmt + 10, channels, 2);
+    write_little_endian(fmt + 12, sample_rate, 4);
+    write_little_endian(fmt + 16, sample_rate * block_align, 4);
+    write_little_endian(fmt + 20, block_align, 2);
+    write_little_endian(fmt + 22, bits_per_sample, 2);
+    write_little_endian(fmt + 24, 22, 2);
+    write_little_endian(fmt + 26, bits_per_sample, 2);
+    write_little_endian(fmt + 32, format_tag, 2);
+    std::memcpy(fmt + 34, guid_tail, sizeof(guid_tail));
+
+    auto* pad = header + wav_writer_pad_offset;
+    write_chunk_id(pad, "JUNK");
+    write_little_endian(pad + 4, wav_writer_data_offset - wav_writer_pad_offset - 8, 4);
+
+    auto* data = header + wav_writer_data_offset;
+    write_chunk_id(data, "data");
+    write_little_endian(data + 4, in_progress || rf64 ? wav_unknown_chunk_size : data_bytes, 4);
+}
+
+inline std::size_t greatest_common_divisor(std::size_t a, std::size_t b) noexcept
+{
+    while (b != 0)
+    {
+        auto remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    return a;
+}
+
+} // namespace detail
+
+// wav_writer
+// Records samples to a WAV file, converting them to SampleValueType as they are written. Recordings that grow past
+// 4GB are written as RF64 files.
+// write() converts (and dithers) the given frames straight into page aligned staging blocks, and a background thread
+// writes each block to disk once it is full, with large sequential writes that bypass the page cache where possible.
+// write() never allocates, locks or makes a system call, so it can be called from an audio thread or its neighbour.
+// If the disk falls so far behind that every staging block is waiting to be written, write() accepts fewer frames
+// than it was given, and the rest are counted by dropped_frames().
+// While a recording is in progress its header describes a file that runs to its end, so a recording interrupted by
+// a crash can still be read. close() writes the final frames and the real sizes.
+// The constructor throws std::system_error if the file can't be created and std::bad_alloc if the staging blocks
+// can't be allocated. close() throws std::system_error if any write failed.
+
+template<typename SampleValueType>
+class wav_writer
+{
+public:
+    using sample_type = sample<SampleValueType>;
+    using size_type = std::size_t;
+
+private:
+    using sample_format = detail::wav_sample_format<SampleValueType>;
+    using staging_span = interleaved_span<SampleValueType>;
+
+    size_type channels_;
+    size_type sample_rate_;
+    wav_writer_options options_;
+    size_type block_bytes_ = 0;
+    size_type block_frames_ = 0;
+    unsigned char* staging_ = nullptr;
+    size_type staging_bytes_ = 0;
+    detail::direct_file file_;
+
+    // producer state
+    dither_generator dither_gen_;
+    size_type used_frames_ = 0;
+    std::uint64_t produced_blocks_ = 0;
+    std::uint64_t dropped_frames_ = 0;
+
+    // shared state, published_blocks_ is only written by the producer and flushed_blocks_ by the background thread
+    alignas(RATL_CACHE_LINE_SIZE) std::atomic<std::uint64_t> published_blocks_{0};
+    alignas(RATL_CACHE_LINE_SIZE) std::atomic<std::uint64_t> flushed_blocks_{0};
+    std::atomic<bool> closing_{false};
+    std::atomic<int> error_{0};
+
+    std::thread thread_;
+    bool open_ = false;
+
+public:
+    wav_writer(
+        const std::string& path,
+        size_type channels,
+        size_type sample_rate,
+        const wav_writer_options& options = wav_writer_options()) :
+        channels_(channels), sample_rate_(sample_rate), options_(options)
+    {
+        options_.blocks = std::max<size_type>(options_.blocks, 1);
+        auto block_align = channels_ * sizeof(sample_type);
+        auto unit = (block_align / detail::greatest_common_divisor(block_align, detail::direct_file_alignment)) *
+                    detail::direct_file_alignment;
+        block_bytes_ = std::max<size_type>(options_.block_bytes / unit, 1) * unit;
+        block_frames_ = block_bytes_ / block_align;
+
+        // one extra block holds the header, the blocks are touched now so the producer never page faults on them
+        staging_bytes_ = (options_.blocks * block_bytes_) + detail::wav_writer_header_size;
+        staging_ = static_cast<unsigned char*>(detail::map_pages(staging_bytes_, true));
+        if (staging_ == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        detail::prefault_pages(staging_, staging_bytes_);
+
+        try
+        {
+            file_ = detail::direct_file(path, options_.direct_io);
+            auto error = write_header(true, 0);
+            if (error != 0)
+            {
+                throw std::system_error(error, std::system_category(), path);
+            }
+        }
+        catch (...)
+        {
+            detail::unmap_pages(staging_, staging_bytes_);
+            throw;
+        }
+
+        open_ = true;
+        thread_ = std::thread(
+            [this]()
+            {
+                run();
+            });
+    }
+
+    wav_writer(const wav_writer&) = delete;
+    wav_writer& operator=(const wav_writer&) = delete;
+
+    ~wav_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+        detail::unmap_pages(staging_, staging_bytes_);
+    }
+
+    template<typename SampleType, typename SampleTraits, std::size_t Extent>
+    size_type write(const basic_interleaved_span<SampleType, SampleTraits, Extent>& span)
+    {
+        return write_frames(
+            span.frames(),
+            [&span](size_type first_frame, size_type frames)
+            {
+                return basic_interleaved_span<SampleType, SampleTraits, Extent>(
+                    span.data() + (first_frame * span.channels()), span.channels(), frames);
+            });
+    }
+
+    template<typename SampleType, typename SampleTraits>
+    size_type write(const basic_noninterleaved_span<SampleType, SampleTraits>& span)
+    {
+        return write_frames(
+            span.frames(),
+            [&span](size_type first_frame, size_type frames)
+            {
+                return basic_noninterleaved_span<SampleType, SampleTraits>(
+                    span.data() + first_frame, span.channels(), frames, span.pitch());
+            });
+    }
+
+    template<typename Sample, typename Allocator>
+    size_type write(const basic_interleaved<Sample, Allocator>& interleaved)
+    {
+        using sample_traits = detail::const_sample_traits_t<detail::sample_traits<Sample>>;
+        return write(basic_interleaved_span<typename sample_traits::sample_type, sample_traits>(interleaved));
+    }
+
+    template<typename Sample, typename Allocator, typename ChannelLayout>
+    size_type write(const basic_noninterleaved<Sample, Allocator, ChannelLayout>& noninterleaved)
+    {
+        using sample_traits = detail::const_sample_traits_t<detail::sample_traits<Sample>>;
+        return write(basic_noninterleaved_span<typename sample_traits::sample_type, sample_traits>(noninterleaved));
+    }
+
+    // Writes the frames that are still staged, fills in the final header and closes the file
+    void close()
+    {
+        if (!open_)
+        {
+            return;
+        }
+        open_ = false;
+
+        closing_.store(true, std::memory_order_release);
+        thread_.join();
+
+        auto error = error_.load(std::memory_order_relaxed);
+        auto data_bytes = (produced_blocks_ * block_bytes_) + (used_frames_ * channels_ * sizeof(sample_type));
+        if (error == 0 && used_frames_ > 0)
+        {
+            // direct writes must be whole blocks, so the tail is padded out and the file is cut back afterwards
+            auto* block = staging_block(produced_blocks_);
+            auto tail_bytes = used_frames_ * channels_ * sizeof(sample_type);
+            auto padded_bytes = detail::round_up_to(tail_bytes, detail::direct_file_alignment);
+            std::memset(block + tail_bytes, 0, padded_bytes - tail_bytes);
+            error = file_.write_at(block, padded_bytes, data_offset(produced_blocks_));
+        }
+        if (error == 0)
+        {
+            // data chunks are padded to an even size
+            error = file_.truncate(detail::wav_writer_header_size + data_bytes + (data_bytes & 1));
+        }
+        if (error == 0)
+        {
+            error = write_header(false, data_bytes);
+        }
+        file_.close();
+        if (error != 0)
+        {
+            throw std::system_error(error, std::system_category(), "wav_writer");
+        }
+    }
+
+    size_type channels() const noexcept
+    {
+        return channels_;
+    }
+
+    size_type sample_rate() const noexcept
+    {
+        return sample_rate_;
+    }
+
+    // Frames accepted by write() so far
+    std::uint64_t frames() const noexcept
+    {
+        return (produced_blocks_ * block_frames_) + used_frames_;
+    }
+
+    // Frames that write() couldn't accept because every staging block was waiting to be written
+    std::uint64_t dropped_frames() const noexcept
+    {
+        return dropped_frames_;
+    }
+
+    // Frames in each staging block, which is how many frames are written to disk at a time
+    size_type block_frames() const noexcept
+    {
+        return block_frames_;
+    }
+
+    bool direct_io() const noexcept
+    {
+        return file_.direct();
+    }
+
+private:
+    unsigned char* staging_block(std::uint64_t block_num) const noexcept
+    {
+        return staging_ + detail::wav_writer_header_size +
+               (static_cast<size_type>(block_num % options_.blocks) * block_bytes_);
+    }
+
+    std::uint64_t data_offset(std::uint64_t block_num) const noexcept
+    {
+        return detail::wav_writer_header_size + (block_num * block_bytes_);
+    }
+
+    int write_header(bool in_progress, std::uint64_t data_bytes)
+    {
+        detail::write_wav_writer_header(
+            staging_,
+            sample_format::format_tag,
+            channels_,
+            sample_rate_,
+            sample_format::bits_per_sample,
+            in_progress,
+            data_bytes);
+        return file_.write_at(staging_, detail::wav_writer_header_size, 0);
+    }
+
+    template<typename MakeSpan>
+    size_type write_frames(size_type frames, MakeSpan make_span)
+    {
+        size_type written = 0;
+        while (written < frames)
+        {
+            // a new block can only be started once the background thread has finished writing its previous contents
+            if (used_frames_ == 0 &&
+                produced_blocks_ - flushed_blocks_.load(std::memory_order_acquire) >= options_.blocks)
+            {
+                dropped_frames_ += frames - written;
+                break;
+            }
+
+            auto block_frames = std::min(frames - written, block_frames_ - used_frames_);
+            auto input = make_span(written, block_frames);
+            auto output = staging_span(
+                staging_block(produced_blocks_) + (used_frames_ * channels_ * sizeof(sample_type)),
+                channels_,
+                block_frames);
+            transform(input.begin(), input.end(), output.begin(), dither_gen_);
+
+            written += block_frames;
+            used_frames_ += block_frames;
+            if (used_frames_ == block_frames_)
+            {
+                used_frames_ = 0;
+                published_blocks_.store(++produced_blocks_, std::memory_order_release);
+            }
+        }
+        return written;
+    }
+
+    void run()
+    {
+        auto flushed_blocks = flushed_blocks_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            // read closing before the published blocks, so that every block published before close() is written
+            auto closing = closing_.load(std::memory_order_acquire);
+            auto published_blocks = published_blocks_.load(std::memory_order_acquire);
+            if (flushed_blocks == published_blocks)
+            {
+                if (closing)
+                {
+                    return;
+                }
+                std::this_thread::sleep_for(options_.poll_interval);
+                continue;
+            }
+
+            if (error_.load(std::memory_order_relaxed) == 0)
+            {
+                auto error = file_.write_at(staging_block(flushed_blocks), block_bytes_, data_offset(flushed_blocks));
+                if (error != 0)
+                {
+                    error_.store(error, std::memory_order_relaxed);
+                }
+            }
+            flushed_blocks_.store(++flushed_blocks, std::memory_order_release);
+        }
+    }
+};
+
+} // namespace ratl
+
+#endif // _ratl_wav_writer_
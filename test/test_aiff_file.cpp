@@ -0,0 +1,340 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleValueType>
+static interleaved<SampleValueType> make_samples(std::size_t channels, std::size_t frames)
+{
+    interleaved<SampleValueType> samples(channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+            samples[frame_num][channel_num] = reference_convert<sample<SampleValueType>>(sample<int32_t>(value));
+        }
+    }
+    return samples;
+}
+
+template<typename SampleValueType>
+static network_interleaved<SampleValueType> to_network(const interleaved<SampleValueType>& samples)
+{
+    network_interleaved<SampleValueType> network_samples(samples.channels(), samples.frames());
+    transform(samples.begin(), samples.end(), network_samples.begin());
+    return network_samples;
+}
+
+// Assembles AIFF and AIFF-C files a chunk at a time
+class AiffBuilder
+{
+public:
+    explicit AiffBuilder(const char* form_type = "AIFF")
+    {
+        append_id("FORM");
+        append(std::uint32_t(0));
+        append_id(form_type);
+    }
+
+    template<typename Tp>
+    void append(Tp value)
+    {
+        for (std::size_t byte_num = sizeof(Tp); byte_num > 0; --byte_num)
+        {
+            auto byte = (static_cast<std::uint64_t>(value) >> ((byte_num - 1) * 8)) & 0xff;
+            bytes_.push_back(static_cast<unsigned char>(byte));
+        }
+    }
+
+    void append_id(const char* id)
+    {
+        bytes_.insert(bytes_.end(), id, id + 4);
+    }
+
+    void chunk(const char* id, const std::vector<unsigned char>& body)
+    {
+        append_id(id);
+        append(static_cast<std::uint32_t>(body.size()));
+        bytes_.insert(bytes_.end(), body.begin(), body.end());
+        if (body.size() % 2 != 0)
+        {
+            bytes_.push_back(0);
+        }
+    }
+
+    void comm(std::size_t channels, std::uint32_t frames, std::size_t bits_per_sample, std::uint32_t sample_rate)
+    {
+        append_id("COMM");
+        append(std::uint32_t(18));
+        append_comm(channels, frames, bits_per_sample, sample_rate);
+    }
+
+    void aifc_comm(std::size_t channels, std::uint32_t frames, std::size_t bits_per_sample, const char* compression)
+    {
+        append_id("COMM");
+        append(std::uint32_t(24));
+        append_comm(channels, frames, bits_per_sample, 48000);
+        append_id(compression);
+        // an empty compression name, padded to an even length
+        append(std::uint16_t(0));
+    }
+
+    // Writes an SSND chunk, with its offset field aligning the samples to 4 bytes unless unaligned is set
+    void ssnd(const void* data, std::size_t size, bool unaligned = false)
+    {
+        auto padding = (4 - ((bytes_.size() + 16) % 4)) % 4;
+        if (unaligned)
+        {
+            padding = (padding + 2) % 4;
+        }
+        append_id("SSND");
+        append(static_cast<std::uint32_t>(8 + padding + size));
+        append(static_cast<std::uint32_t>(padding));
+        append(std::uint32_t(0));
+        bytes_.insert(bytes_.end(), padding, 0);
+        auto bytes = static_cast<const unsigned char*>(data);
+        bytes_.insert(bytes_.end(), bytes, bytes + size);
+        if ((padding + size) % 2 != 0)
+        {
+            bytes_.push_back(0);
+        }
+    }
+
+    std::string write(const std::string& name)
+    {
+        auto form_size = bytes_.size() - 8;
+        for (std::size_t byte_num = 0; byte_num < 4; ++byte_num)
+        {
+            bytes_[4 + byte_num] = static_cast<unsigned char>((form_size >> ((3 - byte_num) * 8)) & 0xff);
+        }
+        auto path = ::testing::TempDir() + name;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes_.data()), static_cast<std::streamsize>(bytes_.size()));
+        return path;
+    }
+
+private:
+    void append_comm(std::size_t channels, std::uint32_t frames, std::size_t bits_per_sample, std::uint32_t rate)
+    {
+        append(static_cast<std::uint16_t>(channels));
+        append(frames);
+        append(static_cast<std::uint16_t>(bits_per_sample));
+
+        // 80 bit extended precision, with an explicit leading mantissa bit
+        std::uint16_t exponent = 16383 + 31;
+        std::uint64_t mantissa = rate;
+        while ((mantissa & 0x80000000) == 0)
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+        append(exponent);
+        append(mantissa << 32);
+    }
+
+    std::vector<unsigned char> bytes_;
+};
+
+template<typename SampleValueType>
+static void check_network_samples(
+    const const_network_interleaved_span<SampleValueType>& span, const interleaved<SampleValueType>& expected)
+{
+    ASSERT_EQ(span.channels(), expected.channels());
+    ASSERT_EQ(span.frames(), expected.frames());
+    interleaved<SampleValueType> output(span.channels(), span.frames());
+    transform(span.begin(), span.end(), output.begin());
+    EXPECT_EQ(output, expected);
+}
+
+template<typename SampleValueType>
+class AiffFile : public ::testing::Test
+{
+public:
+    static constexpr std::size_t bits_per_sample = sizeof(sample<SampleValueType>) * 8;
+};
+
+#if !defined(RATL_CPP_VERSION_HAS_CPP17)
+template<typename SampleValueType>
+constexpr std::size_t AiffFile<SampleValueType>::bits_per_sample;
+#endif
+
+using PossibleAiffSampleValueTypes = ::testing::Types<int16_t, int24_t, int32_t>;
+TYPED_TEST_SUITE(AiffFile, PossibleAiffSampleValueTypes, );
+
+TYPED_TEST(AiffFile, Read)
+{
+    auto expected = make_samples<TypeParam>(3, 37);
+    auto network_samples = to_network(expected);
+    AiffBuilder builder;
+    builder.comm(3, 37, TestFixture::bits_per_sample, 44100);
+    builder.ssnd(network_samples.data(), network_samples.samples() * sizeof(network_sample<TypeParam>));
+    aiff_file file(builder.write("aiff_file_read.aiff"));
+
+    EXPECT_FALSE(file.is_aifc());
+    EXPECT_EQ(file.channels(), 3);
+    EXPECT_EQ(file.frames(), 37);
+    EXPECT_EQ(file.sample_rate(), 44100);
+    EXPECT_EQ(file.bits_per_sample(), TestFixture::bits_per_sample);
+    EXPECT_FALSE(file.is_float());
+    EXPECT_TRUE(file.is_big_endian());
+    EXPECT_TRUE(file.template holds_network<TypeParam>());
+    check_network_samples(file.template network_samples<TypeParam>(), expected);
+#if defined(RATL_CPP_LITTLE_ENDIAN)
+    EXPECT_FALSE(file.template holds<TypeParam>());
+    EXPECT_THROW(file.template samples<TypeParam>(), std::invalid_argument);
+#endif
+}
+
+TYPED_TEST(AiffFile, Twos)
+{
+    auto expected = make_samples<TypeParam>(2, 20);
+    auto network_samples = to_network(expected);
+    AiffBuilder builder("AIFC");
+    builder.chunk("FVER", {0xa2, 0x80, 0x51, 0x40});
+    builder.aifc_comm(2, 20, TestFixture::bits_per_sample, "twos");
+    builder.ssnd(network_samples.data(), network_samples.samples() * sizeof(network_sample<TypeParam>));
+    aiff_file file(builder.write("aiff_file_twos.aifc"));
+
+    EXPECT_TRUE(file.is_aifc());
+    EXPECT_EQ(file.sample_rate(), 48000);
+    check_network_samples(file.template network_samples<TypeParam>(), expected);
+}
+
+TYPED_TEST(AiffFile, Sowt)
+{
+    auto expected = make_samples<TypeParam>(2, 20);
+    AiffBuilder builder("AIFC");
+    builder.aifc_comm(2, 20, TestFixture::bits_per_sample, "sowt");
+    builder.ssnd(expected.data(), expected.samples() * sizeof(sample<TypeParam>));
+    aiff_file file(builder.write("aiff_file_sowt.aifc"));
+
+    EXPECT_FALSE(file.is_big_endian());
+    EXPECT_FALSE(file.template holds_network<TypeParam>());
+#if defined(RATL_CPP_LITTLE_ENDIAN)
+    auto span = file.template samples<TypeParam>();
+    ASSERT_EQ(span.frames(), 20);
+    EXPECT_EQ(span[19][1], expected[19][1]);
+    EXPECT_EQ(span[0][0], expected[0][0]);
+#endif
+}
+
+TEST(AiffFile, Float)
+{
+    auto expected = make_samples<float32_t>(4, 11);
+    auto network_samples = to_network(expected);
+    AiffBuilder builder("AIFC");
+    builder.aifc_comm(4, 11, 32, "fl32");
+    builder.ssnd(network_samples.data(), network_samples.samples() * sizeof(network_sample<float32_t>));
+    aiff_file file(builder.write("aiff_file_float.aifc"));
+
+    EXPECT_TRUE(file.is_float());
+    EXPECT_FALSE(file.holds_network<int32_t>());
+    check_network_samples(file.network_samples<float32_t>(), expected);
+
+    // the byte swap is fused into the conversion
+    noninterleaved<int16_t> output(4, 11);
+    noninterleaved<int16_t> expected_output(4, 11);
+    auto span = file.network_samples<float32_t>();
+    transform(span.begin(), span.end(), output.begin());
+    transform(expected.begin(), expected.end(), expected_output.begin());
+    EXPECT_EQ(output, expected_output);
+}
+
+TEST(AiffFile, ChunkOrder)
+{
+    // the COMM chunk can follow the SSND chunk, and unknown chunks are skipped
+    auto expected = make_samples<int16_t>(1, 9);
+    auto network_samples = to_network(expected);
+    AiffBuilder builder;
+    builder.chunk("NAME", {'a', 'b', 'c'});
+    builder.ssnd(network_samples.data(), network_samples.samples() * sizeof(network_sample<int16_t>));
+    builder.comm(1, 9, 16, 96000);
+    aiff_file file(builder.write("aiff_file_order.aiff"));
+    EXPECT_EQ(file.sample_rate(), 96000);
+    check_network_samples(file.network_samples<int16_t>(), expected);
+}
+
+TEST(AiffFile, ValidBits)
+{
+    // 20 bit samples are stored left justified in 24 bit containers
+    auto expected = make_samples<int24_t>(2, 5);
+    auto network_samples = to_network(expected);
+    AiffBuilder builder;
+    builder.comm(2, 5, 20, 48000);
+    builder.ssnd(network_samples.data(), network_samples.samples() * sizeof(network_sample<int24_t>));
+    aiff_file file(builder.write("aiff_file_20bit.aiff"));
+    EXPECT_EQ(file.bits_per_sample(), 24);
+    EXPECT_EQ(file.valid_bits_per_sample(), 20);
+    check_network_samples(file.network_samples<int24_t>(), expected);
+}
+
+TEST(AiffFile, Truncated)
+{
+    // COMM claims more frames than were written, as an interrupted recording would leave it
+    auto expected = make_samples<int16_t>(2, 10);
+    auto network_samples = to_network(expected);
+    AiffBuilder builder;
+    builder.comm(2, 1000, 16, 48000);
+    builder.ssnd(network_samples.data(), network_samples.samples() * sizeof(network_sample<int16_t>));
+    aiff_file file(builder.write("aiff_file_truncated.aiff"));
+    EXPECT_EQ(file.frames(), 10);
+
+    auto span = file.network_samples<int16_t>(4, 6);
+    EXPECT_EQ(span.frames(), 6);
+    EXPECT_EQ(span[0][1], network_samples[4][1]);
+    EXPECT_THROW(file.network_samples<int16_t>(5, 6), std::out_of_range);
+    file.will_need(0, 10);
+    file.dont_need(0, 10);
+}
+
+TEST(AiffFile, Errors)
+{
+    EXPECT_THROW(aiff_file(::testing::TempDir() + "aiff_file_missing.aiff"), std::system_error);
+
+    AiffBuilder not_aiff("WAVE");
+    EXPECT_THROW(aiff_file(not_aiff.write("aiff_file_wave.aiff")), std::runtime_error);
+
+    AiffBuilder no_ssnd;
+    no_ssnd.comm(2, 0, 16, 48000);
+    EXPECT_THROW(aiff_file(no_ssnd.write("aiff_file_no_ssnd.aiff")), std::runtime_error);
+
+    AiffBuilder compressed("AIFC");
+    compressed.aifc_comm(2, 1, 16, "ulaw");
+    compressed.ssnd("\0\0\0\0", 4);
+    EXPECT_THROW(aiff_file(compressed.write("aiff_file_ulaw.aifc")), std::runtime_error);
+
+    AiffBuilder eight_bit;
+    eight_bit.comm(2, 1, 8, 48000);
+    eight_bit.ssnd("\0\0", 2);
+    EXPECT_THROW(aiff_file(eight_bit.write("aiff_file_8bit.aiff")), std::runtime_error);
+
+    // 32 bit samples that the SSND offset leaves unaligned can't be viewed in place
+    auto samples = to_network(make_samples<int32_t>(1, 4));
+    AiffBuilder unaligned;
+    unaligned.comm(1, 4, 32, 48000);
+    unaligned.ssnd(samples.data(), samples.samples() * sizeof(network_sample<int32_t>), true);
+    aiff_file file(unaligned.write("aiff_file_unaligned.aiff"));
+    EXPECT_FALSE(file.holds_network<int32_t>());
+    EXPECT_THROW(file.network_samples<int32_t>(), std::invalid_argument);
+}
+
+} // namespace test
+} // namespace ratl
@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <cstdint>
+
+namespace ratl
+{
+namespace test
+{
+static bool is_arena_aligned(const void* data)
+{
+    return (reinterpret_cast<std::uintptr_t>(data) % arena::alignment()) == 0;
+}
+
+// Arena
+
+TEST(Arena, Alignment)
+{
+    arena test_arena(4096);
+    EXPECT_TRUE(is_arena_aligned(test_arena.allocate(1)));
+    EXPECT_TRUE(is_arena_aligned(test_arena.allocate(3)));
+    EXPECT_TRUE(is_arena_aligned(test_arena.allocate(arena::alignment() + 1)));
+}
+
+TEST(Arena, ExternalStorageAlignment)
+{
+    unsigned char buffer[1024];
+    arena test_arena(buffer + 1, sizeof(buffer) - 1);
+    EXPECT_LE(test_arena.capacity(), sizeof(buffer) - 1);
+    EXPECT_TRUE(is_arena_aligned(test_arena.allocate(1)));
+}
+
+TEST(Arena, SizeClasses)
+{
+    arena test_arena(4096);
+    test_arena.allocate(1);
+    EXPECT_EQ(test_arena.used(), arena::alignment());
+    test_arena.allocate(arena::alignment() + 1);
+    EXPECT_EQ(test_arena.used(), 3 * arena::alignment());
+    test_arena.allocate(3 * arena::alignment());
+    EXPECT_EQ(test_arena.used(), 7 * arena::alignment());
+}
+
+TEST(Arena, FreeListReuse)
+{
+    arena test_arena(4096);
+    auto* first = test_arena.allocate(100);
+    auto* second = test_arena.allocate(10);
+    auto used = test_arena.used();
+
+    test_arena.deallocate(first, 100);
+    test_arena.deallocate(second, 10);
+
+    // blocks of the same size class are reused in LIFO order without carving more storage
+    EXPECT_EQ(test_arena.allocate(10), second);
+    EXPECT_EQ(test_arena.allocate(100), first);
+    EXPECT_EQ(test_arena.used(), used);
+}
+
+TEST(Arena, Reset)
+{
+    arena test_arena(4096);
+    auto* first = test_arena.allocate(100);
+    test_arena.allocate(1000);
+    test_arena.reset();
+    EXPECT_EQ(test_arena.used(), 0);
+    EXPECT_EQ(test_arena.allocate(100), first);
+}
+
+TEST(Arena, Exhausted)
+{
+    arena test_arena(4 * arena::alignment());
+    test_arena.allocate(2 * arena::alignment());
+    EXPECT_THROW(test_arena.allocate(3 * arena::alignment()), std::bad_alloc);
+    test_arena.allocate(2 * arena::alignment());
+    EXPECT_THROW(test_arena.allocate(1), std::bad_alloc);
+    EXPECT_THROW(test_arena.allocate(std::numeric_limits<std::size_t>::max() / 2), std::bad_alloc);
+}
+
+// ArenaAllocator
+
+template<typename SampleValueType>
+class ArenaAllocator : public ::testing::Test
+{
+};
+
+TYPED_TEST_SUITE(ArenaAllocator, PossibleSampleValueTypes, );
+
+TYPED_TEST(ArenaAllocator, Interleaved)
+{
+    using sample_type = sample<TypeParam>;
+    arena test_arena(16384);
+    arena_allocator<sample_type> alloc(test_arena);
+    {
+        basic_interleaved<sample_type, arena_allocator<sample_type>> container(4, 32, alloc);
+        EXPECT_EQ(container.get_allocator(), alloc);
+        EXPECT_TRUE(is_arena_aligned(container.data()));
+        EXPECT_GE(test_arena.used(), container.samples() * sizeof(sample_type));
+        for (auto frame : container)
+        {
+            for (auto& s : frame)
+            {
+                EXPECT_EQ(s, sample_type());
+            }
+        }
+
+        auto copy = container;
+        EXPECT_EQ(copy.get_allocator(), alloc);
+        EXPECT_EQ(copy, container);
+    }
+
+    // both containers have been returned to the free list
+    auto used = test_arena.used();
+    basic_interleaved<sample_type, arena_allocator<sample_type>> container(4, 32, alloc);
+    basic_interleaved<sample_type, arena_allocator<sample_type>> other(4, 32, alloc);
+    EXPECT_EQ(test_arena.used(), used);
+}
+
+TYPED_TEST(ArenaAllocator, Noninterleaved)
+{
+    using sample_type = network_sample<TypeParam>;
+    arena test_arena(16384);
+    arena_allocator<sample_type> alloc(test_arena);
+    basic_noninterleaved<sample_type, arena_allocator<sample_type>> container(4, 32, alloc);
+    EXPECT_EQ(container.get_allocator(), alloc);
+    EXPECT_TRUE(is_arena_aligned(container.data()));
+
+    basic_noninterleaved<sample_type, arena_allocator<sample_type>> moved(std::move(container));
+    EXPECT_EQ(moved.get_allocator(), alloc);
+    EXPECT_EQ(moved.channels(), 4);
+    EXPECT_EQ(moved.frames(), 32);
+}
+
+TEST(ArenaAllocator, Equality)
+{
+    arena first_arena(1024);
+    arena second_arena(1024);
+    arena_allocator<sample<float32_t>> first(first_arena);
+    arena_allocator<sample<int16_t>> rebound(first);
+    arena_allocator<sample<float32_t>> second(second_arena);
+    EXPECT_TRUE(first == rebound);
+    EXPECT_TRUE(first != second);
+}
+
+#if defined(RATL_HAS_MEMORY_RESOURCE)
+
+TEST(ArenaResource, PolymorphicInterleaved)
+{
+    arena test_arena(16384);
+    pmr::arena_resource resource(test_arena);
+    pmr::interleaved<float32_t> container(4, 32, &resource);
+    EXPECT_TRUE(is_arena_aligned(container.data()));
+    EXPECT_GE(test_arena.used(), container.samples() * sizeof(sample<float32_t>));
+}
+
+TEST(ArenaResource, PolymorphicNoninterleaved)
+{
+    arena test_arena(16384);
+    pmr::arena_resource resource(test_arena);
+    pmr::network_noninterleaved<int24_t> container(4, 32, &resource);
+    EXPECT_TRUE(is_arena_aligned(container.data()));
+    EXPECT_GE(test_arena.used(), container.samples() * sizeof(network_sample<int24_t>));
+}
+
+#endif
+
+} // namespace test
+} // namespace ratl
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleValueType>
+static interleaved<SampleValueType> make_samples(std::size_t channels, std::size_t frames)
+{
+    interleaved<SampleValueType> samples(channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+            samples[frame_num][channel_num] = reference_convert<sample<SampleValueType>>(sample<int32_t>(value));
+        }
+    }
+    return samples;
+}
+
+template<typename SampleValueType>
+static network_interleaved<SampleValueType> to_network(const interleaved<SampleValueType>& samples)
+{
+    network_interleaved<SampleValueType> network_samples(samples.channels(), samples.frames());
+    transform(samples.begin(), samples.end(), network_samples.begin());
+    return network_samples;
+}
+
+// Assembles CAF files a chunk at a time
+class CafBuilder
+{
+public:
+    CafBuilder()
+    {
+        append_id("caff");
+        append(std::uint16_t(1));
+        append(std::uint16_t(0));
+    }
+
+    template<typename Tp>
+    void append(Tp value)
+    {
+        for (std::size_t byte_num = sizeof(Tp); byte_num > 0; --byte_num)
+        {
+            auto byte = (static_cast<std::uint64_t>(value) >> ((byte_num - 1) * 8)) & 0xff;
+            bytes_.push_back(static_cast<unsigned char>(byte));
+        }
+    }
+
+    void append_id(const char* id)
+    {
+        bytes_.insert(bytes_.end(), id, id + 4);
+    }
+
+    void chunk(const char* id, const std::vector<unsigned char>& body)
+    {
+        append_id(id);
+        append(static_cast<std::uint64_t>(body.size()));
+        bytes_.insert(bytes_.end(), body.begin(), body.end());
+    }
+
+    void desc(
+        double sample_rate,
+        std::uint32_t format_flags,
+        std::size_t channels,
+        std::size_t bits_per_sample,
+        const char* format_id = "lpcm")
+    {
+        std::uint64_t rate_bits;
+        std::memcpy(&rate_bits, &sample_rate, sizeof(rate_bits));
+        append_id("desc");
+        append(std::uint64_t(32));
+        append(rate_bits);
+        append_id(format_id);
+        append(format_flags);
+        append(static_cast<std::uint32_t>(channels * (bits_per_sample / 8)));
+        append(std::uint32_t(1));
+        append(static_cast<std::uint32_t>(channels));
+        append(static_cast<std::uint32_t>(bits_per_sample));
+    }
+
+    // Writes a data chunk, padding the chunk before it so that the samples are aligned to 4 bytes
+    void data(const void* data, std::size_t size, std::uint64_t chunk_size)
+    {
+        auto padding = (4 - ((bytes_.size() + 16 + 12) % 4)) % 4;
+        chunk("free", std::vector<unsigned char>(padding, 0));
+        append_id("data");
+        append(chunk_size);
+        append(std::uint32_t(0));
+        auto bytes = static_cast<const unsigned char*>(data);
+        bytes_.insert(bytes_.end(), bytes, bytes + size);
+    }
+
+    void data(const void* data, std::size_t size)
+    {
+        this->data(data, size, size + 4);
+    }
+
+    std::string write(const std::string& name)
+    {
+        auto path = ::testing::TempDir() + name;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes_.data()), static_cast<std::streamsize>(bytes_.size()));
+        return path;
+    }
+
+private:
+    std::vector<unsigned char> bytes_;
+};
+
+template<typename SampleValueType>
+class CafFile : public ::testing::Test
+{
+public:
+    static constexpr std::size_t bits_per_sample = sizeof(sample<SampleValueType>) * 8;
+    static constexpr std::uint32_t float_flag = std::is_same<SampleValueType, float32_t>::value ? 1 : 0;
+};
+
+#if !defined(RATL_CPP_VERSION_HAS_CPP17)
+template<typename SampleValueType>
+constexpr std::size_t CafFile<SampleValueType>::bits_per_sample;
+template<typename SampleValueType>
+constexpr std::uint32_t CafFile<SampleValueType>::float_flag;
+#endif
+
+TYPED_TEST_SUITE(CafFile, PossibleSampleValueTypes, );
+
+TYPED_TEST(CafFile, BigEndian)
+{
+    auto expected = make_samples<TypeParam>(3, 29);
+    auto network_samples = to_network(expected);
+    CafBuilder builder;
+    builder.desc(44100.0, TestFixture::float_flag, 3, TestFixture::bits_per_sample);
+    builder.data(network_samples.data(), network_samples.samples() * sizeof(network_sample<TypeParam>));
+    caf_file file(builder.write("caf_file_big_endian.caf"));
+
+    EXPECT_EQ(file.channels(), 3);
+    EXPECT_EQ(file.frames(), 29);
+    EXPECT_EQ(file.sample_rate(), 44100);
+    EXPECT_EQ(file.bits_per_sample(), TestFixture::bits_per_sample);
+    EXPECT_EQ(file.is_float(), TestFixture::float_flag != 0);
+    EXPECT_TRUE(file.is_big_endian());
+    ASSERT_TRUE(file.template holds_network<TypeParam>());
+
+    // the byte swap is fused into the conversion
+    auto span = file.template network_samples<TypeParam>();
+    noninterleaved<float32_t> output(3, 29);
+    noninterleaved<float32_t> expected_output(3, 29);
+    transform(span.begin(), span.end(), output.begin());
+    transform(expected.begin(), expected.end(), expected_output.begin());
+    EXPECT_EQ(output, expected_output);
+}
+
+TYPED_TEST(CafFile, LittleEndian)
+{
+    auto expected = make_samples<TypeParam>(2, 17);
+    CafBuilder builder;
+    builder.desc(48000.0, TestFixture::float_flag | 2, 2, TestFixture::bits_per_sample);
+    builder.data(expected.data(), expected.samples() * sizeof(sample<TypeParam>));
+    caf_file file(builder.write("caf_file_little_endian.caf"));
+
+    EXPECT_FALSE(file.is_big_endian());
+    EXPECT_FALSE(file.template holds_network<TypeParam>());
+#if defined(RATL_CPP_LITTLE_ENDIAN)
+    auto span = file.template samples<TypeParam>();
+    ASSERT_EQ(span.frames(), 17);
+    for (std::size_t frame_num = 0; frame_num < 17; ++frame_num)
+    {
+        EXPECT_EQ(span[frame_num][0], expected[frame_num][0]);
+        EXPECT_EQ(span[frame_num][1], expected[frame_num][1]);
+    }
+#endif
+}
+
+TEST(CafFile, UnknownDataSize)
+{
+    // a data size of -1 runs to the end of the file, and any partial frame is dropped
+    auto expected = make_samples<int16_t>(2, 8);
+    auto network_samples = to_network(expected);
+    CafBuilder builder;
+    builder.chunk("info", {0, 0, 0, 0});
+    builder.desc(96000.0, 0, 2, 16);
+    builder.data(network_samples.data(), network_samples.samples() * sizeof(network_sample<int16_t>) - 1, ~0ull);
+    EXPECT_THROW(caf_file(builder.write("caf_file_desc_not_first.caf")), std::runtime_error);
+
+    CafBuilder unknown_size;
+    unknown_size.desc(96000.0, 0, 2, 16);
+    unknown_size.data(network_samples.data(), network_samples.samples() * sizeof(network_sample<int16_t>) - 1, ~0ull);
+    caf_file file(unknown_size.write("caf_file_unknown_size.caf"));
+    EXPECT_EQ(file.sample_rate(), 96000);
+    EXPECT_EQ(file.frames(), 7);
+    auto span = file.network_samples<int16_t>(2, 5);
+    EXPECT_EQ(span[0][0], network_samples[2][0]);
+    EXPECT_EQ(span[4][1], network_samples[6][1]);
+    EXPECT_THROW(file.network_samples<int16_t>(3, 5), std::out_of_range);
+}
+
+TEST(CafFile, Errors)
+{
+    EXPECT_THROW(caf_file(::testing::TempDir() + "caf_file_missing.caf"), std::system_error);
+
+    CafBuilder aac;
+    aac.desc(48000.0, 0, 2, 16, "aac ");
+    aac.data("\0\0\0\0", 4);
+    EXPECT_THROW(caf_file(aac.write("caf_file_aac.caf")), std::runtime_error);
+
+    CafBuilder no_data;
+    no_data.desc(48000.0, 0, 2, 16);
+    EXPECT_THROW(caf_file(no_data.write("caf_file_no_data.caf")), std::runtime_error);
+
+    CafBuilder float64;
+    float64.desc(48000.0, 1, 2, 64);
+    float64.data("\0\0\0\0", 4);
+    EXPECT_THROW(caf_file(float64.write("caf_file_float64.caf")), std::runtime_error);
+}
+
+} // namespace test
+} // namespace ratl
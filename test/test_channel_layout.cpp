@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <algorithm>
+#include <cstdint>
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleType>
+static SampleType sample_for(std::size_t channel_num, std::size_t frame_num)
+{
+    auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+    return reference_convert<SampleType>(sample<int32_t>(value));
+}
+
+template<typename ContainerType>
+static void fill_container(ContainerType& container)
+{
+    using sample_type = typename ContainerType::sample_type;
+    for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < container.frames(); ++frame_num)
+        {
+            container.channel(channel_num)[frame_num] = sample_for<sample_type>(channel_num, frame_num);
+        }
+    }
+}
+
+template<typename ContainerType>
+static void check_container(const ContainerType& container, std::size_t old_channels, std::size_t old_frames)
+{
+    using sample_type = typename ContainerType::sample_type;
+    for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < container.pitch(); ++frame_num)
+        {
+            auto actual = container.data()[(channel_num * container.pitch()) + frame_num];
+            if ((channel_num < old_channels) && (frame_num < old_frames) && (frame_num < container.frames()))
+            {
+                EXPECT_EQ(actual, sample_for<sample_type>(channel_num, frame_num));
+            }
+            else
+            {
+                // includes the padding at the end of each channel
+                EXPECT_EQ(actual, sample_type());
+            }
+        }
+    }
+}
+
+TEST(ChannelLayout, PackedPitch)
+{
+    EXPECT_EQ(packed_channel_layout::pitch<sample<int16_t>>(441), 441);
+    EXPECT_EQ(packed_channel_layout::pitch<sample<int24_t>>(480), 480);
+}
+
+TEST(ChannelLayout, AlignedPitch)
+{
+    EXPECT_EQ(aligned_channel_layout<64>::pitch<sample<int16_t>>(441), 448);
+    EXPECT_EQ(aligned_channel_layout<64>::pitch<sample<int16_t>>(480), 480);
+    EXPECT_EQ(aligned_channel_layout<64>::pitch<sample<int24_t>>(441), 448);
+    EXPECT_EQ(aligned_channel_layout<64>::pitch<sample<int24_t>>(480), 512);
+    EXPECT_EQ(aligned_channel_layout<64>::pitch<sample<int32_t>>(441), 448);
+    EXPECT_EQ(aligned_channel_layout<64>::pitch<sample<float32_t>>(1), 16);
+    EXPECT_EQ(aligned_channel_layout<16>::pitch<sample<float32_t>>(5), 8);
+    EXPECT_EQ(aligned_channel_layout<64>::pitch<sample<float32_t>>(0), 0);
+}
+
+template<typename ContainerType>
+class AlignedNoninterleaved : public ::testing::Test
+{
+};
+
+using PossibleAlignedNoninterleaved = ::testing::Types<
+    aligned_noninterleaved<int16_t>,
+    aligned_noninterleaved<int24_t>,
+    aligned_noninterleaved<int32_t>,
+    aligned_noninterleaved<float32_t>,
+    network_aligned_noninterleaved<int24_t>>;
+
+TYPED_TEST_SUITE(AlignedNoninterleaved, PossibleAlignedNoninterleaved, );
+
+TYPED_TEST(AlignedNoninterleaved, ChannelsShareAlignment)
+{
+    using sample_type = typename TypeParam::sample_type;
+    TypeParam container(6, 441);
+    EXPECT_GT(container.pitch(), container.frames());
+    EXPECT_EQ(container.capacity(), 6 * container.pitch());
+    for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+    {
+        auto offset = static_cast<std::size_t>(container.channel(channel_num).data() - container.data());
+        EXPECT_EQ((offset * sizeof(sample_type)) % RATL_SIMD_ALIGNMENT, 0);
+    }
+    check_container(container, 0, 0);
+}
+
+TYPED_TEST(AlignedNoninterleaved, Iterators)
+{
+    TypeParam container(3, 5);
+    fill_container(container);
+    std::size_t channel_num = 0;
+    for (auto channel : container)
+    {
+        EXPECT_EQ(channel.data(), container.data() + (channel_num * container.pitch()));
+        EXPECT_EQ(channel.samples(), 5);
+        ++channel_num;
+    }
+    EXPECT_EQ(channel_num, 3);
+    EXPECT_EQ(container.begin().pitch(), container.pitch());
+    EXPECT_EQ(container.back().data(), container.data() + (2 * container.pitch()));
+    EXPECT_EQ(container.frame(4)[2], container.channel(2)[4]);
+}
+
+TYPED_TEST(AlignedNoninterleaved, Span)
+{
+    using span_type = basic_noninterleaved_span<
+        typename TypeParam::sample_type,
+        detail::sample_traits<typename TypeParam::sample_type>>;
+    TypeParam container(3, 5);
+    fill_container(container);
+    auto span = span_type(container);
+    EXPECT_EQ(span.pitch(), container.pitch());
+    EXPECT_EQ(span.channel(2)[4], container.channel(2)[4]);
+}
+
+TYPED_TEST(AlignedNoninterleaved, CopyAndEquality)
+{
+    TypeParam container(3, 5);
+    fill_container(container);
+    TypeParam copy(container);
+    EXPECT_EQ(copy, container);
+    check_container(copy, 3, 5);
+
+    // padding does not take part in comparisons
+    copy.data()[copy.pitch() - 1] = copy.channel(0)[0];
+    EXPECT_EQ(copy, container);
+    copy.channel(1)[1] = copy.channel(0)[0];
+    EXPECT_NE(copy, container);
+}
+
+TYPED_TEST(AlignedNoninterleaved, Resize)
+{
+    TypeParam container(3, 5);
+    fill_container(container);
+
+    // grows the pitch
+    container.resize(3, 100);
+    check_container(container, 3, 5);
+
+    // shrinks the pitch without reallocating
+    fill_container(container);
+    auto data = container.data();
+    container.resize(4, 20);
+    EXPECT_EQ(container.data(), data);
+    check_container(container, 3, 20);
+
+    // keeps the pitch
+    fill_container(container);
+    container.resize(2, 3);
+    EXPECT_EQ(container.data(), data);
+    check_container(container, 2, 3);
+    container.resize(2, 9);
+    check_container(container, 2, 3);
+
+    container.shrink_to_fit();
+    EXPECT_EQ(container.capacity(), 2 * container.pitch());
+    check_container(container, 2, 3);
+}
+
+TYPED_TEST(AlignedNoninterleaved, ForOverwrite)
+{
+    using sample_type = typename TypeParam::sample_type;
+    TypeParam container(for_overwrite, 3, 37);
+    fill_container(container);
+    check_container(container, 3, 37);
+
+    // the padding is zeroed even though the samples aren't
+    std::fill_n(container.data(), container.capacity(), sample_for<sample_type>(0, 0));
+    container.resize(for_overwrite, 4, 20);
+    fill_container(container);
+    check_container(container, 4, 20);
+}
+
+TYPED_TEST(AlignedNoninterleaved, TransformBetweenAligned)
+{
+    // buffers with the same pitch are converted as a single block, including the padding between channels
+    using sample_type = typename TypeParam::sample_type;
+    aligned_noninterleaved<float32_t> input(3, 125);
+    fill_container(input);
+    TypeParam output(3, 125);
+    ASSERT_EQ(output.pitch(), input.pitch());
+    ASSERT_GT(output.pitch(), output.frames());
+    std::fill_n(output.data(), output.capacity(), sample_for<sample_type>(0, 0));
+    transform(input.begin(), input.end(), output.begin());
+    check_container(output, 3, 125);
+
+    basic_noninterleaved<sample_type> packed(3, 125);
+    transform(input.begin(), input.end(), packed.begin());
+    EXPECT_EQ(output, packed);
+
+    // converted padding is zeroed again after dithering
+    dither_generator dither_gen;
+    auto end = transform(input.begin(), input.end(), output.begin(), dither_gen);
+    EXPECT_EQ(end, output.end());
+    for (std::size_t channel_num = 0; channel_num < output.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = output.frames(); frame_num < output.pitch(); ++frame_num)
+        {
+            EXPECT_EQ(output.data()[(channel_num * output.pitch()) + frame_num], sample_type());
+        }
+    }
+}
+
+TYPED_TEST(AlignedNoninterleaved, TransformRoundTrip)
+{
+    TypeParam container(3, 37);
+    fill_container(container);
+    interleaved<float32_t> intermediate(3, 37);
+    TypeParam output(3, 37);
+    transform(container.begin(), container.end(), intermediate.begin());
+    transform(intermediate.begin(), intermediate.end(), output.begin());
+    EXPECT_EQ(output, container);
+    check_container(output, 3, 37);
+
+    basic_noninterleaved<typename TypeParam::sample_type> packed(3, 37);
+    transform(container.begin(), container.end(), packed.begin());
+    EXPECT_EQ(packed, container);
+    TypeParam aligned(3, 37);
+    transform(packed.begin(), packed.end(), aligned.begin());
+    EXPECT_EQ(aligned, container);
+}
+
+} // namespace test
+} // namespace ratl
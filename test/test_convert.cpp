@@ -554,5 +554,66 @@ TYPED_TEST(ConvertFloatInputNegativeTransparent, FloatInputConvert)
     }
 }
 
+// ConvertComposition
+
+template<typename InputSampleType, typename OutputSampleType>
+struct SampleTypeCombination
+{
+    using input_sample_type = InputSampleType;
+    using output_sample_type = OutputSampleType;
+};
+
+using PossibleSampleTypeCombinations =
+    testing_types_combine_t<SampleTypeCombination, PossibleSampleTypes, PossibleSampleTypes>;
+
+template<typename SampleTypeCombination>
+class ConvertComposition : public ::testing::Test
+{
+public:
+    using input_sample_type = typename SampleTypeCombination::input_sample_type;
+    using output_sample_type = typename SampleTypeCombination::output_sample_type;
+    using host_input_sample_type = sample<typename input_sample_type::sample_value_type>;
+    using host_output_sample_type = sample<typename output_sample_type::sample_value_type>;
+};
+
+TYPED_TEST_SUITE(ConvertComposition, PossibleSampleTypeCombinations, );
+
+// Every conversion, including the fused network conversions, must match converting through host samples
+TYPED_TEST(ConvertComposition, MatchesHostConversion)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+    using host_input_sample_type = typename TestFixture::host_input_sample_type;
+    using host_output_sample_type = typename TestFixture::host_output_sample_type;
+    using int32_sample_limits = sample_limits<int32_t>;
+    for (std::int64_t i = int32_sample_limits::min(); i <= static_cast<std::int64_t>(int32_sample_limits::max());
+         i += 0x3ffff)
+    {
+        auto input = reference_convert<input_sample_type>(sample<int32_t>(static_cast<int32_t>(i)));
+        EXPECT_EQ(
+            reference_convert<output_sample_type>(input),
+            reference_convert<output_sample_type>(
+                reference_convert<host_output_sample_type>(reference_convert<host_input_sample_type>(input))));
+        EXPECT_EQ(
+            fast_convert<output_sample_type>(input),
+            fast_convert<output_sample_type>(
+                fast_convert<host_output_sample_type>(fast_convert<host_input_sample_type>(input))));
+    }
+}
+
+TEST(ConvertNetwork, Resize)
+{
+    auto int16_input = static_cast<uint16_t>(0xcdab);
+    auto int24_output = static_cast<uint24_t>(0x00cdab);
+    auto int32_output = static_cast<uint32_t>(0x0000cdab);
+    auto input = network_sample<int16_t>(detail::network_underlying_to_network_cast<int16_t>(int16_input));
+    auto output = fast_convert<network_sample<int24_t>>(input);
+    EXPECT_EQ(output, network_sample<int24_t>(detail::network_underlying_to_network_cast<int24_t>(int24_output)));
+    EXPECT_EQ(
+        fast_convert<network_sample<int32_t>>(output),
+        network_sample<int32_t>(detail::network_underlying_to_network_cast<int32_t>(int32_output)));
+    EXPECT_EQ(fast_convert<network_sample<int16_t>>(fast_convert<network_sample<int32_t>>(input)), input);
+}
+
 } // namespace test
 } // namespace ratl
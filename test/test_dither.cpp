@@ -69,5 +69,29 @@ TYPED_TEST(DitherGeneratorTest, Float32Limits)
     EXPECT_LE(min, limit_min * 0.95);
 }
 
+template<typename Generator>
+class SeededDitherGeneratorTest : public testing::Test
+{
+};
+
+using SeededDitherGenerators =
+    testing::Types<ratl::detail::triangular_dither_generator, ratl::detail::shaped_dither_generator>;
+TYPED_TEST_SUITE(SeededDitherGeneratorTest, SeededDitherGenerators, );
+
+TYPED_TEST(SeededDitherGeneratorTest, Seed)
+{
+    TypeParam first(1234);
+    TypeParam same(1234);
+    TypeParam other(1235);
+    auto differs = false;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        auto value = first.generate_int16();
+        EXPECT_EQ(value, same.generate_int16());
+        differs = differs || value != other.generate_int16();
+    }
+    EXPECT_TRUE(differs);
+}
+
 } // namespace test
 } // namespace ratl
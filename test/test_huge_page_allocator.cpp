@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <cstdint>
+
+namespace ratl
+{
+namespace test
+{
+static bool is_page_aligned(const void* data)
+{
+    return (reinterpret_cast<std::uintptr_t>(data) % detail::page_size()) == 0;
+}
+
+// PageMapping
+
+TEST(PageMapping, MappingSize)
+{
+    EXPECT_EQ(detail::page_mapping_size(1), detail::page_size());
+    EXPECT_EQ(detail::page_mapping_size(detail::page_size() + 1), 2 * detail::page_size());
+    EXPECT_EQ(detail::page_mapping_size(detail::huge_page_size()), detail::huge_page_size());
+    EXPECT_EQ(detail::page_mapping_size(detail::huge_page_size() + 1), 2 * detail::huge_page_size());
+}
+
+// HugePageAllocator
+
+template<typename SampleValueType>
+class HugePageAllocator : public ::testing::Test
+{
+};
+
+TYPED_TEST_SUITE(HugePageAllocator, PossibleSampleValueTypes, );
+
+template<typename ContainerType>
+static void test_huge_page_container(const page_options& options, std::size_t channels, std::size_t frames)
+{
+    using sample_type = typename ContainerType::sample_type;
+    using allocator_type = typename ContainerType::allocator_type;
+
+    ContainerType container(channels, frames, allocator_type(options));
+    EXPECT_TRUE(is_page_aligned(container.data()));
+    EXPECT_EQ(container.channels(), channels);
+    EXPECT_EQ(container.frames(), frames);
+    EXPECT_EQ(container.data()[0], sample_type());
+    EXPECT_EQ(container.data()[container.samples() - 1], sample_type());
+
+    container.data()[container.samples() - 1] = reference_convert<sample_type>(sample<int32_t>(0x10000));
+    auto copy = container;
+    EXPECT_EQ(copy, container);
+}
+
+TYPED_TEST(HugePageAllocator, InterleavedSmall)
+{
+    using container_type = basic_interleaved<sample<TypeParam>, huge_page_allocator<sample<TypeParam>>>;
+    test_huge_page_container<container_type>(page_options(), 2, 16);
+}
+
+TYPED_TEST(HugePageAllocator, NoninterleavedLarge)
+{
+    using container_type = basic_noninterleaved<sample<TypeParam>, huge_page_allocator<sample<TypeParam>>>;
+    auto frames = (2 * detail::huge_page_size()) / sizeof(sample<TypeParam>);
+    test_huge_page_container<container_type>(page_options(), 2, frames + 1);
+}
+
+TYPED_TEST(HugePageAllocator, Prefault)
+{
+    using container_type = basic_interleaved<network_sample<TypeParam>, huge_page_allocator<network_sample<TypeParam>>>;
+    page_options options;
+    options.prefault = true;
+    test_huge_page_container<container_type>(options, 3, 1000);
+}
+
+TYPED_TEST(HugePageAllocator, NoHugePages)
+{
+    using container_type = basic_noninterleaved<sample<TypeParam>, huge_page_allocator<sample<TypeParam>>>;
+    page_options options;
+    options.huge_pages = false;
+    test_huge_page_container<container_type>(options, 1, detail::huge_page_size() / sizeof(sample<TypeParam>));
+}
+
+TEST(HugePageAllocator, Realtime)
+{
+    // keep the locked size small so that it fits within the default locked memory limit
+    huge_page_allocator<sample<float32_t>> alloc(page_options::realtime());
+    auto n = detail::page_size() / sizeof(sample<float32_t>);
+    auto* data = alloc.allocate(n);
+    EXPECT_TRUE(is_page_aligned(data));
+    data[n - 1] = sample<float32_t>(0.5f);
+    alloc.deallocate(data, n);
+}
+
+TEST(HugePageAllocator, Equality)
+{
+    huge_page_allocator<sample<float32_t>> first;
+    huge_page_allocator<sample<int16_t>> second(page_options::realtime());
+    EXPECT_TRUE(first == second);
+    EXPECT_FALSE(first != second);
+    huge_page_allocator<sample<float32_t>> rebound(second);
+    EXPECT_TRUE(rebound.options().lock);
+}
+
+TEST(HugePageAllocator, TooLarge)
+{
+    huge_page_allocator<sample<float32_t>> alloc;
+    EXPECT_THROW(alloc.allocate(std::numeric_limits<std::size_t>::max() / 2), std::bad_alloc);
+}
+
+} // namespace test
+} // namespace ratl
@@ -0,0 +1,378 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace ratl
+{
+namespace test
+{
+static constexpr std::size_t test_channels = 2;
+static constexpr std::size_t test_packet_frames = 48;
+
+// The samples of the stream at each timestamp, never zero so that silence can be told apart
+static sample<int16_t> stream_sample(std::uint32_t timestamp, std::size_t channel_num)
+{
+    return sample<int16_t>(static_cast<int16_t>(((timestamp % 1000) + 1) * (channel_num == 0 ? 1 : -1)));
+}
+
+// Packets of the stream, with payloads in network order
+class TestStream
+{
+public:
+    explicit TestStream(std::size_t packets) : payloads_(test_channels, packets * test_packet_frames)
+    {
+        interleaved<int16_t> samples(test_channels, packets * test_packet_frames);
+        for (std::size_t frame_num = 0; frame_num < samples.frames(); ++frame_num)
+        {
+            for (std::size_t channel_num = 0; channel_num < test_channels; ++channel_num)
+            {
+                samples[frame_num][channel_num] = stream_sample(static_cast<std::uint32_t>(frame_num), channel_num);
+            }
+        }
+        transform(samples.begin(), samples.end(), payloads_.begin());
+    }
+
+    bool push(jitter_buffer<int16_t>& buffer, std::size_t packet_num) const
+    {
+        auto timestamp = static_cast<std::uint32_t>(packet_num * test_packet_frames);
+        return buffer.push(
+            static_cast<std::uint16_t>(packet_num),
+            timestamp,
+            const_network_interleaved_span<int16_t>(
+                payloads_.data() + (timestamp * test_channels), test_channels, test_packet_frames));
+    }
+
+private:
+    network_interleaved<int16_t> payloads_;
+};
+
+static jitter_buffer_options make_options(std::size_t latency_frames, jitter_concealment concealment)
+{
+    jitter_buffer_options options;
+    options.latency_frames = latency_frames;
+    options.capacity_frames = 16 * test_packet_frames;
+    options.max_period_frames = 64;
+    options.concealment = concealment;
+    return options;
+}
+
+// Reads periods of the given sizes in turn until frames frames have been read
+static interleaved<int16_t> read_all(jitter_buffer<int16_t>& buffer, std::size_t frames, std::size_t period)
+{
+    interleaved<int16_t> output(test_channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; frame_num += period)
+    {
+        auto period_frames = std::min(period, frames - frame_num);
+        buffer.read(
+            interleaved_span<int16_t>(output.data() + (frame_num * test_channels), test_channels, period_frames));
+    }
+    return output;
+}
+
+static void expect_stream(
+    const interleaved<int16_t>& output, std::size_t first, std::size_t frames, std::int64_t offset)
+{
+    for (std::size_t frame_num = first; frame_num < first + frames; ++frame_num)
+    {
+        auto timestamp = static_cast<std::uint32_t>(static_cast<std::int64_t>(frame_num) + offset);
+        EXPECT_EQ(output[frame_num][0], stream_sample(timestamp, 0)) << "frame " << frame_num;
+        EXPECT_EQ(output[frame_num][1], stream_sample(timestamp, 1)) << "frame " << frame_num;
+    }
+}
+
+static void expect_silence(const interleaved<int16_t>& output, std::size_t first, std::size_t frames)
+{
+    for (std::size_t frame_num = first; frame_num < first + frames; ++frame_num)
+    {
+        EXPECT_EQ(output[frame_num][0].get(), 0) << "frame " << frame_num;
+        EXPECT_EQ(output[frame_num][1].get(), 0) << "frame " << frame_num;
+    }
+}
+
+TEST(JitterBuffer, InOrder)
+{
+    TestStream stream(8);
+    jitter_buffer<int16_t> buffer(test_channels, test_packet_frames, make_options(40, jitter_concealment::repeat));
+
+    // silence is played until the first packet arrives, and then playback starts latency_frames before it
+    auto before = read_all(buffer, 20, 20);
+    expect_silence(before, 0, 20);
+    for (std::size_t packet_num = 0; packet_num < 8; ++packet_num)
+    {
+        EXPECT_TRUE(stream.push(buffer, packet_num));
+    }
+
+    // periods that don't line up with packets are split between them
+    auto output = read_all(buffer, 40 + (8 * test_packet_frames), 37);
+    expect_silence(output, 0, 40);
+    expect_stream(output, 40, 8 * test_packet_frames, -40);
+    EXPECT_EQ(buffer.received_packets(), 8);
+    EXPECT_EQ(buffer.dropped_packets(), 0);
+    EXPECT_EQ(buffer.concealed_packets(), 0);
+}
+
+TEST(JitterBuffer, LongPeriodsBeforeFirstPacket)
+{
+    // periods longer than a packet are silenced before the first packet arrives
+    TestStream stream(8);
+    jitter_buffer<int16_t> buffer(test_channels, test_packet_frames);
+    interleaved<int16_t> before(test_channels, 256);
+    std::fill(before.data(), before.data() + before.samples(), sample<int16_t>(1));
+    buffer.read(before);
+    expect_silence(before, 0, 256);
+    for (std::size_t packet_num = 0; packet_num < 8; ++packet_num)
+    {
+        EXPECT_TRUE(stream.push(buffer, packet_num));
+    }
+    EXPECT_EQ(buffer.concealed_packets(), 0);
+}
+
+TEST(JitterBuffer, NonInterleaved)
+{
+    TestStream stream(2);
+    jitter_buffer<int16_t> buffer(test_channels, test_packet_frames, make_options(0, jitter_concealment::repeat));
+    stream.push(buffer, 0);
+    stream.push(buffer, 1);
+
+    noninterleaved<float32_t> output(test_channels, 60);
+    buffer.read(noninterleaved_span<float32_t>(output));
+    for (std::size_t frame_num = 0; frame_num < 60; ++frame_num)
+    {
+        auto value = stream_sample(static_cast<std::uint32_t>(frame_num), 1).get();
+        auto expected = static_cast<float32_t>(value) / 32768.0f;
+        EXPECT_EQ(output[1][frame_num].get(), expected);
+    }
+    interleaved<float32_t> too_long(test_channels, 65);
+    EXPECT_THROW(buffer.read(too_long), std::invalid_argument);
+}
+
+TEST(JitterBuffer, Reorders)
+{
+    TestStream stream(8);
+    jitter_buffer<int16_t> buffer(test_channels, test_packet_frames, make_options(96, jitter_concealment::silence));
+    for (auto packet_num : {0, 2, 1, 3, 5, 4, 4, 7, 6})
+    {
+        stream.push(buffer, static_cast<std::size_t>(packet_num));
+    }
+    EXPECT_EQ(buffer.received_packets(), 8);
+    EXPECT_EQ(buffer.reordered_packets(), 4);
+    EXPECT_EQ(buffer.dropped_packets(), 1);
+
+    auto output = read_all(buffer, 96 + (8 * test_packet_frames), 64);
+    expect_silence(output, 0, 96);
+    expect_stream(output, 96, 8 * test_packet_frames, -96);
+
+    // packets that arrive after they were due are dropped
+    EXPECT_FALSE(stream.push(buffer, 3));
+    EXPECT_EQ(buffer.dropped_packets(), 2);
+}
+
+TEST(JitterBuffer, DropsEarlyPackets)
+{
+    TestStream stream(16);
+    jitter_buffer<int16_t> buffer(test_channels, test_packet_frames, make_options(0, jitter_concealment::silence));
+    EXPECT_TRUE(stream.push(buffer, 0));
+
+    // a packet can be held if its slot won't be needed before it is played, leaving room for a period and two packets
+    EXPECT_TRUE(stream.push(buffer, 12));
+    EXPECT_FALSE(stream.push(buffer, 13));
+    EXPECT_EQ(buffer.dropped_packets(), 1);
+    read_all(buffer, test_packet_frames, test_packet_frames);
+    EXPECT_TRUE(stream.push(buffer, 13));
+}
+
+TEST(JitterBuffer, ConcealsWithSilence)
+{
+    TestStream stream(4);
+    jitter_buffer<int16_t> buffer(test_channels, test_packet_frames, make_options(0, jitter_concealment::silence));
+    stream.push(buffer, 0);
+    stream.push(buffer, 2);
+    stream.push(buffer, 3);
+
+    auto output = read_all(buffer, 4 * test_packet_frames, 32);
+    expect_stream(output, 0, test_packet_frames, 0);
+    expect_silence(output, test_packet_frames, test_packet_frames);
+    expect_stream(output, 2 * test_packet_frames, 2 * test_packet_frames, 0);
+    EXPECT_EQ(buffer.concealed_packets(), 1);
+}
+
+TEST(JitterBuffer, ConcealsWithRepeat)
+{
+    TestStream stream(5);
+    jitter_buffer<int16_t> buffer(test_channels, test_packet_frames, make_options(0, jitter_concealment::repeat));
+    stream.push(buffer, 0);
+    stream.push(buffer, 3);
+    stream.push(buffer, 4);
+
+    noninterleaved<float32_t> output(test_channels, 5 * test_packet_frames);
+    for (std::size_t frame_num = 0; frame_num < output.frames(); frame_num += 16)
+    {
+        buffer.read(noninterleaved_span<float32_t>(output.data() + frame_num, test_channels, 16, output.pitch()));
+    }
+    EXPECT_EQ(buffer.concealed_packets(), 2);
+
+    // the first missing packet repeats the one before it fading out, and the second is silent
+    auto value = [&output](std::size_t frame_num) { return output[0][frame_num].get(); };
+    auto stream_value = [](std::size_t frame_num)
+    { return static_cast<float32_t>(stream_sample(static_cast<std::uint32_t>(frame_num), 0).get()) / 32768.0f; };
+    for (std::size_t frame_num = 0; frame_num < test_packet_frames; ++frame_num)
+    {
+        EXPECT_EQ(value(frame_num), stream_value(frame_num));
+        auto gain = 1.0f - static_cast<float32_t>(frame_num + 1) / static_cast<float32_t>(test_packet_frames);
+        EXPECT_NEAR(value(test_packet_frames + frame_num), stream_value(frame_num) * gain, 1e-6f);
+        EXPECT_EQ(value((2 * test_packet_frames) + frame_num), 0.0f);
+    }
+
+    // the packet that arrives after a gap fades in, and the rest play as they are
+    auto first = 3 * test_packet_frames;
+    EXPECT_LT(std::abs(value(first)), std::abs(stream_value(first)));
+    EXPECT_NEAR(value(first + test_packet_frames - 1), stream_value(first + test_packet_frames - 1), 1e-6f);
+    for (std::size_t frame_num = first + test_packet_frames; frame_num < output.frames(); ++frame_num)
+    {
+        EXPECT_EQ(value(frame_num), stream_value(frame_num));
+    }
+}
+
+TEST(JitterBuffer, SimulatedNetwork)
+{
+    // packets are sent every packet time, lost or delayed by up to 3 packet times by a fixed seed generator, and the
+    // buffer is read by a device with a period that doesn't line up with the packets
+    static constexpr std::size_t num_packets = 400;
+    static constexpr std::size_t period = 40;
+    static constexpr std::size_t latency = 4 * test_packet_frames;
+    TestStream stream(num_packets);
+    jitter_buffer<int16_t> buffer(
+        test_channels, test_packet_frames, make_options(latency, jitter_concealment::silence));
+
+    std::uint32_t seed = 12345;
+    auto next_random = [&seed]()
+    {
+        seed = (seed * 1103515245u) + 12345u;
+        return (seed >> 16) & 0x7fff;
+    };
+    std::vector<std::size_t> arrivals(num_packets);
+    std::vector<bool> lost(num_packets);
+    std::size_t num_lost = 0;
+    for (std::size_t packet_num = 0; packet_num < num_packets; ++packet_num)
+    {
+        lost[packet_num] = packet_num != 0 && next_random() % 50 == 0;
+        num_lost += lost[packet_num] ? 1 : 0;
+        auto delay = packet_num == 0 ? 0 : (next_random() % (3 * test_packet_frames));
+        arrivals[packet_num] = ((packet_num + 1) * test_packet_frames) + delay;
+    }
+
+    auto total_frames = latency + (num_packets * test_packet_frames);
+    interleaved<int16_t> output(test_channels, total_frames);
+    std::size_t clock = test_packet_frames;
+    std::size_t frame_num = 0;
+    while (frame_num < total_frames)
+    {
+        for (std::size_t packet_num = 0; packet_num < num_packets; ++packet_num)
+        {
+            if (!lost[packet_num] && arrivals[packet_num] > clock - period && arrivals[packet_num] <= clock)
+            {
+                EXPECT_TRUE(stream.push(buffer, packet_num));
+            }
+        }
+        auto period_frames = std::min(period, total_frames - frame_num);
+        buffer.read(
+            interleaved_span<int16_t>(output.data() + (frame_num * test_channels), test_channels, period_frames));
+        frame_num += period_frames;
+        clock += period;
+    }
+
+    EXPECT_GT(num_lost, 0);
+    EXPECT_EQ(buffer.received_packets(), num_packets - num_lost);
+    EXPECT_EQ(buffer.dropped_packets(), 0);
+    EXPECT_EQ(buffer.concealed_packets(), num_lost);
+    for (std::size_t packet_num = 0; packet_num < num_packets; ++packet_num)
+    {
+        auto first = latency + (packet_num * test_packet_frames);
+        if (lost[packet_num])
+        {
+            expect_silence(output, first, test_packet_frames);
+        }
+        else
+        {
+            expect_stream(output, first, test_packet_frames, -static_cast<std::int64_t>(latency));
+        }
+    }
+}
+
+TEST(JitterBuffer, Threads)
+{
+    // the network thread pushes each packet once it fits in the buffer, and the audio thread reads each period once
+    // its packets have been pushed, so the threads run concurrently but every packet arrives in time
+    static constexpr std::size_t num_packets = 2000;
+    static constexpr std::size_t period = 32;
+    static constexpr std::size_t latency = 4 * test_packet_frames;
+    TestStream stream(num_packets);
+    jitter_buffer<int16_t> buffer(
+        test_channels, test_packet_frames, make_options(latency, jitter_concealment::silence));
+    std::atomic<std::size_t> frames_read{0};
+    std::atomic<std::size_t> packets_pushed{0};
+
+    std::thread network_thread(
+        [&]()
+        {
+            for (std::size_t packet_num = 0; packet_num < num_packets; ++packet_num)
+            {
+                while ((packet_num * test_packet_frames) > frames_read.load() + (8 * test_packet_frames))
+                {
+                    std::this_thread::yield();
+                }
+                EXPECT_TRUE(stream.push(buffer, packet_num));
+                packets_pushed.store(packet_num + 1);
+            }
+        });
+
+    auto total_frames = latency + (num_packets * test_packet_frames);
+    interleaved<int16_t> output(test_channels, total_frames);
+    for (std::size_t frame_num = 0; frame_num < total_frames; frame_num += period)
+    {
+        auto needed = std::min(num_packets, (frame_num + period + test_packet_frames - 1) / test_packet_frames);
+        while (packets_pushed.load() < std::max<std::size_t>(needed, 1))
+        {
+            std::this_thread::yield();
+        }
+        buffer.read(interleaved_span<int16_t>(output.data() + (frame_num * test_channels), test_channels, period));
+        frames_read.store(frame_num + period);
+    }
+    network_thread.join();
+
+    EXPECT_EQ(buffer.received_packets(), num_packets);
+    EXPECT_EQ(buffer.concealed_packets(), 0);
+    expect_silence(output, 0, latency);
+    expect_stream(output, latency, num_packets * test_packet_frames, -static_cast<std::int64_t>(latency));
+}
+
+TEST(JitterBuffer, Errors)
+{
+    EXPECT_THROW(jitter_buffer<int16_t>(0, 48), std::invalid_argument);
+    EXPECT_THROW(jitter_buffer<int16_t>(2, 0), std::invalid_argument);
+    EXPECT_THROW(
+        jitter_buffer<int16_t>(2, 48, make_options(16 * 48, jitter_concealment::silence)), std::invalid_argument);
+
+    // packets of the wrong size are dropped
+    jitter_buffer<int16_t> buffer(test_channels, test_packet_frames);
+    network_interleaved<int16_t> payload(test_channels, test_packet_frames - 1);
+    EXPECT_FALSE(
+        buffer.push(0, 0, const_network_interleaved_span<int16_t>(payload.data(), test_channels, payload.frames())));
+    EXPECT_EQ(buffer.dropped_packets(), 1);
+}
+
+} // namespace test
+} // namespace ratl
@@ -0,0 +1,323 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <vector>
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleType>
+static SampleType sample_for(std::size_t channel_num, std::size_t frame_num)
+{
+    auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+    return reference_convert<SampleType>(sample<int32_t>(value));
+}
+
+// Channels held in independent allocations, in the same way as a plugin host would hand them over
+template<typename SampleType>
+class planar_buffer
+{
+public:
+    using sample_type = SampleType;
+    using span_type = basic_planar_span<sample_type, detail::sample_traits<sample_type>>;
+
+    planar_buffer(std::size_t channels, std::size_t frames) : storage_(channels, std::vector<sample_type>(frames))
+    {
+        for (auto& channel : storage_)
+        {
+            pointers_.push_back(channel.data());
+        }
+    }
+
+    span_type span()
+    {
+        return span_type(pointers_.data(), storage_.size(), frames());
+    }
+
+    std::size_t channels() const
+    {
+        return storage_.size();
+    }
+
+    std::size_t frames() const
+    {
+        return storage_.empty() ? 0 : storage_.front().size();
+    }
+
+    sample_type& at(std::size_t channel_num, std::size_t frame_num)
+    {
+        return storage_[channel_num][frame_num];
+    }
+
+    void fill()
+    {
+        for (std::size_t channel_num = 0; channel_num < channels(); ++channel_num)
+        {
+            for (std::size_t frame_num = 0; frame_num < frames(); ++frame_num)
+            {
+                at(channel_num, frame_num) = sample_for<sample_type>(channel_num, frame_num);
+            }
+        }
+    }
+
+private:
+    std::vector<std::vector<sample_type>> storage_;
+    std::vector<sample_type*> pointers_;
+};
+
+TEST(PlanarSpan, Channels)
+{
+    planar_buffer<sample<float32_t>> buffer(3, 8);
+    buffer.fill();
+    auto span = buffer.span();
+    EXPECT_EQ(span.channels(), 3);
+    EXPECT_EQ(span.frames(), 8);
+    EXPECT_EQ(span.samples(), 24);
+    EXPECT_FALSE(span.empty());
+    EXPECT_EQ(span.channel(1).data(), &buffer.at(1, 0));
+    EXPECT_EQ(span[2][7], buffer.at(2, 7));
+    EXPECT_EQ(span.front().data(), &buffer.at(0, 0));
+    EXPECT_EQ(span.back().data(), &buffer.at(2, 0));
+    EXPECT_THROW(span.at(3), std::out_of_range);
+    EXPECT_TRUE(planar_span<float32_t>().empty());
+}
+
+TEST(PlanarSpan, ValuePointers)
+{
+    std::vector<float> left(4, 0.25f);
+    std::vector<float> right(4, -0.5f);
+    float* channels[] = {left.data(), right.data()};
+
+    auto span = planar_span<float32_t>(channels, 2, 4);
+    span[1][3] = sample<float32_t>(1.0f);
+    EXPECT_EQ(right[3], 1.0f);
+
+    const_planar_span<float32_t> const_span(channels, 2, 4);
+    EXPECT_EQ(const_span[0][0], sample<float32_t>(0.25f));
+    const_planar_span<float32_t> converted_span = span;
+    EXPECT_EQ(converted_span.data(), span.data());
+}
+
+TEST(PlanarSpan, Iterators)
+{
+    planar_buffer<sample<int16_t>> buffer(4, 5);
+    buffer.fill();
+    auto span = buffer.span();
+    std::size_t channel_num = 0;
+    for (auto channel : span)
+    {
+        EXPECT_EQ(channel.data(), &buffer.at(channel_num, 0));
+        EXPECT_EQ(channel.samples(), 5);
+        ++channel_num;
+    }
+    EXPECT_EQ(channel_num, 4);
+    EXPECT_EQ(span.end() - span.begin(), 4);
+    EXPECT_EQ(span.rbegin()->data(), &buffer.at(3, 0));
+    EXPECT_EQ(span.begin()[2][4], buffer.at(2, 4));
+
+    const_planar_span<int16_t>::const_iterator const_iter = span.begin();
+    EXPECT_EQ(const_iter, span.cbegin());
+    EXPECT_EQ(*(const_iter + 3)->begin(), buffer.at(3, 0));
+
+    auto offset_iter = planar_span<int16_t>::iterator(span.data(), 2, 3);
+    EXPECT_EQ(offset_iter->data(), &buffer.at(0, 2));
+    EXPECT_EQ(offset_iter[1].samples(), 3);
+    EXPECT_EQ(offset_iter[1].back(), buffer.at(1, 4));
+}
+
+template<typename SampleValueTypeCombination>
+class PlanarTransform : public ::testing::Test
+{
+public:
+    using input_sample_type = sample<typename SampleValueTypeCombination::input_sample_value_type>;
+    using output_sample_type = sample<typename SampleValueTypeCombination::output_sample_value_type>;
+
+    template<typename InputContainer, typename OutputContainer>
+    static void check(InputContainer& input, OutputContainer& output, std::size_t channels, std::size_t frames)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+            {
+                EXPECT_EQ(
+                    output.channel(channel_num)[frame_num],
+                    reference_convert<output_sample_type>(input.channel(channel_num)[frame_num]));
+            }
+        }
+    }
+
+    template<std::size_t Extent>
+    static void interleaved_round_trip(std::size_t channels, std::size_t frames)
+    {
+        planar_buffer<input_sample_type> input(channels, frames);
+        input.fill();
+        auto input_span = input.span();
+
+        interleaved<typename output_sample_type::value_type> intermediate(channels, frames);
+        auto intermediate_span =
+            interleaved_span<typename output_sample_type::value_type, Extent>(intermediate.data(), channels, frames);
+        auto intermediate_end = reference_transform(input_span.cbegin(), input_span.cend(), intermediate_span.begin());
+        EXPECT_EQ(intermediate_end, intermediate_span.end());
+        check(input_span, intermediate, channels, frames);
+
+        planar_buffer<output_sample_type> output(channels, frames);
+        auto output_span = output.span();
+        auto output_end = reference_transform(intermediate_span.begin(), intermediate_span.end(), output_span.begin());
+        EXPECT_EQ(output_end, output_span.end());
+        check(intermediate, output_span, channels, frames);
+    }
+};
+
+TYPED_TEST_SUITE(PlanarTransform, PossibleSampleValueTypeCombinations, );
+
+TYPED_TEST(PlanarTransform, Planar)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+
+    planar_buffer<input_sample_type> input(3, 17);
+    input.fill();
+    auto input_span = input.span();
+    planar_buffer<output_sample_type> output(3, 17);
+    auto output_span = output.span();
+
+    auto output_end = reference_transform(input_span.cbegin(), input_span.cend(), output_span.begin());
+    EXPECT_EQ(output_end, output_span.end());
+    TestFixture::check(input_span, output_span, 3, 17);
+}
+
+TYPED_TEST(PlanarTransform, MoreOutputFrames)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+
+    planar_buffer<input_sample_type> input(2, 5);
+    input.fill();
+    auto input_span = input.span();
+    planar_buffer<output_sample_type> output(2, 9);
+    auto output_span = output.span();
+
+    reference_transform(input_span.begin(), input_span.end(), output_span.begin());
+    TestFixture::check(input_span, output_span, 2, 5);
+    for (std::size_t frame_num = 5; frame_num < 9; ++frame_num)
+    {
+        EXPECT_EQ(output.at(0, frame_num), output_sample_type());
+        EXPECT_EQ(output.at(1, frame_num), output_sample_type());
+    }
+}
+
+TYPED_TEST(PlanarTransform, Noninterleaved)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+
+    planar_buffer<input_sample_type> input(4, 13);
+    input.fill();
+    auto input_span = input.span();
+
+    aligned_noninterleaved<typename output_sample_type::value_type> intermediate(4, 13);
+    auto intermediate_end = reference_transform(input_span.begin(), input_span.end(), intermediate.begin());
+    EXPECT_EQ(intermediate_end, intermediate.end());
+    TestFixture::check(input_span, intermediate, 4, 13);
+
+    planar_buffer<output_sample_type> output(4, 13);
+    auto output_span = output.span();
+    auto output_end = reference_transform(intermediate.cbegin(), intermediate.cend(), output_span.begin());
+    EXPECT_EQ(output_end, output_span.end());
+    TestFixture::check(intermediate, output_span, 4, 13);
+}
+
+TYPED_TEST(PlanarTransform, Interleaved)
+{
+    TestFixture::template interleaved_round_trip<dynamic_extent>(1, 17);
+    TestFixture::template interleaved_round_trip<dynamic_extent>(5, 9);
+}
+
+TYPED_TEST(PlanarTransform, InterleavedStaticExtent)
+{
+    TestFixture::template interleaved_round_trip<1>(1, 17);
+    TestFixture::template interleaved_round_trip<2>(2, 33);
+    TestFixture::template interleaved_round_trip<6>(6, 9);
+}
+
+TYPED_TEST(PlanarTransform, InterleavedDifferentChannels)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+
+    // fewer planar channels than interleaved channels
+    planar_buffer<input_sample_type> input(1, 4);
+    input.fill();
+    auto input_span = input.span();
+    interleaved<typename output_sample_type::value_type> output(2, 4);
+    auto output_span = interleaved_span<typename output_sample_type::value_type, 2>(output.data(), 2, 4);
+    auto output_end = reference_transform(input_span.begin(), input_span.end(), output_span.begin());
+    EXPECT_EQ(output_end, output_span.end());
+    for (std::size_t frame_num = 0; frame_num < 4; ++frame_num)
+    {
+        EXPECT_EQ(output[frame_num][0], reference_convert<output_sample_type>(input.at(0, frame_num)));
+        EXPECT_EQ(output[frame_num][1], output_sample_type());
+    }
+
+    // more planar channels than interleaved channels
+    planar_buffer<input_sample_type> wide_input(3, 4);
+    wide_input.fill();
+    auto wide_input_span = wide_input.span();
+    output_end = reference_transform(wide_input_span.begin(), wide_input_span.end(), output_span.begin());
+    EXPECT_EQ(output_end, output_span.end());
+    TestFixture::check(wide_input_span, output, 2, 4);
+}
+
+TYPED_TEST(PlanarTransform, RingBuffer)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+
+    planar_buffer<input_sample_type> input(2, 5);
+    input.fill();
+    auto input_span = input.span();
+    planar_buffer<output_sample_type> output(2, 5);
+    auto output_span = output.span();
+
+    // wrap the ring buffer so that each transfer is split in two
+    noninterleaved_ring_buffer<typename output_sample_type::value_type> ring(2, 7);
+    ring.commit_write(4);
+    ring.commit_read(4);
+
+    EXPECT_EQ(reference_transform(input_span.begin(), input_span.end(), ring), 5);
+    EXPECT_EQ(reference_transform(ring, output_span.begin(), output_span.end()), 5);
+    TestFixture::check(input_span, output_span, 2, 5);
+}
+
+TEST(PlanarTransform, DefaultTransform)
+{
+    planar_buffer<sample<int16_t>> input(2, 67);
+    input.fill();
+    auto input_span = input.span();
+    planar_buffer<sample<float32_t>> output(2, 67);
+    auto output_span = output.span();
+    interleaved<int16_t> intermediate(2, 67);
+
+    transform(input_span.begin(), input_span.end(), output_span.begin());
+    transform(output_span.begin(), output_span.end(), intermediate.begin());
+    for (std::size_t channel_num = 0; channel_num < 2; ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < 67; ++frame_num)
+        {
+            EXPECT_EQ(output.at(channel_num, frame_num), convert<sample<float32_t>>(input.at(channel_num, frame_num)));
+            EXPECT_EQ(intermediate[frame_num][channel_num], input.at(channel_num, frame_num));
+        }
+    }
+}
+
+} // namespace test
+} // namespace ratl
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleType>
+static SampleType sample_for(std::size_t channel_num, std::size_t frame_num)
+{
+    auto value = static_cast<int32_t>(((channel_num + 1) * 0x1000) + frame_num + 1) * 0x10000;
+    return reference_convert<SampleType>(sample<int32_t>(value));
+}
+
+template<typename ContainerType>
+static void fill_container(ContainerType& container)
+{
+    using sample_type = typename ContainerType::sample_type;
+    for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < container.frames(); ++frame_num)
+        {
+            container.channel(channel_num)[frame_num] = sample_for<sample_type>(channel_num, frame_num);
+        }
+    }
+}
+
+template<typename ContainerType>
+static void check_container(const ContainerType& container, std::size_t old_channels, std::size_t old_frames)
+{
+    using sample_type = typename ContainerType::sample_type;
+    for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < container.frames(); ++frame_num)
+        {
+            if ((channel_num < old_channels) && (frame_num < old_frames))
+            {
+                EXPECT_EQ(container.channel(channel_num)[frame_num], sample_for<sample_type>(channel_num, frame_num));
+            }
+            else
+            {
+                EXPECT_EQ(container.channel(channel_num)[frame_num], sample_type());
+            }
+        }
+    }
+}
+
+template<typename ContainerType>
+class Resize : public ::testing::Test
+{
+};
+
+using PossibleResizeContainers = ::testing::Types<
+    interleaved<int16_t>,
+    interleaved<int24_t>,
+    interleaved<int32_t>,
+    interleaved<float32_t>,
+    network_interleaved<int24_t>,
+    noninterleaved<int16_t>,
+    noninterleaved<int24_t>,
+    noninterleaved<int32_t>,
+    noninterleaved<float32_t>,
+    network_noninterleaved<int24_t>>;
+
+TYPED_TEST_SUITE(Resize, PossibleResizeContainers, );
+
+TYPED_TEST(Resize, Capacity)
+{
+    TypeParam container(3, 5);
+    EXPECT_EQ(container.capacity(), 15);
+    TypeParam empty_container;
+    EXPECT_EQ(empty_container.capacity(), 0);
+}
+
+TYPED_TEST(Resize, ForOverwriteConstructor)
+{
+    TypeParam container(for_overwrite, 3, 5);
+    EXPECT_NE(container.data(), nullptr);
+    EXPECT_EQ(container.channels(), 3);
+    EXPECT_EQ(container.frames(), 5);
+    EXPECT_EQ(container.capacity(), 15);
+}
+
+TYPED_TEST(Resize, Reserve)
+{
+    TypeParam container(3, 5);
+    fill_container(container);
+    container.reserve(40);
+    EXPECT_EQ(container.capacity(), 40);
+    EXPECT_EQ(container.channels(), 3);
+    EXPECT_EQ(container.frames(), 5);
+    check_container(container, 3, 5);
+
+    // reserving less than the capacity does nothing
+    auto data = container.data();
+    container.reserve(10);
+    EXPECT_EQ(container.capacity(), 40);
+    EXPECT_EQ(container.data(), data);
+}
+
+TYPED_TEST(Resize, GrowWithinCapacity)
+{
+    TypeParam container(3, 5);
+    container.reserve(64);
+    fill_container(container);
+    auto data = container.data();
+
+    container.resize(4, 7);
+    EXPECT_EQ(container.data(), data);
+    EXPECT_EQ(container.channels(), 4);
+    EXPECT_EQ(container.frames(), 7);
+    check_container(container, 3, 5);
+}
+
+TYPED_TEST(Resize, ShrinkWithinCapacity)
+{
+    TypeParam container(4, 7);
+    fill_container(container);
+    auto data = container.data();
+
+    container.resize(2, 3);
+    EXPECT_EQ(container.data(), data);
+    EXPECT_EQ(container.capacity(), 28);
+    check_container(container, 2, 3);
+}
+
+TYPED_TEST(Resize, MoreChannelsFewerFrames)
+{
+    TypeParam container(2, 8);
+    fill_container(container);
+    container.resize(4, 4);
+    EXPECT_EQ(container.capacity(), 16);
+    check_container(container, 2, 4);
+}
+
+TYPED_TEST(Resize, FewerChannelsMoreFrames)
+{
+    TypeParam container(4, 4);
+    fill_container(container);
+    container.resize(2, 8);
+    EXPECT_EQ(container.capacity(), 16);
+    check_container(container, 2, 4);
+}
+
+TYPED_TEST(Resize, GrowBeyondCapacity)
+{
+    TypeParam container(3, 5);
+    fill_container(container);
+    container.resize(5, 9);
+    EXPECT_EQ(container.channels(), 5);
+    EXPECT_EQ(container.frames(), 9);
+    EXPECT_GE(container.capacity(), 45);
+    check_container(container, 3, 5);
+}
+
+TYPED_TEST(Resize, FromEmpty)
+{
+    TypeParam container;
+    container.resize(2, 3);
+    EXPECT_EQ(container.capacity(), 6);
+    check_container(container, 0, 0);
+}
+
+TYPED_TEST(Resize, ToEmpty)
+{
+    TypeParam container(2, 3);
+    container.resize(0, 0);
+    EXPECT_TRUE(container.empty());
+    EXPECT_EQ(container.capacity(), 6);
+    container.shrink_to_fit();
+    EXPECT_EQ(container.capacity(), 0);
+    EXPECT_EQ(container.data(), nullptr);
+}
+
+TYPED_TEST(Resize, ForOverwrite)
+{
+    TypeParam container(3, 5);
+    auto data = container.data();
+    container.resize(for_overwrite, 5, 3);
+    EXPECT_EQ(container.data(), data);
+    EXPECT_EQ(container.channels(), 5);
+    EXPECT_EQ(container.frames(), 3);
+
+    container.resize(for_overwrite, 8, 8);
+    EXPECT_EQ(container.channels(), 8);
+    EXPECT_EQ(container.frames(), 8);
+    EXPECT_EQ(container.capacity(), 64);
+}
+
+TYPED_TEST(Resize, ShrinkToFit)
+{
+    TypeParam container(4, 7);
+    container.resize(2, 3);
+    fill_container(container);
+    container.shrink_to_fit();
+    EXPECT_EQ(container.capacity(), 6);
+    check_container(container, 2, 3);
+}
+
+TYPED_TEST(Resize, CopyHasExactCapacity)
+{
+    TypeParam container(3, 5);
+    container.reserve(100);
+    fill_container(container);
+    auto copy = container;
+    EXPECT_EQ(copy.capacity(), 15);
+    EXPECT_EQ(copy, container);
+}
+
+} // namespace test
+} // namespace ratl
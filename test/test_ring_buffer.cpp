@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <thread>
+
+namespace ratl
+{
+namespace test
+{
+static constexpr std::size_t ring_buffer_channels = 3;
+static constexpr std::size_t ring_buffer_capacity = 7;
+
+template<typename ContainerType>
+static void fill_container(ContainerType& container, int32_t start)
+{
+    using sample_type = typename ContainerType::sample_type;
+    auto value = start;
+    for (std::size_t frame_num = 0; frame_num < container.frames(); ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+        {
+            container.channel(channel_num)[frame_num] =
+                reference_convert<sample_type>(sample<int32_t>(value++ * 0x10000));
+        }
+    }
+}
+
+// RingBufferRegion
+
+TEST(RingBufferRegion, EmptyRing)
+{
+    interleaved_ring_buffer<int16_t> ring(ring_buffer_channels, ring_buffer_capacity);
+    EXPECT_EQ(ring.read_available(), 0);
+    EXPECT_EQ(ring.write_available(), ring_buffer_capacity);
+    EXPECT_TRUE(ring.read_region().empty());
+    EXPECT_EQ(ring.write_region().frames(), ring_buffer_capacity);
+    EXPECT_FALSE(ring.write_region().wraps());
+}
+
+TEST(RingBufferRegion, FullRing)
+{
+    interleaved_ring_buffer<int16_t> ring(ring_buffer_channels, ring_buffer_capacity);
+    ring.commit_write(ring_buffer_capacity);
+    EXPECT_EQ(ring.read_available(), ring_buffer_capacity);
+    EXPECT_EQ(ring.write_available(), 0);
+    EXPECT_TRUE(ring.write_region().empty());
+    EXPECT_EQ(ring.read_region().frames(), ring_buffer_capacity);
+}
+
+TEST(RingBufferRegion, InterleavedWraps)
+{
+    interleaved_ring_buffer<int16_t> ring(ring_buffer_channels, ring_buffer_capacity);
+    auto start = ring.write_region().first().data();
+    ring.commit_write(5);
+    ring.commit_read(5);
+
+    auto region = ring.write_region(4);
+    EXPECT_TRUE(region.wraps());
+    EXPECT_EQ(region.frames(), 4);
+    EXPECT_EQ(region.first().frames(), 2);
+    EXPECT_EQ(region.first().channels(), ring_buffer_channels);
+    EXPECT_EQ(region.first().data(), start + (5 * ring_buffer_channels));
+    EXPECT_EQ(region.second().frames(), 2);
+    EXPECT_EQ(region.second().data(), start);
+}
+
+TEST(RingBufferRegion, NoninterleavedWraps)
+{
+    noninterleaved_ring_buffer<int16_t> ring(ring_buffer_channels, ring_buffer_capacity);
+    auto start = ring.write_region().first().data();
+    ring.commit_write(5);
+    ring.commit_read(5);
+
+    auto region = ring.write_region(4);
+    EXPECT_TRUE(region.wraps());
+    EXPECT_EQ(region.first().frames(), 2);
+    EXPECT_EQ(region.first().pitch(), ring_buffer_capacity);
+    EXPECT_EQ(region.first().data(), start + 5);
+    EXPECT_EQ(region.first().channel(1).data(), start + 5 + ring_buffer_capacity);
+    EXPECT_EQ(region.second().frames(), 2);
+    EXPECT_EQ(region.second().data(), start);
+}
+
+// RingBufferTransform
+
+template<typename SampleValueType>
+class RingBufferTransform : public ::testing::Test
+{
+};
+
+TYPED_TEST_SUITE(RingBufferTransform, PossibleSampleValueTypes, );
+
+template<typename InputType, typename RingType, typename OutputType>
+static void test_ring_buffer_round_trip()
+{
+    RingType ring(ring_buffer_channels, ring_buffer_capacity);
+    InputType input(ring_buffer_channels, 5);
+    OutputType output(ring_buffer_channels, 5);
+    OutputType expected(ring_buffer_channels, 5);
+
+    // run enough iterations for the read and write positions to wrap multiple times
+    for (int32_t iteration = 0; iteration < 10; ++iteration)
+    {
+        fill_container(input, iteration * 100);
+        EXPECT_EQ(reference_transform(input.begin(), input.end(), ring), 5);
+        EXPECT_EQ(ring.read_available(), 5);
+        EXPECT_EQ(reference_transform(ring, output.begin(), output.end()), 5);
+        EXPECT_EQ(ring.read_available(), 0);
+
+        reference_transform(input.begin(), input.end(), expected.begin());
+        for (std::size_t channel_num = 0; channel_num < ring_buffer_channels; ++channel_num)
+        {
+            for (std::size_t frame_num = 0; frame_num < 5; ++frame_num)
+            {
+                EXPECT_EQ(output.channel(channel_num)[frame_num], expected.channel(channel_num)[frame_num]);
+            }
+        }
+    }
+}
+
+TYPED_TEST(RingBufferTransform, InterleavedToInterleavedRing)
+{
+    test_ring_buffer_round_trip<
+        interleaved<TypeParam>,
+        network_interleaved_ring_buffer<TypeParam>,
+        interleaved<TypeParam>>();
+}
+
+TYPED_TEST(RingBufferTransform, NoninterleavedToInterleavedRing)
+{
+    test_ring_buffer_round_trip<
+        noninterleaved<TypeParam>,
+        interleaved_ring_buffer<TypeParam>,
+        noninterleaved<TypeParam>>();
+}
+
+TYPED_TEST(RingBufferTransform, InterleavedToNoninterleavedRing)
+{
+    test_ring_buffer_round_trip<
+        interleaved<TypeParam>,
+        noninterleaved_ring_buffer<TypeParam>,
+        noninterleaved<TypeParam>>();
+}
+
+TYPED_TEST(RingBufferTransform, NoninterleavedToNoninterleavedRing)
+{
+    test_ring_buffer_round_trip<
+        noninterleaved<TypeParam>,
+        network_noninterleaved_ring_buffer<TypeParam>,
+        interleaved<TypeParam>>();
+}
+
+TYPED_TEST(RingBufferTransform, Convert)
+{
+    test_ring_buffer_round_trip<interleaved<TypeParam>, interleaved_ring_buffer<float32_t>, interleaved<int32_t>>();
+}
+
+TEST(RingBufferTransform, WriteLimitedByCapacity)
+{
+    interleaved_ring_buffer<int32_t> ring(ring_buffer_channels, ring_buffer_capacity);
+    interleaved<int32_t> input(ring_buffer_channels, ring_buffer_capacity + 3);
+    fill_container(input, 0);
+    EXPECT_EQ(transform(input.begin(), input.end(), ring), ring_buffer_capacity);
+    EXPECT_EQ(transform(input.begin(), input.end(), ring), 0);
+
+    interleaved<int32_t> output(ring_buffer_channels, ring_buffer_capacity + 3);
+    EXPECT_EQ(transform(ring, output.begin(), output.end()), ring_buffer_capacity);
+    for (std::size_t frame_num = 0; frame_num < ring_buffer_capacity; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < ring_buffer_channels; ++channel_num)
+        {
+            EXPECT_EQ(output[frame_num][channel_num], input[frame_num][channel_num]);
+        }
+    }
+}
+
+TEST(RingBufferTransform, ProducerConsumer)
+{
+    static constexpr std::size_t total_frames = 100000;
+    static constexpr std::size_t block_frames = 13;
+
+    interleaved_ring_buffer<int32_t> ring(2, 64);
+
+    std::thread producer(
+        [&ring]()
+        {
+            interleaved<int32_t> block(2, block_frames);
+            std::size_t frame_num = 0;
+            while (frame_num < total_frames)
+            {
+                auto frames = std::min(block_frames, total_frames - frame_num);
+                for (std::size_t i = 0; i < frames; ++i)
+                {
+                    block[i][0] = sample<int32_t>(static_cast<int32_t>(frame_num + i));
+                    block[i][1] = sample<int32_t>(-static_cast<int32_t>(frame_num + i));
+                }
+                auto block_begin = block.begin();
+                auto block_end = block.begin() + static_cast<std::ptrdiff_t>(frames);
+                while (block_begin != block_end)
+                {
+                    auto written = transform(block_begin, block_end, ring);
+                    if (written == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    block_begin += static_cast<std::ptrdiff_t>(written);
+                }
+                frame_num += frames;
+            }
+        });
+
+    interleaved<int32_t> block(2, block_frames);
+    std::size_t frame_num = 0;
+    bool in_order = true;
+    while (frame_num < total_frames)
+    {
+        auto frames = transform(ring, block.begin(), block.end());
+        if (frames == 0)
+        {
+            std::this_thread::yield();
+        }
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            in_order &= block[i][0] == sample<int32_t>(static_cast<int32_t>(frame_num + i));
+            in_order &= block[i][1] == sample<int32_t>(-static_cast<int32_t>(frame_num + i));
+        }
+        frame_num += frames;
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(ring.read_available(), 0);
+}
+
+} // namespace test
+} // namespace ratl
@@ -0,0 +1,314 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+#    include <arpa/inet.h>
+#    include <netinet/in.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+namespace ratl
+{
+namespace test
+{
+static interleaved<float32_t> make_input(std::size_t channels, std::size_t frames, std::size_t offset)
+{
+    interleaved<float32_t> input(channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            auto value = static_cast<float32_t>((channel_num * 64) + ((frame_num + offset) % 64)) / 1024.0f - 0.25f;
+            input[frame_num][channel_num] = sample<float32_t>(value);
+        }
+    }
+    return input;
+}
+
+template<typename SampleValueType>
+static interleaved<SampleValueType> to_host(const interleaved<float32_t>& input)
+{
+    interleaved<SampleValueType> output(input.channels(), input.frames());
+    transform(input.begin(), input.end(), output.begin());
+    return output;
+}
+
+template<typename SampleValueType>
+static interleaved<SampleValueType> to_host(const const_network_interleaved_span<SampleValueType>& input)
+{
+    interleaved<SampleValueType> output(input.channels(), input.frames());
+    transform(input.begin(), input.end(), output.begin());
+    return output;
+}
+
+// The packetiser dithers, so received samples can differ from an undithered conversion by one step
+template<typename SampleValueType>
+static void check_payload(
+    const const_network_interleaved_span<SampleValueType>& payload, const interleaved<float32_t>& input)
+{
+    auto received = to_host<SampleValueType>(payload);
+    auto expected = to_host<SampleValueType>(input);
+    ASSERT_EQ(received.channels(), expected.channels());
+    ASSERT_EQ(received.frames(), expected.frames());
+    for (std::size_t frame_num = 0; frame_num < expected.frames(); ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < expected.channels(); ++channel_num)
+        {
+            auto difference = static_cast<std::int64_t>(received[frame_num][channel_num].get()) -
+                              static_cast<std::int64_t>(expected[frame_num][channel_num].get());
+            EXPECT_LE(std::abs(difference), 1) << "frame " << frame_num << " channel " << channel_num;
+        }
+    }
+}
+
+// Packet storage, aligned for any payload sample type
+static std::vector<std::uint32_t> make_packet(std::size_t bytes)
+{
+    return std::vector<std::uint32_t>((bytes + 3) / 4);
+}
+
+static unsigned char* packet_data(std::vector<std::uint32_t>& packet)
+{
+    return reinterpret_cast<unsigned char*>(packet.data());
+}
+
+template<typename SampleValueType>
+class Rtp : public ::testing::Test
+{
+};
+
+using PossibleRtpSampleValueTypes = ::testing::Types<int16_t, int24_t>;
+TYPED_TEST_SUITE(Rtp, PossibleRtpSampleValueTypes, );
+
+TYPED_TEST(Rtp, RoundTrip)
+{
+    rtp_packetiser<TypeParam> packetiser(8, rtp_packet_frames(48000, std::chrono::milliseconds(1)), 97, 0x12345678);
+    rtp_depacketiser<TypeParam> depacketiser(8, 97);
+    EXPECT_EQ(packetiser.frames_per_packet(), 48);
+    EXPECT_EQ(packetiser.packet_bytes(), 12 + (8 * 48 * sizeof(network_sample<TypeParam>)));
+
+    auto packet = make_packet(packetiser.packet_bytes());
+    for (std::size_t packet_num = 0; packet_num < 4; ++packet_num)
+    {
+        auto input = make_input(8, 48, packet_num * 48);
+        auto bytes = packetiser.write_packet(input, packet_data(packet), packet_num == 0);
+        EXPECT_EQ(bytes, packetiser.packet_bytes());
+
+        rtp_packet<TypeParam> received;
+        ASSERT_TRUE(depacketiser.read_packet(packet.data(), bytes, received));
+        EXPECT_EQ(received.header.payload_type, 97);
+        EXPECT_EQ(received.header.marker, packet_num == 0);
+        EXPECT_EQ(received.header.sequence_number, packet_num);
+        EXPECT_EQ(received.header.timestamp, packet_num * 48);
+        EXPECT_EQ(received.header.ssrc, 0x12345678);
+
+        // the payload is viewed in place in the packet
+        EXPECT_EQ(
+            static_cast<const void*>(received.payload.data()), static_cast<const void*>(packet_data(packet) + 12));
+        check_payload<TypeParam>(received.payload, input);
+    }
+}
+
+TYPED_TEST(Rtp, NonInterleaved)
+{
+    rtp_packetiser<TypeParam> packetiser(2, 6, 98, 1);
+    rtp_depacketiser<TypeParam> depacketiser(2, 98);
+    auto input = make_input(2, 6, 0);
+    noninterleaved<float32_t> noninterleaved_input(2, 6);
+    transform(input.begin(), input.end(), noninterleaved_input.begin());
+
+    auto packet = make_packet(packetiser.packet_bytes());
+    rtp_packet<TypeParam> received;
+    ASSERT_TRUE(depacketiser.read_packet(
+        packet.data(), packetiser.write_packet(noninterleaved_input, packet_data(packet)), received));
+    check_payload<TypeParam>(received.payload, input);
+
+    EXPECT_THROW(packetiser.write_packet(make_input(2, 5, 0), packet_data(packet)), std::invalid_argument);
+    EXPECT_THROW(packetiser.write_packet(make_input(3, 6, 0), packet_data(packet)), std::invalid_argument);
+}
+
+TEST(Rtp, SequenceWraps)
+{
+    rtp_packetiser<int24_t> packetiser(1, 6, 96, 7, 0xffff, 0xfffffffd);
+    rtp_depacketiser<int24_t> depacketiser(1, 96);
+    auto input = make_input(1, 6, 0);
+    auto packet = make_packet(packetiser.packet_bytes());
+    rtp_packet<int24_t> received;
+
+    auto size = packetiser.write_packet(input, packet_data(packet));
+    ASSERT_TRUE(depacketiser.read_packet(packet.data(), size, received));
+    EXPECT_EQ(received.header.sequence_number, 0xffff);
+    EXPECT_EQ(received.header.timestamp, 0xfffffffd);
+    size = packetiser.write_packet(input, packet_data(packet));
+    ASSERT_TRUE(depacketiser.read_packet(packet.data(), size, received));
+    EXPECT_EQ(received.header.sequence_number, 0);
+    EXPECT_EQ(received.header.timestamp, 3);
+}
+
+TEST(Rtp, HeaderFields)
+{
+    // CSRCs, a header extension and padding are all skipped to find the payload
+    std::vector<std::uint32_t> storage(32);
+    auto* packet = reinterpret_cast<unsigned char*>(storage.data());
+    const unsigned char header[] = {
+        0xb1, 0x60, 0x01, 0x02, 0x00, 0x00, 0x10, 0x00, 0xde, 0xad, 0xbe, 0xef,   // V=2 P X CC=1, PT=96
+        0x00, 0x00, 0x00, 0x01,                                                   // CSRC
+        0xbe, 0xde, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00};                          // one word of extension
+    std::memcpy(packet, header, sizeof(header));
+    const unsigned char payload[] = {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc};
+    std::memcpy(packet + sizeof(header), payload, sizeof(payload));
+    const unsigned char padding[] = {0, 0, 3};
+    std::memcpy(packet + sizeof(header) + sizeof(payload), padding, sizeof(padding));
+    auto size = sizeof(header) + sizeof(payload) + sizeof(padding);
+
+    rtp_packet<int24_t> received;
+    ASSERT_TRUE(rtp_depacketiser<int24_t>(2, 96).read_packet(packet, size, received));
+    EXPECT_EQ(received.header.sequence_number, 0x0102);
+    EXPECT_EQ(received.header.timestamp, 0x1000);
+    EXPECT_EQ(received.header.ssrc, 0xdeadbeef);
+    EXPECT_FALSE(received.header.marker);
+    ASSERT_EQ(received.payload.frames(), 1);
+    EXPECT_EQ(static_cast<const void*>(received.payload.data()), static_cast<const void*>(packet + sizeof(header)));
+    EXPECT_EQ(received.payload.channels(), 2);
+}
+
+TEST(Rtp, RejectsPackets)
+{
+    rtp_packetiser<int16_t> packetiser(2, 6, 96, 1);
+    rtp_depacketiser<int16_t> depacketiser(2, 96);
+    auto packet = make_packet(packetiser.packet_bytes());
+    auto size = packetiser.write_packet(make_input(2, 6, 0), packet_data(packet));
+    rtp_packet<int16_t> received;
+
+    EXPECT_FALSE(depacketiser.read_packet(packet.data(), 11, received));
+    EXPECT_FALSE(depacketiser.read_packet(packet.data(), size - 2, received));
+    EXPECT_FALSE(rtp_depacketiser<int16_t>(2, 97).read_packet(packet.data(), size, received));
+    EXPECT_FALSE(rtp_depacketiser<int16_t>(5, 96).read_packet(packet.data(), size, received));
+
+    // version 1
+    packet_data(packet)[0] = 0x40;
+    EXPECT_FALSE(depacketiser.read_packet(packet.data(), size, received));
+
+    // padding longer than the packet
+    packet_data(packet)[0] = 0xa0;
+    packet_data(packet)[size - 1] = 0xff;
+    EXPECT_FALSE(depacketiser.read_packet(packet.data(), size, received));
+
+    // an extension that runs past the end of the packet
+    packet_data(packet)[0] = 0x90;
+    packet_data(packet)[14] = 0xff;
+    EXPECT_FALSE(depacketiser.read_packet(packet.data(), size, received));
+}
+
+TEST(Rtp, RejectsMalformedPackets)
+{
+    // lengths in the packet that run past its end must not be trusted
+    rtp_depacketiser<int16_t> depacketiser(2, 96);
+    std::vector<std::uint32_t> storage(8);
+    auto* packet = reinterpret_cast<unsigned char*>(storage.data());
+    const unsigned char header[] = {0x80, 0x60, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
+    std::memcpy(packet, header, sizeof(header));
+    rtp_packet<int16_t> received;
+    ASSERT_TRUE(depacketiser.read_packet(packet, 16, received));
+    EXPECT_EQ(received.payload.frames(), 1);
+
+    // padding longer than the payload, which would wrap to a payload past the end of the packet
+    packet[0] = 0xa0;
+    packet[15] = 200;
+    EXPECT_FALSE(depacketiser.read_packet(packet, 16, received));
+    packet[15] = 5;
+    EXPECT_FALSE(depacketiser.read_packet(packet, 16, received));
+
+    // padding can't be empty, as its length byte is part of it
+    packet[15] = 0;
+    EXPECT_FALSE(depacketiser.read_packet(packet, 16, received));
+
+    // padding filling the whole payload leaves no frames
+    packet[15] = 4;
+    ASSERT_TRUE(depacketiser.read_packet(packet, 16, received));
+    EXPECT_EQ(received.payload.frames(), 0);
+
+    // CSRCs past the end of the packet
+    packet[0] = 0x82;
+    EXPECT_FALSE(depacketiser.read_packet(packet, 16, received));
+    packet[0] = 0xa2;
+    packet[15] = 1;
+    EXPECT_FALSE(depacketiser.read_packet(packet, 16, received));
+
+    // an extension header cut short by the end of the packet
+    packet[0] = 0x91;
+    EXPECT_FALSE(depacketiser.read_packet(packet, 18, received));
+
+    // an extension whose length runs past the end of the packet
+    packet[0] = 0x90;
+    packet[12] = 0xbe;
+    packet[13] = 0xde;
+    packet[14] = 0x00;
+    packet[15] = 0x03;
+    EXPECT_FALSE(depacketiser.read_packet(packet, 24, received));
+    packet[15] = 0x01;
+    ASSERT_TRUE(depacketiser.read_packet(packet, 24, received));
+    EXPECT_EQ(received.payload.frames(), 1);
+}
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+TEST(Rtp, Loopback)
+{
+    auto receiver = ::socket(AF_INET, SOCK_DGRAM, 0);
+    auto sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    ASSERT_GE(sender, 0);
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_size = sizeof(address);
+    ASSERT_EQ(::bind(receiver, reinterpret_cast<sockaddr*>(&address), address_size), 0);
+    ASSERT_EQ(::getsockname(receiver, reinterpret_cast<sockaddr*>(&address), &address_size), 0);
+
+    static constexpr std::size_t num_packets = 32;
+    rtp_packetiser<int24_t> packetiser(8, rtp_packet_frames(48000, std::chrono::microseconds(125)), 97, 42);
+    rtp_depacketiser<int24_t> depacketiser(8, 97);
+    auto packet = make_packet(packetiser.packet_bytes());
+    for (std::size_t packet_num = 0; packet_num < num_packets; ++packet_num)
+    {
+        auto size = packetiser.write_packet(make_input(8, 6, packet_num * 6), packet_data(packet));
+        ASSERT_EQ(
+            ::sendto(sender, packet.data(), size, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address)),
+            static_cast<ssize_t>(size));
+    }
+
+    auto received_packet = make_packet(1500);
+    for (std::size_t packet_num = 0; packet_num < num_packets; ++packet_num)
+    {
+        auto size = ::recv(receiver, received_packet.data(), 1500, 0);
+        ASSERT_GT(size, 0);
+        rtp_packet<int24_t> received;
+        ASSERT_TRUE(depacketiser.read_packet(received_packet.data(), static_cast<std::size_t>(size), received));
+        EXPECT_EQ(received.header.sequence_number, packet_num);
+        EXPECT_EQ(received.header.timestamp, packet_num * 6);
+        check_payload<int24_t>(received.payload, make_input(8, 6, packet_num * 6));
+    }
+
+    ::close(sender);
+    ::close(receiver);
+}
+#endif
+
+} // namespace test
+} // namespace ratl
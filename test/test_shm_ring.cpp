@@ -0,0 +1,262 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <chrono>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+
+namespace ratl
+{
+namespace test
+{
+// Names are unique to the test process so that tests running in parallel don't share rings, forked children must use
+// their parent's name
+static std::string ring_name(const char* name)
+{
+    return std::string("/ratl_test_") + name + "_" + std::to_string(::getpid());
+}
+
+static interleaved<float32_t> make_frames(std::size_t channels, std::size_t frames, std::size_t offset)
+{
+    interleaved<float32_t> input(channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            auto value = static_cast<float32_t>(((frame_num + offset) % 512) + (channel_num * 512)) / 2048.0f - 0.5f;
+            input[frame_num][channel_num] = sample<float32_t>(value);
+        }
+    }
+    return input;
+}
+
+TEST(ShmRing, RoundTrip)
+{
+    shm_ring_writer<int32_t> writer(ring_name("round_trip"), 3, 100);
+    shm_ring_reader<int32_t> reader(ring_name("round_trip"));
+    EXPECT_EQ(writer.readers(), 1);
+    EXPECT_EQ(reader.channels(), 3);
+    EXPECT_EQ(reader.capacity(), 100);
+    EXPECT_EQ(reader.read_available(), 0);
+
+    // 7 writes of 40 frames wrap around the ring a few times
+    for (std::size_t block_num = 0; block_num < 7; ++block_num)
+    {
+        auto input = make_frames(3, 40, block_num * 40);
+        EXPECT_EQ(transform(input.begin(), input.end(), writer), 40);
+        EXPECT_EQ(writer.write_available(), 60);
+
+        interleaved<float32_t> output(3, 40);
+        EXPECT_EQ(transform(reader, output.begin(), output.end()), 40);
+        EXPECT_EQ(output, input);
+    }
+}
+
+TEST(ShmRing, NetworkSpans)
+{
+    network_shm_ring_writer<int24_t> writer(ring_name("network_spans"), 2, 16);
+    network_shm_ring_reader<int24_t> reader(ring_name("network_spans"));
+    auto input = make_frames(2, 10, 0);
+    transform(input.begin(), input.end(), writer);
+
+    // the reader views the writer's frames in place, in network order
+    auto write_region = writer.write_region();
+    auto region = reader.read_region();
+    ASSERT_EQ(region.frames(), 10);
+    EXPECT_FALSE(region.wraps());
+    const_network_interleaved_span<int24_t> span = region.first();
+    EXPECT_EQ(span.channels(), 2);
+    network_interleaved<int24_t> expected(2, 10);
+    transform(input.begin(), input.end(), expected.begin());
+    for (std::size_t frame_num = 0; frame_num < 10; ++frame_num)
+    {
+        EXPECT_EQ(span[frame_num][0], expected[frame_num][0]);
+        EXPECT_EQ(span[frame_num][1], expected[frame_num][1]);
+    }
+    EXPECT_NE(static_cast<const void*>(span.data()), static_cast<const void*>(expected.data()));
+    EXPECT_EQ(write_region.frames(), 6);
+    reader.commit_read(4);
+    EXPECT_EQ(reader.read_available(), 6);
+}
+
+TEST(ShmRing, MultipleReaders)
+{
+    shm_ring_writer<int16_t> writer(ring_name("multiple_readers"), 1, 32, 2);
+    shm_ring_reader<int16_t> fast(ring_name("multiple_readers"));
+    auto input = make_frames(1, 20, 0);
+    transform(input.begin(), input.end(), writer);
+
+    // a reader joins at the writer's position, and the writer is held back by the slowest reader
+    shm_ring_reader<int16_t> slow(ring_name("multiple_readers"));
+    EXPECT_EQ(writer.readers(), 2);
+    EXPECT_EQ(fast.read_available(), 20);
+    EXPECT_EQ(slow.read_available(), 0);
+    EXPECT_EQ(writer.write_available(), 12);
+    fast.commit_read(20);
+    EXPECT_EQ(writer.write_available(), 32);
+    transform(input.begin(), input.end(), writer);
+    EXPECT_EQ(slow.read_available(), 20);
+    fast.commit_read(20);
+    EXPECT_EQ(writer.write_available(), 12);
+    EXPECT_THROW(shm_ring_reader<int16_t>(ring_name("multiple_readers")), std::runtime_error);
+    slow.commit_read(20);
+    EXPECT_EQ(writer.write_available(), 32);
+}
+
+TEST(ShmRing, Wakeups)
+{
+    shm_ring_writer<float32_t> writer(ring_name("wakeups"), 2, 64);
+    shm_ring_reader<float32_t> reader(ring_name("wakeups"));
+    EXPECT_FALSE(reader.wait_read(1, std::chrono::milliseconds(1)));
+
+    std::thread reader_thread(
+        [&reader]()
+        {
+            EXPECT_TRUE(reader.wait_read(48, std::chrono::seconds(10)));
+            reader.commit_read(48);
+        });
+    auto input = make_frames(2, 48, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    transform(input.begin(), input.end(), writer);
+    reader_thread.join();
+
+    // the writer waits for the reader to make room
+    transform(input.begin(), input.end(), writer);
+    EXPECT_FALSE(writer.wait_write(48, std::chrono::milliseconds(1)));
+    std::thread consumer_thread(
+        [&reader]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            reader.commit_read(48);
+        });
+    EXPECT_TRUE(writer.wait_write(48, std::chrono::seconds(10)));
+    consumer_thread.join();
+}
+
+TEST(ShmRing, CrossProcess)
+{
+    static constexpr std::size_t channels = 4;
+    static constexpr std::size_t period = 64;
+    static constexpr std::size_t periods = 200;
+    auto name = ring_name("cross_process");
+    shm_ring_writer<int24_t> writer(name, channels, 4 * period);
+
+    auto child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+    {
+        // the child checks every frame and reports through its exit status
+        auto status = 0;
+        {
+            shm_ring_reader<int24_t> reader(name);
+            for (std::size_t period_num = 0; period_num < periods && status == 0; ++period_num)
+            {
+                auto expected = make_frames(channels, period, period_num * period);
+                interleaved<int24_t> expected_samples(channels, period);
+                transform(expected.begin(), expected.end(), expected_samples.begin());
+                interleaved<int24_t> received(channels, period);
+                if (!reader.wait_read(period, std::chrono::seconds(10)) ||
+                    transform(reader, received.begin(), received.end()) != period || !(received == expected_samples))
+                {
+                    status = 1;
+                }
+            }
+        }
+        ::_exit(status);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (writer.readers() == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(writer.readers(), 1);
+    for (std::size_t period_num = 0; period_num < periods; ++period_num)
+    {
+        auto input = make_frames(channels, period, period_num * period);
+        ASSERT_TRUE(writer.wait_write(period, std::chrono::seconds(10)));
+        ASSERT_EQ(transform(input.begin(), input.end(), writer), period);
+    }
+
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(ShmRing, ReaderExits)
+{
+    auto name = ring_name("reader_exits");
+    shm_ring_writer<int16_t> writer(name, 2, 32);
+    auto child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+    {
+        // exits while still attached, as if it had crashed
+        new shm_ring_reader<int16_t>(name);
+        ::_exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    EXPECT_EQ(writer.readers(), 1);
+
+    auto input = make_frames(2, 32, 0);
+    transform(input.begin(), input.end(), writer);
+    EXPECT_EQ(writer.write_available(), 0);
+
+    // the writer detaches the exited reader rather than waiting for it forever
+    EXPECT_TRUE(writer.wait_write(32, std::chrono::seconds(10)));
+    EXPECT_EQ(writer.readers(), 0);
+    EXPECT_EQ(writer.release_exited_readers(), 0);
+}
+
+TEST(ShmRing, WriterCloses)
+{
+    std::unique_ptr<shm_ring_writer<int16_t>> writer(new shm_ring_writer<int16_t>(ring_name("writer_closes"), 2, 32));
+    shm_ring_reader<int16_t> reader(ring_name("writer_closes"));
+    auto input = make_frames(2, 8, 0);
+    transform(input.begin(), input.end(), *writer);
+    EXPECT_FALSE(reader.writer_closed());
+    writer.reset();
+
+    // frames already written can still be read, and the name has gone
+    EXPECT_TRUE(reader.writer_closed());
+    EXPECT_TRUE(reader.wait_read(8, std::chrono::seconds(10)));
+    EXPECT_FALSE(reader.wait_read(9, std::chrono::seconds(10)));
+    EXPECT_THROW(shm_ring_reader<int16_t>(ring_name("writer_closes")), std::system_error);
+}
+
+TEST(ShmRing, Errors)
+{
+    EXPECT_THROW(shm_ring_reader<int16_t>(ring_name("missing")), std::system_error);
+    EXPECT_THROW(shm_ring_writer<int16_t>(ring_name("errors"), 0, 32), std::invalid_argument);
+    EXPECT_THROW(shm_ring_writer<int16_t>(ring_name("errors"), 2, 0), std::invalid_argument);
+
+    shm_ring_writer<int16_t> writer(ring_name("errors"), 2, 32);
+    EXPECT_THROW(shm_ring_writer<int16_t>(ring_name("errors"), 2, 32), std::system_error);
+    EXPECT_THROW(shm_ring_reader<int32_t>(ring_name("errors")), std::runtime_error);
+    EXPECT_THROW(network_shm_ring_reader<int16_t>(ring_name("errors")), std::runtime_error);
+    shm_ring_reader<int16_t> reader(ring_name("errors"));
+}
+
+} // namespace test
+} // namespace ratl
+
+#endif
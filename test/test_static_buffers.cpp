@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <cstdint>
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleType>
+static SampleType sample_for(std::size_t channel_num, std::size_t frame_num)
+{
+    auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+    return reference_convert<SampleType>(sample<int32_t>(value));
+}
+
+template<typename ContainerType>
+static void fill_container(ContainerType& container)
+{
+    using sample_type = typename ContainerType::sample_type;
+    for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < container.frames(); ++frame_num)
+        {
+            container.channel(channel_num)[frame_num] = sample_for<sample_type>(channel_num, frame_num);
+        }
+    }
+}
+
+template<typename ContainerType>
+static void check_container(const ContainerType& container, std::size_t old_channels, std::size_t old_frames)
+{
+    using sample_type = typename ContainerType::sample_type;
+    for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < container.frames(); ++frame_num)
+        {
+            if ((channel_num < old_channels) && (frame_num < old_frames))
+            {
+                EXPECT_EQ(container.channel(channel_num)[frame_num], sample_for<sample_type>(channel_num, frame_num));
+            }
+            else
+            {
+                EXPECT_EQ(container.channel(channel_num)[frame_num], sample_type());
+            }
+        }
+    }
+}
+
+template<typename ContainerType>
+class StaticBuffer : public ::testing::Test
+{
+};
+
+using PossibleStaticBuffers = ::testing::Types<
+    static_interleaved<int16_t, 8, 16>,
+    static_interleaved<int24_t, 8, 16>,
+    static_interleaved<int32_t, 8, 16>,
+    static_interleaved<float32_t, 8, 16>,
+    network_static_interleaved<int24_t, 8, 16>,
+    static_noninterleaved<int16_t, 8, 16>,
+    static_noninterleaved<int24_t, 8, 16>,
+    static_noninterleaved<int32_t, 8, 16>,
+    static_noninterleaved<float32_t, 8, 16>,
+    network_static_noninterleaved<int24_t, 8, 16>>;
+
+TYPED_TEST_SUITE(StaticBuffer, PossibleStaticBuffers, );
+
+TYPED_TEST(StaticBuffer, DefaultConstructor)
+{
+    TypeParam container;
+    EXPECT_EQ(container.channels(), 8);
+    EXPECT_EQ(container.frames(), 16);
+    EXPECT_EQ(TypeParam::capacity(), 128);
+    check_container(container, 0, 0);
+}
+
+TYPED_TEST(StaticBuffer, Alignment)
+{
+    TypeParam container(2, 3);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(container.data()) % RATL_SIMD_ALIGNMENT, 0);
+    EXPECT_EQ(alignof(TypeParam) % RATL_SIMD_ALIGNMENT, 0);
+}
+
+TYPED_TEST(StaticBuffer, DataIsInObject)
+{
+    TypeParam container(2, 3);
+    auto object_begin = reinterpret_cast<const unsigned char*>(&container);
+    auto data_begin = reinterpret_cast<const unsigned char*>(container.data());
+    EXPECT_GE(data_begin, object_begin);
+    EXPECT_LT(data_begin, object_begin + sizeof(TypeParam));
+}
+
+TYPED_TEST(StaticBuffer, SizedConstructor)
+{
+    TypeParam container(3, 5);
+    EXPECT_EQ(container.channels(), 3);
+    EXPECT_EQ(container.frames(), 5);
+    EXPECT_EQ(container.samples(), 15);
+    check_container(container, 0, 0);
+}
+
+TYPED_TEST(StaticBuffer, TooLarge)
+{
+    EXPECT_THROW(TypeParam(9, 16), std::length_error);
+    EXPECT_THROW(TypeParam(for_overwrite, 8, 17), std::length_error);
+    // each dimension is limited, even when the total number of samples would fit
+    EXPECT_THROW(TypeParam(16, 8), std::length_error);
+    EXPECT_THROW(TypeParam(for_overwrite, 1, 17), std::length_error);
+    EXPECT_NO_THROW(TypeParam(8, 16));
+    TypeParam container;
+    EXPECT_THROW(container.resize(9, 1), std::length_error);
+    EXPECT_THROW(container.resize(129, 1), std::length_error);
+    EXPECT_THROW(container.resize(for_overwrite, 1, 17), std::length_error);
+    EXPECT_EQ(container.channels(), 8);
+    EXPECT_EQ(container.frames(), 16);
+}
+
+TYPED_TEST(StaticBuffer, Copy)
+{
+    TypeParam container(3, 5);
+    fill_container(container);
+    TypeParam copy(container);
+    EXPECT_EQ(copy, container);
+    TypeParam assigned(1, 1);
+    assigned = container;
+    EXPECT_EQ(assigned, container);
+}
+
+TYPED_TEST(StaticBuffer, Resize)
+{
+    TypeParam container(3, 5);
+    fill_container(container);
+    container.resize(4, 7);
+    check_container(container, 3, 5);
+
+    fill_container(container);
+    container.resize(2, 9);
+    check_container(container, 2, 7);
+
+    fill_container(container);
+    container.resize(6, 3);
+    check_container(container, 2, 3);
+}
+
+TYPED_TEST(StaticBuffer, At)
+{
+    TypeParam container(3, 5);
+    EXPECT_THROW(container.at(container.end() - container.begin()), std::out_of_range);
+    EXPECT_NO_THROW(container.at(0));
+}
+
+TYPED_TEST(StaticBuffer, TransformRoundTrip)
+{
+    TypeParam container(3, 5);
+    fill_container(container);
+    interleaved<float32_t> intermediate(3, 5);
+    TypeParam output(3, 5);
+    transform(container.begin(), container.end(), intermediate.begin());
+    transform(intermediate.begin(), intermediate.end(), output.begin());
+    EXPECT_EQ(output, container);
+}
+
+TEST(StaticBuffer, TransformInterleavedToNoninterleaved)
+{
+    static_interleaved<int16_t, 2, 32> input;
+    fill_container(input);
+    static_noninterleaved<int16_t, 2, 32> output;
+    transform(input.begin(), input.end(), output.begin());
+    for (std::size_t channel_num = 0; channel_num < 2; ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < 32; ++frame_num)
+        {
+            EXPECT_EQ(output.channel(channel_num)[frame_num], input.channel(channel_num)[frame_num]);
+        }
+    }
+}
+
+} // namespace test
+} // namespace ratl
@@ -0,0 +1,346 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <utility>
+#include <vector>
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleType>
+static SampleType sample_for(std::size_t channel_num, std::size_t frame_num)
+{
+    auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+    return reference_convert<SampleType>(sample<int32_t>(value));
+}
+
+// The transform entry points, so that the static extent kernels can be checked for each of them
+struct reference_tier
+{
+    template<typename... Args>
+    static auto apply(Args&&... args)
+    {
+        return reference_transform(std::forward<Args>(args)...);
+    }
+};
+
+struct fast_tier
+{
+    template<typename... Args>
+    static auto apply(Args&&... args)
+    {
+        return fast_transform(std::forward<Args>(args)...);
+    }
+};
+
+struct standard_tier
+{
+    template<typename... Args>
+    static auto apply(Args&&... args)
+    {
+        return transform(std::forward<Args>(args)...);
+    }
+};
+
+TEST(StaticExtent, Channels)
+{
+    std::vector<sample<float32_t>> storage(2 * 8);
+    auto span = interleaved_span<float32_t, 2>(storage.data(), 2, 8);
+    EXPECT_EQ(span.channels(), 2);
+    EXPECT_EQ(span.frames(), 8);
+    EXPECT_EQ(span.begin().channels(), 2);
+    EXPECT_EQ(span.front().channels(), 2);
+    EXPECT_EQ(span.end() - span.begin(), 8);
+}
+
+TEST(StaticExtent, Conversions)
+{
+    interleaved<int16_t> buffer(6, 4);
+    auto dynamic_span = interleaved_span<int16_t>(buffer);
+    auto static_span = interleaved_span<int16_t, 6>(dynamic_span);
+    EXPECT_EQ(static_span.data(), buffer.data());
+    EXPECT_EQ(static_span.channels(), 6);
+    EXPECT_EQ(static_span.frames(), 4);
+
+    interleaved_span<int16_t> converted_span = static_span;
+    EXPECT_EQ(converted_span.data(), buffer.data());
+    EXPECT_EQ(converted_span.channels(), 6);
+
+    const_interleaved_span<int16_t, 6>::const_iterator const_iter = static_span.begin();
+    interleaved_span<int16_t>::const_iterator dynamic_iter = const_iter;
+    EXPECT_EQ(dynamic_iter.base(), buffer.data());
+    EXPECT_EQ(dynamic_iter.channels(), 6);
+
+    auto static_frame = static_span.frame(1);
+    basic_frame_span<sample<int16_t>, detail::sample_traits<sample<int16_t>>, std::true_type> dynamic_frame =
+        static_frame;
+    EXPECT_EQ(dynamic_frame.data(), buffer.data() + 6);
+    EXPECT_EQ(dynamic_frame.channels(), 6);
+}
+
+TEST(StaticExtent, FrameSpan)
+{
+    std::vector<sample<int32_t>> storage(8 * 3);
+    auto frame = frame_span<int32_t, 8>(storage.data() + 1, 8, 3);
+    EXPECT_EQ(frame.channels(), 8);
+    EXPECT_EQ(frame.end() - frame.begin(), 8);
+    frame.back() = sample<int32_t>(42);
+    EXPECT_EQ(storage[1 + (7 * 3)], sample<int32_t>(42));
+    EXPECT_THROW(frame.at(8), std::out_of_range);
+}
+
+template<typename SampleValueTypeCombination>
+class StaticExtentTransform : public ::testing::Test
+{
+public:
+    using input_sample_type = sample<typename SampleValueTypeCombination::input_sample_value_type>;
+    using output_sample_type = sample<typename SampleValueTypeCombination::output_sample_value_type>;
+
+    template<std::size_t Channels>
+    static void interleaved_to_noninterleaved(std::size_t frames)
+    {
+        interleaved<typename input_sample_type::value_type> input(Channels, frames);
+        for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+        {
+            for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+            {
+                input[frame_num][channel_num] = sample_for<input_sample_type>(channel_num, frame_num);
+            }
+        }
+        auto input_span = const_interleaved_span<typename input_sample_type::value_type, Channels>(
+            input.data(), Channels, frames);
+
+        // pad each output channel to check that the pitch is respected
+        auto pitch = frames + 3;
+        std::vector<output_sample_type> storage(Channels * pitch);
+        auto output_span = noninterleaved_span<typename output_sample_type::value_type>(
+            storage.data(), Channels, frames, pitch);
+
+        auto output_end = reference_transform(input_span.begin(), input_span.end(), output_span.begin());
+        EXPECT_EQ(output_end, output_span.end());
+        for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+        {
+            for (std::size_t frame_num = 0; frame_num < pitch; ++frame_num)
+            {
+                auto expected = frame_num < frames
+                                    ? reference_convert<output_sample_type>(input[frame_num][channel_num])
+                                    : output_sample_type();
+                EXPECT_EQ(storage[(channel_num * pitch) + frame_num], expected);
+            }
+        }
+    }
+
+    template<std::size_t Channels>
+    static void noninterleaved_to_interleaved(std::size_t frames)
+    {
+        auto pitch = frames + 5;
+        std::vector<input_sample_type> storage(Channels * pitch);
+        for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+        {
+            for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+            {
+                storage[(channel_num * pitch) + frame_num] = sample_for<input_sample_type>(channel_num, frame_num);
+            }
+        }
+        auto input_span = const_noninterleaved_span<typename input_sample_type::value_type>(
+            storage.data(), Channels, frames, pitch);
+
+        interleaved<typename output_sample_type::value_type> output(Channels, frames);
+        auto output_span =
+            interleaved_span<typename output_sample_type::value_type, Channels>(output.data(), Channels, frames);
+
+        auto output_end = reference_transform(input_span.begin(), input_span.end(), output_span.begin());
+        EXPECT_EQ(output_end, output_span.end());
+        for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+        {
+            for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+            {
+                EXPECT_EQ(
+                    output[frame_num][channel_num],
+                    reference_convert<output_sample_type>(storage[(channel_num * pitch) + frame_num]));
+            }
+        }
+    }
+};
+
+TYPED_TEST_SUITE(StaticExtentTransform, PossibleSampleValueTypeCombinations, );
+
+TYPED_TEST(StaticExtentTransform, InterleavedToNoninterleaved)
+{
+    TestFixture::template interleaved_to_noninterleaved<1>(17);
+    TestFixture::template interleaved_to_noninterleaved<2>(33);
+    TestFixture::template interleaved_to_noninterleaved<6>(9);
+    TestFixture::template interleaved_to_noninterleaved<8>(5);
+}
+
+TYPED_TEST(StaticExtentTransform, NoninterleavedToInterleaved)
+{
+    TestFixture::template noninterleaved_to_interleaved<1>(17);
+    TestFixture::template noninterleaved_to_interleaved<2>(33);
+    TestFixture::template noninterleaved_to_interleaved<6>(9);
+    TestFixture::template noninterleaved_to_interleaved<8>(5);
+}
+
+TYPED_TEST(StaticExtentTransform, FewerInputChannels)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+
+    noninterleaved<typename input_sample_type::value_type> input(1, 4);
+    for (std::size_t frame_num = 0; frame_num < 4; ++frame_num)
+    {
+        input[0][frame_num] = sample_for<input_sample_type>(0, frame_num);
+    }
+    interleaved<typename output_sample_type::value_type> output(2, 4);
+    auto output_span = interleaved_span<typename output_sample_type::value_type, 2>(output.data(), 2, 4);
+
+    // falls back to transforming the available channels of each frame
+    auto output_end = reference_transform(input.begin(), input.end(), output_span.begin());
+    EXPECT_EQ(output_end, output_span.end());
+    for (std::size_t frame_num = 0; frame_num < 4; ++frame_num)
+    {
+        EXPECT_EQ(output[frame_num][0], reference_convert<output_sample_type>(input[0][frame_num]));
+        EXPECT_EQ(output[frame_num][1], output_sample_type());
+    }
+}
+
+TYPED_TEST(StaticExtentTransform, InterleavedDifferentChannels)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+
+    interleaved<typename input_sample_type::value_type> input(2, 4);
+    for (std::size_t frame_num = 0; frame_num < 4; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < 2; ++channel_num)
+        {
+            input[frame_num][channel_num] = sample_for<input_sample_type>(channel_num, frame_num);
+        }
+    }
+    auto input_span = interleaved_span<typename input_sample_type::value_type, 2>(input.data(), 2, 4);
+    interleaved<typename output_sample_type::value_type> output(8, 4);
+    auto output_span = interleaved_span<typename output_sample_type::value_type, 8>(output.data(), 8, 4);
+
+    auto output_end = reference_transform(input_span.begin(), input_span.end(), output_span.begin());
+    EXPECT_EQ(output_end, output_span.end());
+    for (std::size_t frame_num = 0; frame_num < 4; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < 8; ++channel_num)
+        {
+            auto expected = channel_num < 2 ? reference_convert<output_sample_type>(input[frame_num][channel_num])
+                                            : output_sample_type();
+            EXPECT_EQ(output[frame_num][channel_num], expected);
+        }
+    }
+}
+
+// Static extent spans must give the same samples as dynamic extent spans for every transform tier, including when the
+// frames don't fit in a single chunk of the static extent kernel
+template<typename Tier, typename InputSampleType, typename OutputSampleType, std::size_t Channels>
+static void check_matches_dynamic_extent(std::size_t frames)
+{
+    using input_interleaved_span = basic_interleaved_span<InputSampleType, detail::sample_traits<InputSampleType>>;
+    using output_interleaved_span = basic_interleaved_span<OutputSampleType, detail::sample_traits<OutputSampleType>>;
+    using input_static_span =
+        basic_interleaved_span<InputSampleType, detail::sample_traits<InputSampleType>, Channels>;
+    using output_static_span =
+        basic_interleaved_span<OutputSampleType, detail::sample_traits<OutputSampleType>, Channels>;
+    using output_planar_span = basic_planar_span<OutputSampleType, detail::sample_traits<OutputSampleType>>;
+    using input_planar_span = basic_planar_span<InputSampleType, detail::sample_traits<InputSampleType>>;
+
+    std::vector<InputSampleType> interleaved_input(Channels * frames);
+    basic_noninterleaved<InputSampleType> noninterleaved_input(Channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < Channels; ++channel_num)
+        {
+            auto input = sample_for<InputSampleType>(channel_num, frame_num);
+            interleaved_input[(frame_num * Channels) + channel_num] = input;
+            noninterleaved_input.channel(channel_num)[frame_num] = input;
+        }
+    }
+    auto dynamic_input = input_interleaved_span(interleaved_input.data(), Channels, frames);
+    auto static_input = input_static_span(interleaved_input.data(), Channels, frames);
+
+    // interleaved to noninterleaved
+    basic_noninterleaved<OutputSampleType> dynamic_noninterleaved(Channels, frames);
+    basic_noninterleaved<OutputSampleType> static_noninterleaved(Channels, frames);
+    Tier::apply(dynamic_input.begin(), dynamic_input.end(), dynamic_noninterleaved.begin());
+    auto noninterleaved_end = Tier::apply(static_input.begin(), static_input.end(), static_noninterleaved.begin());
+    EXPECT_EQ(noninterleaved_end, static_noninterleaved.end());
+    EXPECT_EQ(static_noninterleaved, dynamic_noninterleaved);
+
+    // noninterleaved to interleaved
+    std::vector<OutputSampleType> dynamic_interleaved(Channels * frames);
+    std::vector<OutputSampleType> static_interleaved(Channels * frames);
+    auto dynamic_output = output_interleaved_span(dynamic_interleaved.data(), Channels, frames);
+    auto static_output = output_static_span(static_interleaved.data(), Channels, frames);
+    Tier::apply(noninterleaved_input.begin(), noninterleaved_input.end(), dynamic_output.begin());
+    auto interleaved_end = Tier::apply(noninterleaved_input.begin(), noninterleaved_input.end(), static_output.begin());
+    EXPECT_EQ(interleaved_end, static_output.end());
+    EXPECT_EQ(static_interleaved, dynamic_interleaved);
+
+    // interleaved to planar and back
+    std::vector<OutputSampleType*> planar_pointers;
+    for (auto channel : static_noninterleaved)
+    {
+        std::fill(channel.begin(), channel.end(), OutputSampleType());
+        planar_pointers.push_back(channel.data());
+    }
+    auto planar_output = output_planar_span(planar_pointers.data(), Channels, frames);
+    auto planar_end = Tier::apply(static_input.begin(), static_input.end(), planar_output.begin());
+    EXPECT_EQ(planar_end, planar_output.end());
+    EXPECT_EQ(static_noninterleaved, dynamic_noninterleaved);
+
+    std::vector<InputSampleType*> input_planar_pointers;
+    for (auto channel : noninterleaved_input)
+    {
+        input_planar_pointers.push_back(channel.data());
+    }
+    auto planar_input = input_planar_span(input_planar_pointers.data(), Channels, frames);
+    std::fill(static_interleaved.begin(), static_interleaved.end(), OutputSampleType());
+    interleaved_end = Tier::apply(planar_input.begin(), planar_input.end(), static_output.begin());
+    EXPECT_EQ(interleaved_end, static_output.end());
+    EXPECT_EQ(static_interleaved, dynamic_interleaved);
+}
+
+template<typename Tier, typename InputSampleType, typename OutputSampleType>
+static void check_tier_matches_dynamic_extent()
+{
+    check_matches_dynamic_extent<Tier, InputSampleType, OutputSampleType, 1>(17);
+    check_matches_dynamic_extent<Tier, InputSampleType, OutputSampleType, 2>(1000);
+    check_matches_dynamic_extent<Tier, InputSampleType, OutputSampleType, 6>(9);
+    check_matches_dynamic_extent<Tier, InputSampleType, OutputSampleType, 8>(300);
+}
+
+TYPED_TEST(StaticExtentTransform, MatchesDynamicExtent)
+{
+    using input_sample_type = typename TestFixture::input_sample_type;
+    using output_sample_type = typename TestFixture::output_sample_type;
+
+    check_tier_matches_dynamic_extent<reference_tier, input_sample_type, output_sample_type>();
+    check_tier_matches_dynamic_extent<fast_tier, input_sample_type, output_sample_type>();
+    check_tier_matches_dynamic_extent<standard_tier, input_sample_type, output_sample_type>();
+}
+
+TEST(StaticExtentTransform, NetworkMatchesDynamicExtent)
+{
+    check_tier_matches_dynamic_extent<reference_tier, network_sample<int24_t>, sample<float32_t>>();
+    check_tier_matches_dynamic_extent<fast_tier, network_sample<int24_t>, sample<float32_t>>();
+    check_tier_matches_dynamic_extent<standard_tier, network_sample<int24_t>, sample<float32_t>>();
+    check_tier_matches_dynamic_extent<reference_tier, sample<float32_t>, network_sample<int24_t>>();
+    check_tier_matches_dynamic_extent<fast_tier, sample<float32_t>, network_sample<int24_t>>();
+    check_tier_matches_dynamic_extent<standard_tier, sample<float32_t>, network_sample<int24_t>>();
+}
+
+} // namespace test
+} // namespace ratl
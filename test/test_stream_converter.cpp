@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <cstring>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+#if !defined(RATL_CPP_PLATFORM_WINDOWS)
+
+namespace ratl
+{
+namespace test
+{
+class StreamConverter : public ::testing::TestWithParam<stream_io_backend>
+{
+};
+
+class TestFile
+{
+private:
+    std::string path_;
+    int fd_;
+
+public:
+    explicit TestFile(const std::string& name) :
+        path_(::testing::TempDir() + name), fd_(::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644))
+    {
+    }
+
+    TestFile(const TestFile&) = delete;
+    TestFile& operator=(const TestFile&) = delete;
+
+    ~TestFile()
+    {
+        ::close(fd_);
+        ::unlink(path_.c_str());
+    }
+
+    int fd() const noexcept
+    {
+        return fd_;
+    }
+
+    void write(const void* data, std::size_t size, std::uint64_t offset)
+    {
+        ASSERT_EQ(::pwrite(fd_, data, size, static_cast<off_t>(offset)), static_cast<ssize_t>(size));
+    }
+
+    std::vector<unsigned char> read(std::size_t size, std::uint64_t offset)
+    {
+        std::vector<unsigned char> data(size);
+        EXPECT_EQ(::pread(fd_, data.data(), size, static_cast<off_t>(offset)), static_cast<ssize_t>(size));
+        return data;
+    }
+};
+
+static stream_converter_options small_blocks(stream_io_backend backend)
+{
+    stream_converter_options options;
+    options.block_frames = 1000;
+    options.blocks = 4;
+    options.backend = backend;
+    options.io_threads = 2;
+    return options;
+}
+
+// Returns nullptr if the backend isn't supported here
+template<typename Converter>
+static std::unique_ptr<Converter> make_converter(std::size_t channels, const stream_converter_options& options)
+{
+    try
+    {
+        return std::unique_ptr<Converter>(new Converter(channels, options));
+    }
+    catch (const std::system_error&)
+    {
+        EXPECT_EQ(options.backend, stream_io_backend::io_uring);
+        return nullptr;
+    }
+}
+
+template<typename SampleValueType>
+static interleaved<SampleValueType> make_input(std::size_t channels, std::size_t frames)
+{
+    interleaved<float32_t> input(channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            auto value = static_cast<float32_t>((frame_num * 7 + channel_num * 131) % 2001) / 1000.0f - 1.0f;
+            input[frame_num][channel_num] = sample<float32_t>(value * 0.999f);
+        }
+    }
+    interleaved<SampleValueType> converted(channels, frames);
+    transform(input.begin(), input.end(), converted.begin());
+    return converted;
+}
+
+TEST_P(StreamConverter, Convert)
+{
+    static constexpr std::size_t channels = 3;
+    static constexpr std::size_t frames = 10037;
+    static constexpr std::uint64_t input_offset = 44;
+    static constexpr std::uint64_t output_offset = 12;
+    auto converter = make_converter<stream_converter<int16_t, float32_t>>(channels, small_blocks(GetParam()));
+    if (!converter)
+    {
+        return;
+    }
+    EXPECT_EQ(converter->channels(), channels);
+    EXPECT_NE(converter->backend(), stream_io_backend::automatic);
+
+    auto input = make_input<int16_t>(channels, frames);
+    TestFile input_file("stream_converter_convert.in");
+    TestFile output_file("stream_converter_convert.out");
+    input_file.write(input.data(), input.samples() * sizeof(sample<int16_t>), input_offset);
+
+    // the converter can be used again, and its buffers are reused
+    for (auto pass = 0; pass < 2; ++pass)
+    {
+        auto stats = converter->convert(input_file.fd(), input_offset, output_file.fd(), output_offset, frames);
+        EXPECT_EQ(stats.backend, converter->backend());
+        EXPECT_EQ(stats.frames, frames);
+        EXPECT_EQ(stats.bytes_read, frames * channels * sizeof(sample<int16_t>));
+        EXPECT_EQ(stats.bytes_written, frames * channels * sizeof(sample<float32_t>));
+        EXPECT_GT(stats.seconds, 0.0);
+        EXPECT_GE(stats.megabytes_per_second(), 0.0);
+        EXPECT_GE(stats.cpu_utilisation(), 0.0);
+
+        interleaved<float32_t> expected(channels, frames);
+        transform(input.begin(), input.end(), expected.begin());
+        auto output = output_file.read(expected.samples() * sizeof(sample<float32_t>), output_offset);
+        EXPECT_EQ(std::memcmp(output.data(), expected.data(), output.size()), 0);
+    }
+}
+
+TEST_P(StreamConverter, NetworkInput)
+{
+    static constexpr std::size_t channels = 2;
+    static constexpr std::size_t frames = 4000;
+    using converter_type = basic_stream_converter<network_sample<int24_t>, sample<int32_t>>;
+    auto converter = make_converter<converter_type>(channels, small_blocks(GetParam()));
+    if (!converter)
+    {
+        return;
+    }
+
+    auto input = make_input<float32_t>(channels, frames);
+    network_interleaved<int24_t> network_input(channels, frames);
+    transform(input.begin(), input.end(), network_input.begin());
+    TestFile input_file("stream_converter_network.in");
+    TestFile output_file("stream_converter_network.out");
+    input_file.write(network_input.data(), network_input.samples() * sizeof(network_sample<int24_t>), 0);
+    converter->convert(input_file.fd(), 0, output_file.fd(), 0, frames);
+
+    interleaved<int32_t> expected(channels, frames);
+    transform(network_input.begin(), network_input.end(), expected.begin());
+    auto output = output_file.read(expected.samples() * sizeof(sample<int32_t>), 0);
+    EXPECT_EQ(std::memcmp(output.data(), expected.data(), output.size()), 0);
+}
+
+TEST_P(StreamConverter, Dither)
+{
+    static constexpr std::size_t channels = 2;
+    static constexpr std::size_t frames = 5500;
+    auto options = small_blocks(GetParam());
+    options.dither = true;
+    auto converter = make_converter<stream_converter<float32_t, int16_t>>(channels, options);
+    if (!converter)
+    {
+        return;
+    }
+
+    auto input = make_input<float32_t>(channels, frames);
+    TestFile input_file("stream_converter_dither.in");
+    TestFile output_file("stream_converter_dither.out");
+    input_file.write(input.data(), input.samples() * sizeof(sample<float32_t>), 0);
+    converter->convert(input_file.fd(), 0, output_file.fd(), 0, frames);
+
+    // blocks are dithered in order, exactly as if they had been converted one after another
+    dither_generator dither_gen;
+    interleaved<int16_t> expected(channels, frames);
+    for (std::size_t first_frame = 0; first_frame < frames; first_frame += options.block_frames)
+    {
+        auto block_frames = std::min(options.block_frames, frames - first_frame);
+        auto offset = first_frame * channels;
+        auto block_input = const_interleaved_span<float32_t>(input.data() + offset, channels, block_frames);
+        auto block_output = interleaved_span<int16_t>(expected.data() + offset, channels, block_frames);
+        transform(block_input.begin(), block_input.end(), block_output.begin(), dither_gen);
+    }
+    auto output = output_file.read(expected.samples() * sizeof(sample<int16_t>), 0);
+    EXPECT_EQ(std::memcmp(output.data(), expected.data(), output.size()), 0);
+}
+
+TEST_P(StreamConverter, Errors)
+{
+    auto converter = make_converter<stream_converter<int16_t, int32_t>>(2, small_blocks(GetParam()));
+    if (!converter)
+    {
+        return;
+    }
+
+    // the input ends part way through the third block
+    auto input = make_input<int16_t>(2, 2500);
+    TestFile input_file("stream_converter_errors.in");
+    TestFile output_file("stream_converter_errors.out");
+    input_file.write(input.data(), input.samples() * sizeof(sample<int16_t>), 0);
+    EXPECT_THROW(converter->convert(input_file.fd(), 0, output_file.fd(), 0, 6000), std::system_error);
+    EXPECT_THROW(converter->convert(input_file.fd(), 0, -1, 0, 2500), std::system_error);
+    EXPECT_NO_THROW(converter->convert(input_file.fd(), 0, output_file.fd(), 0, 2500));
+    EXPECT_NO_THROW(converter->convert(input_file.fd(), 0, output_file.fd(), 0, 0));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Backends,
+    StreamConverter,
+    ::testing::Values(stream_io_backend::io_uring, stream_io_backend::threads, stream_io_backend::automatic));
+
+TEST(StreamConverterOptions, Errors)
+{
+    using converter = stream_converter<int16_t, int32_t>;
+    stream_converter_options options;
+    EXPECT_THROW(converter(0, options), std::invalid_argument);
+    options.block_frames = 0;
+    EXPECT_THROW(converter(2, options), std::invalid_argument);
+    options.block_frames = 1024;
+    options.blocks = 0;
+    EXPECT_THROW(converter(2, options), std::invalid_argument);
+}
+
+} // namespace test
+} // namespace ratl
+
+#endif
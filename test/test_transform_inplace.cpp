@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleType>
+static SampleType sample_for(std::size_t channel_num, std::size_t frame_num)
+{
+    auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+    return reference_convert<SampleType>(sample<int32_t>(value));
+}
+
+template<typename ContainerType>
+static void fill_container(ContainerType& container)
+{
+    using sample_type = typename ContainerType::sample_type;
+    for (std::size_t channel_num = 0; channel_num < container.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < container.frames(); ++frame_num)
+        {
+            container.channel(channel_num)[frame_num] = sample_for<sample_type>(channel_num, frame_num);
+        }
+    }
+}
+
+template<typename ExpectedType, typename ActualType>
+static void check_channels(const ExpectedType& expected, const ActualType& actual)
+{
+    ASSERT_EQ(actual.channels(), expected.channels());
+    ASSERT_EQ(actual.frames(), expected.frames());
+    for (std::size_t channel_num = 0; channel_num < expected.channels(); ++channel_num)
+    {
+        for (std::size_t frame_num = 0; frame_num < expected.frames(); ++frame_num)
+        {
+            EXPECT_EQ(actual.channel(channel_num)[frame_num], expected.channel(channel_num)[frame_num]);
+        }
+    }
+}
+
+template<typename InputSampleType, typename OutputSampleType>
+struct SampleTypeCombination
+{
+    using input_sample_type = InputSampleType;
+    using output_sample_type = OutputSampleType;
+};
+
+template<typename SampleValueType>
+using HostSampleType = ::testing::Types<sample<SampleValueType>>;
+
+template<typename SampleValueType>
+using NetworkSampleType = ::testing::Types<network_sample<SampleValueType>>;
+
+// Every sample type can be converted to a host sample, but only host samples can be converted to network samples
+using PossibleSampleTypeCombinations = testing_types_concat_t<
+    testing_types_combine_t<
+        SampleTypeCombination,
+        PossibleSampleTypes,
+        testing_types_combine_t<HostSampleType, PossibleSampleValueTypes>>,
+    testing_types_combine_t<
+        SampleTypeCombination,
+        testing_types_combine_t<HostSampleType, PossibleSampleValueTypes>,
+        testing_types_combine_t<NetworkSampleType, PossibleSampleValueTypes>>>;
+
+template<typename SampleTypeCombination>
+class TransformInplace : public ::testing::Test
+{
+public:
+    using input_sample_type = typename SampleTypeCombination::input_sample_type;
+    using output_sample_type = typename SampleTypeCombination::output_sample_type;
+
+    // In-place transforms can only narrow samples, so there is nothing to test for widening combinations
+    using is_narrowing = std::integral_constant<
+        bool,
+        (sizeof(output_sample_type) <= sizeof(input_sample_type)) &&
+            (alignof(output_sample_type) <= alignof(input_sample_type))>;
+
+    static void interleaved(std::true_type)
+    {
+        basic_interleaved<input_sample_type> input(3, 37);
+        fill_container(input);
+        basic_interleaved<output_sample_type> expected(3, 37);
+        reference_transform(input.begin(), input.end(), expected.begin());
+
+        auto span = basic_interleaved_span<input_sample_type, detail::sample_traits<input_sample_type>>(input);
+        auto output = reference_transform_inplace<output_sample_type>(span);
+        EXPECT_EQ(static_cast<void*>(output.data()), static_cast<void*>(input.data()));
+        check_channels(expected, output);
+    }
+
+    static void interleaved(std::false_type) {}
+
+    static void noninterleaved(std::true_type)
+    {
+        // padded channels are packed as they are transformed
+        basic_noninterleaved<input_sample_type, ratl::allocator<input_sample_type>, aligned_channel_layout<>> input(
+            4, 37);
+        fill_container(input);
+        basic_noninterleaved<output_sample_type> expected(4, 37);
+        reference_transform(input.begin(), input.end(), expected.begin());
+
+        auto span = basic_noninterleaved_span<input_sample_type, detail::sample_traits<input_sample_type>>(input);
+        auto output = reference_transform_inplace<output_sample_type>(span);
+        EXPECT_EQ(static_cast<void*>(output.data()), static_cast<void*>(input.data()));
+        EXPECT_EQ(output.pitch(), output.frames());
+        check_channels(expected, output);
+    }
+
+    static void noninterleaved(std::false_type) {}
+
+    static void default_transform(std::true_type)
+    {
+        basic_noninterleaved<input_sample_type> input(2, 67);
+        fill_container(input);
+        basic_noninterleaved<output_sample_type> expected(2, 67);
+        transform(input.begin(), input.end(), expected.begin());
+
+        auto span = basic_noninterleaved_span<input_sample_type, detail::sample_traits<input_sample_type>>(input);
+        auto output = transform_inplace<output_sample_type>(span);
+        check_channels(expected, output);
+    }
+
+    static void default_transform(std::false_type) {}
+};
+
+TYPED_TEST_SUITE(TransformInplace, PossibleSampleTypeCombinations, );
+
+TYPED_TEST(TransformInplace, Interleaved)
+{
+    TestFixture::interleaved(typename TestFixture::is_narrowing());
+}
+
+TYPED_TEST(TransformInplace, Noninterleaved)
+{
+    TestFixture::noninterleaved(typename TestFixture::is_narrowing());
+}
+
+TYPED_TEST(TransformInplace, DefaultTransform)
+{
+    TestFixture::default_transform(typename TestFixture::is_narrowing());
+}
+
+TEST(TransformInplace, Dither)
+{
+    interleaved<float32_t> input(2, 16);
+    fill_container(input);
+    dither_generator dither_gen;
+    auto output = transform_inplace<sample<int16_t>>(interleaved_span<float32_t>(input), dither_gen);
+    EXPECT_EQ(output.channels(), 2);
+    EXPECT_EQ(output.frames(), 16);
+}
+
+template<typename SampleValueType>
+class ReverseEndiannessInplace : public ::testing::Test
+{
+};
+
+TYPED_TEST_SUITE(ReverseEndiannessInplace, PossibleSampleValueTypes, );
+
+TYPED_TEST(ReverseEndiannessInplace, RoundTrip)
+{
+    interleaved<TypeParam> input(3, 41);
+    fill_container(input);
+    interleaved<TypeParam> original(input);
+    network_interleaved<TypeParam> expected(3, 41);
+    reference_transform(input.begin(), input.end(), expected.begin());
+
+    auto network = reverse_endianness_inplace(interleaved_span<TypeParam>(input));
+    static_assert(std::is_same<decltype(network), network_interleaved_span<TypeParam>>::value, "");
+    check_channels(expected, network);
+
+    auto host = reverse_endianness_inplace(network);
+    static_assert(std::is_same<decltype(host), interleaved_span<TypeParam>>::value, "");
+    check_channels(original, host);
+}
+
+} // namespace test
+} // namespace ratl
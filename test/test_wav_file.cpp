@@ -0,0 +1,346 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleValueType>
+static sample<SampleValueType> sample_for(std::size_t channel_num, std::size_t frame_num)
+{
+    auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+    return reference_convert<sample<SampleValueType>>(sample<int32_t>(value));
+}
+
+template<typename SampleValueType>
+static interleaved<SampleValueType> make_samples(std::size_t channels, std::size_t frames)
+{
+    interleaved<SampleValueType> samples(channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            samples[frame_num][channel_num] = sample_for<SampleValueType>(channel_num, frame_num);
+        }
+    }
+    return samples;
+}
+
+template<typename SampleValueType>
+struct WavFormat;
+
+template<>
+struct WavFormat<int16_t>
+{
+    static constexpr std::uint16_t format_tag = 1;
+};
+
+template<>
+struct WavFormat<int24_t>
+{
+    static constexpr std::uint16_t format_tag = 1;
+};
+
+template<>
+struct WavFormat<int32_t>
+{
+    static constexpr std::uint16_t format_tag = 1;
+};
+
+template<>
+struct WavFormat<float32_t>
+{
+    static constexpr std::uint16_t format_tag = 3;
+};
+
+// Assembles WAV files a chunk at a time, so that tests can produce the unusual layouts found in the wild
+class WavBuilder
+{
+public:
+    explicit WavBuilder(const char* riff_id = "RIFF")
+    {
+        append_id(riff_id);
+        append(std::uint32_t(0));
+        append_id("WAVE");
+    }
+
+    template<typename Tp>
+    void append(Tp value)
+    {
+        for (std::size_t byte_num = 0; byte_num < sizeof(Tp); ++byte_num)
+        {
+            auto byte = (static_cast<std::uint64_t>(value) >> (byte_num * 8)) & 0xff;
+            bytes_.push_back(static_cast<unsigned char>(byte));
+        }
+    }
+
+    void append_id(const char* id)
+    {
+        bytes_.insert(bytes_.end(), id, id + 4);
+    }
+
+    void append_bytes(const void* data, std::size_t size)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        bytes_.insert(bytes_.end(), bytes, bytes + size);
+    }
+
+    void chunk(const char* id, const std::vector<unsigned char>& body)
+    {
+        append_id(id);
+        append(static_cast<std::uint32_t>(body.size()));
+        bytes_.insert(bytes_.end(), body.begin(), body.end());
+        if (body.size() % 2 != 0)
+        {
+            bytes_.push_back(0);
+        }
+    }
+
+    void format(std::uint16_t format_tag, std::size_t channels, std::size_t bits_per_sample)
+    {
+        append_id("fmt ");
+        append(std::uint32_t(16));
+        append_format(format_tag, channels, bits_per_sample);
+    }
+
+    void extensible_format(
+        std::uint16_t format_tag, std::size_t channels, std::size_t bits_per_sample, std::size_t valid_bits_per_sample)
+    {
+        append_id("fmt ");
+        append(std::uint32_t(40));
+        append_format(0xfffe, channels, bits_per_sample);
+        append(std::uint16_t(22));
+        append(static_cast<std::uint16_t>(valid_bits_per_sample));
+        append(std::uint32_t(0));
+        // KSDATAFORMAT_SUBTYPE_PCM and KSDATAFORMAT_SUBTYPE_IEEE_FLOAT only differ in the leading format tag
+        append(format_tag);
+        static const unsigned char guid_tail[] = {
+            0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71};
+        append_bytes(guid_tail, sizeof(guid_tail));
+    }
+
+    template<typename SampleValueType>
+    void data(const interleaved<SampleValueType>& samples, std::uint32_t chunk_size)
+    {
+        append_id("data");
+        append(chunk_size);
+        append_bytes(samples.data(), samples.samples() * sizeof(sample<SampleValueType>));
+    }
+
+    template<typename SampleValueType>
+    void data(const interleaved<SampleValueType>& samples)
+    {
+        data(samples, static_cast<std::uint32_t>(samples.samples() * sizeof(sample<SampleValueType>)));
+    }
+
+    std::string write(const std::string& name)
+    {
+        auto riff_size = static_cast<std::uint32_t>(bytes_.size() - 8);
+        std::memcpy(bytes_.data() + 4, &riff_size, sizeof(riff_size));
+        auto path = ::testing::TempDir() + name;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes_.data()), static_cast<std::streamsize>(bytes_.size()));
+        return path;
+    }
+
+private:
+    void append_format(std::uint16_t format_tag, std::size_t channels, std::size_t bits_per_sample)
+    {
+        auto block_align = channels * (bits_per_sample / 8);
+        append(format_tag);
+        append(static_cast<std::uint16_t>(channels));
+        append(std::uint32_t(48000));
+        append(static_cast<std::uint32_t>(48000 * block_align));
+        append(static_cast<std::uint16_t>(block_align));
+        append(static_cast<std::uint16_t>(bits_per_sample));
+    }
+
+    std::vector<unsigned char> bytes_;
+};
+
+template<typename SampleValueType>
+static void check_samples(
+    const const_interleaved_span<SampleValueType>& span, const interleaved<SampleValueType>& expected)
+{
+    ASSERT_EQ(span.channels(), expected.channels());
+    ASSERT_EQ(span.frames(), expected.frames());
+    for (std::size_t frame_num = 0; frame_num < expected.frames(); ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < expected.channels(); ++channel_num)
+        {
+            EXPECT_EQ(span[frame_num][channel_num], expected[frame_num][channel_num]);
+        }
+    }
+}
+
+template<typename SampleValueType>
+class WavFile : public ::testing::Test
+{
+public:
+    static constexpr std::size_t bits_per_sample = sizeof(sample<SampleValueType>) * 8;
+};
+
+#if !defined(RATL_CPP_VERSION_HAS_CPP17)
+template<typename SampleValueType>
+constexpr std::size_t WavFile<SampleValueType>::bits_per_sample;
+#endif
+
+TYPED_TEST_SUITE(WavFile, PossibleSampleValueTypes, );
+
+TYPED_TEST(WavFile, Read)
+{
+    auto expected = make_samples<TypeParam>(3, 37);
+    WavBuilder builder;
+    builder.format(WavFormat<TypeParam>::format_tag, 3, TestFixture::bits_per_sample);
+    builder.data(expected);
+    wav_file file(builder.write("wav_file_read.wav"));
+
+    EXPECT_EQ(file.channels(), 3);
+    EXPECT_EQ(file.frames(), 37);
+    EXPECT_EQ(file.sample_rate(), 48000);
+    EXPECT_EQ(file.bits_per_sample(), TestFixture::bits_per_sample);
+    EXPECT_EQ(file.valid_bits_per_sample(), TestFixture::bits_per_sample);
+    EXPECT_EQ(file.is_float(), (std::is_same<TypeParam, float32_t>::value));
+    EXPECT_FALSE(file.is_rf64());
+    EXPECT_TRUE(file.template holds<TypeParam>());
+    check_samples(file.template samples<TypeParam>(), expected);
+}
+
+TYPED_TEST(WavFile, Extensible)
+{
+    auto expected = make_samples<TypeParam>(6, 19);
+    WavBuilder builder;
+    builder.extensible_format(WavFormat<TypeParam>::format_tag, 6, TestFixture::bits_per_sample, 20);
+    builder.data(expected);
+    wav_file file(builder.write("wav_file_extensible.wav"));
+
+    EXPECT_EQ(file.channels(), 6);
+    EXPECT_EQ(file.valid_bits_per_sample(), 20);
+    EXPECT_TRUE(file.template holds<TypeParam>());
+    check_samples(file.template samples<TypeParam>(), expected);
+}
+
+TYPED_TEST(WavFile, RF64)
+{
+    auto expected = make_samples<TypeParam>(2, 41);
+    auto data_size = static_cast<std::uint64_t>(expected.samples() * sizeof(sample<TypeParam>));
+    WavBuilder builder("RF64");
+    builder.append_id("ds64");
+    builder.append(std::uint32_t(28));
+    builder.append(std::uint64_t(0));
+    builder.append(data_size);
+    builder.append(static_cast<std::uint64_t>(expected.frames()));
+    builder.append(std::uint32_t(0));
+    builder.format(WavFormat<TypeParam>::format_tag, 2, TestFixture::bits_per_sample);
+    builder.data(expected, 0xffffffff);
+    wav_file file(builder.write("wav_file_rf64.wav"));
+
+    EXPECT_TRUE(file.is_rf64());
+    EXPECT_EQ(file.frames(), 41);
+    check_samples(file.template samples<TypeParam>(), expected);
+}
+
+TYPED_TEST(WavFile, Transform)
+{
+    auto expected = make_samples<TypeParam>(4, 67);
+    WavBuilder builder;
+    builder.format(WavFormat<TypeParam>::format_tag, 4, TestFixture::bits_per_sample);
+    builder.data(expected);
+    wav_file file(builder.write("wav_file_transform.wav"));
+
+    auto span = file.template samples<TypeParam>();
+    noninterleaved<float32_t> output(4, 67);
+    noninterleaved<float32_t> expected_output(4, 67);
+    transform(span.begin(), span.end(), output.begin());
+    transform(expected.begin(), expected.end(), expected_output.begin());
+    EXPECT_EQ(output, expected_output);
+}
+
+TEST(WavFile, SkipsUnknownChunks)
+{
+    auto expected = make_samples<int16_t>(2, 9);
+    WavBuilder builder;
+    builder.chunk("LIST", {'I', 'N', 'F', 'O', 'x'});
+    builder.format(1, 2, 16);
+    builder.chunk("fact", {1, 2, 3, 4});
+    builder.data(expected);
+    wav_file file(builder.write("wav_file_chunks.wav"));
+    check_samples(file.samples<int16_t>(), expected);
+}
+
+TEST(WavFile, TruncatedData)
+{
+    // the data chunk claims more frames than were written, as an interrupted recording would leave it
+    auto expected = make_samples<int24_t>(2, 10);
+    WavBuilder builder;
+    builder.format(1, 2, 24);
+    builder.data(expected, 6000);
+    builder.append(std::uint8_t(0xab));
+    wav_file file(builder.write("wav_file_truncated.wav"));
+    EXPECT_EQ(file.frames(), 10);
+    check_samples(file.samples<int24_t>(), expected);
+}
+
+TEST(WavFile, Frames)
+{
+    auto expected = make_samples<int32_t>(3, 20);
+    WavBuilder builder;
+    builder.format(1, 3, 32);
+    builder.data(expected);
+    wav_file file(builder.write("wav_file_frames.wav"));
+
+    auto span = file.samples<int32_t>(5, 10);
+    EXPECT_EQ(span.frames(), 10);
+    EXPECT_EQ(span[0][2], expected[5][2]);
+    EXPECT_EQ(span[9][0], expected[14][0]);
+    EXPECT_EQ(file.samples<int32_t>(20, 0).frames(), 0);
+    EXPECT_THROW(file.samples<int32_t>(15, 6), std::out_of_range);
+    EXPECT_THROW(file.samples<int32_t>(21, 0), std::out_of_range);
+
+    file.will_need(0, 20);
+    file.dont_need(0, 20);
+    EXPECT_EQ(file.samples<int32_t>()[19][2], expected[19][2]);
+}
+
+TEST(WavFile, Errors)
+{
+    EXPECT_THROW(wav_file(::testing::TempDir() + "wav_file_missing.wav"), std::system_error);
+
+    WavBuilder not_wav("RIFX");
+    EXPECT_THROW(wav_file(not_wav.write("wav_file_rifx.wav")), std::runtime_error);
+
+    WavBuilder eight_bit;
+    eight_bit.format(1, 2, 8);
+    eight_bit.chunk("data", {0, 0});
+    EXPECT_THROW(wav_file(eight_bit.write("wav_file_8bit.wav")), std::runtime_error);
+
+    WavBuilder no_data;
+    no_data.format(1, 2, 16);
+    EXPECT_THROW(wav_file(no_data.write("wav_file_no_data.wav")), std::runtime_error);
+
+    WavBuilder int16_file;
+    int16_file.format(1, 1, 16);
+    int16_file.data(make_samples<int16_t>(1, 4));
+    wav_file file(int16_file.write("wav_file_int16.wav"));
+    EXPECT_FALSE(file.holds<float32_t>());
+    EXPECT_FALSE(file.holds<int24_t>());
+    EXPECT_THROW(file.samples<float32_t>(), std::invalid_argument);
+}
+
+} // namespace test
+} // namespace ratl
@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2018-2022 Hamish Cook
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// ratl test includes
+#include "test_utils.hpp"
+
+// other includes
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace ratl
+{
+namespace test
+{
+template<typename SampleValueType>
+static interleaved<SampleValueType> make_samples(std::size_t channels, std::size_t frames)
+{
+    interleaved<SampleValueType> samples(channels, frames);
+    for (std::size_t frame_num = 0; frame_num < frames; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < channels; ++channel_num)
+        {
+            auto value = static_cast<int32_t>(((channel_num + 1) * 0x100) + frame_num + 1) * 0x10000;
+            samples[frame_num][channel_num] = reference_convert<sample<SampleValueType>>(sample<int32_t>(value));
+        }
+    }
+    return samples;
+}
+
+template<typename SampleValueType>
+static void check_samples(
+    const const_interleaved_span<SampleValueType>& span, const interleaved<SampleValueType>& expected)
+{
+    ASSERT_EQ(span.channels(), expected.channels());
+    ASSERT_EQ(span.frames(), expected.frames());
+    for (std::size_t frame_num = 0; frame_num < expected.frames(); ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < expected.channels(); ++channel_num)
+        {
+            EXPECT_EQ(span[frame_num][channel_num], expected[frame_num][channel_num]);
+        }
+    }
+}
+
+// Small blocks, so that a few hundred frames span several of them
+static wav_writer_options small_blocks()
+{
+    wav_writer_options options;
+    options.block_bytes = 1;
+    options.blocks = 4;
+    return options;
+}
+
+template<typename SampleValueType>
+class WavWriter : public ::testing::Test
+{
+};
+
+TYPED_TEST_SUITE(WavWriter, PossibleSampleValueTypes, );
+
+TYPED_TEST(WavWriter, Write)
+{
+    auto expected = make_samples<TypeParam>(3, 3000);
+    auto path = ::testing::TempDir() + "wav_writer_write.wav";
+    {
+        wav_writer<TypeParam> writer(path, 3, 48000, small_blocks());
+        EXPECT_EQ(writer.block_frames() * 3 * sizeof(sample<TypeParam>) % 4096, 0);
+
+        // uneven writes, so that they straddle block boundaries
+        std::size_t frame_num = 0;
+        for (std::size_t frames = 1; frame_num < expected.frames(); frames = (frames * 3) % 1000 + 1)
+        {
+            frames = std::min(frames, expected.frames() - frame_num);
+            auto span = const_interleaved_span<TypeParam>(expected.data() + (frame_num * 3), 3, frames);
+            EXPECT_EQ(writer.write(span), frames);
+            frame_num += frames;
+        }
+        EXPECT_EQ(writer.frames(), expected.frames());
+        EXPECT_EQ(writer.dropped_frames(), 0);
+        writer.close();
+    }
+
+    wav_file file(path);
+    EXPECT_EQ(file.channels(), 3);
+    EXPECT_EQ(file.sample_rate(), 48000);
+    EXPECT_EQ(file.is_float(), (std::is_same<TypeParam, float32_t>::value));
+    EXPECT_FALSE(file.is_rf64());
+    check_samples(file.template samples<TypeParam>(), expected);
+}
+
+TEST(WavWriter, Convert)
+{
+    auto input = make_samples<int32_t>(2, 500);
+    noninterleaved<int32_t> noninterleaved_input(2, 500);
+    for (std::size_t frame_num = 0; frame_num < 500; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < 2; ++channel_num)
+        {
+            noninterleaved_input[channel_num][frame_num] = input[frame_num][channel_num];
+        }
+    }
+
+    auto path = ::testing::TempDir() + "wav_writer_convert.wav";
+    {
+        wav_writer<float32_t> writer(path, 2, 96000, small_blocks());
+        EXPECT_EQ(writer.write(input), 500);
+        EXPECT_EQ(writer.write(noninterleaved_input), 500);
+    }
+
+    wav_file file(path);
+    EXPECT_EQ(file.sample_rate(), 96000);
+    auto samples = file.samples<float32_t>();
+    ASSERT_EQ(samples.frames(), 1000);
+    for (std::size_t frame_num = 0; frame_num < 500; ++frame_num)
+    {
+        for (std::size_t channel_num = 0; channel_num < 2; ++channel_num)
+        {
+            auto expected = reference_convert<sample<float32_t>>(input[frame_num][channel_num]);
+            EXPECT_EQ(samples[frame_num][channel_num], expected);
+            EXPECT_EQ(samples[frame_num + 500][channel_num], expected);
+        }
+    }
+}
+
+TEST(WavWriter, DropsFramesWhenFull)
+{
+    auto options = small_blocks();
+    options.blocks = 2;
+    options.poll_interval = std::chrono::seconds(1);
+    auto path = ::testing::TempDir() + "wav_writer_drops.wav";
+
+    wav_writer<int32_t> writer(path, 1, 48000, options);
+    auto input = make_samples<int32_t>(1, writer.block_frames() * 3);
+
+    // the background thread is asleep, so only the first two blocks can be staged
+    EXPECT_EQ(writer.write(input), writer.block_frames() * 2);
+    EXPECT_EQ(writer.frames(), writer.block_frames() * 2);
+    EXPECT_EQ(writer.dropped_frames(), writer.block_frames());
+    writer.close();
+
+    wav_file file(path);
+    EXPECT_EQ(file.frames(), writer.block_frames() * 2);
+}
+
+TEST(WavWriter, Header)
+{
+    auto path = ::testing::TempDir() + "wav_writer_header.wav";
+    auto write_file = [&path](bool in_progress, std::uint64_t data_bytes)
+    {
+        std::vector<unsigned char> bytes(detail::wav_writer_header_size + 24, 0);
+        detail::write_wav_writer_header(
+            bytes.data(), detail::wav_format_pcm, 2, 48000, 24, in_progress, data_bytes);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    };
+
+    // a recording in progress is read to the end of the file
+    write_file(true, 0);
+    {
+        wav_file file(path);
+        EXPECT_FALSE(file.is_rf64());
+        EXPECT_EQ(file.channels(), 2);
+        EXPECT_EQ(file.valid_bits_per_sample(), 24);
+        EXPECT_EQ(file.frames(), 4);
+        EXPECT_TRUE(file.holds<int24_t>());
+    }
+
+    write_file(false, 12);
+    EXPECT_FALSE(wav_file(path).is_rf64());
+    EXPECT_EQ(wav_file(path).frames(), 2);
+
+    // past 4GB the sizes move to the ds64 chunk, and the data chunk is truncated to the frames in the file
+    write_file(false, std::uint64_t(6) << 30);
+    EXPECT_TRUE(wav_file(path).is_rf64());
+    EXPECT_EQ(wav_file(path).frames(), 4);
+}
+
+TEST(WavWriter, Errors)
+{
+    EXPECT_THROW(
+        wav_writer<int16_t>(::testing::TempDir() + "wav_writer_missing/file.wav", 2, 48000), std::system_error);
+}
+
+} // namespace test
+} // namespace ratl